@@ -20,6 +20,8 @@
 #include <stdint.h>
 #include "mbed-client/m2mconfig.h"
 #include "mbed-client/m2mreportobserver.h"
+#include "mbed-client/m2mmemorystats.h"
+#include "mbed-client/m2mstringpool.h"
 
 //FORWARD DECLARATION
 struct sn_coap_hdr_;
@@ -45,7 +47,8 @@ public:
     typedef enum {
         Object = 0x0,
         Resource = 0x1,
-        ObjectInstance = 0x2
+        ObjectInstance = 0x2,
+        ResourceTable = 0x3
     } BaseType;
 
     /**
@@ -268,6 +271,15 @@ public:
      */
     virtual uint16_t observation_number() const;
 
+    /**
+     * @brief Returns the memory held by this object and everything
+     * it owns. Objects and object instances keep their counters up
+     * to date on every allocation, so reading them does not walk the
+     * object tree. The numbers of a resource are computed when asked.
+     * @return Memory statistics of the object.
+     */
+    virtual M2MMemoryStats memory_stats() const;
+
     /**
      * @brief Parses the received query for notification
      * attribute.
@@ -357,31 +369,103 @@ protected:
     */
     M2MObservationHandler* observation_handler();
 
+    /**
+     * @brief Adds the memory held by this object to the memory statistics
+     * of its owner, or removes it from them.
+     * @param attached, True when the object is added to its owner, false
+     * when it is removed.
+    */
+    virtual void set_memory_attached(bool attached);
+
+    /**
+     * @brief Sets whether the object is included in the memory statistics
+     * of its owner without passing anything to the owner. Used for objects
+     * whose memory the owner already received as part of their parent.
+     * @param attached, True if included else false.
+    */
+    void mark_memory_attached(bool attached);
+
+    /**
+     * @brief Returns whether the memory held by this object is included
+     * in the memory statistics of its owner.
+     * @return True if included else false.
+    */
+    bool memory_attached() const;
+
+    /**
+     * @brief Updates the memory statistics after this object allocated or
+     * released memory. Resources keep no counters of their own, the change
+     * is passed to their owner once they are attached to it.
+     * @param category, Category of the memory.
+     * @param delta, Number of bytes allocated (positive) or released (negative).
+    */
+    virtual void update_memory_stats(M2MMemoryStats::Category category, int32_t delta);
+
+    /**
+     * @brief Passes a change in the memory held by this object to the
+     * memory statistics of its owner.
+     * @param category, Category of the memory.
+     * @param delta, Number of bytes allocated (positive) or released (negative).
+    */
+    virtual void update_owner_memory_stats(M2MMemoryStats::Category category, int32_t delta);
+
+    /**
+     * @brief Updates the memory statistics after a change in a list of pointers
+     * owned by this object.
+     * @param old_size, Size of the list before the change.
+     * @param old_capacity, Capacity of the list before the change.
+     * @param new_size, Size of the list after the change.
+     * @param new_capacity, Capacity of the list after the change.
+    */
+    void update_list_memory_stats(int old_size, int old_capacity,
+                                  int new_size, int new_capacity);
+
 private:
 
+    /**
+     * Observation state of the object. Allocated only for objects that
+     * are observed or have a token or an observation number, the rest
+     * of the objects don't pay for it.
+     */
+    typedef struct {
+        M2MReportHandler           *report_handler;
+        uint8_t                    *token;
+        uint16_t                    observation_number;
+        uint8_t                     token_length;
+    } ObservationData;
+
     bool is_integer(const String &value);
 
-private:
+    M2MBase::ObservationData* observation_data();
+
+    void release_observation_data();
+
+    void create_report_handler();
+
+    void delete_report_handler();
 
+    void copy_observation_data(const M2MBase &other);
+
+private:
 
-    M2MReportHandler           *_report_handler;
     M2MObservationHandler      *_observation_handler;
-    M2MBase::Operation          _operation;
-    M2MBase::Mode               _mode;
-    M2MBase::BaseType           _base_type;
-    M2MBase::Observation        _observation_level;
-    String                      _name;
-    String                      _resource_type;
+    ObservationData            *_observation;
     int32_t                     _name_id;
-    String                      _interface_description;
-    uint8_t                     _coap_content_type;
+    M2MStringPool::Handle       _name;
+    M2MStringPool::Handle       _resource_type;
+    M2MStringPool::Handle       _interface_description;
     uint16_t                    _instance_id;
-    bool                        _observable;
-    uint16_t                    _observation_number;
-    uint8_t                     *_token;
-    uint8_t                     _token_length;
+    uint8_t                     _coap_content_type;
+    M2MBase::Operation          _operation : 4;
+    M2MBase::Mode               _mode : 2;
+    M2MBase::BaseType           _base_type : 2;
+    M2MBase::Observation        _observation_level : 3;
+    bool                        _observable : 1;
+    bool                        _memory_attached : 1;
 
 friend class Test_M2MBase;
+friend class Test_M2MNsdlInterface;
+friend class M2MNsdlInterface;
 
 };
 
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_COAP_TCP_FRAMER_H
+#define M2M_COAP_TCP_FRAMER_H
+
+#include <stdint.h>
+
+/**
+ *  @brief M2MCoapTcpFramer.
+ *  Converts between CoAP messages in the UDP format used by the CoAP
+ *  library and the length-prefixed framing of CoAP over TCP (RFC 8323).
+ *  Outbound messages are reframed, empty ACK and RST messages are
+ *  dropped and retransmissions of confirmable messages are suppressed,
+ *  as the stream is reliable. A CoAP ping, an empty confirmable message,
+ *  is sent as a Ping signal and the Pong is handed back as a reset with
+ *  the ping's message ID. Inbound bytes are reassembled into
+ *  complete messages which are handed back in the UDP format:
+ *  a response to a confirmable request gets the request's message ID
+ *  as a piggybacked ACK, so the library completes the exchange as usual.
+ *  Confirmable notifications are acknowledged locally. Signaling
+ *  messages (CSM, Ping, Pong, Release, Abort) are handled here.
+ */
+class M2MCoapTcpFramer {
+
+public:
+
+    static const uint8_t MAX_EXCHANGES = 8;
+    static const uint8_t SENT_HISTORY = 16;
+    static const uint8_t MAX_LOCAL_ACKS = 4;
+
+    /**
+     * @brief Constructor
+     * @param max_message_size, Largest message handled in either direction.
+     */
+    M2MCoapTcpFramer(uint16_t max_message_size);
+
+    /**
+     * @brief Destructor
+     */
+    ~M2MCoapTcpFramer();
+
+    /**
+     * @brief Clears the state, called when a new connection is opened.
+     */
+    void reset();
+
+    /**
+     * @brief Converts an outbound message into a TCP frame. The first
+     * frame after reset() is preceded by the CSM signaling message.
+     * @param message, Message in the UDP format.
+     * @param length, Length of the message.
+     * @param frame_length[OUT], Length of the frame.
+     * @return Frame, valid until the next call to encode(), NULL if
+     * the message must not be sent on TCP or is invalid.
+     */
+    const uint8_t* encode(const uint8_t *message,
+                          uint16_t length,
+                          uint16_t &frame_length);
+
+    /**
+     * @brief Appends received stream data for reassembly.
+     * @param data, Received data.
+     * @param length, Length of the data.
+     * @return Number of bytes taken, less than length when the
+     * reassembly buffer is full and messages should be taken out
+     * with next_message() first.
+     */
+    uint16_t feed(const uint8_t *data, uint16_t length);
+
+    /**
+     * @brief Returns the next reassembled message in the UDP format.
+     * Local acknowledgements are returned first.
+     * @param length[OUT], Length of the message.
+     * @return Message, valid until the next call to next_message(),
+     * NULL if no complete message is available.
+     */
+    const uint8_t* next_message(uint16_t &length);
+
+    /**
+     * @brief Returns a signaling frame to be sent in reply to the peer,
+     * for example a Pong.
+     * @param frame_length[OUT], Length of the frame.
+     * @return Frame, valid until the next call to next_message(), NULL if
+     * nothing needs to be sent.
+     */
+    const uint8_t* next_signal(uint16_t &frame_length);
+
+    /**
+     * @brief Returns whether the stream can't be used anymore, the peer
+     * sent Release or Abort or a frame couldn't be parsed. The connection
+     * must be closed.
+     */
+    bool failed() const;
+
+    /**
+     * @brief Returns the Max-Message-Size announced by the peer.
+     */
+    uint32_t peer_max_message_size() const;
+
+private:
+
+    typedef struct {
+        uint16_t    msg_id;
+        uint8_t     token_length;
+        uint8_t     token[8];
+        bool        in_use;
+    } Exchange;
+
+    typedef enum {
+        FrameIncomplete,
+        FrameComplete,
+        FrameInvalid
+    } FrameStatus;
+
+    FrameStatus frame_length(const uint8_t *data,
+                             uint32_t available,
+                             uint32_t &header_length,
+                             uint32_t &body_length) const;
+
+    uint16_t write_frame_header(uint8_t *frame,
+                                uint32_t body_length,
+                                uint8_t token_length,
+                                uint8_t code) const;
+
+    bool handle_signal(uint8_t code,
+                       const uint8_t *token,
+                       uint8_t token_length,
+                       const uint8_t *options,
+                       uint32_t options_length);
+
+    bool was_sent(uint16_t msg_id) const;
+
+    // Prevents the use of assignment operator.
+    M2MCoapTcpFramer& operator=( const M2MCoapTcpFramer& /*other*/ );
+
+    // Prevents the use of copy constructor
+    M2MCoapTcpFramer( const M2MCoapTcpFramer& /*other*/ );
+
+private:
+
+    uint16_t                _max_message_size;
+    uint8_t                 *_stream;           // Reassembly buffer.
+    uint32_t                _stream_length;
+    uint32_t                _stream_capacity;
+    uint8_t                 *_output;           // Frame handed out by encode().
+    uint8_t                 *_message;          // Message handed out by next_message().
+    uint8_t                 _signal[16];        // Pending reply to a signal.
+    uint16_t                _signal_length;
+    Exchange                _exchanges[MAX_EXCHANGES];
+    uint8_t                 _exchange_next;
+    uint16_t                _sent[SENT_HISTORY];  // Confirmable message IDs already sent.
+    uint8_t                 _sent_count;
+    uint8_t                 _sent_next;
+    uint16_t                _local_acks[MAX_LOCAL_ACKS];
+    uint8_t                 _local_ack_count;
+    uint16_t                _ping_msg_id;       // Message ID of the ping sent as a Ping signal.
+    bool                    _ping_pending;
+    uint16_t                _next_msg_id;
+    uint32_t                _peer_max_message_size;
+    bool                    _csm_sent;
+    bool                    _failed;
+
+friend class Test_M2MCoapTcpFramer;
+};
+
+#endif // M2M_COAP_TCP_FRAMER_H
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_COMMAND_QUEUE_H
+#define M2M_COMMAND_QUEUE_H
+
+#include <stdint.h>
+#include "mbed-client/m2mconfig.h"
+
+class M2MBase;
+class M2MResourceInstance;
+
+/**
+ * @brief M2MCommandQueue.
+ * Queue through which other threads hand mutations of the object model to
+ * the thread running the client. The object model, the report handlers and
+ * the NSDL interface are not synchronized, so they may only be touched by
+ * the client thread. Producer threads post commands without taking a lock,
+ * and the client thread applies them in batches by calling process().
+ * Any number of threads may post, but only one thread may process.
+ */
+class M2MCommandQueue {
+
+public:
+
+    /**
+     * Function run on the client thread by a posted call command.
+     */
+    typedef void (*command_function)(void *argument);
+
+    /**
+     * @brief Constructor
+     */
+    M2MCommandQueue();
+
+    /**
+     * @brief Destructor. Pending commands are discarded without
+     * being applied.
+     */
+    ~M2MCommandQueue();
+
+    /**
+     * @brief Posts a value update for the resource. The value is copied
+     * and set with M2MResourceInstance::set_value() on the client thread.
+     * Can be called from any thread.
+     * @param resource, Resource to be updated.
+     * @param value, New value of the resource.
+     * @param value_length, Length of the value.
+     * @return True if posted, false if memory ran out.
+     */
+    bool post_value(M2MResourceInstance *resource,
+                    const uint8_t *value,
+                    const uint32_t value_length);
+
+    /**
+     * @brief Posts a function to be called on the client thread, for
+     * mutations of the object model other than value updates.
+     * Can be called from any thread.
+     * @param function, Function to be called.
+     * @param argument, Argument passed to the function.
+     * @param target, Object the function operates on, used by cancel(),
+     * can be NULL.
+     * @return True if posted, false if memory ran out.
+     */
+    bool post_call(command_function function,
+                   void *argument,
+                   M2MBase *target = NULL);
+
+    /**
+     * @brief Applies the pending commands in the order they were posted.
+     * Must be called from the client thread only.
+     * @param max_commands, Maximum number of commands to apply, 0 applies
+     * all the commands which are fully posted.
+     * @return Number of commands applied.
+     */
+    uint32_t process(uint32_t max_commands = 0);
+
+    /**
+     * @brief Discards the pending commands targeting the given object.
+     * Must be called from the client thread before the object is deleted.
+     * @param target, Object being deleted.
+     */
+    void cancel(M2MBase *target);
+
+private:
+
+    typedef enum {
+        SetValue,
+        Call
+    } CommandType;
+
+    struct Command {
+        Command                *next;
+        CommandType             type;
+        M2MBase                *target;
+        command_function        function;
+        void                   *argument;
+        uint32_t                value_length;
+        uint8_t                 value[1];
+    };
+
+    void push(Command *command);
+
+    Command* pop();
+
+    void apply(Command *command);
+
+    // Prevents the use of assignment operator.
+    M2MCommandQueue& operator=( const M2MCommandQueue& /*other*/ );
+
+    // Prevents the use of copy constructor
+    M2MCommandQueue( const M2MCommandQueue& /*other*/ );
+
+private:
+
+    Command                    *_head;      // Last posted command, shared by the producers.
+    Command                    *_tail;      // Next command to apply, owned by the consumer.
+    Command                     _stub;
+
+friend class Test_M2MCommandQueue;
+};
+
+#endif // M2M_COMMAND_QUEUE_H
@@ -100,6 +100,19 @@ public:
     */
     void stop_listening();
 
+    /**
+    * @brief Returns the socket of the connection.
+    * @return Socket descriptor, -1 if no socket is open.
+    */
+    int socket_fd() const;
+
+    /**
+    * @brief Reads the data available on the socket without blocking
+    * and reports it through the observer, used in poll mode instead
+    * of the listen thread. A pending non-blocking handshake is continued.
+    */
+    void process_io();
+
     /**
      * @brief sendToSocket Sends directly to socket. This is used by
      * security classes to send after data has been encrypted.
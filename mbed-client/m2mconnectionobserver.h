@@ -37,6 +37,15 @@ public :
         LWM2MServer
     }ServerType;
 
+    /**
+      * @enum TransportType, Defines the kind of
+      * socket the connection uses.
+      */
+    typedef enum {
+        Datagram,
+        Stream
+    }TransportType;
+
     /**
      * @brief The M2MSocketAddress struct.
      * Unified container for holding socket address data
@@ -49,9 +58,54 @@ public :
         uint16_t                    _port;
     };
 
+    /**
+    * @brief Returns the transport the observer expects. With Stream the
+    * connection is a TCP socket, data_available() passes the bytes as read
+    * from the stream and sent data is already framed for the stream.
+    * @return Transport type, Datagram by default.
+    */
+    virtual M2MConnectionObserver::TransportType transport_type() const { return Datagram; }
+
+    /**
+    * @brief Returns the registration state saved by an earlier run. The
+    * connection handler may connect to the server address in it without
+    * resolving the name again and resume the DTLS session in it instead
+    * of a full handshake, storing the new session once connected.
+    * @return Registration store, NULL by default.
+    */
+    virtual M2MRegistrationStore* registration_store() { return NULL; }
+
+    /**
+    * @brief Returns whether the client is polled from the application's
+    * event loop. In poll mode the connection handler starts no threads,
+    * start_listening_for_data() doesn't block or start a listen thread and
+    * the received data is read in M2MConnectionHandler::process_io().
+    * @return True in poll mode, false by default.
+    */
+    virtual bool poll_mode() const { return false; }
+
+    /**
+    * @brief Lends a buffer to receive the next datagram into. Data received
+    * into it and passed to data_available() is processed without copying,
+    * the buffer is handed back to the observer once processed.
+    * @param size[OUT], Size of the buffer.
+    * @return Buffer to receive into, NULL if the observer has no buffer
+    * available and data_available() should be called with the socket's
+    * own buffer.
+    */
+    virtual uint8_t* receive_buffer(uint16_t &size) { size = 0; return NULL; }
+
+    /**
+    * @brief Returns a buffer taken with receive_buffer() which was not
+    * passed to data_available(), for example when the receive failed.
+    * @param buffer, Buffer to return.
+    */
+    virtual void release_receive_buffer(uint8_t* /*buffer*/) {}
+
     /**
     * @brief Indicates data is available from socket.
-    * @param data, data read from socket.
+    * @param data, data read from socket, either a buffer taken with
+    * receive_buffer() or a buffer which is valid only during the call.
     * @param data_size, length of data read from socket.
     * @param address, Server Address from where data is coming.
     */
@@ -19,6 +19,7 @@
 class M2MConnectionHandler;
 class M2MSecurity;
 class M2MConnectionSecurityPimpl;
+class M2MDtlsSessionCache;
 
 /**
  * @brief M2MConnectionSecurity.
@@ -49,9 +50,20 @@ public:
 
     /**
      * @brief Resets the socket connection states.
+     * The session and Connection ID kept in the session cache survive
+     * the reset, so the next handshake can be abbreviated.
      */
     void reset();
 
+    /**
+     * @brief Sets the cache used to resume DTLS sessions and to keep the
+     * negotiated Connection ID over reconnects. Without a cache every
+     * connect performs a full handshake.
+     * @param cache, Session cache, not owned, must outlive this object.
+     * NULL disables resumption.
+     */
+    void set_session_cache(M2MDtlsSessionCache *cache);
+
     /**
      * @brief Initiatlizes the socket connection states.
      */
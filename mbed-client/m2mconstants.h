@@ -21,6 +21,23 @@
 
 const int MAX_VALUE_LENGTH = 256;
 const int BUFFER_LENGTH = 1024;
+const uint8_t RECEIVE_BUFFER_COUNT = 4;
+const uint16_t RECEIVE_BUFFER_SIZE = BUFFER_LENGTH;
+const uint16_t COAP_TCP_MAX_MESSAGE_SIZE = 1152;
+const uint32_t DTLS_SESSION_LIFETIME = 86400; //in seconds
+const uint8_t DTLS_SESSION_CACHE_SIZE = 4;
+const uint8_t DNS_CACHE_SIZE = 4;
+const uint32_t DNS_CACHE_DEFAULT_TTL = 300; //in seconds, when the resolver gives no TTL
+const uint32_t DNS_CACHE_MAX_TTL = 86400; //in seconds
+const uint32_t HAPPY_EYEBALLS_DELAY = 250; //in milliseconds, RFC 8305 Connection Attempt Delay
+const uint8_t SEND_QUEUE_SIZE = 8;
+const uint8_t SEND_RETRY_LIMIT = 5; // Failed send attempts before a network error.
+const uint8_t COAP_NSTART = 1; // Confirmable messages in flight.
+const uint32_t COAP_EXCHANGE_TIMEOUT = 93; //in seconds, MAX_TRANSMIT_WAIT
+const uint32_t QUEUE_MODE_LISTEN_TIME = 93; //in seconds, MAX_TRANSMIT_WAIT
+const uint32_t QUEUE_MODE_WAKE_INTERVAL = 60; //in seconds, within the CoAP retransmission span
+const uint32_t KEEPALIVE_TIMEOUT = 3; //in seconds, first wait for the ping reply, doubled per attempt
+const uint8_t KEEPALIVE_ATTEMPTS = 3; // Ping transmissions before the path is considered lost.
 extern const String COAP;
 const int32_t MINIMUM_REGISTRATION_TIME = 60; //in seconds
 const uint64_t ONE_SECOND_TIMER = 1;
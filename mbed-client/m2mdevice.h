@@ -26,12 +26,14 @@ class M2MResourceInstance;
  *  @brief M2MDevice.
  *  This class represents the Device Object model of LWM2M framework.
  *  This class will provides interface for handling the device object
- *  and all its corresponding resources.There can be only one instance
- *  of Device Object.
+ *  and all its corresponding resources. The factory returns one shared
+ *  instance, applications running several interfaces in the same process
+ *  get a separate Device Object for each of them from M2MInterface::device().
  */
 class  M2MDevice : public M2MObject {
 
 friend class M2MInterfaceFactory;
+friend class M2MInterfaceImpl;
 
 public:
 
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_DNS_CACHE_H
+#define M2M_DNS_CACHE_H
+
+#include <stdint.h>
+#include "mbed-client/m2mconstants.h"
+
+/**
+ *  @brief M2MDnsCache.
+ *  Keeps resolved server addresses over re-registrations and reconnects
+ *  so that the connection handler doesn't need a fresh, blocking name
+ *  resolution every time. Each host keeps all its IPv4 and IPv6
+ *  addresses until its TTL runs out. Lookups return the addresses in the
+ *  order they should be tried in a dual-stack connect: the family and
+ *  the address that last connected first, IPv6 first if none has, and
+ *  the families interleaved after that.
+ */
+class M2MDnsCache {
+
+public:
+
+    static const uint8_t MAX_ADDRESSES = 4;
+
+    /**
+     * @brief Resolved address, 4 bytes for IPv4 and 16 for IPv6.
+     */
+    typedef struct {
+        uint8_t     address[16];
+        uint8_t     length;
+    } Address;
+
+    /**
+     * @brief Lookup counters.
+     */
+    typedef struct {
+        uint32_t    hits;
+        uint32_t    misses;
+        uint32_t    expired;
+    } Stats;
+
+    /**
+     * @brief Constructor
+     * @param entries, Maximum number of hosts cached.
+     * @param max_ttl, Upper limit for the TTL of an entry, in seconds.
+     */
+    M2MDnsCache(uint8_t entries = DNS_CACHE_SIZE,
+                uint32_t max_ttl = DNS_CACHE_MAX_TTL);
+
+    /**
+     * @brief Destructor
+     */
+    ~M2MDnsCache();
+
+    /**
+     * @brief Stores the addresses a host resolved to, replacing the earlier
+     * ones. The least recently used host is evicted when the cache is full.
+     * @param host, Host name as given in the server URI.
+     * @param addresses, Resolved addresses, in the order of the resolver.
+     * Addresses beyond MAX_ADDRESSES and of other lengths are ignored.
+     * @param count, Number of addresses.
+     * @param ttl, Seconds the addresses are valid, DNS_CACHE_DEFAULT_TTL
+     * when the resolver doesn't tell.
+     * @param now, Current time in seconds.
+     * @return True if stored, false if there was no valid address or
+     * memory ran out.
+     */
+    bool store(const char *host,
+               const M2MDnsCache::Address *addresses,
+               uint8_t count,
+               uint32_t ttl,
+               uint32_t now);
+
+    /**
+     * @brief Returns the cached addresses of a host in connection order.
+     * An expired entry is removed.
+     * @param host, Host name.
+     * @param now, Current time in seconds.
+     * @param addresses[OUT], Array receiving the addresses.
+     * @param max_count, Size of the array.
+     * @return Number of addresses returned, 0 if the host must be resolved.
+     */
+    uint8_t lookup(const char *host,
+                   uint32_t now,
+                   M2MDnsCache::Address *addresses,
+                   uint8_t max_count);
+
+    /**
+     * @brief Records the address a connection was established to. It is
+     * tried first on the next lookup.
+     * @param host, Host name.
+     * @param address, Address that connected.
+     */
+    void connected(const char *host, const M2MDnsCache::Address &address);
+
+    /**
+     * @brief Removes the addresses of a host, for example when none of
+     * them could be connected to.
+     * @param host, Host name.
+     */
+    void remove(const char *host);
+
+    /**
+     * @brief Removes all the hosts.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of cached hosts.
+     */
+    uint8_t count() const;
+
+    /**
+     * @brief Returns the lookup counters.
+     */
+    const Stats& stats() const;
+
+private:
+
+    typedef struct {
+        char       *host;               // NULL when the entry is free.
+        Address     addresses[MAX_ADDRESSES];
+        uint8_t     count;
+        uint8_t     winner;             // Index of the address that connected, or count.
+        uint32_t    expires;            // Seconds from the store time.
+        uint32_t    stored;
+        uint32_t    used;               // Use sequence number, for eviction.
+    } Entry;
+
+    int find(const char *host) const;
+
+    void release(Entry &entry);
+
+    // Prevents the use of assignment operator.
+    M2MDnsCache& operator=( const M2MDnsCache& /*other*/ );
+
+    // Prevents the use of copy constructor
+    M2MDnsCache( const M2MDnsCache& /*other*/ );
+
+private:
+
+    Entry          *_entries;
+    uint8_t         _capacity;
+    uint32_t        _max_ttl;
+    uint32_t        _use_counter;
+    Stats           _stats;
+
+friend class Test_M2MDnsCache;
+};
+
+#endif // M2M_DNS_CACHE_H
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_DTLS_SESSION_CACHE_H
+#define M2M_DTLS_SESSION_CACHE_H
+
+#include <stdint.h>
+#include "mbed-client/m2mconstants.h"
+
+/**
+ *  @brief M2MDtlsSessionCache.
+ *  Keeps DTLS sessions and Connection IDs over reconnects so that the
+ *  security implementation can resume a session with an abbreviated
+ *  handshake instead of a full one, and keep using a negotiated
+ *  Connection ID when the client address changes. Sessions are stored as
+ *  opaque serialized blobs, so the cache does not depend on the TLS
+ *  library. Entries are keyed by the peer identity, which should cover
+ *  the server address and the credentials used, so that a change of
+ *  either never resumes a stale session.
+ */
+class M2MDtlsSessionCache {
+
+public:
+
+    static const uint8_t MAX_CID_LENGTH = 32;
+
+    /**
+     * @brief Handshake counters.
+     */
+    typedef struct {
+        uint32_t    full_handshakes;
+        uint32_t    resumed_handshakes;
+        uint32_t    rejected_sessions;      // Cached sessions the server refused.
+        uint32_t    expired_sessions;
+    } Stats;
+
+    /**
+     * @brief Constructor
+     * @param entries, Maximum number of peers cached.
+     * @param lifetime, Seconds a session can be resumed after it was stored.
+     */
+    M2MDtlsSessionCache(uint8_t entries = DTLS_SESSION_CACHE_SIZE,
+                        uint32_t lifetime = DTLS_SESSION_LIFETIME);
+
+    /**
+     * @brief Destructor, the cached sessions are wiped.
+     */
+    ~M2MDtlsSessionCache();
+
+    /**
+     * @brief Stores the session of a completed handshake, replacing the
+     * earlier one of the peer. The least recently used entry is evicted
+     * when the cache is full.
+     * @param peer, Peer identity.
+     * @param peer_length, Length of the peer identity.
+     * @param session, Serialized session, copied.
+     * @param session_length, Length of the session.
+     * @param now, Current time in seconds.
+     * @return True if stored, false if memory ran out.
+     */
+    bool store_session(const uint8_t *peer,
+                       uint16_t peer_length,
+                       const uint8_t *session,
+                       uint16_t session_length,
+                       uint32_t now);
+
+    /**
+     * @brief Returns the session to resume with the peer.
+     * An expired session is removed.
+     * @param peer, Peer identity.
+     * @param peer_length, Length of the peer identity.
+     * @param now, Current time in seconds.
+     * @param session_length[OUT], Length of the session.
+     * @return Serialized session, valid until the cache is next modified,
+     * NULL if there is no session to resume.
+     */
+    const uint8_t* session(const uint8_t *peer,
+                           uint16_t peer_length,
+                           uint32_t now,
+                           uint16_t &session_length);
+
+    /**
+     * @brief Stores the Connection ID negotiated with the peer. The peer
+     * must already have a session stored.
+     * @param peer, Peer identity.
+     * @param peer_length, Length of the peer identity.
+     * @param cid, Connection ID the peer uses for the client, copied.
+     * @param cid_length, Length of the Connection ID, 0 clears it.
+     * @return True if stored, false if the peer has no session or the
+     * Connection ID is too long.
+     */
+    bool set_connection_id(const uint8_t *peer,
+                           uint16_t peer_length,
+                           const uint8_t *cid,
+                           uint8_t cid_length);
+
+    /**
+     * @brief Returns the Connection ID negotiated with the peer.
+     * @param peer, Peer identity.
+     * @param peer_length, Length of the peer identity.
+     * @param cid_length[OUT], Length of the Connection ID.
+     * @return Connection ID, NULL if none was negotiated.
+     */
+    const uint8_t* connection_id(const uint8_t *peer,
+                                 uint16_t peer_length,
+                                 uint8_t &cid_length) const;
+
+    /**
+     * @brief Removes the session of the peer, for example when the server
+     * refused to resume it or the credentials changed.
+     * @param peer, Peer identity.
+     * @param peer_length, Length of the peer identity.
+     */
+    void remove_session(const uint8_t *peer, uint16_t peer_length);
+
+    /**
+     * @brief Records a completed handshake in the counters.
+     * @param resumed, True if the cached session was resumed.
+     */
+    void handshake_completed(bool resumed);
+
+    /**
+     * @brief Records that the peer refused to resume the cached session,
+     * which is removed.
+     * @param peer, Peer identity.
+     * @param peer_length, Length of the peer identity.
+     */
+    void session_rejected(const uint8_t *peer, uint16_t peer_length);
+
+    /**
+     * @brief Removes all the sessions.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of cached sessions.
+     */
+    uint8_t count() const;
+
+    /**
+     * @brief Returns the handshake counters.
+     */
+    const Stats& stats() const;
+
+private:
+
+    typedef struct {
+        uint8_t    *peer;
+        uint8_t    *session;
+        uint16_t    peer_length;
+        uint16_t    session_length;
+        uint32_t    stored;             // Time the session was stored.
+        uint32_t    used;               // Use sequence number, for eviction.
+        uint8_t     cid[MAX_CID_LENGTH];
+        uint8_t     cid_length;
+    } Entry;
+
+    int find(const uint8_t *peer, uint16_t peer_length) const;
+
+    void release(Entry &entry);
+
+    // Prevents the use of assignment operator.
+    M2MDtlsSessionCache& operator=( const M2MDtlsSessionCache& /*other*/ );
+
+    // Prevents the use of copy constructor
+    M2MDtlsSessionCache( const M2MDtlsSessionCache& /*other*/ );
+
+private:
+
+    Entry          *_entries;
+    uint8_t         _capacity;
+    uint32_t        _lifetime;
+    uint32_t        _use_counter;
+    Stats           _stats;
+
+friend class Test_M2MDtlsSessionCache;
+};
+
+#endif // M2M_DTLS_SESSION_CACHE_H
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_DTLS_TIMER_H
+#define M2M_DTLS_TIMER_H
+
+#ifdef __linux__
+
+#include <stdint.h>
+#include "mbed-client/m2mreactor.h"
+#include "mbed-client/m2mtimerobserver.h"
+
+/**
+ *  @brief M2MDtlsTimer.
+ *  DTLS retransmission timer on a timer of the shared M2MReactor, in place
+ *  of a separate M2MTimer per connection. set_delay() and get_delay() have
+ *  the signatures of the mbedTLS timer callbacks and can be passed to
+ *  mbedtls_ssl_set_timer_cb() with the timer as context. When the final
+ *  delay expires the observer is told with the Dtls timer type from the
+ *  reactor thread, which is the point to call continue_connecting() again.
+ */
+class M2MDtlsTimer : public M2MReactorHandler {
+
+public:
+
+    /**
+     * @brief Constructor
+     * @param reactor, Reactor owning the timer.
+     * @param observer, Observer told about the expiry of the final delay.
+     */
+    M2MDtlsTimer(M2MReactor &reactor, M2MTimerObserver &observer);
+
+    /**
+     * @brief Destructor, the timer is removed from the reactor.
+     */
+    virtual ~M2MDtlsTimer();
+
+    /**
+     * @brief Returns whether the reactor timer could be created.
+     */
+    bool is_valid() const;
+
+    /**
+     * @brief Starts or cancels the timer, mbedtls_ssl_set_timer_t.
+     * @param timer, The M2MDtlsTimer.
+     * @param intermediate_ms, Intermediate delay in milliseconds.
+     * @param final_ms, Final delay in milliseconds, 0 cancels the timer.
+     */
+    static void set_delay(void *timer, uint32_t intermediate_ms, uint32_t final_ms);
+
+    /**
+     * @brief Returns the timer state, mbedtls_ssl_get_timer_t.
+     * @param timer, The M2MDtlsTimer.
+     * @return -1 if cancelled, 0 if no delay has passed, 1 if the
+     * intermediate delay has passed and 2 if the final delay has passed.
+     */
+    static int get_delay(void *timer);
+
+    /**
+     * @brief From M2MReactorHandler.
+     */
+    virtual void io_ready(int fd, uint32_t events);
+
+    /**
+     * @brief From M2MReactorHandler.
+     */
+    virtual void timer_expired(int timer_fd, uint64_t expirations);
+
+private:
+
+    static uint64_t now();
+
+    // Prevents the use of assignment operator.
+    M2MDtlsTimer& operator=( const M2MDtlsTimer& /*other*/ );
+
+    // Prevents the use of copy constructor
+    M2MDtlsTimer( const M2MDtlsTimer& /*other*/ );
+
+private:
+
+    M2MReactor          &_reactor;
+    M2MTimerObserver    &_observer;
+    int                 _timer_fd;
+    uint64_t            _intermediate;      // Monotonic deadlines in ms, 0 when cancelled.
+    uint64_t            _final;
+
+friend class Test_M2MDtlsTimer;
+};
+
+#endif // __linux__
+
+#endif // M2M_DTLS_TIMER_H
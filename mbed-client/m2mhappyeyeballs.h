@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_HAPPY_EYEBALLS_H
+#define M2M_HAPPY_EYEBALLS_H
+
+#include "mbed-client/m2mdnscache.h"
+
+/**
+ *  @brief M2MHappyEyeballs.
+ *  Schedules the connection attempts of a dual-stack connect as in
+ *  RFC 8305. The addresses are tried in the order given, normally the
+ *  order returned by M2MDnsCache::lookup(), so the families alternate.
+ *  The next attempt starts when the attempt delay has passed without a
+ *  connection, or right away when all the started attempts have failed.
+ *  The first attempt to connect wins and the others are abandoned. The
+ *  class only keeps the schedule, the connection handler opens and
+ *  closes the sockets. Times are in milliseconds.
+ */
+class M2MHappyEyeballs {
+
+public:
+
+    typedef enum {
+        Idle = 0,
+        Connecting,
+        Connected,
+        Failed
+    } State;
+
+    /**
+     * @brief Constructor
+     * @param attempt_delay, Milliseconds to wait for an attempt before
+     * starting the next one.
+     */
+    M2MHappyEyeballs(uint32_t attempt_delay = HAPPY_EYEBALLS_DELAY);
+
+    /**
+     * @brief Destructor
+     */
+    ~M2MHappyEyeballs();
+
+    /**
+     * @brief Starts a new race, forgetting the earlier one.
+     * @param addresses, Addresses in connection order, copied. At most
+     * M2MDnsCache::MAX_ADDRESSES are used.
+     * @param count, Number of addresses.
+     * @param now, Current time.
+     */
+    void start(const M2MDnsCache::Address *addresses, uint8_t count, uint32_t now);
+
+    /**
+     * @brief Returns the address to start connecting to now.
+     * Call until it returns -1 whenever time passes or an attempt fails.
+     * @param now, Current time.
+     * @return Index of the address, -1 if no attempt is due.
+     */
+    int next_attempt(uint32_t now);
+
+    /**
+     * @brief Returns the time until the next attempt is due, for
+     * arming a timer.
+     * @param now, Current time.
+     * @return Milliseconds until next_attempt() returns an address,
+     * UINT32_MAX if no attempt is left.
+     */
+    uint32_t time_to_next_attempt(uint32_t now) const;
+
+    /**
+     * @brief Records a failed attempt.
+     * @param index, Index of the address.
+     * @param now, Current time.
+     */
+    void attempt_failed(uint8_t index, uint32_t now);
+
+    /**
+     * @brief Records the attempt that connected, it wins the race.
+     * Attempts still in progress should be closed.
+     * @param index, Index of the address.
+     */
+    void attempt_connected(uint8_t index);
+
+    /**
+     * @brief Returns true if an attempt was started and hasn't completed.
+     * @param index, Index of the address.
+     */
+    bool in_progress(uint8_t index) const;
+
+    /**
+     * @brief Returns the state of the race.
+     */
+    State state() const;
+
+    /**
+     * @brief Returns the address of the given index, NULL if out of range.
+     */
+    const M2MDnsCache::Address* address(uint8_t index) const;
+
+    /**
+     * @brief Returns the index of the address that connected, -1 if none.
+     */
+    int winner() const;
+
+private:
+
+    typedef enum {
+        NotStarted = 0,
+        InProgress,
+        Done
+    } AttemptState;
+
+    void update_state();
+
+    // Prevents the use of assignment operator.
+    M2MHappyEyeballs& operator=( const M2MHappyEyeballs& /*other*/ );
+
+    // Prevents the use of copy constructor
+    M2MHappyEyeballs( const M2MHappyEyeballs& /*other*/ );
+
+private:
+
+    M2MDnsCache::Address    _addresses[M2MDnsCache::MAX_ADDRESSES];
+    uint8_t                 _attempts[M2MDnsCache::MAX_ADDRESSES];
+    uint8_t                 _count;
+    uint8_t                 _started;       // Attempts started so far, in order.
+    int                     _winner;
+    State                   _state;
+    uint32_t                _attempt_delay;
+    uint32_t                _last_start;
+
+friend class Test_M2MHappyEyeballs;
+};
+
+#endif // M2M_HAPPY_EYEBALLS_H
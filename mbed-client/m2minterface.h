@@ -19,11 +19,14 @@
 #include <stdint.h>
 #include "mbed-client/m2mvector.h"
 #include "mbed-client/m2mconfig.h"
+#include "mbed-client/m2mmemorystats.h"
 
 //FORWARD DECLARATION
 class M2MSecurity;
 class M2MObject;
+class M2MDevice;
 class M2MInterfaceObserver;
+class M2MRegistrationStore;
 
 typedef Vector<M2MObject *> M2MObjectList;
 
@@ -67,7 +70,9 @@ public:
         UDP_QUEUE = 0x03,
         SMS = 0x04,
         SMS_QUEUE =0x06,
-        UDP_SMS_QUEUE = 0x07
+        UDP_SMS_QUEUE = 0x07,
+        TCP = 0x08,
+        TCP_QUEUE = 0x0A
     }BindingMode;
 
     /**
@@ -83,6 +88,28 @@ public:
         Unknown
     }NetworkStack;
 
+    /**
+     * @brief Queue mode activity counters, times in seconds.
+     */
+    typedef struct {
+        uint32_t    windows;                // Wake windows opened.
+        uint32_t    idle_time;              // Time spent not listening between windows.
+        uint32_t    bytes_sent;             // Bytes sent in all the windows.
+        uint32_t    window_bytes;           // Bytes sent in the current or last window.
+        uint32_t    largest_window_bytes;
+        uint32_t    messages_deferred;      // Messages held back until a window.
+    } QueueModeStats;
+
+    /**
+     * @brief Keepalive counters, times in seconds.
+     */
+    typedef struct {
+        uint32_t    interval;               // Idle time before the next ping.
+        uint32_t    nat_timeout;            // Idle time after which the path was lost, 0 if not seen.
+        uint32_t    pings;                  // Pings answered.
+        uint32_t    failures;               // Pings left unanswered.
+    } KeepaliveStats;
+
 public:
 
     virtual ~M2MInterface(){}
@@ -135,6 +162,114 @@ public:
      */
     virtual void unregister_object(M2MSecurity* security_object = NULL) = 0;
 
+    /**
+     * @brief Returns the memory held by the objects registered through
+     * this interface, split per category. The statistics are maintained
+     * incrementally, so this is cheap enough to be polled periodically.
+     * @return Memory statistics of the client.
+     */
+    virtual M2MMemoryStats memory_stats() const = 0;
+
+    /**
+     * @brief Sets the timing of the wake windows used with the queue mode
+     * bindings. The client listens only while a window is open. Its own
+     * requests open a window right away, notifications are held back
+     * until the next window. Has no effect with the other bindings.
+     * @param listen_time, Seconds the client keeps listening after the
+     * last exchange before going idle.
+     * @param wake_interval, Seconds the client stays idle at least before
+     * waking up to send held back notifications.
+     */
+    virtual void set_queue_mode_timing(uint32_t listen_time, uint32_t wake_interval) = 0;
+
+    /**
+     * @brief Returns the queue mode activity counters, all zero with
+     * bindings other than queue mode.
+     * @return Queue mode statistics of the client.
+     */
+    virtual QueueModeStats queue_mode_stats() const = 0;
+
+    /**
+     * @brief Sets the store the registration is kept in across restarts.
+     * The saved state is read right away. If it belongs to the endpoint
+     * and server of the next registration and its lifetime hasn't run out,
+     * the client resumes it with a registration update and registers again
+     * only if the server rejects the update. The store is not owned and
+     * must outlive the interface, NULL stops the saving.
+     * @param store, Registration store of the client.
+     */
+    virtual void set_registration_store(M2MRegistrationStore *store) = 0;
+
+    /**
+     * @brief Sets the keepalive used to hold the path to the server open,
+     * for example through a NAT, independently of the registration lifetime.
+     * After the given idle time the client sends a CoAP ping, a Ping
+     * signal with TCP. If max_interval is larger, the interval grows step
+     * by step while the pings are answered, and falls back to the longest
+     * idle time known to work once a ping goes unanswered. An unanswered
+     * ping triggers a registration update. Has no effect with the queue
+     * mode bindings. Disabled by default.
+     * @param interval, Seconds of idle time before a ping, 0 disables it.
+     * @param max_interval, Longest interval tried while adapting.
+     */
+    virtual void set_keepalive_interval(uint32_t interval, uint32_t max_interval) = 0;
+
+    /**
+     * @brief Returns the keepalive counters.
+     * @return Keepalive statistics of the client.
+     */
+    virtual KeepaliveStats keepalive_stats() const = 0;
+
+    /**
+     * @brief Switches the client to poll mode, to run it from an existing
+     * event loop without any threads of its own. The connection handler
+     * then doesn't start a listen thread, the application calls
+     * process_io() when socket_fd() is readable instead. The timers are
+     * shared by all the clients of a process, so they are switched to
+     * polling once for the whole process with M2MTimer::set_polled(),
+     * then the application calls process_timers() once next_deadline()
+     * is reached. Call this before bootstrapping or registering.
+     * @param poll_mode, True for poll mode, false for the default threads.
+     */
+    virtual void set_poll_mode(bool poll_mode) = 0;
+
+    /**
+     * @brief Returns the socket to watch for readability in poll mode.
+     * The socket changes when the client connects again, so read it
+     * again after every call to process_io() and process_timers().
+     * @return Socket descriptor, -1 if no socket is open.
+     */
+    virtual int socket_fd() const = 0;
+
+    /**
+     * @brief Returns when process_timers() has to be called next in poll mode.
+     * @param time[OUT], Time in milliseconds of the monotonic clock, in
+     * the past if a timer is due already.
+     * @return False if no timer is pending.
+     */
+    virtual bool next_deadline(uint64_t &time) const = 0;
+
+    /**
+     * @brief Receives and processes the data available on the socket
+     * without blocking, in poll mode.
+     */
+    virtual void process_io() = 0;
+
+    /**
+     * @brief Runs the timers due by the given time, in poll mode.
+     * @param now, Current time in milliseconds of the monotonic clock.
+     */
+    virtual void process_timers(uint64_t now) = 0;
+
+    /**
+     * @brief Returns the Device Object of this interface. Every interface
+     * has its own Device Object so that several interfaces can run in the
+     * same process, the object is created on first use and deleted together
+     * with the interface. It still needs to be registered like any other object.
+     * @return Device Object of the interface, NULL if out of memory.
+     */
+    virtual M2MDevice* device() = 0;
+
 };
 
 #endif // M2M_INTERFACE_H
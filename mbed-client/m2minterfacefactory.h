@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include "mbed-client/m2msecurity.h"
 #include "mbed-client/m2mresource.h"
+#include "mbed-client/m2mresourcetable.h"
 #include "mbed-client/m2minterfaceobserver.h"
 
 //FORWARD DECLARATION
@@ -88,7 +89,8 @@ public:
      * @brief Creates device object for mbed Client Inteface using which
      * client can manage device resources used for client operations
      * like Client Registration, Device Management and Information Reporting.
-     * @param name, Name of the device object
+     * The same instance is returned on every call, use M2MInterface::device()
+     * to get a separate device object for each interface.
      * @return M2MDevice, Object to manage other client operations.
      */
     static M2MDevice *create_device();
@@ -104,6 +106,29 @@ public:
      */
     static M2MObject *create_object(const String &name);
 
+    /**
+     * @brief Creates a resource table for mbed Client Inteface. A table is
+     * a compact alternative to a generic object for objects which have a
+     * large number of homogeneous instances, see M2MResourceTable.
+     * @param name, Name of the object
+     * @return M2MResourceTable, Table to manage the object's resources.
+     */
+    static M2MResourceTable *create_resource_table(const String &name);
+
+    /**
+     * @brief Creates a read-only resource table on top of constant resource
+     * definitions. The definitions and their values are referenced, not
+     * copied, so they must stay valid for the lifetime of the table.
+     * @param name, Name of the object
+     * @param resources, Resource definitions sorted by instance ID and resource ID.
+     * @param count, Number of resource definitions.
+     * @return M2MResourceTable, Table to manage the object's resources,
+     * NULL if the definitions are not sorted or contain duplicates.
+     */
+    static M2MResourceTable *create_resource_table(const String &name,
+                                                   const M2MResourceTable::ConstResource *resources,
+                                                   uint16_t count);
+
 
     friend class Test_M2MInterfaceFactory;
 };
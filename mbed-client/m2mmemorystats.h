@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_MEMORY_STATS_H
+#define M2M_MEMORY_STATS_H
+
+#include <stdint.h>
+
+/**
+ * @brief M2MMemoryStats.
+ * Snapshot of the memory held by a part of the object model, split
+ * per category. Counters are maintained incrementally by the objects
+ * themselves whenever they allocate or release memory, so reading them
+ * is cheap enough to be exported as a live gauge.
+ */
+class M2MMemoryStats {
+
+public:
+
+    /**
+     * Enum defining the categories of memory being accounted.
+     */
+    typedef enum {
+        NodeStruct,
+        Strings,
+        Values,
+        Tokens,
+        ReportHandlers,
+        NsdlEntries,
+        ContainerSlack
+    } Category;
+
+    M2MMemoryStats()
+    : node_bytes(0),
+      string_bytes(0),
+      value_bytes(0),
+      token_bytes(0),
+      report_handler_bytes(0),
+      nsdl_bytes(0),
+      container_slack_bytes(0)
+    {
+    }
+
+    /**
+     * @brief Adjusts the counter of the given category.
+     * @param category, Category to be adjusted.
+     * @param delta, Number of bytes allocated (positive) or released (negative).
+     */
+    void update(M2MMemoryStats::Category category, int32_t delta)
+    {
+        switch(category) {
+            case NodeStruct:
+                node_bytes += delta;
+                break;
+            case Strings:
+                string_bytes += delta;
+                break;
+            case Values:
+                value_bytes += delta;
+                break;
+            case Tokens:
+                token_bytes += delta;
+                break;
+            case ReportHandlers:
+                report_handler_bytes += delta;
+                break;
+            case NsdlEntries:
+                nsdl_bytes += delta;
+                break;
+            case ContainerSlack:
+                container_slack_bytes += delta;
+                break;
+        }
+    }
+
+    /**
+     * @brief Returns the counter of the given category.
+     * @param category, Category to be read.
+     * @return Bytes held in the category.
+     */
+    uint32_t bytes(M2MMemoryStats::Category category) const
+    {
+        uint32_t value = 0;
+        switch(category) {
+            case NodeStruct:
+                value = node_bytes;
+                break;
+            case Strings:
+                value = string_bytes;
+                break;
+            case Values:
+                value = value_bytes;
+                break;
+            case Tokens:
+                value = token_bytes;
+                break;
+            case ReportHandlers:
+                value = report_handler_bytes;
+                break;
+            case NsdlEntries:
+                value = nsdl_bytes;
+                break;
+            case ContainerSlack:
+                value = container_slack_bytes;
+                break;
+        }
+        return value;
+    }
+
+    /**
+     * @brief Returns the sum of all the categories.
+     * @return Total bytes held.
+     */
+    uint32_t total() const
+    {
+        return node_bytes + string_bytes + value_bytes + token_bytes +
+               report_handler_bytes + nsdl_bytes + container_slack_bytes;
+    }
+
+    M2MMemoryStats& operator+=(const M2MMemoryStats &other)
+    {
+        node_bytes += other.node_bytes;
+        string_bytes += other.string_bytes;
+        value_bytes += other.value_bytes;
+        token_bytes += other.token_bytes;
+        report_handler_bytes += other.report_handler_bytes;
+        nsdl_bytes += other.nsdl_bytes;
+        container_slack_bytes += other.container_slack_bytes;
+        return *this;
+    }
+
+    M2MMemoryStats& operator-=(const M2MMemoryStats &other)
+    {
+        node_bytes -= other.node_bytes;
+        string_bytes -= other.string_bytes;
+        value_bytes -= other.value_bytes;
+        token_bytes -= other.token_bytes;
+        report_handler_bytes -= other.report_handler_bytes;
+        nsdl_bytes -= other.nsdl_bytes;
+        container_slack_bytes -= other.container_slack_bytes;
+        return *this;
+    }
+
+public:
+
+    uint32_t    node_bytes;             // Object model node structures and their lists.
+    uint32_t    string_bytes;           // Interned names, resource types and interface descriptions.
+    uint32_t    value_bytes;            // Resource values.
+    uint32_t    token_bytes;            // Observation tokens.
+    uint32_t    report_handler_bytes;   // Report handlers and their timers.
+    uint32_t    nsdl_bytes;             // Resource mirrors held by the NSDL library.
+    uint32_t    container_slack_bytes;  // Reserved but unused list capacity.
+};
+
+#endif // M2M_MEMORY_STATS_H
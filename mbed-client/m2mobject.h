@@ -146,13 +146,29 @@ public:
                                                sn_coap_hdr_s *received_coap_header,
                                                M2MObservationHandler *observation_handler = NULL);
 
+    /**
+     * @brief Returns the memory held by the object and its object
+     * instances, kept up to date on every allocation.
+     * @return Memory statistics of the object.
+     */
+    virtual M2MMemoryStats memory_stats() const;
+
 protected :
 
      virtual void notification_update();
 
+     virtual void memory_updated(M2MMemoryStats::Category category, int32_t delta);
+
+     virtual void update_memory_stats(M2MMemoryStats::Category category, int32_t delta);
+
+private:
+
+    void add_object_instance(M2MObjectInstance *instance);
+
 private:
 
     M2MObjectInstanceList     _instance_list; // owned    
+    M2MMemoryStats            _memory_stats;
 
 friend class Test_M2MObject;
 friend class Test_M2MInterfaceImpl;
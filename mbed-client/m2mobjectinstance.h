@@ -26,6 +26,14 @@ typedef Vector<M2MResourceInstance *> M2MResourceInstanceList;
 class M2MObjectCallback {
 public:
     virtual void notification_update() = 0;
+
+    /**
+     * @brief Passes a change in the memory held by an object instance
+     * to the memory statistics of its object.
+     * @param category, Category of the memory.
+     * @param delta, Number of bytes allocated (positive) or released (negative).
+     */
+    virtual void memory_updated(M2MMemoryStats::Category category, int32_t delta) = 0;
 };
 
 /**
@@ -62,6 +70,14 @@ private: // Constructor and destructor are private
     // Prevents the use of copy constructor
     M2MObjectInstance( const M2MObjectInstance& /*other*/ );
 
+    /**
+     * @brief Copies the object instance into another object.
+     * @param other, Object instance to be copied.
+     * @param object_callback, Object owning the copy.
+     */
+    M2MObjectInstance(const M2MObjectInstance &other,
+                      M2MObjectCallback &object_callback);
+
     /**
      * Destructor
      */
@@ -234,14 +250,34 @@ public:
                                                M2MObservationHandler *observation_handler = NULL);
 
 
+    /**
+     * @brief Returns the memory held by the object instance and its
+     * resources, kept up to date on every allocation.
+     * @return Memory statistics of the object instance.
+     */
+    virtual M2MMemoryStats memory_stats() const;
+
 protected :
 
     virtual void notification_update(M2MBase::Observation observation_level);
 
+    virtual void memory_updated(M2MMemoryStats::Category category, int32_t delta);
+
+    virtual void update_memory_stats(M2MMemoryStats::Category category, int32_t delta);
+
+    virtual void update_owner_memory_stats(M2MMemoryStats::Category category, int32_t delta);
+
+private:
+
+    void add_resource(M2MResource *res);
+
+    void erase_resource(int pos);
+
 private:
 
     M2MObjectCallback   &_object_callback;
     M2MResourceList     _resource_list; // owned
+    M2MMemoryStats      _memory_stats;
 
     friend class Test_M2MObjectInstance;
     friend class Test_M2MObject;
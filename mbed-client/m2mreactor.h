@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_REACTOR_H
+#define M2M_REACTOR_H
+
+#ifdef __linux__
+
+#include <stdint.h>
+#include <pthread.h>
+
+/**
+ * @brief M2MReactorHandler.
+ * Receives the readiness of the file descriptors registered
+ * to an M2MReactor. Called from the thread of the reactor loop
+ * owning the descriptor.
+ */
+class M2MReactorHandler {
+
+public:
+
+    virtual ~M2MReactorHandler() {}
+
+    /**
+     * @brief Indicates a registered socket is ready.
+     * @param fd, Socket which is ready.
+     * @param events, M2MReactor::Event bits that are ready.
+     */
+    virtual void io_ready(int fd, uint32_t events) = 0;
+
+    /**
+     * @brief Indicates a timer created with M2MReactor::add_timer() expired.
+     * @param timer_fd, Timer which expired.
+     * @param expirations, Number of expirations since the last call.
+     */
+    virtual void timer_expired(int /*timer_fd*/, uint64_t /*expirations*/) {}
+};
+
+/**
+ *  @brief M2MReactor.
+ *  Shared I/O reactor for the Linux platform. A fixed number of epoll loops,
+ *  each running in its own thread, own the sockets and timers of any number
+ *  of clients and dispatch their readiness to the handlers, so the thread
+ *  count doesn't grow with the number of clients. A connection handler
+ *  using the reactor registers its socket instead of starting a listen
+ *  thread and keeps reporting through M2MConnectionObserver from its
+ *  handler. Descriptors are spread over the loops by load and stay on the
+ *  loop they were added to, so the callbacks of one descriptor never run
+ *  concurrently.
+ */
+class M2MReactor {
+
+public:
+
+    /**
+     * Readiness events.
+     */
+    typedef enum {
+        Readable = 0x1,
+        Writable = 0x2,
+        Error    = 0x4
+    } Event;
+
+    static const uint8_t MAX_LOOPS = 16;
+    static const uint8_t DEFAULT_LOOPS = 2;
+
+    /**
+     * @brief Returns the process-wide reactor, created and started with
+     * DEFAULT_LOOPS loops on first use.
+     */
+    static M2MReactor* shared();
+
+    /**
+     * @brief Constructor
+     * @param loop_count, Number of epoll loops and threads, 1 - MAX_LOOPS.
+     */
+    M2MReactor(uint8_t loop_count);
+
+    /**
+     * @brief Destructor, stops the loops. Registered descriptors are
+     * not closed, except the timers.
+     */
+    ~M2MReactor();
+
+    /**
+     * @brief Starts the loop threads.
+     * @return True if running, else false.
+     */
+    bool start();
+
+    /**
+     * @brief Stops the loop threads and waits for them to exit.
+     * Must not be called from a handler.
+     */
+    void stop();
+
+    /**
+     * @brief Registers a socket.
+     * @param fd, Socket to watch, not owned.
+     * @param events, Event bits to watch, Error is always reported.
+     * @param handler, Handler for the socket.
+     * @return True if registered, else false.
+     */
+    bool add(int fd, uint32_t events, M2MReactorHandler *handler);
+
+    /**
+     * @brief Changes the events watched on a registered socket.
+     * @param fd, Registered socket.
+     * @param events, Event bits to watch.
+     * @return True if changed, false if not registered.
+     */
+    bool modify(int fd, uint32_t events);
+
+    /**
+     * @brief Unregisters a socket. Once this returns the handler is not
+     * running and won't be called for the socket, also when called from
+     * another thread. Can be called from a handler.
+     * @param fd, Registered socket.
+     */
+    void remove(int fd);
+
+    /**
+     * @brief Creates a timer owned by the reactor.
+     * @param handler, Handler for the timer.
+     * @return Timer descriptor, -1 on failure.
+     */
+    int add_timer(M2MReactorHandler *handler);
+
+    /**
+     * @brief Starts or restarts a timer.
+     * @param timer_fd, Timer from add_timer().
+     * @param interval, Interval in milliseconds, 0 stops the timer.
+     * @param single_shot, True to expire once, false to repeat.
+     * @return True if started, else false.
+     */
+    bool start_timer(int timer_fd, uint64_t interval, bool single_shot);
+
+    /**
+     * @brief Removes and closes a timer, see remove().
+     * @param timer_fd, Timer from add_timer().
+     */
+    void remove_timer(int timer_fd);
+
+    /**
+     * @brief Returns the number of loops, which is also the thread count.
+     */
+    uint8_t loop_count() const;
+
+    /**
+     * @brief Returns the number of registered descriptors.
+     */
+    uint32_t registered() const;
+
+private:
+
+    struct Entry;
+
+    /**
+     * Epoll loop with its thread. The mutex is held while events are
+     * dispatched, remove() takes it to wait for a running handler.
+     */
+    struct Loop {
+        M2MReactor          *reactor;
+        int                 epoll_fd;
+        int                 wakeup_fd;
+        pthread_t           thread;
+        bool                thread_started;
+        pthread_mutex_t     mutex;
+        uint32_t            entry_count;
+        Entry               *retired;       // Removed entries, freed after the dispatch round.
+    };
+
+    struct Entry {
+        int                 fd;
+        uint32_t            events;
+        M2MReactorHandler   *handler;       // NULL once removed.
+        bool                timer;
+        Loop                *loop;
+        Entry               *next;          // In the entry list or in the retired list.
+    };
+
+    static void* loop_thread(void *argument);
+
+    void run_loop(Loop *loop);
+
+    bool add_entry(int fd, uint32_t events, M2MReactorHandler *handler, bool timer);
+
+    Entry* find(int fd) const;
+
+    void unlink(Entry *entry);
+
+    static uint32_t epoll_events(uint32_t events);
+
+    static void create_shared();
+
+    // Prevents the use of assignment operator.
+    M2MReactor& operator=( const M2MReactor& /*other*/ );
+
+    // Prevents the use of copy constructor
+    M2MReactor( const M2MReactor& /*other*/ );
+
+private:
+
+    Loop                        _loops[MAX_LOOPS];
+    uint8_t                     _loop_count;
+    bool                        _running;
+    mutable pthread_mutex_t     _entries_mutex;
+    Entry                       *_entries;
+    uint32_t                    _entry_count;
+
+    static M2MReactor           *_shared;
+    static pthread_once_t       _shared_once;
+
+friend class Test_M2MReactor;
+};
+
+#endif // __linux__
+
+#endif // M2M_REACTOR_H
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_REGISTRATION_STORE_H
+#define M2M_REGISTRATION_STORE_H
+
+#include <stdint.h>
+
+/**
+ *  @brief M2MRegistrationStore.
+ *  Registration state of the client kept in a small local file so that
+ *  a restarted client can resume its registration with a registration
+ *  update instead of registering again. The record holds the endpoint
+ *  name and server URI it belongs to, the registration location and
+ *  lifetime, the time of the last successful registration or update,
+ *  the resolved server address and optionally the DTLS session, which
+ *  the connection handler can use to skip the name resolution and the
+ *  full handshake. The file is replaced atomically and protected with a
+ *  checksum, a damaged or foreign file is ignored. On Linux it is synced
+ *  to the disk before it replaces the old one and only its owner can
+ *  read it.
+ */
+class M2MRegistrationStore {
+
+public:
+
+    static const uint8_t MAX_NAME_LENGTH = 64;
+    static const uint8_t MAX_URI_LENGTH = 128;
+    static const uint8_t MAX_LOCATION_LENGTH = 64;
+    static const uint16_t MAX_SESSION_LENGTH = 1024;
+
+    /**
+     * @brief Constructor
+     * @param path, File the state is kept in, copied.
+     */
+    M2MRegistrationStore(const char *path);
+
+    /**
+     * @brief Destructor, the session held in memory is wiped.
+     */
+    ~M2MRegistrationStore();
+
+    /**
+     * @brief Reads the state from the file.
+     * @return True if a valid state was read, false if the file is
+     * missing or damaged, the state is then empty.
+     */
+    bool load();
+
+    /**
+     * @brief Writes the state to the file, replacing it atomically.
+     * @return True if written.
+     */
+    bool save();
+
+    /**
+     * @brief Empties the state and removes the file.
+     */
+    void clear();
+
+    /**
+     * @brief Returns true if the state holds a registration.
+     */
+    bool is_registered() const;
+
+    /**
+     * @brief Checks whether the stored registration can be resumed.
+     * @param endpoint_name, Endpoint name of the client.
+     * @param server_uri, URI of the LWM2M server.
+     * @param now, Current time in seconds since the epoch.
+     * @return True if the registration belongs to the endpoint and
+     * server and its lifetime hasn't run out.
+     */
+    bool can_resume(const char *endpoint_name, const char *server_uri, uint32_t now) const;
+
+    /**
+     * @brief Records a successful registration.
+     * @param endpoint_name, Endpoint name of the client.
+     * @param server_uri, URI of the LWM2M server.
+     * @param location, Registration location returned by the server.
+     * @param location_length, Length of the location.
+     * @param lifetime, Registration lifetime in seconds.
+     * @param now, Current time in seconds since the epoch.
+     * @return True if recorded, false if a parameter is too long.
+     */
+    bool set_registration(const char *endpoint_name,
+                          const char *server_uri,
+                          const uint8_t *location,
+                          uint8_t location_length,
+                          uint32_t lifetime,
+                          uint32_t now);
+
+    /**
+     * @brief Records a successful registration update.
+     * @param lifetime, New lifetime in seconds, 0 keeps the old one.
+     * @param now, Current time in seconds since the epoch.
+     */
+    void registration_updated(uint32_t lifetime, uint32_t now);
+
+    /**
+     * @brief Returns the registration location.
+     * @param length[OUT], Length of the location.
+     * @return Location, NULL if not registered.
+     */
+    const uint8_t* location(uint8_t &length) const;
+
+    /**
+     * @brief Returns the registration lifetime in seconds.
+     */
+    uint32_t lifetime() const;
+
+    /**
+     * @brief Returns the time of the last registration or update.
+     */
+    uint32_t registered_at() const;
+
+    /**
+     * @brief Records the resolved address of the server.
+     * @param address, Address, 4 bytes for IPv4 and 16 for IPv6.
+     * @param length, Length of the address.
+     * @param port, Server port.
+     */
+    void set_server_address(const uint8_t *address, uint8_t length, uint16_t port);
+
+    /**
+     * @brief Returns the resolved address of the server.
+     * @param length[OUT], Length of the address, 0 if none.
+     * @param port[OUT], Server port.
+     * @return Address, NULL if none.
+     */
+    const uint8_t* server_address(uint8_t &length, uint16_t &port) const;
+
+    /**
+     * @brief Records the DTLS session with the server.
+     * @param session, Serialized session, copied. NULL removes it.
+     * @param length, Length of the session.
+     * @return True if recorded, false if too long or out of memory.
+     */
+    bool set_dtls_session(const uint8_t *session, uint16_t length);
+
+    /**
+     * @brief Returns the DTLS session with the server.
+     * @param length[OUT], Length of the session.
+     * @return Serialized session, NULL if none.
+     */
+    const uint8_t* dtls_session(uint16_t &length) const;
+
+private:
+
+    void release_session();
+
+    bool serialize(uint8_t *buffer, uint32_t &length) const;
+
+    bool parse(const uint8_t *buffer, uint32_t length);
+
+    // Prevents the use of assignment operator.
+    M2MRegistrationStore& operator=( const M2MRegistrationStore& /*other*/ );
+
+    // Prevents the use of copy constructor
+    M2MRegistrationStore( const M2MRegistrationStore& /*other*/ );
+
+private:
+
+    char           *_path;
+    char            _endpoint_name[MAX_NAME_LENGTH + 1];
+    char            _server_uri[MAX_URI_LENGTH + 1];
+    uint8_t         _location[MAX_LOCATION_LENGTH];
+    uint8_t         _location_length;       // 0 when not registered.
+    uint32_t        _lifetime;
+    uint32_t        _registered_at;
+    uint8_t         _address[16];
+    uint8_t         _address_length;
+    uint16_t        _port;
+    uint8_t        *_session;
+    uint16_t        _session_length;
+
+friend class Test_M2MRegistrationStore;
+};
+
+#endif // M2M_REGISTRATION_STORE_H
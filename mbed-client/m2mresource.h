@@ -75,6 +75,14 @@ private: // Constructor and destructor are private
     // Prevents the use of copy constructor
     M2MResource( const M2MResource& /*other*/ );
 
+    /**
+     * @brief Copies the resource into another object instance.
+     * @param other, Resource to be copied.
+     * @param object_instance_callback, Object instance owning the copy.
+     */
+    M2MResource(const M2MResource &other,
+                M2MObjectInstanceCallback &object_instance_callback);
+
     /**
      * Destructor
      */
@@ -142,6 +150,23 @@ public:
      */
     virtual void remove_observation_level(M2MBase::Observation observation_level);
 
+    /**
+     * @brief Returns the memory held by the resource and its resource
+     * instances, computed from their values and observation state.
+     * @return Memory statistics of the resource.
+     */
+    virtual M2MMemoryStats memory_stats() const;
+
+protected:
+
+    /**
+     * @brief Adds the memory held by the resource and its resource
+     * instances to the memory statistics of the object instance, or
+     * removes it from them.
+     * @param attached, True when the resource is added to the object
+     * instance, false when it is removed.
+     */
+    virtual void set_memory_attached(bool attached);
 
 private:
 
@@ -22,6 +22,14 @@
 class M2MObjectInstanceCallback {
 public:
     virtual void notification_update(M2MBase::Observation observation_level) = 0;
+
+    /**
+     * @brief Passes a change in the memory held by a resource to the
+     * memory statistics of its object instance.
+     * @param category, Category of the memory.
+     * @param delta, Number of bytes allocated (positive) or released (negative).
+     */
+    virtual void memory_updated(M2MMemoryStats::Category category, int32_t delta) = 0;
 };
 
 /**
@@ -91,6 +99,14 @@ private: // Constructor and destructor are private
     // Prevents the use of copy constructor
     M2MResourceInstance( const M2MResourceInstance& /*other*/ );
 
+    /**
+     * @brief Copies the resource instance into another object instance.
+     * @param other, Resource instance to be copied.
+     * @param object_instance_callback, Object instance owning the copy.
+     */
+    M2MResourceInstance(const M2MResourceInstance &other,
+                        M2MObjectInstanceCallback &object_instance_callback);
+
     /**
      * Destructor
      */
@@ -193,12 +209,52 @@ public:
                                                sn_coap_hdr_s *received_coap_header,
                                                M2MObservationHandler *observation_handler = NULL);
 
+    /**
+     * @brief Returns the memory held by the resource instance, computed
+     * from its value and observation state.
+     * @return Memory statistics of the resource instance.
+     */
+    virtual M2MMemoryStats memory_stats() const;
+
+protected:
+
+    /**
+     * @brief Passes a change in the memory held by the resource instance
+     * to its object instance.
+     * @param category, Category of the memory.
+     * @param delta, Number of bytes allocated (positive) or released (negative).
+     */
+    virtual void update_owner_memory_stats(M2MMemoryStats::Category category, int32_t delta);
+
 private:
 
+    /**
+     * @brief Copies the value into the value buffer, reusing the
+     * current buffer if the value fits in it.
+     * @param value, Pointer to the value to be stored.
+     * @param value_length, Length of the value pointer.
+     * @return True if successfully stored else false.
+     */
+    bool store_value(const uint8_t *value, const uint32_t value_length);
+
+    /**
+     * @brief Releases the value buffer.
+     */
+    void free_value();
+
+private:
+
+    // Values up to this size are stored inside the instance itself.
+    enum {
+        INLINE_VALUE_SIZE = 16
+    };
+
     M2MObjectInstanceCallback               &_object_instance_callback;
     execute_callback                        _execute_callback;
     uint8_t                                 *_value;
     uint32_t                                _value_length;
+    uint32_t                                _value_capacity;
+    uint8_t                                 _inline_value[INLINE_VALUE_SIZE + 1];
     ResourceType                            _resource_type;
 
     friend class Test_M2MResourceInstance;
@@ -211,6 +267,7 @@ private:
     friend class Test_M2MNsdlInterface;
     friend class Test_M2MTLVSerializer;
     friend class Test_M2MTLVDeserializer;
+    friend class Test_M2MCommandQueue;
 };
 
 #endif // M2M_RESOURCE_INSTANCE_H
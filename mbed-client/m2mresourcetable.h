@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_RESOURCE_TABLE_H
+#define M2M_RESOURCE_TABLE_H
+
+#include "mbed-client/m2mobject.h"
+
+/**
+ *  @brief M2MResourceTable.
+ *  Compact alternative to the object tree for objects exposing a large number
+ *  of homogeneous instances. Instead of allocating an object instance and a
+ *  resource node per entry, the resources are stored as rows of contiguous
+ *  columns (instance id, resource id, type, operation, value offset) sorted by
+ *  instance and resource id, and all the values live in one shared value heap.
+ *  The table is registered like any other object; the NSDL interface and the
+ *  TLV serializer recognize it from its base type. Resources in a table can
+ *  be read and written, but they cannot be observed or executed and they
+ *  support only a single instance each.
+ *  A table can also be created read-only on top of a constant array of
+ *  resource definitions. The definitions and the values they point to are
+ *  referenced directly, so such a table costs no heap per resource and
+ *  nothing is copied at start-up or at registration.
+ */
+class M2MResourceTable : public M2MObject
+{
+
+friend class M2MInterfaceFactory;
+
+public:
+
+    /**
+     * @brief Definition of a read-only resource, intended to be placed
+     * in a constant array. The array must be sorted by instance ID and
+     * resource ID and must outlive the table.
+     */
+    typedef struct {
+        uint16_t                            instance_id;
+        uint16_t                            resource_id;
+        M2MResourceInstance::ResourceType   type;
+        const uint8_t                      *value;
+        uint16_t                            value_length;
+    } ConstResource;
+
+private:
+
+    /**
+     * @brief Constructor
+     * @param name, name of the object
+     */
+    M2MResourceTable(const String &object_name);
+
+    /**
+     * @brief Constructor for a read-only table.
+     * @param name, name of the object
+     * @param resources, Sorted resource definitions, referenced not copied.
+     * @param count, Number of resource definitions.
+     */
+    M2MResourceTable(const String &object_name,
+                     const M2MResourceTable::ConstResource *resources,
+                     uint16_t count);
+
+    // Prevents the use of default constructor.
+    M2MResourceTable();
+
+    // Prevents the use of assignment operator.
+    M2MResourceTable& operator=( const M2MResourceTable& /*other*/ );
+
+    // Prevents the use of copy constructor
+    M2MResourceTable( const M2MResourceTable& /*other*/ );
+
+public:
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~M2MResourceTable();
+
+    /**
+     * @brief Adds a resource row to the table.
+     * @param instance_id, Object instance ID of the resource.
+     * @param resource_id, Resource ID.
+     * @param type, Type of the resource value.
+     * @param operation, Operations allowed on the resource, GET and PUT are supported.
+     * @param value, Initial value of the resource, can be NULL.
+     * @param value_length, Length of the initial value.
+     * @return True if added, false if the row already exists, the table is
+     * read-only or memory ran out.
+     */
+    bool add_resource(uint16_t instance_id,
+                      uint16_t resource_id,
+                      M2MResourceInstance::ResourceType type,
+                      M2MBase::Operation operation,
+                      const uint8_t *value = NULL,
+                      const uint32_t value_length = 0);
+
+    /**
+     * @brief Sets the value of an existing resource row. The value is
+     * updated in place when it fits in the space already reserved for it.
+     * @param instance_id, Object instance ID of the resource.
+     * @param resource_id, Resource ID.
+     * @param value, New value of the resource.
+     * @param value_length, Length of the new value.
+     * @return True if set, false if the row doesn't exist, the table is
+     * read-only or memory ran out.
+     */
+    bool set_resource_value(uint16_t instance_id,
+                            uint16_t resource_id,
+                            const uint8_t *value,
+                            const uint32_t value_length);
+
+    /**
+     * @brief Returns the value of a resource row. The pointer refers to
+     * the value heap and stays valid until the table is next modified.
+     * @param instance_id, Object instance ID of the resource.
+     * @param resource_id, Resource ID.
+     * @param value_length[OUT], Length of the value.
+     * @return Pointer to the value, NULL if the row doesn't exist.
+     */
+    const uint8_t* resource_value(uint16_t instance_id,
+                                  uint16_t resource_id,
+                                  uint32_t &value_length) const;
+
+    /**
+     * @brief Returns the row index of the given resource.
+     * @param instance_id, Object instance ID of the resource.
+     * @param resource_id, Resource ID.
+     * @return Row index, -1 if not found.
+     */
+    int32_t find_row(uint16_t instance_id, uint16_t resource_id) const;
+
+    /**
+     * @brief Returns the rows belonging to the given object instance.
+     * @param instance_id, Object instance ID.
+     * @param first_row[OUT], Index of the first row of the instance.
+     * @return Number of rows of the instance, 0 if the instance doesn't exist.
+     */
+    uint32_t instance_rows(uint16_t instance_id, uint32_t &first_row) const;
+
+    /**
+     * @brief Returns the number of rows in the table.
+     * @return Number of rows.
+     */
+    uint32_t row_count() const;
+
+    /**
+     * @brief Returns the object instance ID of the given row.
+     */
+    uint16_t row_instance_id(uint32_t row) const;
+
+    /**
+     * @brief Returns the resource ID of the given row.
+     */
+    uint16_t row_resource_id(uint32_t row) const;
+
+    /**
+     * @brief Returns the value type of the given row.
+     */
+    M2MResourceInstance::ResourceType row_type(uint32_t row) const;
+
+    /**
+     * @brief Returns the operations allowed on the given row.
+     */
+    M2MBase::Operation row_operation(uint32_t row) const;
+
+    /**
+     * @brief Returns the value of the given row.
+     * @param row, Row index.
+     * @param value_length[OUT], Length of the value.
+     * @return Pointer to the value in the value heap.
+     */
+    const uint8_t* row_value(uint32_t row, uint32_t &value_length) const;
+
+    /**
+     * @brief Handles GET request for the registered objects.
+     * The request path selects the whole table, one object instance
+     * or a single resource.
+     * @param nsdl, NSDL handler for the Coap library.
+     * @param received_coap_header, Received CoAP message from the server.
+     * @param observation_handler, Handler object for sending
+     * observation callbacks.
+     * @return sn_coap_hdr_s,  Message that needs to be sent to server.
+     */
+    virtual sn_coap_hdr_s* handle_get_request(nsdl_s *nsdl,
+                                              sn_coap_hdr_s *received_coap_header,
+                                              M2MObservationHandler *observation_handler = NULL);
+
+    /**
+     * @brief Handles PUT request for the registered objects.
+     * Only single resources in the table can be written.
+     * @param nsdl, NSDL handler for the Coap library.
+     * @param received_coap_header, Received CoAP message from the server.
+     * @param observation_handler, Handler object for sending
+     * observation callbacks.
+     * @return sn_coap_hdr_s,  Message that needs to be sent to server.
+     */
+    virtual sn_coap_hdr_s* handle_put_request(nsdl_s *nsdl,
+                                              sn_coap_hdr_s *received_coap_header,
+                                              M2MObservationHandler *observation_handler = NULL);
+
+    /**
+     * @brief Handles POST request for the registered objects.
+     * Tables can't create instances or execute resources, so the
+     * request is always rejected.
+     * @param nsdl, NSDL handler for the Coap library.
+     * @param received_coap_header, Received CoAP message from the server.
+     * @param observation_handler, Handler object for sending
+     * observation callbacks.
+     * @return sn_coap_hdr_s,  Message that needs to be sent to server.
+     */
+    virtual sn_coap_hdr_s* handle_post_request(nsdl_s *nsdl,
+                                               sn_coap_hdr_s *received_coap_header,
+                                               M2MObservationHandler *observation_handler = NULL);
+
+private:
+
+    uint32_t lower_bound(uint32_t key) const;
+
+    uint32_t row_key(uint32_t row) const;
+
+    bool reserve_rows(uint32_t capacity);
+
+    bool store_value(uint32_t row, const uint8_t *value, uint32_t value_length);
+
+    bool compact_value_heap(uint32_t extra);
+
+    bool parse_path(sn_coap_hdr_s *coap_header,
+                    int32_t &instance_id,
+                    int32_t &resource_id) const;
+
+    void update_table_memory_stats();
+
+private:
+
+    uint32_t                    *_keys;             // (instance id << 16) | resource id, sorted.
+    uint8_t                     *_types;
+    uint8_t                     *_operations;
+    uint32_t                    *_value_offsets;
+    uint16_t                    *_value_lengths;
+    uint16_t                    *_value_capacities;
+    uint32_t                     _row_count;
+    uint32_t                     _row_capacity;
+    uint8_t                     *_value_heap;
+    uint32_t                     _heap_size;
+    uint32_t                     _heap_capacity;
+    uint32_t                     _heap_garbage;     // Bytes left behind by relocated values.
+    M2MMemoryStats               _table_memory;     // Table memory already accounted in the stats.
+    const ConstResource         *_const_resources;  // Rows of a read-only table, not owned.
+
+friend class Test_M2MResourceTable;
+friend class Test_M2MNsdlInterface;
+friend class Test_M2MTLVSerializer;
+};
+
+#endif // M2M_RESOURCE_TABLE_H
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_STRING_POOL_H
+#define M2M_STRING_POOL_H
+
+#include <stdint.h>
+#include "mbed-client/m2mconfig.h"
+
+/**
+ * @brief M2MStringPool.
+ * Shared, reference counted storage for the names and descriptive
+ * attributes of the object model (resource type and interface description).
+ * Only a handful of distinct values exist even in large models, since
+ * instance and resource names are mostly short numeric ids, so every node
+ * keeps a small handle instead of its own String and all nodes with the
+ * same value share one copy of it. Handle 0 always refers to the empty
+ * string and needs no reference counting. All the functions can be called
+ * from any thread.
+ */
+class M2MStringPool {
+
+public:
+
+    typedef uint16_t Handle;
+
+    /**
+     * Handle of the empty string.
+     */
+    static const Handle EMPTY = 0;
+
+    /**
+     * @brief Returns a handle to the given value, adding it to the
+     * pool if it is not there yet. Every acquired handle must be
+     * released with release().
+     * @param value, Value to be interned.
+     * @return Handle of the value, EMPTY for an empty value or if
+     * memory ran out.
+     */
+    static Handle acquire(const String &value);
+
+    /**
+     * @brief Takes one more reference to an already acquired handle.
+     * @param handle, Handle to be referenced.
+     * @return The same handle.
+     */
+    static Handle acquire(Handle handle);
+
+    /**
+     * @brief Releases one reference to the handle. The value is removed
+     * from the pool when its last reference is released.
+     * @param handle, Handle to be released.
+     */
+    static void release(Handle handle);
+
+    /**
+     * @brief Takes a reference to the value for a holder which keeps only
+     * its bytes, such as the NSDL library. The reference is dropped with
+     * release_bytes().
+     * @param value, Value to be interned.
+     * @return NUL terminated bytes of the interned value, NULL for an
+     * empty value or if memory ran out.
+     */
+    static const char* acquire_bytes(const String &value);
+
+    /**
+     * @brief Releases a reference taken with acquire_bytes().
+     * @param bytes, Bytes of an interned value, or any other pointer.
+     * @return True if the bytes belong to the pool and were released,
+     * false if the caller still owns them.
+     */
+    static bool release_bytes(const void *bytes);
+
+    /**
+     * @brief Returns the value of the handle. The reference stays valid
+     * as long as the handle is held.
+     * @param handle, Handle of the value.
+     * @return Interned value.
+     */
+    static const String& string(Handle handle);
+
+    /**
+     * @brief Returns the number of distinct values in the pool.
+     * @return Number of values.
+     */
+    static uint16_t size();
+
+    /**
+     * @brief Returns the heap memory held by the pool.
+     * @return Size in bytes.
+     */
+    static uint32_t memory();
+
+private:
+
+    // Pool is used only through its static interface.
+    M2MStringPool();
+
+    static Handle add(const String &value);
+
+    static void remove(Handle handle);
+
+    typedef struct {
+        String          value;
+        uint32_t        references;
+    } Entry;
+
+    static Entry        **_entries;
+    static uint16_t       _size;
+    static uint16_t       _capacity;
+
+friend class Test_M2MStringPool;
+};
+
+#endif // M2M_STRING_POOL_H
@@ -80,6 +80,32 @@ public:
      */
     bool is_total_interval_passed();
 
+    /**
+     * @brief Chooses how the timers of the process are driven. Polled
+     * timers run no threads of their own, the application calls poll()
+     * from its event loop instead, waiting at most until next_expiry()
+     * in between. The setting applies to every timer of the process, so
+     * call this once before any client is created. On Linux the timers
+     * run on the shared M2MTimingWheel, elsewhere they can't be polled
+     * and this has no effect, unless the platform implements polling
+     * itself, see M2M_PLATFORM_TIMER_POLL.
+     * @param polled True to poll the timers, false to let the platform drive them.
+     */
+    static void set_polled(bool polled);
+
+    /**
+     * @brief Returns when poll() needs to be called next.
+     * @param time[OUT] Time in milliseconds of the monotonic clock.
+     * @return False if the timers are not polled or none is pending.
+     */
+    static bool next_expiry(uint64_t &time);
+
+    /**
+     * @brief Runs the polled timers due by the given time.
+     * @param time Current time in milliseconds of the monotonic clock.
+     */
+    static void poll(uint64_t time);
+
 private:
 
     M2MTimerObserver&   _observer;
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_TIMING_WHEEL_H
+#define M2M_TIMING_WHEEL_H
+
+#ifdef __linux__
+
+#include <stdint.h>
+#include <pthread.h>
+#include "mbed-client/m2mtimerobserver.h"
+
+/**
+ *  @brief M2MTimingWheel.
+ *  Hierarchical timing wheel backing any number of timers for the Linux
+ *  platform. A timer is a node embedded in its owner, for example in
+ *  M2MTimerPimpl, so starting and stopping one takes constant time and no
+ *  allocation. The wheel has LEVELS levels of SLOTS slots each; a timer
+ *  goes to the level matching how far away it expires and moves down a
+ *  level when the wheel turns past it. All the timers expired by one
+ *  advance of the wheel are dispatched as one batch, each to its
+ *  M2MTimerObserver.
+ *  The wheel is driven either by its own thread, started with start(), or
+ *  by calling poll() from an existing event loop, waiting at most until
+ *  next_expiry() in between. Time is in milliseconds of the monotonic
+ *  clock, see now().
+ */
+class M2MTimingWheel {
+
+public:
+
+    /**
+     * Timer node, owned by the caller. Set the observer and the type,
+     * the other fields belong to the wheel. A timer must be stopped
+     * before it is freed.
+     */
+    struct Timer {
+        M2MTimerObserver        *observer;
+        M2MTimerObserver::Type  type;
+        uint64_t                expires;    // Tick to expire at.
+        uint64_t                period;     // Ticks between expirations, 0 for single shot.
+        Timer                   *next;
+        Timer                   **pprev;    // Link pointing to this timer, NULL if not pending.
+        bool                    due;        // Expired, waiting for dispatch.
+    };
+
+    static const uint8_t LEVELS = 4;
+    static const uint8_t SLOT_BITS = 6;
+    static const uint16_t SLOTS = 1 << SLOT_BITS;
+    static const uint32_t DEFAULT_TICK = 10;
+
+    /**
+     * @brief Returns the process-wide wheel, created with DEFAULT_TICK
+     * on first use and started with its own thread unless polled, see
+     * set_shared_polled().
+     */
+    static M2MTimingWheel* shared();
+
+    /**
+     * @brief Chooses how the process-wide wheel is driven. When polled,
+     * the wheel starts no thread and the application calls poll() from
+     * its own event loop. Must not be called from a timer callback.
+     * @param polled, True to poll the wheel, false for its own thread.
+     */
+    static void set_shared_polled(bool polled);
+
+    /**
+     * @brief Returns whether the process-wide wheel is polled.
+     */
+    static bool shared_polled();
+
+    /**
+     * @brief Returns the current time of the monotonic clock.
+     * @return Time in milliseconds.
+     */
+    static uint64_t now();
+
+    /**
+     * @brief Initializes a timer node.
+     * @param timer, Timer to initialize.
+     * @param observer, Observer notified when the timer expires.
+     * @param type, Type passed to the observer.
+     */
+    static void init_timer(Timer *timer,
+                           M2MTimerObserver &observer,
+                           M2MTimerObserver::Type type = M2MTimerObserver::Notdefined);
+
+    /**
+     * @brief Constructor
+     * @param tick, Resolution of the wheel in milliseconds, timers
+     * expire at most one tick late.
+     */
+    M2MTimingWheel(uint32_t tick = DEFAULT_TICK);
+
+    /**
+     * @brief Destructor, stops the thread. Pending timers are dropped.
+     */
+    ~M2MTimingWheel();
+
+    /**
+     * @brief Starts the thread driving the wheel.
+     * @return True if running, else false.
+     */
+    bool start();
+
+    /**
+     * @brief Stops the thread and waits for it to exit.
+     * Must not be called from a timer callback.
+     */
+    void stop();
+
+    /**
+     * @brief Starts or restarts a timer. Restarting a timer which has
+     * expired but not been dispatched yet drops that expiration.
+     * @param timer, Initialized timer.
+     * @param interval, Interval in milliseconds.
+     * @param single_shot, True to expire once, false to repeat.
+     * @param time, Current time, see now().
+     */
+    void start_timer(Timer *timer, uint64_t interval, bool single_shot, uint64_t time);
+
+    /**
+     * @brief Stops a timer. Once this returns the observer of the timer
+     * is not running and won't be called, also when called from another
+     * thread. Can be called from a timer callback.
+     * @param timer, Timer to stop, can be stopped already.
+     */
+    void stop_timer(Timer *timer);
+
+    /**
+     * @brief Returns whether a timer is pending.
+     */
+    bool is_pending(const Timer *timer) const;
+
+    /**
+     * @brief Turns the wheel up to the given time and dispatches the
+     * expired timers.
+     * @param time, Current time, see now().
+     * @return Number of timers dispatched.
+     */
+    uint32_t poll(uint64_t time);
+
+    /**
+     * @brief Returns when poll() needs to be called next. This can be
+     * earlier than the next expiration, when the timers of an upper
+     * level move down.
+     * @param time[OUT], Time of the next poll.
+     * @return False if no timer is pending.
+     */
+    bool next_expiry(uint64_t &time) const;
+
+    /**
+     * @brief Returns the number of pending timers.
+     */
+    uint32_t pending() const;
+
+private:
+
+    void add(Timer *timer);
+
+    void remove(Timer *timer);
+
+    void advance(uint64_t target);
+
+    void cascade(uint8_t level, uint32_t slot);
+
+    uint64_t next_tick() const;
+
+    static void link(Timer **head, Timer *timer);
+
+    static void unlink(Timer *timer);
+
+    static void* wheel_thread(void *argument);
+
+    void run();
+
+    static void create_shared();
+
+    // Prevents the use of assignment operator.
+    M2MTimingWheel& operator=( const M2MTimingWheel& /*other*/ );
+
+    // Prevents the use of copy constructor
+    M2MTimingWheel( const M2MTimingWheel& /*other*/ );
+
+private:
+
+    Timer                       *_slots[LEVELS][SLOTS];
+    Timer                       *_expired;          // Expired timers waiting for dispatch.
+    Timer                       **_expired_tail;
+    uint32_t                    _tick;
+    uint64_t                    _current;           // Next tick to process.
+    uint32_t                    _count;             // Timers in the slots.
+    Timer                       *_running;          // Timer whose observer is being called.
+    pthread_t                   _dispatch_thread;
+    bool                        _dispatching;
+    uint64_t                    _wake_tick;         // Tick the thread sleeps until.
+    bool                        _thread_running;
+    bool                        _thread_started;
+    pthread_t                   _thread;
+    mutable pthread_mutex_t     _mutex;
+    pthread_cond_t              _wake_cond;         // Wakes the thread.
+    pthread_cond_t              _dispatch_cond;     // Signals the end of a callback.
+
+    static M2MTimingWheel       *_shared;
+    static bool                 _shared_polled;
+    static pthread_once_t       _shared_once;
+
+friend class Test_M2MTimingWheel;
+};
+
+#endif // __linux__
+
+#endif // M2M_TIMING_WHEEL_H
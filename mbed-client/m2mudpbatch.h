@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_UDP_BATCH_H
+#define M2M_UDP_BATCH_H
+
+#ifdef __linux__
+
+#include <stdint.h>
+#include <sys/socket.h>
+
+/**
+ *  @brief M2MUdpBatch.
+ *  Batches datagram I/O on a UDP socket for the Linux connection handler.
+ *  Outbound datagrams are copied into preallocated slots while the event
+ *  loop runs and sent with a single sendmmsg() when the loop turn ends,
+ *  inbound datagrams are drained with recvmmsg() into the buffers the
+ *  caller provides, usually the receive buffers lent by the connection
+ *  observer. The counters show the batch sizes achieved.
+ */
+class M2MUdpBatch {
+
+public:
+
+    static const uint8_t MAX_BATCH = 16;
+
+    /**
+     * @brief Batching counters.
+     */
+    typedef struct {
+        uint32_t    send_calls;             // sendmmsg() calls made.
+        uint32_t    datagrams_sent;
+        uint32_t    largest_send_batch;
+        uint32_t    send_errors;            // Datagrams dropped on a socket error.
+        uint32_t    receive_calls;          // recvmmsg() calls returning data.
+        uint32_t    datagrams_received;
+        uint32_t    largest_receive_batch;
+    } Stats;
+
+    /**
+     * @brief Constructor
+     * @param socket, UDP socket, not owned. Should be non-blocking.
+     * @param datagram_size, Maximum size of an outbound datagram.
+     */
+    M2MUdpBatch(int socket, uint16_t datagram_size);
+
+    /**
+     * @brief Destructor, queued datagrams are discarded.
+     */
+    ~M2MUdpBatch();
+
+    /**
+     * @brief Queues a datagram to be sent with the next flush(). The batch
+     * is flushed first if it is full.
+     * @param data, Datagram to send, copied.
+     * @param length, Length of the datagram.
+     * @param address, Destination address.
+     * @param address_length, Length of the destination address.
+     * @return True if queued, false if too large or the batch is full and
+     * the socket can't take more data.
+     */
+    bool queue(const uint8_t *data,
+               uint16_t length,
+               const struct sockaddr *address,
+               socklen_t address_length);
+
+    /**
+     * @brief Sends the queued datagrams. Datagrams the socket can't take
+     * yet stay queued for the next call.
+     * @return Number of datagrams sent, -1 if a datagram was dropped
+     * on a socket error.
+     */
+    int flush();
+
+    /**
+     * @brief Returns the number of queued datagrams.
+     */
+    uint8_t pending() const;
+
+    /**
+     * @brief Receives the datagrams waiting in the socket.
+     * @param buffers, Buffers to receive into, one datagram each.
+     * @param count, Number of buffers, at most MAX_BATCH are used.
+     * @param buffer_size, Size of each buffer.
+     * @return Number of datagrams received, 0 if none are waiting,
+     * -1 on a socket error.
+     */
+    int receive(uint8_t *const *buffers, uint8_t count, uint16_t buffer_size);
+
+    /**
+     * @brief Returns the length of a datagram from the last receive().
+     * @param index, Index of the datagram.
+     */
+    uint16_t received_length(uint8_t index) const;
+
+    /**
+     * @brief Returns the source address of a datagram from the last receive().
+     * @param index, Index of the datagram.
+     * @param address_length[OUT], Length of the address.
+     */
+    const struct sockaddr* received_address(uint8_t index,
+                                            socklen_t &address_length) const;
+
+    /**
+     * @brief Returns the batching counters.
+     */
+    const M2MUdpBatch::Stats& stats() const;
+
+private:
+
+    // Prevents the use of assignment operator.
+    M2MUdpBatch& operator=( const M2MUdpBatch& /*other*/ );
+
+    // Prevents the use of copy constructor
+    M2MUdpBatch( const M2MUdpBatch& /*other*/ );
+
+private:
+
+    int                         _socket;
+    uint16_t                    _datagram_size;
+    uint8_t                     *_send_data;        // MAX_BATCH slots of _datagram_size.
+    struct mmsghdr              *_send_headers;
+    struct iovec                *_send_iovecs;
+    struct sockaddr_storage     *_send_addresses;
+    uint8_t                     _send_head;         // First datagram not sent yet.
+    uint8_t                     _send_count;
+    struct mmsghdr              *_receive_headers;
+    struct iovec                *_receive_iovecs;
+    struct sockaddr_storage     *_receive_addresses;
+    Stats                       _stats;
+
+friend class Test_M2MUdpBatch;
+};
+
+#endif // __linux__
+
+#endif // M2M_UDP_BATCH_H
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_WORKER_POOL_H
+#define M2M_WORKER_POOL_H
+
+#ifdef __linux__
+
+#include <stdint.h>
+#include <pthread.h>
+#include "mbed-client/m2mreactor.h"
+
+/**
+ * @brief M2MWorkerJob.
+ * Work offloaded to an M2MWorkerPool, for example the public key
+ * operation of a DTLS handshake.
+ */
+class M2MWorkerJob {
+
+public:
+
+    virtual ~M2MWorkerJob() {}
+
+    /**
+     * @brief Does the work, called from a worker thread.
+     */
+    virtual void run() = 0;
+
+    /**
+     * @brief Indicates the work is done, called from the reactor thread
+     * so the result can be handed to the client without locking.
+     */
+    virtual void completed() = 0;
+};
+
+/**
+ *  @brief M2MWorkerPool.
+ *  Runs expensive jobs, such as the certificate and key exchange steps of
+ *  a DTLS handshake, on a small set of worker threads so that they don't
+ *  stall the reactor loop serving the other clients of the process.
+ *  Completions are reported through an eventfd on the reactor, so
+ *  completed() runs on the reactor thread like the socket and timer
+ *  callbacks of the client.
+ */
+class M2MWorkerPool : public M2MReactorHandler {
+
+public:
+
+    static const uint8_t MAX_WORKERS = 8;
+    static const uint8_t MAX_JOBS = 64;
+
+    /**
+     * @brief Constructor
+     * @param reactor, Reactor the completions are reported on.
+     * @param workers, Number of worker threads, 1 - MAX_WORKERS.
+     */
+    M2MWorkerPool(M2MReactor &reactor, uint8_t workers);
+
+    /**
+     * @brief Destructor, stops the workers. Jobs that haven't completed
+     * are dropped without calling completed().
+     */
+    virtual ~M2MWorkerPool();
+
+    /**
+     * @brief Starts the worker threads.
+     * @return True if running, else false.
+     */
+    bool start();
+
+    /**
+     * @brief Stops the worker threads and waits for the running jobs.
+     * Must not be called from a job.
+     */
+    void stop();
+
+    /**
+     * @brief Queues a job. The job must stay valid until completed() is
+     * called or cancel() returns.
+     * @param job, Job to run.
+     * @return True if queued, false if the pool is not running or full,
+     * in which case the caller should do the work itself.
+     */
+    bool submit(M2MWorkerJob *job);
+
+    /**
+     * @brief Cancels a job. A queued job is dropped, a running one is
+     * waited for, and in both cases completed() won't be called. Must not
+     * be called from the job's run().
+     * @param job, Job to cancel.
+     * @return True if the job was dropped, false if it wasn't pending,
+     * completed() has then already been called or is being called.
+     */
+    bool cancel(M2MWorkerJob *job);
+
+    /**
+     * @brief Returns the number of jobs queued, running or waiting for
+     * completion.
+     */
+    uint8_t pending() const;
+
+    /**
+     * @brief From M2MReactorHandler.
+     */
+    virtual void io_ready(int fd, uint32_t events);
+
+private:
+
+    typedef enum {
+        Free,
+        Queued,
+        Running,
+        Cancelling,         // Running, cancel() waits for it.
+        Done
+    } State;
+
+    typedef struct {
+        M2MWorkerJob        *job;
+        State               state;
+        uint32_t            sequence;       // Submission order.
+    } Slot;
+
+    static void* worker_thread(void *argument);
+
+    void run_worker();
+
+    int oldest(State state) const;
+
+    // Prevents the use of assignment operator.
+    M2MWorkerPool& operator=( const M2MWorkerPool& /*other*/ );
+
+    // Prevents the use of copy constructor
+    M2MWorkerPool( const M2MWorkerPool& /*other*/ );
+
+private:
+
+    M2MReactor                  &_reactor;
+    Slot                        _slots[MAX_JOBS];
+    pthread_t                   _threads[MAX_WORKERS];
+    uint8_t                     _worker_count;
+    uint8_t                     _threads_started;
+    bool                        _running;
+    uint32_t                    _sequence;
+    int                         _event_fd;
+    mutable pthread_mutex_t     _mutex;
+    pthread_cond_t              _work_available;
+    pthread_cond_t              _job_finished;
+
+friend class Test_M2MWorkerPool;
+};
+
+#endif // __linux__
+
+#endif // M2M_WORKER_POOL_H
@@ -25,6 +25,7 @@ class M2MObject;
 typedef Vector<M2MObject *> M2MObjectList;
 
 class M2MSecurity;
+class M2MServer;
 
 class EventData
 {
@@ -45,11 +46,15 @@ class ResolvedAddressData : public EventData
 {
 public:
     ResolvedAddressData()
-    :_address(NULL),
-    _port(0){}
+    :_port(0){
+        _address._address = _address_data;
+        _address._length = 0;
+        _address._port = 0;
+    }
     ~ResolvedAddressData() {}
-    const M2MConnectionObserver::SocketAddress    *_address;
-    uint16_t                                       _port;
+    M2MConnectionObserver::SocketAddress            _address;   // Points to _address_data.
+    uint8_t                                         _address_data[16];
+    uint16_t                                        _port;
 };
 
 class ReceivedData : public EventData
@@ -58,13 +63,17 @@ public:
     ReceivedData()
     :_data(NULL),
     _size(0),
-    _port(0),
-    _address(NULL){}
+    _port(0){
+        _address._address = _address_data;
+        _address._length = 0;
+        _address._port = 0;
+    }
     ~ReceivedData() {}
-    uint8_t                                         *_data;
+    uint8_t                                         *_data;     // Receive buffer, owned until processed.
     uint16_t                                        _size;
     uint16_t                                        _port;
-    const M2MConnectionObserver::SocketAddress      *_address;
+    M2MConnectionObserver::SocketAddress            _address;   // Points to _address_data.
+    uint8_t                                         _address_data[16];
 };
 
 class M2MRegisterData : public EventData
@@ -88,6 +97,39 @@ public:
     uint32_t        _lifetime;
 };
 
+class NotificationData : public EventData
+{
+public:
+    NotificationData()
+    :_type(0),
+    _error(0),
+    _security(NULL),
+    _server(NULL){}
+    ~NotificationData() {}
+    uint8_t             _type;
+    uint8_t             _error;
+    M2MSecurity        *_security;
+    const M2MServer    *_server;
+};
+
+/**
+ * Preallocated slot for the data of a queued interface event. The slot holds
+ * storage for every kind of event data, so queuing an event never allocates.
+ */
+class EventSlot
+{
+public:
+    EventSlot()
+    :_in_use(false){}
+    ~EventSlot() {}
+    bool                    _in_use;
+    M2MSecurityData         _security_data;
+    ResolvedAddressData     _resolved_address_data;
+    ReceivedData            _received_data;
+    M2MRegisterData         _register_data;
+    M2MUpdateRegisterData   _update_register_data;
+    NotificationData        _notification_data;
+};
 
 #endif //EVENT_DATA_H
 
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_ATOMIC_H
+#define M2M_ATOMIC_H
+
+#include <stdint.h>
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+// Atomic operations used by the structures shared between threads.
+// Toolchains with lock-free GCC style builtins use them directly. Other
+// toolchains, ArmCC and IAR, and cores without an atomic exchange such
+// as Cortex-M0, fall back to a critical section provided by the platform.
+// Defining M2M_ATOMIC_CRITICAL_SECTION forces the fallback.
+#if !defined(M2M_ATOMIC_CRITICAL_SECTION) && defined(__GNUC__) && defined(__GCC_ATOMIC_INT_LOCK_FREE) && \
+    defined(__GCC_ATOMIC_POINTER_LOCK_FREE) && \
+    (__GCC_ATOMIC_INT_LOCK_FREE == 2) && (__GCC_ATOMIC_POINTER_LOCK_FREE == 2)
+#define M2M_ATOMIC_BUILTINS
+#endif
+
+#ifndef M2M_ATOMIC_BUILTINS
+
+/**
+ * @brief Enters a critical section, implemented by the platform. Must
+ * be safe to nest and keep out every other thread and interrupt handler
+ * using the client.
+ */
+extern "C" void m2m_critical_section_enter(void);
+
+/**
+ * @brief Leaves a critical section entered with m2m_critical_section_enter().
+ */
+extern "C" void m2m_critical_section_exit(void);
+
+#endif
+
+/**
+ * @brief Reads a value, later reads and writes are not moved before it.
+ */
+template <typename T>
+inline T m2m_atomic_load(const T *ptr)
+{
+#ifdef M2M_ATOMIC_BUILTINS
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#else
+    m2m_critical_section_enter();
+    T value = *(const volatile T*)ptr;
+    m2m_critical_section_exit();
+    return value;
+#endif
+}
+
+/**
+ * @brief Writes a value, earlier reads and writes are not moved after it.
+ */
+template <typename T>
+inline void m2m_atomic_store(T *ptr, T value)
+{
+#ifdef M2M_ATOMIC_BUILTINS
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#else
+    m2m_critical_section_enter();
+    *(volatile T*)ptr = value;
+    m2m_critical_section_exit();
+#endif
+}
+
+/**
+ * @brief Writes a value and returns the previous one as a single step.
+ */
+template <typename T>
+inline T m2m_atomic_exchange(T *ptr, T value)
+{
+#ifdef M2M_ATOMIC_BUILTINS
+    return __atomic_exchange_n(ptr, value, __ATOMIC_ACQ_REL);
+#else
+    m2m_critical_section_enter();
+    T previous = *(volatile T*)ptr;
+    *(volatile T*)ptr = value;
+    m2m_critical_section_exit();
+    return previous;
+#endif
+}
+
+/**
+ * @brief Replaces the value with desired if it equals expected. Otherwise
+ * stores the current value in expected. May fail spuriously, so it
+ * is to be called in a loop.
+ * @return True if the value was replaced.
+ */
+template <typename T>
+inline bool m2m_atomic_compare_exchange(T *ptr, T *expected, T desired)
+{
+#ifdef M2M_ATOMIC_BUILTINS
+    return __atomic_compare_exchange_n(ptr, expected, desired, true,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+#else
+    bool replaced = false;
+    m2m_critical_section_enter();
+    if(*(volatile T*)ptr == *expected) {
+        *(volatile T*)ptr = desired;
+        replaced = true;
+    } else {
+        *expected = *(volatile T*)ptr;
+    }
+    m2m_critical_section_exit();
+    return replaced;
+#endif
+}
+
+/**
+ * @brief Sets the given bits, earlier reads and writes are not moved after it.
+ */
+template <typename T>
+inline void m2m_atomic_fetch_or(T *ptr, T bits)
+{
+#ifdef M2M_ATOMIC_BUILTINS
+    __atomic_fetch_or(ptr, bits, __ATOMIC_RELEASE);
+#else
+    m2m_critical_section_enter();
+    *(volatile T*)ptr |= bits;
+    m2m_critical_section_exit();
+#endif
+}
+
+/**
+ * @brief Returns the index of the lowest set bit, value must not be 0.
+ */
+inline uint8_t m2m_lowest_bit(uint32_t value)
+{
+#ifdef __GNUC__
+    return __builtin_ctz(value);
+#else
+    uint8_t index = 0;
+    while(!(value & 1)) {
+        value >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+/**
+ * @brief Returns the number of set bits.
+ */
+inline uint8_t m2m_bit_count(uint32_t value)
+{
+#ifdef __GNUC__
+    return __builtin_popcount(value);
+#else
+    uint8_t count = 0;
+    for( ; value; value &= value - 1) {
+        count++;
+    }
+    return count;
+#endif
+}
+
+// Lock around the short sections updating the structures shared by all
+// the clients of a process. Linux uses a mutex, other targets spin on an
+// atomic flag.
+#ifdef __linux__
+typedef pthread_mutex_t m2m_lock_t;
+#define M2M_LOCK_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+#else
+typedef uint8_t m2m_lock_t;
+#define M2M_LOCK_INITIALIZER 0
+#endif
+
+/**
+ * @brief Takes the lock, waiting while another thread holds it.
+ * Not recursive.
+ */
+inline void m2m_lock(m2m_lock_t *lock)
+{
+#ifdef __linux__
+    pthread_mutex_lock(lock);
+#else
+    while(m2m_atomic_exchange(lock, (m2m_lock_t)1)) {
+    }
+#endif
+}
+
+/**
+ * @brief Releases a lock taken with m2m_lock().
+ */
+inline void m2m_unlock(m2m_lock_t *lock)
+{
+#ifdef __linux__
+    pthread_mutex_unlock(lock);
+#else
+    m2m_atomic_store(lock, (m2m_lock_t)0);
+#endif
+}
+
+// Storage class of the variables with one copy per thread. A platform
+// can define M2M_THREAD_LOCAL itself, on toolchains without thread local
+// storage a single copy is shared, so data must then be processed on one
+// thread at a time.
+#ifndef M2M_THREAD_LOCAL
+#if defined(__GNUC__)
+#define M2M_THREAD_LOCAL __thread
+#elif __cplusplus >= 201103L
+#define M2M_THREAD_LOCAL thread_local
+#else
+#define M2M_THREAD_LOCAL
+#endif
+#endif
+
+#endif // M2M_ATOMIC_H
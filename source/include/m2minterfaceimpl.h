@@ -20,11 +20,16 @@
 #include "mbed-client/m2mserver.h"
 #include "mbed-client/m2mconnectionobserver.h"
 #include "include/m2mnsdlobserver.h"
+#include "include/eventdata.h"
+#include "include/m2mreceivebufferpool.h"
+#include "include/m2msendqueue.h"
+#include "include/m2mwakewindow.h"
+#include "include/m2mkeepalive.h"
 
 //FORWARD DECLARATION
 class M2MNsdlInterface;
 class M2MConnectionHandler;
-class EventData;
+class M2MCoapTcpFramer;
 
 /**
  *  @brief M2MInterfaceImpl.
@@ -124,6 +129,82 @@ public:
      */
     void unregister_object(M2MSecurity* security = NULL);
 
+    /**
+     * @brief Returns the memory held by the objects registered through
+     * this interface, split per category.
+     * @return Memory statistics of the client.
+     */
+    virtual M2MMemoryStats memory_stats() const;
+
+    /**
+     * @brief Sets the timing of the queue mode wake windows.
+     * @param listen_time, Seconds to listen after the last exchange.
+     * @param wake_interval, Minimum idle seconds before held back
+     * notifications are sent.
+     */
+    virtual void set_queue_mode_timing(uint32_t listen_time, uint32_t wake_interval);
+
+    /**
+     * @brief Returns the queue mode activity counters.
+     * @return Queue mode statistics of the client.
+     */
+    virtual QueueModeStats queue_mode_stats() const;
+
+    /**
+     * @brief Sets the store the registration is kept in across restarts.
+     * @param store, Registration store of the client, not owned.
+     */
+    virtual void set_registration_store(M2MRegistrationStore *store);
+
+    /**
+     * @brief Sets the keepalive used to hold the path to the server open.
+     * @param interval, Seconds of idle time before a ping, 0 disables it.
+     * @param max_interval, Longest interval tried while adapting.
+     */
+    virtual void set_keepalive_interval(uint32_t interval, uint32_t max_interval);
+
+    /**
+     * @brief Returns the keepalive counters.
+     * @return Keepalive statistics of the client.
+     */
+    virtual KeepaliveStats keepalive_stats() const;
+
+    /**
+     * @brief Switches the client to poll mode.
+     * @param poll_mode, True for poll mode, false for the default threads.
+     */
+    virtual void set_poll_mode(bool poll_mode);
+
+    /**
+     * @brief Returns the socket to watch in poll mode.
+     * @return Socket descriptor, -1 if no socket is open.
+     */
+    virtual int socket_fd() const;
+
+    /**
+     * @brief Returns when the timers need to run next in poll mode.
+     * @param time[OUT], Time in milliseconds of the monotonic clock.
+     * @return False if no timer is pending.
+     */
+    virtual bool next_deadline(uint64_t &time) const;
+
+    /**
+     * @brief Processes the data available on the socket in poll mode.
+     */
+    virtual void process_io();
+
+    /**
+     * @brief Runs the timers due in poll mode.
+     * @param now, Current time in milliseconds of the monotonic clock.
+     */
+    virtual void process_timers(uint64_t now);
+
+    /**
+     * @brief Returns the Device Object owned by this interface.
+     * @return Device Object of the interface.
+     */
+    virtual M2MDevice* device();
+
 protected: // From M2MNsdlObserver
 
     virtual void coap_message_ready(uint8_t *data_ptr,
@@ -146,8 +227,22 @@ protected: // From M2MNsdlObserver
 
     virtual void value_updated(M2MBase *base);
 
+    virtual void coap_timer_tick(uint32_t time);
+
+    virtual uint32_t coap_timer_delay(uint32_t time);
+
 protected: // From M2MConnectionObserver
 
+    virtual M2MConnectionObserver::TransportType transport_type() const;
+
+    virtual uint8_t* receive_buffer(uint16_t &size);
+
+    virtual void release_receive_buffer(uint8_t* buffer);
+
+    virtual M2MRegistrationStore* registration_store();
+
+    virtual bool poll_mode() const;
+
     virtual void data_available(uint8_t* data,
                                 uint16_t data_size,
                                 const M2MConnectionObserver::SocketAddress &address);
@@ -291,39 +386,180 @@ private: // state machine state functions
     void state_function( uint8_t current_state, EventData* data  );
 
     /**
-     * @brief State Engine maintaining state machine logic.
+     * @brief State Engine maintaining state machine logic. Runs the queued
+     * events until the queue is empty. Events generated by a state function
+     * are queued and run once the function has returned, ahead of the events
+     * that were already pending.
      */
     void state_engine(void);
 
     /**
     * External event which can trigger the state machine.
-    * @param New State which the state machine should go to.
+    * @param event, External event, one of E_Events.
     * @param data to be passed to the state machine.
     */
-    void external_event(uint8_t, EventData* = NULL);
+    void external_event(uint8_t event, EventData* = NULL);
 
     /**
     * Internal event generated by state machine.
     * @param New State which the state machine should go to.
-    * @param data to be passed to the state machine.
+    * @param data to be passed to the state machine, must
+    * be stored in a slot returned by next_event_slot().
+    * @return False if the event queue was full and the event dropped,
+    * the observer is then informed with M2MInterface::UnknownError.
     */
-    void internal_event(uint8_t, EventData* = NULL);
+    bool internal_event(uint8_t, EventData* = NULL);
+
+    /**
+    * Calls the observer once the state changes queued before
+    * have been processed, so that the observer sees the new state
+    * and can call the interface again from the callback.
+    * @param type, Callback to call, one of E_Notifications.
+    * @param error, Error passed to M2MInterfaceObserver::error().
+    * @param security, Security object passed to the callback.
+    * @param server, Server object passed to the callback.
+    */
+    void notify(uint8_t type,
+                M2MInterface::Error error = M2MInterface::ErrorNone,
+                M2MSecurity *security = NULL,
+                const M2MServer *server = NULL);
+
+    /**
+    * Calls the observer callback described by the notification.
+    */
+    void notification(const NotificationData &data);
+
+    /**
+    * Returns a free slot for the data of the next event.
+    * @return Free event slot, NULL if all the slots are in use.
+    */
+    EventSlot* next_event_slot();
+
+    /**
+    * Returns the slot holding the given event data.
+    */
+    EventSlot* event_slot(EventData *data);
+
+    /**
+    * Releases the slot and the receive buffer it may hold.
+    */
+    void release_event_slot(EventSlot *slot);
+
+    /**
+    * Passes the messages reassembled from the TCP stream to the
+    * CoAP library and sends the replies to signaling messages.
+    * @param address, Address of the server.
+    * @return False if a message couldn't be parsed.
+    */
+    bool process_tcp_messages(sn_nsdl_addr_s *address);
+
+    /**
+    * Sends the queued messages the send queue releases. A message the
+    * socket doesn't take stays queued and is retried on the next timer
+    * tick or send completion.
+    */
+    void send_queued_messages();
+
+    /**
+    * Starts listening for data. In queue mode this opens the wake
+    * window, listening is already on if the window is open.
+    */
+    void start_listening();
+
+    /**
+    * Queues a keepalive ping to the server.
+    */
+    void send_ping();
+
+    /**
+    * Brings the CoAP time up to date, the execution timer doesn't tick
+    * while nothing is pending.
+    */
+    void refresh_time();
 
     enum
     {
+        EVENT_NOTIFICATION = 0xFD,  // Queued observer callback, not a state.
         EVENT_IGNORED = 0xFE,
         CANNOT_HAPPEN
     };
 
+    /**
+    * Observer callbacks queued behind a state change.
+    */
+    enum E_Notifications {
+        NOTIFY_ERROR = 0,
+        NOTIFY_REGISTERED,
+        NOTIFY_REGISTRATION_UPDATED,
+        NOTIFY_UNREGISTERED,
+        NOTIFY_BOOTSTRAP_DONE
+    };
+
+    /**
+    * External events triggered by the application.
+    */
+    enum E_Events {
+        EVENT_BOOTSTRAP = 0,
+        EVENT_REGISTER,
+        EVENT_UPDATE_REGISTRATION,
+        EVENT_UNREGISTER,
+        EVENT_MAX_EVENTS
+    };
+
+    /**
+    * Transition caused by an external event, allowed_states
+    * has the bit (1 << state) set for every state the event is
+    * accepted in.
+    */
+    typedef struct {
+        uint8_t     new_state;
+        uint32_t    allowed_states;
+    } Transition;
+
+    static const Transition TRANSITIONS[EVENT_MAX_EVENTS];
+
+    typedef struct {
+        uint8_t     state;
+        EventData  *data;
+    } Event;
+
+    static const uint8_t EVENT_QUEUE_SIZE = 8;
+
+    // Queue entries only the state machine itself can use, so that
+    // application calls and received data can't crowd out the state
+    // changes and notifications they lead to.
+    static const uint8_t EVENT_QUEUE_RESERVE = 3;
+
 private:
 
     M2MInterfaceObserver        &_observer;
     M2MConnectionHandler        *_connection_handler;
     M2MNsdlInterface            *_nsdl_interface;
+    M2MDevice                   *_device;
     uint8_t                     _current_state;
     const int                   _max_states;
-    bool                        _event_generated;
-    EventData                   *_event_data;
+    Event                       _event_queue[EVENT_QUEUE_SIZE];
+    EventSlot                   _event_slots[EVENT_QUEUE_SIZE];
+    uint8_t                     _event_head;
+    uint8_t                     _event_count;
+    uint8_t                     _event_insert;      // Queue position for the next generated event.
+    bool                        _event_dispatching;
+    M2MReceiveBufferPool        _receive_pool;
+    M2MCoapTcpFramer            *_tcp_framer;       // Only with the TCP binding.
+    bool                        _tcp_processing;
+    M2MSendQueue                _send_queue;
+    uint8_t                     _send_failures;     // Consecutive failed send attempts.
+    bool                        _sending;
+    bool                        _queue_mode;        // Binding has the queue mode flag.
+    M2MWakeWindow               _wake_window;
+    uint32_t                    _coap_time;         // Last CoAP timer tick, in seconds.
+    M2MRegistrationStore        *_registration_store;
+    bool                        _resume_registration;
+    String                      _server_uri;        // Server of the ongoing registration.
+    M2MKeepalive                _keepalive;
+    sn_nsdl_addr_s              _server_address;    // Destination of the pings.
+    uint8_t                     _server_address_data[16];
+    bool                        _poll_mode;
 
     String                      _endpoint_name;
     String                      _endpoint_type;
@@ -341,16 +577,6 @@ private:
 
 };
 
-#define BEGIN_TRANSITION_MAP \
-    static const uint8_t TRANSITIONS[] = {\
-
-#define TRANSITION_MAP_ENTRY(entry)\
-    entry,
-
-#define END_TRANSITION_MAP(data) \
-    0 };\
-    external_event(TRANSITIONS[_current_state], data);
-
 #endif //M2M_INTERFACE_IMPL_H
 
 
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_KEEPALIVE_H
+#define M2M_KEEPALIVE_H
+
+#include "mbed-client/m2minterface.h"
+
+/**
+ *  @brief M2MKeepalive.
+ *  Keeps the path to the server open with CoAP pings sent after a given
+ *  idle time, independently of the registration updates. Any traffic in
+ *  either direction restarts the idle time. A ping is retransmitted with
+ *  a doubling timeout and the path is considered lost when none of the
+ *  attempts is answered. With adaptation the interval grows by the base
+ *  interval after every answered ping, up to a maximum, until a ping goes
+ *  unanswered. The idle time of that ping is taken as the NAT timeout and
+ *  the interval falls back to the longest one answered. Time is in seconds.
+ */
+class M2MKeepalive {
+
+public:
+
+    typedef enum {
+        None = 0,
+        Ping,           // Send the ping message.
+        Failed          // The ping went unanswered.
+    } Action;
+
+    static const uint8_t PING_LENGTH = 4;
+
+    /**
+     * @brief Constructor
+     * @param timeout, Seconds to wait for the reply to the first transmission.
+     * @param max_attempts, Transmissions of a ping before giving up.
+     */
+    M2MKeepalive(uint32_t timeout, uint8_t max_attempts);
+
+    /**
+     * @brief Destructor
+     */
+    ~M2MKeepalive();
+
+    /**
+     * @brief Sets the interval, restarting the adaptation.
+     * @param interval, Idle seconds before a ping, 0 disables the keepalive.
+     * @param max_interval, Longest interval tried, no adaptation if not
+     * larger than interval.
+     */
+    void set_interval(uint32_t interval, uint32_t max_interval);
+
+    /**
+     * @brief Starts sending pings, the client is registered.
+     * @param now, Current time.
+     */
+    void start(uint32_t now);
+
+    /**
+     * @brief Stops sending pings, the client isn't registered.
+     */
+    void stop();
+
+    /**
+     * @brief Records traffic to or from the server, restarts the idle time.
+     * @param now, Current time.
+     */
+    void activity(uint32_t now);
+
+    /**
+     * @brief Decides whether a ping is due as time passes.
+     * @param now, Current time.
+     * @return Ping when the ping message is to be sent, Failed when the
+     * ping went unanswered, None otherwise.
+     */
+    Action tick(uint32_t now);
+
+    /**
+     * @brief Returns when tick() next has something to do.
+     * @param now, Current time.
+     * @return Seconds until the next ping or reply timeout, 0 if none.
+     */
+    uint32_t next_action(uint32_t now) const;
+
+    /**
+     * @brief Writes the ping message, an empty confirmable CoAP message.
+     * @param buffer, Buffer of at least PING_LENGTH bytes.
+     * @return Length of the message.
+     */
+    uint16_t ping_message(uint8_t *buffer) const;
+
+    /**
+     * @brief Checks whether a received message answers the ping.
+     * @param data, Received CoAP message in the UDP format.
+     * @param length, Length of the message.
+     * @param now, Current time.
+     * @return True if the message is the reset answering the ping, it
+     * is then consumed.
+     */
+    bool pong_received(const uint8_t *data, uint16_t length, uint32_t now);
+
+    /**
+     * @brief Returns the keepalive counters.
+     */
+    M2MInterface::KeepaliveStats stats() const;
+
+private:
+
+    void ping_failed();
+
+    // Prevents the use of assignment operator.
+    M2MKeepalive& operator=( const M2MKeepalive& /*other*/ );
+
+    // Prevents the use of copy constructor
+    M2MKeepalive( const M2MKeepalive& /*other*/ );
+
+private:
+
+    uint32_t                        _timeout;
+    uint8_t                         _max_attempts;
+    uint8_t                         _attempts;          // Transmissions of the current ping, 0 if none.
+    uint32_t                        _step;
+    uint32_t                        _interval;
+    uint32_t                        _max_interval;
+    uint32_t                        _good_interval;     // Longest interval answered.
+    uint32_t                        _last_activity;
+    uint32_t                        _sent_at;
+    uint16_t                        _message_id;
+    bool                            _running;
+    bool                            _adapting;
+    M2MInterface::KeepaliveStats    _stats;
+
+friend class Test_M2MKeepalive;
+};
+
+#endif // M2M_KEEPALIVE_H
@@ -21,6 +21,7 @@
 #include "mbed-client/m2minterface.h"
 #include "mbed-client/m2mtimerobserver.h"
 #include "mbed-client/m2mobservationhandler.h"
+#include "mbed-client/m2mmemorystats.h"
 #include "include/nsdllinker.h"
 
 //FORWARD DECLARARTION
@@ -29,6 +30,7 @@ class M2MObject;
 class M2MObjectInstance;
 class M2MResource;
 class M2MResourceInstance;
+class M2MResourceTable;
 class M2MNsdlObserver;
 class M2MBase;
 class M2MServer;
@@ -115,6 +117,35 @@ public:
                                const uint16_t port,
                                sn_nsdl_addr_type_e address_type);
 
+    /**
+     * @brief Resumes a registration made earlier, possibly by an earlier
+     * run of the client, by sending a registration update to its location.
+     * If the server rejects the update the client registers again.
+     * @param address M2MServer address.
+     * @param port M2MServer port.
+     * @param address_type IP Address type.
+     * @param location, Location of the registration on the server.
+     * @param location_length, Length of the location.
+     * @return  true if the update sent successfully else false.
+    */
+    bool send_resume_registration(uint8_t* address,
+                                  const uint16_t port,
+                                  sn_nsdl_addr_type_e address_type,
+                                  const uint8_t *location,
+                                  uint8_t location_length);
+
+    /**
+     * @brief Returns the location of the registration on the server.
+     * @param length[OUT], Length of the location.
+     * @return Location, NULL if not registered.
+    */
+    const uint8_t* registration_location(uint8_t &length) const;
+
+    /**
+     * @brief Returns the registration lifetime in seconds, 0 if not set.
+    */
+    uint32_t registration_lifetime() const;
+
     /**
      * @brief Sends the update registration message to the server.
      * @param lifetime, Updated lifetime value in seconds.
@@ -199,11 +230,34 @@ public:
                                uint16_t data_size,
                                sn_nsdl_addr_s *address);
 
+    /**
+     * @brief Returns the memory held by the registered objects and
+     * the interface itself.
+     * @return Memory statistics of the registered objects.
+     */
+    M2MMemoryStats memory_stats() const;
+
     /**
      * @brief Stops all the timers in case there is any errors.
      */
     void stop_timers();
 
+    /**
+     * @brief Returns the time of the CoAP library, the time given to its
+     * execution and to M2MNsdlObserver::coap_timer_tick(). The clock is
+     * shared by all the interfaces of the process.
+     * @return Seconds since the first interface was initialized.
+     */
+    uint32_t coap_time() const;
+
+    /**
+     * @brief Schedules the execution timer for the next deadline given by
+     * M2MNsdlObserver::coap_timer_delay(). Call when a deadline of the
+     * observer may have moved earlier, messages sent through the CoAP
+     * library schedule it by themselves.
+     */
+    void schedule_execution();
+
 protected: // from M2MTimerObserver
 
     virtual void timer_expired(M2MTimerObserver::Type type);
@@ -238,11 +292,42 @@ private:
 
     bool create_nsdl_resource(M2MBase *base, const String &name = "");
 
+    bool create_nsdl_table_structure(M2MResourceTable *table);
+
+    bool create_nsdl_table_entry(M2MResourceTable *table,
+                                 uint16_t instance_id,
+                                 int32_t resource_id,
+                                 uint8_t operation);
+
+    /**
+     * @brief Removes the NSDL library copies of the object and everything
+     * below it from the memory statistics.
+     * @param base, Object whose copies are released.
+     * @param path, Path of the object, used to find the copies of a resource.
+     * @param resource_instance, True if the object is a resource instance.
+     */
+    void release_nsdl_memory(M2MBase *base,
+                             const String &path,
+                             bool resource_instance = false);
+
+    /**
+     * @brief Returns the size of the NSDL library copy of the given path.
+     * @param path, Path of the resource.
+     * @return Size in bytes, 0 if the library holds no such resource.
+     */
+    int32_t nsdl_path_memory(const String &path);
+
     String coap_to_string(uint8_t *coap_data_ptr,
                           int coap_data_ptr_length);
 
     void execute_nsdl_process_loop();
 
+    void advance_time(uint32_t deadline);
+
+    void update_coap_time();
+
+    uint32_t coap_cache_delay(uint32_t now) const;
+
     uint64_t registration_time();
 
     M2MBase* find_resource(const String &object);
@@ -269,6 +354,14 @@ private:
 
     void send_resource_observation(M2MResourceInstance *resource);
 
+    bool set_location(const uint8_t *location, uint16_t length);
+
+    uint16_t send_update(uint8_t *lifetime, uint8_t lifetime_length);
+
+    uint16_t send_location_request(sn_coap_msg_code_e msg_code,
+                                   uint8_t *query,
+                                   uint16_t query_length);
+
 private:
 
     M2MNsdlObserver                   &_observer;
@@ -283,10 +376,21 @@ private:
     sn_nsdl_addr_s                     _sn_nsdl_address;
     nsdl_s                            *_nsdl_handle;
     uint32_t                           _counter_for_nsdl;
+    uint32_t                           _execution_deadline;  // 0 when the timer isn't running.
+    uint32_t                           _resend_until;        // End of the resends of the last confirmable message.
+    uint32_t                           _duplicate_until;     // End of the duplicate detection of the last request.
+    static uint32_t                    _clock_start;         // Monotonic seconds at the start, on Linux.
+    static uint32_t                    _clock_ticks;         // The clock elsewhere, moved on by the timers.
+    static uint32_t                    _exec_time;           // Time last given to the CoAP library.
     uint16_t                           _register_id;
     uint16_t                           _unregister_id;
     uint16_t                           _update_id;
     uint16_t                           _bootstrap_id;
+    uint8_t                            _server_address[16];
+    uint8_t                           *_location;          // Registration location on the server.
+    uint8_t                            _location_length;
+    uint16_t                           _resume_id;
+    bool                               _resumed;           // Registration not known by the library.
 
 friend class Test_M2MNsdlInterface;
 
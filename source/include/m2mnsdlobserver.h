@@ -90,5 +90,21 @@ public :
      * @param base Object whose value is updated.
      */
     virtual void value_updated(M2MBase *base) = 0;
+
+    /**
+     * @brief Informs that the execution timer of the CoAP library ticked.
+     * @param time, Seconds since the timer was started.
+     */
+    virtual void coap_timer_tick(uint32_t /*time*/) {}
+
+    /**
+     * @brief Returns when the execution timer needs to tick next. The
+     * timer sleeps while nothing is pending, so every retransmission or
+     * other timing of the observer is to be expressed as a deadline here.
+     * @param time, Current time in seconds, as given to coap_timer_tick().
+     * @return Seconds until the next tick, 0 if no tick is needed.
+     * Every second by default.
+     */
+    virtual uint32_t coap_timer_delay(uint32_t /*time*/) { return 1; }
 };
 #endif // M2M_NSDL_OBSERVER_H
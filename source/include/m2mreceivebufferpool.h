@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_RECEIVE_BUFFER_POOL_H
+#define M2M_RECEIVE_BUFFER_POOL_H
+
+#include <stdint.h>
+
+/**
+ *  @brief M2MReceiveBufferPool.
+ *  Fixed set of datagram buffers allocated once when the client is
+ *  created. The socket layer receives directly into a buffer from the
+ *  pool and the client returns it once the CoAP library has parsed the
+ *  data, so receiving costs neither a copy nor an allocation per packet.
+ *  Buffers can be acquired and released from different threads.
+ */
+class M2MReceiveBufferPool {
+
+public:
+
+    static const uint8_t MAX_BUFFERS = 32;
+
+    /**
+     * @brief Constructor
+     * @param buffer_count, Number of buffers, at most MAX_BUFFERS.
+     * @param buffer_size, Size of each buffer.
+     */
+    M2MReceiveBufferPool(uint8_t buffer_count, uint16_t buffer_size);
+
+    /**
+     * @brief Destructor
+     */
+    ~M2MReceiveBufferPool();
+
+    /**
+     * @brief Takes a free buffer from the pool.
+     * @return Buffer of buffer_size() bytes, NULL if all are in use.
+     */
+    uint8_t* acquire();
+
+    /**
+     * @brief Returns a buffer to the pool.
+     * @param buffer, Buffer or any pointer into a buffer taken
+     * with acquire(), pointers not owned by the pool are ignored.
+     */
+    void release(uint8_t *buffer);
+
+    /**
+     * @brief Returns whether the data lies in a buffer of the pool.
+     * @param data, Pointer to check.
+     * @return True if owned by the pool, else false.
+     */
+    bool owns(const uint8_t *data) const;
+
+    /**
+     * @brief Returns the size of each buffer.
+     */
+    uint16_t buffer_size() const;
+
+    /**
+     * @brief Returns the number of free buffers.
+     */
+    uint8_t available() const;
+
+    /**
+     * @brief Returns the memory held by the pool.
+     */
+    uint32_t memory() const;
+
+private:
+
+    // Prevents the use of assignment operator.
+    M2MReceiveBufferPool& operator=( const M2MReceiveBufferPool& /*other*/ );
+
+    // Prevents the use of copy constructor
+    M2MReceiveBufferPool( const M2MReceiveBufferPool& /*other*/ );
+
+private:
+
+    uint8_t                 *_buffers;
+    uint16_t                _buffer_size;
+    uint8_t                 _buffer_count;
+    uint32_t                _free_mask;     // Bit per buffer, set when free.
+
+friend class Test_M2MReceiveBufferPool;
+};
+
+#endif // M2M_RECEIVE_BUFFER_POOL_H
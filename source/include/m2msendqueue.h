@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_SEND_QUEUE_H
+#define M2M_SEND_QUEUE_H
+
+#include "include/nsdllinker.h"
+
+/**
+ *  @brief M2MSendQueue.
+ *  Outbound CoAP messages on their way from the CoAP library to the
+ *  socket. Messages are classified from their header: acknowledgements
+ *  go first, then registration requests, then other responses, then
+ *  notifications. At most a given number of confirmable messages are
+ *  in flight at a time (NSTART), the next one is released when the
+ *  server acknowledges or the exchange times out. A queued notification
+ *  is superseded by a newer one for the same observation, and when the
+ *  queue is full the oldest message of the lowest priority is dropped.
+ *  Retransmissions of a message already in flight bypass the limit.
+ */
+class M2MSendQueue {
+
+public:
+
+    /**
+     * Message priorities, highest first.
+     */
+    typedef enum {
+        Control = 0,            // ACK and RST.
+        Registration,           // Requests sent by the client.
+        Response,               // Separate responses.
+        Notification,           // Responses carrying the Observe option.
+        PRIORITY_COUNT
+    } Priority;
+
+    static const uint8_t MAX_MESSAGES = 32;
+    static const uint8_t MAX_IN_FLIGHT = 8;
+
+    /**
+     * @brief Queue counters.
+     */
+    typedef struct {
+        uint32_t    queued;
+        uint32_t    sent;
+        uint32_t    superseded;         // Notifications replaced by a newer one.
+        uint32_t    dropped;            // Messages dropped because the queue was full.
+        uint32_t    in_flight_timeouts; // Exchanges released without an acknowledgement.
+        uint32_t    largest_depth;
+    } Stats;
+
+    /**
+     * @brief Constructor
+     * @param max_messages, Number of messages the queue holds, at most MAX_MESSAGES.
+     * @param max_in_flight, Confirmable messages in flight, 0 for no limit.
+     * @param exchange_timeout, Seconds after which an unacknowledged
+     * message no longer counts as in flight.
+     */
+    M2MSendQueue(uint8_t max_messages, uint8_t max_in_flight, uint32_t exchange_timeout);
+
+    /**
+     * @brief Destructor
+     */
+    ~M2MSendQueue();
+
+    /**
+     * @brief Queues a message.
+     * @param data, CoAP message in the UDP format, copied.
+     * @param length, Length of the message.
+     * @param address, Destination address, copied.
+     * @return True if queued, false if invalid, a duplicate of a queued
+     * message, out of memory or dropped because the queue is full of
+     * messages with a higher priority.
+     */
+    bool enqueue(const uint8_t *data, uint16_t length, const sn_nsdl_addr_s *address);
+
+    /**
+     * @brief Returns the next message that can be sent now. The message
+     * stays queued until sent() is called.
+     * @param length[OUT], Length of the message.
+     * @param address[OUT], Destination address, valid until sent().
+     * @return Message, NULL if the queue is empty or only holds
+     * confirmable messages waiting for the in-flight limit.
+     */
+    const uint8_t* front(uint16_t &length, sn_nsdl_addr_s *&address);
+
+    /**
+     * @brief Removes the message returned by front() once it is sent.
+     * A confirmable message is then in flight.
+     */
+    void sent();
+
+    /**
+     * @brief Inspects a received message, an acknowledgement or reset
+     * ends the exchange of the confirmable message it refers to.
+     * @param data, Received CoAP message in the UDP format.
+     * @param length, Length of the message.
+     */
+    void message_received(const uint8_t *data, uint16_t length);
+
+    /**
+     * @brief Advances the time used for the exchange timeout.
+     * @param now, Current time in seconds.
+     */
+    void tick(uint32_t now);
+
+    /**
+     * @brief Drops all queued messages and ends all exchanges.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of queued messages.
+     */
+    uint8_t count() const;
+
+    /**
+     * @brief Returns the number of confirmable messages in flight.
+     */
+    uint8_t in_flight() const;
+
+    /**
+     * @brief Returns the queue counters.
+     */
+    const Stats& stats() const;
+
+    /**
+     * @brief Returns the priority of a CoAP message.
+     * @param data, CoAP message in the UDP format.
+     * @param length, Length of the message.
+     * @return Priority, PRIORITY_COUNT if the message is invalid.
+     */
+    static Priority classify(const uint8_t *data, uint16_t length);
+
+private:
+
+    typedef struct {
+        uint8_t             *data;          // NULL when the slot is free.
+        uint16_t            length;
+        uint32_t            sequence;       // Queueing order.
+        uint8_t             priority;
+        sn_nsdl_addr_s      address;
+        uint8_t             address_data[16];
+    } Message;
+
+    typedef struct {
+        uint16_t            message_id;
+        uint32_t            sent;           // Time the exchange started.
+    } Exchange;
+
+    int find_exchange(uint16_t message_id) const;
+
+    int find_message(uint16_t message_id) const;
+
+    int find_notification(const uint8_t *data, uint16_t length) const;
+
+    int eviction_candidate(Priority priority) const;
+
+    void remove(int index);
+
+    static bool is_confirmable(const uint8_t *data);
+
+    static uint16_t message_id(const uint8_t *data);
+
+    // Prevents the use of assignment operator.
+    M2MSendQueue& operator=( const M2MSendQueue& /*other*/ );
+
+    // Prevents the use of copy constructor
+    M2MSendQueue( const M2MSendQueue& /*other*/ );
+
+private:
+
+    Message                 *_messages;
+    Exchange                _exchanges[MAX_IN_FLIGHT];
+    uint8_t                 _max_messages;
+    uint8_t                 _max_in_flight;
+    uint8_t                 _count;
+    uint8_t                 _in_flight;
+    uint32_t                _exchange_timeout;
+    uint32_t                _now;
+    uint32_t                _sequence;
+    int                     _front;         // Message returned by front(), -1 if none.
+    Stats                   _stats;
+
+friend class Test_M2MSendQueue;
+};
+
+#endif // M2M_SEND_QUEUE_H
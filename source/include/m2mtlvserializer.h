@@ -18,6 +18,9 @@
 #include "mbed-client/m2mobjectinstance.h"
 #include "mbed-client/m2mresource.h"
 
+//FORWARD DECLARATION
+class M2MResourceTable;
+
 /**
  * @brief M2MTLVSerializer
  * TLV Serialiser constructs the binary representation of object instances,
@@ -82,8 +85,36 @@ public:
      */
     uint8_t* serialize(M2MResourceList resource_list, uint32_t &size);
 
+    /**
+     * Serialises all the object instances of a resource table, producing the
+     * same TLV as serialize(M2MObjectInstanceList, uint32_t&) does for the
+     * equivalent object tree. The size of the output is computed first, so
+     * the table is encoded into a single allocation by scanning its rows
+     * and value heap sequentially.
+     * @param table Resource table to serialise.
+     * @return Object instances encoded binary as OMA-TLV
+     */
+    uint8_t* serialize(const M2MResourceTable *table, uint32_t &size);
+
+    /**
+     * Serialises the resources of one object instance of a resource table,
+     * producing the same TLV as serialize(M2MResourceList, uint32_t&).
+     * @param table Resource table to serialise.
+     * @param instance_id Object instance whose resources are encoded.
+     * @return Resources encoded binary as OMA-TLV
+     */
+    uint8_t* serialize(const M2MResourceTable *table, uint16_t instance_id, uint32_t &size);
+
 private :
 
+    uint32_t table_rows_size(const M2MResourceTable *table, uint32_t first_row, uint32_t last_row);
+
+    uint8_t* serialize_table_rows(const M2MResourceTable *table, uint32_t first_row, uint32_t last_row, uint8_t *ptr);
+
+    uint32_t TL_size(uint16_t id, uint32_t value_length);
+
+    uint8_t* serialize_TL(uint8_t type, uint16_t id, uint32_t value_length, uint8_t *ptr);
+
     uint8_t* serialize_object_instances(M2MObjectInstanceList object_instance_list, uint32_t &size);
 
     uint8_t* serialize_resources(M2MResourceList resource_list, uint32_t &size, bool &valid);
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_WAKE_WINDOW_H
+#define M2M_WAKE_WINDOW_H
+
+#include "mbed-client/m2minterface.h"
+
+/**
+ *  @brief M2MWakeWindow.
+ *  Activity window of a client in queue mode. The client listens only
+ *  while the window is open. The window opens when the client has
+ *  something to send, either right away for its own requests or at the
+ *  next wake for deferred notifications, and closes once nothing has
+ *  been sent or received for the listen time. Idle time and the bytes
+ *  sent per window are counted. Time is in seconds.
+ */
+class M2MWakeWindow {
+
+public:
+
+    typedef enum {
+        None = 0,
+        Opened,
+        Closed
+    } Change;
+
+    /**
+     * @brief Constructor
+     * @param listen_time, Seconds the window stays open after the last exchange.
+     * @param wake_interval, Seconds the window stays closed at least when
+     * only deferred messages are waiting.
+     */
+    M2MWakeWindow(uint32_t listen_time, uint32_t wake_interval);
+
+    /**
+     * @brief Destructor
+     */
+    ~M2MWakeWindow();
+
+    /**
+     * @brief Sets the window timing, applied from the next tick.
+     * @param listen_time, Seconds the window stays open after the last exchange.
+     * @param wake_interval, Minimum seconds between windows for deferred messages.
+     */
+    void set_timing(uint32_t listen_time, uint32_t wake_interval);
+
+    /**
+     * @brief Opens the window if it isn't open.
+     * @param now, Current time.
+     * @return True if the window was opened, false if it already was.
+     */
+    bool open(uint32_t now);
+
+    /**
+     * @brief Stops the window handling, the client isn't registered.
+     * @param now, Current time.
+     */
+    void stop(uint32_t now);
+
+    /**
+     * @brief Returns true if the window is open.
+     */
+    bool is_open() const;
+
+    /**
+     * @brief Records a received message, keeps the window open.
+     * @param now, Current time.
+     */
+    void message_received(uint32_t now);
+
+    /**
+     * @brief Records a sent message, keeps the window open.
+     * @param now, Current time.
+     * @param bytes, Size of the message.
+     */
+    void message_sent(uint32_t now, uint16_t bytes);
+
+    /**
+     * @brief Records a message held back until the next window.
+     */
+    void message_deferred();
+
+    /**
+     * @brief Opens or closes the window as time passes.
+     * @param now, Current time.
+     * @param pending, True if messages are queued or exchanges are
+     * waiting for a reply.
+     * @return Opened or Closed when the window changed, None otherwise.
+     */
+    Change tick(uint32_t now, bool pending);
+
+    /**
+     * @brief Returns when tick() next changes the window.
+     * @param now, Current time.
+     * @param pending, True if messages are queued or exchanges ongoing.
+     * @return Seconds until the window opens or closes, 0 if it doesn't.
+     */
+    uint32_t next_change(uint32_t now, bool pending) const;
+
+    /**
+     * @brief Returns the counters, idle time includes the ongoing idle period.
+     * @param now, Current time.
+     */
+    M2MInterface::QueueModeStats stats(uint32_t now) const;
+
+private:
+
+    typedef enum {
+        Stopped = 0,
+        Open,
+        Idle
+    } State;
+
+    void close(uint32_t now);
+
+    // Prevents the use of assignment operator.
+    M2MWakeWindow& operator=( const M2MWakeWindow& /*other*/ );
+
+    // Prevents the use of copy constructor
+    M2MWakeWindow( const M2MWakeWindow& /*other*/ );
+
+private:
+
+    State                           _state;
+    uint32_t                        _listen_time;
+    uint32_t                        _wake_interval;
+    uint32_t                        _last_activity;
+    uint32_t                        _closed_at;
+    M2MInterface::QueueModeStats    _stats;
+
+friend class Test_M2MWakeWindow;
+};
+
+#endif // M2M_WAKE_WINDOW_H
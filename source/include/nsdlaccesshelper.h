@@ -1,49 +1,75 @@
-/*
- * Copyright (c) 2015 ARM Limited. All rights reserved.
- * SPDX-License-Identifier: Apache-2.0
- * Licensed under the Apache License, Version 2.0 (the License); you may
- * not use this file except in compliance with the License.
- * You may obtain a copy of the License at
- *
- * http://www.apache.org/licenses/LICENSE-2.0
- *
- * Unless required by applicable law or agreed to in writing, software
- * distributed under the License is distributed on an AS IS BASIS, WITHOUT
- * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
- * See the License for the specific language governing permissions and
- * limitations under the License.
- */
-#ifndef NSDL_ACCESS_HELPER_H
-#define NSDL_ACCESS_HELPER_H
-
-#include "include/m2mnsdlinterface.h"
-
-extern M2MNsdlInterface  *__nsdl_interface;
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-uint8_t __nsdl_c_callback(struct nsdl_s * nsdl_handle,
-                          sn_coap_hdr_s *received_coap_ptr,
-                          sn_nsdl_addr_s *address,
-                          sn_nsdl_capab_e nsdl_capab);
-void *__nsdl_c_memory_alloc(uint16_t size);
-void __nsdl_c_memory_free(void *ptr);
-uint8_t __nsdl_c_send_to_server(struct nsdl_s * nsdl_handle,
-                                sn_nsdl_capab_e protocol,
-                                uint8_t *data_ptr,
-                                uint16_t data_len,
-                                sn_nsdl_addr_s *address_ptr);
-uint8_t __nsdl_c_received_from_server(struct nsdl_s * nsdl_handle,
-                                      sn_coap_hdr_s *coap_header,
-                                      sn_nsdl_addr_s *address_ptr);
-void __nsdl_c_bootstrap_done(sn_nsdl_oma_server_info_t *server_info_ptr);
-void *__socket_malloc( void * context, size_t size);
-void __socket_free(void * context, void * ptr);
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif // NSDL_ACCESS_HELPER_H
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef NSDL_ACCESS_HELPER_H
+#define NSDL_ACCESS_HELPER_H
+
+#include "include/m2mnsdlinterface.h"
+#include "include/m2matomic.h"
+
+// Interface whose handle the calling thread is processing with the NSDL
+// library, used to route the callbacks that don't carry the library handle.
+extern M2M_THREAD_LOCAL M2MNsdlInterface  *__nsdl_processing_interface;
+
+/**
+ * @brief Binds an NSDL library handle to the interface owning it so that
+ * the library callbacks can be routed to the right interface.
+ * @param nsdl_handle, Handle returned by sn_nsdl_init().
+ * @param nsdl_interface, Interface owning the handle.
+ * @return True if registered, false if out of memory.
+ */
+bool __nsdl_interface_register(struct nsdl_s *nsdl_handle,
+                               M2MNsdlInterface *nsdl_interface);
+
+/**
+ * @brief Removes the binding of an NSDL library handle.
+ * @param nsdl_handle, Handle to be removed.
+ */
+void __nsdl_interface_unregister(struct nsdl_s *nsdl_handle);
+
+/**
+ * @brief Returns the interface owning the given NSDL library handle.
+ * @param nsdl_handle, Handle of the NSDL library.
+ * @return Interface owning the handle, NULL if not registered.
+ */
+M2MNsdlInterface* __nsdl_interface_find(struct nsdl_s *nsdl_handle);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint8_t __nsdl_c_callback(struct nsdl_s * nsdl_handle,
+                          sn_coap_hdr_s *received_coap_ptr,
+                          sn_nsdl_addr_s *address,
+                          sn_nsdl_capab_e nsdl_capab);
+void *__nsdl_c_memory_alloc(uint16_t size);
+void __nsdl_c_memory_free(void *ptr);
+uint8_t __nsdl_c_send_to_server(struct nsdl_s * nsdl_handle,
+                                sn_nsdl_capab_e protocol,
+                                uint8_t *data_ptr,
+                                uint16_t data_len,
+                                sn_nsdl_addr_s *address_ptr);
+uint8_t __nsdl_c_received_from_server(struct nsdl_s * nsdl_handle,
+                                      sn_coap_hdr_s *coap_header,
+                                      sn_nsdl_addr_s *address_ptr);
+void __nsdl_c_bootstrap_done(sn_nsdl_oma_server_info_t *server_info_ptr);
+void *__socket_malloc( void * context, size_t size);
+void __socket_free(void * context, void * ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NSDL_ACCESS_HELPER_H
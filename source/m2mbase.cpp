@@ -22,94 +22,75 @@
 #include <ctype.h>
 #include <string.h>
 
+// Report handler allocates the pmin and pmax timers along with itself.
+#define REPORT_HANDLER_MEMORY ((int32_t)(sizeof(M2MReportHandler) + 2 * sizeof(M2MTimer)))
+
 M2MBase& M2MBase::operator=(const M2MBase& other)
 {
     if (this != &other) { // protect against invalid self-assignment
         _operation = other._operation;
         _mode = other._mode;
+        M2MStringPool::acquire(other._name);
+        M2MStringPool::release(_name);
         _name = other._name;
+        _name_id = other._name_id;
+        M2MStringPool::acquire(other._resource_type);
+        M2MStringPool::release(_resource_type);
         _resource_type = other._resource_type;
+        M2MStringPool::acquire(other._interface_description);
+        M2MStringPool::release(_interface_description);
         _interface_description = other._interface_description;
         _coap_content_type = other._coap_content_type;
         _instance_id = other._instance_id;
         _observable = other._observable;
-        _observation_number = other._observation_number;
         _observation_level = other._observation_level;
         _observation_handler = other._observation_handler;
 
-        if(_token) {
-            free(_token);
-            _token = NULL;
-            _token_length = 0;
-        }
-        _token_length = other._token_length;
-        if(other._token) {
-            _token = (uint8_t *)malloc(other._token_length+1);
-            if(_token) {
-                memset(_token, 0, other._token_length+1);
-                memcpy((uint8_t *)_token, (uint8_t *)other._token, other._token_length);
-            }
-        }
-
-        if(_report_handler) {
-            delete _report_handler;
-            _report_handler = NULL;
-        }
-        if(other._report_handler) {
-            _report_handler = new M2MReportHandler(*other._report_handler);
-        }
+        set_observation_token(NULL, 0);
+        set_observation_number(0);
+        delete_report_handler();
+        copy_observation_data(other);
     }
     return *this;
 }
 
 M2MBase::M2MBase(const M2MBase& other) :
-    _report_handler(NULL),
-    _token(NULL),
-    _token_length(0)
+    _observation(NULL),
+    _memory_attached(false)
 {
     _operation = other._operation;
     _mode = other._mode;
-    _name = other._name;
-    _resource_type = other._resource_type;
-    _interface_description = other._interface_description;
+    _name = M2MStringPool::acquire(other._name);
+    _name_id = other._name_id;
+    _base_type = other._base_type;
+    _resource_type = M2MStringPool::acquire(other._resource_type);
+    _interface_description = M2MStringPool::acquire(other._interface_description);
     _coap_content_type = other._coap_content_type;
     _instance_id = other._instance_id;
     _observable = other._observable;
     _observation_handler = other._observation_handler;
-    _observation_number = other._observation_number;
     _observation_level = other._observation_level;
-
-    _token_length = other._token_length;
-    if(other._token) {
-        _token = (uint8_t *)malloc(other._token_length+1);
-        if(_token) {
-            memset(_token, 0, other._token_length+1);
-            memcpy((uint8_t *)_token, (uint8_t *)other._token, other._token_length);
-        }
-    }
-
-    if(other._report_handler) {
-        _report_handler = new M2MReportHandler(*other._report_handler);
-    }
+    copy_observation_data(other);
 }
 
 M2MBase::M2MBase(const String & resource_name,
                  M2MBase::Mode mde)
-: _report_handler(NULL),
-  _observation_handler(NULL),
-  _operation(M2MBase::NOT_ALLOWED),  
+: _observation_handler(NULL),
+  _observation(NULL),
+  _name(M2MStringPool::acquire(resource_name)),
+  _resource_type(M2MStringPool::EMPTY),
+  _interface_description(M2MStringPool::EMPTY),
+  _instance_id(0),
+  _coap_content_type(0),
+  _operation(M2MBase::NOT_ALLOWED),
   _mode(mde),
+  _base_type(M2MBase::Object),
   _observation_level(M2MBase::None),
-  _name(resource_name),
-  _coap_content_type(0),
-  _instance_id(0),
   _observable(false),
-  _observation_number(0),
-  _token(NULL),
-  _token_length(0)
+  _memory_attached(false)
 {
-    if(is_integer(_name)) {
-        _name_id = strtoul(_name.c_str(), NULL, 10);
+    if(is_integer(resource_name)) {
+        _name_id = strtoul(resource_name.c_str(), NULL, 10);
     } else {
         _name_id = -1;
     }
@@ -117,14 +98,16 @@ M2MBase::M2MBase(const String & resource_name,
 
 M2MBase::~M2MBase()
 {
-    if(_report_handler) {
-        delete _report_handler;
-        _report_handler = NULL;
-    }
-    if(_token) {
-        free(_token);
-        _token = NULL;
-        _token_length = 0;
+    M2MStringPool::release(_name);
+    M2MStringPool::release(_resource_type);
+    M2MStringPool::release(_interface_description);
+    if(_observation) {
+        if(_observation->report_handler) {
+            delete _observation->report_handler;
+        }
+        free(_observation->token);
+        free(_observation);
+        _observation = NULL;
     }
 }
 
@@ -141,12 +124,17 @@ void M2MBase::set_operation(M2MBase::Operation opr)
 
 void M2MBase::set_interface_description(const String &desc)
 {
-    _interface_description = desc;
+    // Acquire before release, the value may already be the current one.
+    M2MStringPool::Handle handle = M2MStringPool::acquire(desc);
+    M2MStringPool::release(_interface_description);
+    _interface_description = handle;
 }
 
 void M2MBase::set_resource_type(const String &res_type)
 {
-    _resource_type = res_type;
+    M2MStringPool::Handle handle = M2MStringPool::acquire(res_type);
+    M2MStringPool::release(_resource_type);
+    _resource_type = handle;
 }
 
 void M2MBase::set_coap_content_type(const uint8_t con_type)
@@ -174,34 +162,41 @@ void M2MBase::set_under_observation(bool observed,
 {
     _observation_handler = handler;
     if(handler) {
-        if(!_report_handler){
-            _report_handler = new M2MReportHandler(*this);
+        // The report handler and its timers are needed only once the
+        // object is observed, registration alone doesn't create them.
+        if(observed) {
+            create_report_handler();
         }
-        _report_handler->set_under_observation(observed);
-    } else {
-        if(_report_handler) {
-            delete _report_handler;
-            _report_handler = NULL;
+        if(_observation && _observation->report_handler) {
+            _observation->report_handler->set_under_observation(observed);
         }
+    } else {
+        delete_report_handler();
     }
 }
 
 void M2MBase::set_observation_token(const uint8_t *token, const uint8_t length)
 {
-    if(_token) {
-         free(_token);
-         _token = NULL;
-         _token_length = 0;
+    if(_observation && _observation->token) {
+        free(_observation->token);
+        _observation->token = NULL;
+        update_memory_stats(M2MMemoryStats::Tokens, -(_observation->token_length+1));
+        _observation->token_length = 0;
     }
 
     if( token != NULL && length > 0 ) {
-        _token = (uint8_t *)malloc(length+1);
-       if(_token) {
-            memset(_token, 0, length+1);
-            memcpy((uint8_t *)_token, (uint8_t *)token, length);
-            _token_length = length;
+        ObservationData *data = observation_data();
+        if(data) {
+            data->token = (uint8_t *)malloc(length+1);
+            if(data->token) {
+                memset(data->token, 0, length+1);
+                memcpy((uint8_t *)data->token, (uint8_t *)token, length);
+                data->token_length = length;
+                update_memory_stats(M2MMemoryStats::Tokens, data->token_length+1);
+            }
         }
     }
+    release_observation_data();
 }
 
 void M2MBase::set_instance_id(const uint16_t inst_id)
@@ -211,7 +206,13 @@ void M2MBase::set_instance_id(const uint16_t inst_id)
 
 void M2MBase::set_observation_number(const uint16_t observation_number)
 {
-    _observation_number = observation_number;
+    if(observation_number || _observation) {
+        ObservationData *data = observation_data();
+        if(data) {
+            data->observation_number = observation_number;
+        }
+        release_observation_data();
+    }
 }
 
 M2MBase::BaseType M2MBase::base_type() const
@@ -226,7 +227,7 @@ M2MBase::Operation M2MBase::operation() const
 
 const String& M2MBase::name() const
 {
-    return _name;
+    return M2MStringPool::string(_name);
 }
 
 int32_t M2MBase::name_id() const
@@ -241,12 +242,12 @@ uint16_t M2MBase::instance_id() const
 
 const String& M2MBase::interface_description() const
 {
-    return _interface_description;
+    return M2MStringPool::string(_interface_description);
 }
 
 const String& M2MBase::resource_type() const
 {
-    return _resource_type;
+    return M2MStringPool::string(_resource_type);
 }
 
 uint8_t M2MBase::coap_content_type() const
@@ -271,11 +272,14 @@ void M2MBase::get_observation_token(uint8_t *&token, uint32_t &token_length)
         free(token);
         token = NULL;
     }
-    token = (uint8_t *)malloc(_token_length+1);
+    uint8_t length = _observation ? _observation->token_length : 0;
+    token = (uint8_t *)malloc(length+1);
     if(token) {
-        token_length = _token_length;
-        memset(token, 0, _token_length+1);
-        memcpy((uint8_t *)token, (uint8_t *)_token, token_length);
+        token_length = length;
+        memset(token, 0, length+1);
+        if(length) {
+            memcpy((uint8_t *)token, (uint8_t *)_observation->token, token_length);
+        }
     }
 }
 
@@ -286,14 +290,37 @@ M2MBase::Mode M2MBase::mode() const
 
 uint16_t M2MBase::observation_number() const
 {
-    return _observation_number;
+    return _observation ? _observation->observation_number : 0;
+}
+
+M2MMemoryStats M2MBase::memory_stats() const
+{
+    // Computed from the node itself, names and descriptions are interned
+    // in the string pool, which is accounted once by the NSDL interface.
+    M2MMemoryStats stats;
+    stats.update(M2MMemoryStats::NodeStruct, sizeof(M2MBase));
+    if(_observation) {
+        stats.update(M2MMemoryStats::NodeStruct, sizeof(ObservationData));
+        if(_observation->token) {
+            stats.update(M2MMemoryStats::Tokens, _observation->token_length+1);
+        }
+        if(_observation->report_handler) {
+            stats.update(M2MMemoryStats::ReportHandlers, REPORT_HANDLER_MEMORY);
+        }
+    }
+    return stats;
 }
 
 bool M2MBase::handle_observation_attribute(char *&query)
 {
     bool success = false;
-    if(_report_handler) {
-        success = _report_handler->parse_notification_attribute(query,_base_type);
+    // Attributes can be written before the object is observed.
+    if(_observation_handler) {
+        create_report_handler();
+    }
+    M2MReportHandler *handler = report_handler();
+    if(handler) {
+        success = handler->parse_notification_attribute(query,_base_type);
     }
     return success;
 }
@@ -365,7 +392,7 @@ void M2MBase::memory_free(void *ptr)
 
 M2MReportHandler* M2MBase::report_handler()
 {
-    return _report_handler;
+    return _observation ? _observation->report_handler : NULL;
 }
 
 M2MObservationHandler* M2MBase::observation_handler()
@@ -373,6 +400,52 @@ M2MObservationHandler* M2MBase::observation_handler()
     return _observation_handler;
 }
 
+void M2MBase::set_memory_attached(bool attached)
+{
+    if(attached != _memory_attached) {
+        M2MMemoryStats stats = memory_stats();
+        for(int category = M2MMemoryStats::NodeStruct;
+            category <= M2MMemoryStats::ContainerSlack; category++) {
+            int32_t bytes = stats.bytes((M2MMemoryStats::Category)category);
+            if(bytes) {
+                update_owner_memory_stats((M2MMemoryStats::Category)category,
+                                          attached ? bytes : -bytes);
+            }
+        }
+        _memory_attached = attached;
+    }
+}
+
+void M2MBase::mark_memory_attached(bool attached)
+{
+    _memory_attached = attached;
+}
+
+bool M2MBase::memory_attached() const
+{
+    return _memory_attached;
+}
+
+void M2MBase::update_memory_stats(M2MMemoryStats::Category category, int32_t delta)
+{
+    if(delta && _memory_attached) {
+        update_owner_memory_stats(category, delta);
+    }
+}
+
+void M2MBase::update_owner_memory_stats(M2MMemoryStats::Category, int32_t)
+{
+}
+
+void M2MBase::update_list_memory_stats(int old_size, int old_capacity,
+                                       int new_size, int new_capacity)
+{
+    update_memory_stats(M2MMemoryStats::NodeStruct,
+                        (new_size - old_size) * (int32_t)sizeof(void*));
+    update_memory_stats(M2MMemoryStats::ContainerSlack,
+                        ((new_capacity - new_size) - (old_capacity - old_size)) * (int32_t)sizeof(void*));
+}
+
 bool M2MBase::is_integer(const String &value)
 {
     const char *s = value.c_str();
@@ -383,3 +456,64 @@ bool M2MBase::is_integer(const String &value)
     strtol(value.c_str(), &p, 10);
     return (*p == 0);
 }
+
+M2MBase::ObservationData* M2MBase::observation_data()
+{
+    if(!_observation) {
+        _observation = (ObservationData*)malloc(sizeof(ObservationData));
+        if(_observation) {
+            memset(_observation, 0, sizeof(ObservationData));
+            update_memory_stats(M2MMemoryStats::NodeStruct, sizeof(ObservationData));
+        }
+    }
+    return _observation;
+}
+
+void M2MBase::release_observation_data()
+{
+    if(_observation &&
+       !_observation->report_handler &&
+       !_observation->token &&
+       !_observation->observation_number) {
+        free(_observation);
+        _observation = NULL;
+        update_memory_stats(M2MMemoryStats::NodeStruct, -(int32_t)sizeof(ObservationData));
+    }
+}
+
+void M2MBase::create_report_handler()
+{
+    ObservationData *data = observation_data();
+    if(data && !data->report_handler) {
+        data->report_handler = new M2MReportHandler(*this);
+        update_memory_stats(M2MMemoryStats::ReportHandlers, REPORT_HANDLER_MEMORY);
+    }
+}
+
+void M2MBase::delete_report_handler()
+{
+    if(_observation && _observation->report_handler) {
+        delete _observation->report_handler;
+        _observation->report_handler = NULL;
+        update_memory_stats(M2MMemoryStats::ReportHandlers, -REPORT_HANDLER_MEMORY);
+        release_observation_data();
+    }
+}
+
+void M2MBase::copy_observation_data(const M2MBase &other)
+{
+    if(other._observation) {
+        if(other._observation->token) {
+            set_observation_token(other._observation->token,
+                                  other._observation->token_length);
+        }
+        if(other._observation->report_handler) {
+            ObservationData *data = observation_data();
+            if(data) {
+                data->report_handler = new M2MReportHandler(*other._observation->report_handler);
+                update_memory_stats(M2MMemoryStats::ReportHandlers, REPORT_HANDLER_MEMORY);
+            }
+        }
+        set_observation_number(other._observation->observation_number);
+    }
+}
@@ -0,0 +1,416 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "mbed-client/m2mcoaptcpframer.h"
+#include "ns_trace.h"
+
+#define COAP_VERSION                0x40
+#define COAP_TYPE_CONFIRMABLE       0
+#define COAP_TYPE_NON_CONFIRMABLE   1
+#define COAP_TYPE_ACKNOWLEDGEMENT   2
+#define COAP_TYPE_RESET             3
+#define COAP_UDP_HEADER_LENGTH      4
+#define COAP_MAX_TOKEN_LENGTH       8
+#define COAP_PAYLOAD_MARKER         0xFF
+
+// Signaling codes, class 7 (RFC 8323 section 5).
+#define COAP_SIGNAL_CSM             0xE1
+#define COAP_SIGNAL_PING            0xE2
+#define COAP_SIGNAL_PONG            0xE3
+#define COAP_SIGNAL_RELEASE         0xE4
+#define COAP_SIGNAL_ABORT           0xE5
+#define COAP_OPTION_MAX_MESSAGE_SIZE 2
+
+// Largest frame header: length byte, 4 extended length bytes and code.
+#define FRAME_HEADER_MAX            6
+#define CSM_FRAME_LENGTH            5
+#define DEFAULT_MAX_MESSAGE_SIZE    1152
+
+M2MCoapTcpFramer::M2MCoapTcpFramer(uint16_t max_message_size)
+: _max_message_size(max_message_size),
+  _stream(NULL),
+  _stream_length(0),
+  _stream_capacity(max_message_size + FRAME_HEADER_MAX),
+  _output(NULL),
+  _message(NULL),
+  _ping_msg_id(0),
+  _next_msg_id(1)
+{
+    _stream = (uint8_t*)malloc(_stream_capacity);
+    _output = (uint8_t*)malloc(CSM_FRAME_LENGTH + max_message_size + FRAME_HEADER_MAX);
+    _message = (uint8_t*)malloc(max_message_size + FRAME_HEADER_MAX + COAP_UDP_HEADER_LENGTH);
+    if(!_stream || !_output || !_message) {
+        tr_error("M2MCoapTcpFramer::M2MCoapTcpFramer() - out of memory");
+        _stream_capacity = 0;
+        _max_message_size = 0;
+    }
+    reset();
+}
+
+M2MCoapTcpFramer::~M2MCoapTcpFramer()
+{
+    free(_stream);
+    free(_output);
+    free(_message);
+}
+
+void M2MCoapTcpFramer::reset()
+{
+    _stream_length = 0;
+    _signal_length = 0;
+    memset(_exchanges, 0, sizeof(_exchanges));
+    _exchange_next = 0;
+    _sent_count = 0;
+    _sent_next = 0;
+    _local_ack_count = 0;
+    _ping_pending = false;
+    _peer_max_message_size = DEFAULT_MAX_MESSAGE_SIZE;
+    _csm_sent = false;
+    _failed = false;
+}
+
+const uint8_t* M2MCoapTcpFramer::encode(const uint8_t *message,
+                                        uint16_t length,
+                                        uint16_t &frame_length)
+{
+    frame_length = 0;
+    if(!message || length < COAP_UDP_HEADER_LENGTH ||
+       (message[0] & 0xC0) != COAP_VERSION || length > _max_message_size) {
+        tr_error("M2MCoapTcpFramer::encode() - invalid message");
+        return NULL;
+    }
+    uint8_t type = (message[0] >> 4) & 0x03;
+    uint8_t token_length = message[0] & 0x0F;
+    uint8_t code = message[1];
+    uint16_t msg_id = (message[2] << 8) | message[3];
+    if(token_length > COAP_MAX_TOKEN_LENGTH ||
+       length < COAP_UDP_HEADER_LENGTH + token_length) {
+        tr_error("M2MCoapTcpFramer::encode() - invalid token");
+        return NULL;
+    }
+    const uint8_t *token = message + COAP_UDP_HEADER_LENGTH;
+
+    // A CoAP ping becomes a Ping signal, its Pong is handed back as
+    // the reset a UDP peer would answer with. Other empty messages
+    // only serve the UDP reliability layer.
+    bool ping = (0 == code && COAP_TYPE_CONFIRMABLE == type);
+    if(ping) {
+        if(_ping_pending && msg_id == _ping_msg_id) {
+            return NULL;
+        }
+        _ping_pending = true;
+        _ping_msg_id = msg_id;
+        code = COAP_SIGNAL_PING;
+        token_length = 0;
+        length = COAP_UDP_HEADER_LENGTH;
+    } else if(0 == code || COAP_TYPE_RESET == type) {
+        return NULL;
+    }
+    if(COAP_TYPE_CONFIRMABLE == type && !ping) {
+        if(was_sent(msg_id)) {
+            tr_debug("M2MCoapTcpFramer::encode() - retransmission of %d dropped", msg_id);
+            return NULL;
+        }
+        _sent[_sent_next] = msg_id;
+        _sent_next = (_sent_next + 1) % SENT_HISTORY;
+        if(_sent_count < SENT_HISTORY) {
+            _sent_count++;
+        }
+        if(code < 32) {
+            // Request, the response is matched back by its token.
+            Exchange &exchange = _exchanges[_exchange_next];
+            _exchange_next = (_exchange_next + 1) % MAX_EXCHANGES;
+            exchange.msg_id = msg_id;
+            exchange.token_length = token_length;
+            memcpy(exchange.token, token, token_length);
+            exchange.in_use = true;
+        } else if(_local_ack_count < MAX_LOCAL_ACKS) {
+            // Notification, delivery is guaranteed by the stream.
+            _local_acks[_local_ack_count++] = msg_id;
+        }
+    }
+
+    // Each side starts the connection with a CSM carrying Max-Message-Size.
+    uint8_t *frame = _output;
+    if(!_csm_sent) {
+        frame += write_frame_header(frame, 3, 0, COAP_SIGNAL_CSM);
+        *frame++ = (COAP_OPTION_MAX_MESSAGE_SIZE << 4) | 2;
+        *frame++ = _max_message_size >> 8;
+        *frame++ = _max_message_size & 0xFF;
+        _csm_sent = true;
+    }
+    uint32_t body_length = length - COAP_UDP_HEADER_LENGTH - token_length;
+    frame += write_frame_header(frame, body_length, token_length, code);
+    memcpy(frame, token, token_length + body_length);
+    frame_length = (frame - _output) + token_length + body_length;
+    return _output;
+}
+
+uint16_t M2MCoapTcpFramer::feed(const uint8_t *data, uint16_t length)
+{
+    uint32_t room = _stream_capacity - _stream_length;
+    uint16_t taken = (length < room) ? length : room;
+    if(taken) {
+        memcpy(_stream + _stream_length, data, taken);
+        _stream_length += taken;
+    }
+    return taken;
+}
+
+const uint8_t* M2MCoapTcpFramer::next_message(uint16_t &length)
+{
+    length = 0;
+    if(_local_ack_count) {
+        uint16_t msg_id = _local_acks[0];
+        _local_ack_count--;
+        memmove(_local_acks, _local_acks + 1, _local_ack_count * sizeof(uint16_t));
+        _message[0] = COAP_VERSION | (COAP_TYPE_ACKNOWLEDGEMENT << 4);
+        _message[1] = 0;
+        _message[2] = msg_id >> 8;
+        _message[3] = msg_id & 0xFF;
+        length = COAP_UDP_HEADER_LENGTH;
+        return _message;
+    }
+
+    while(!_failed && _stream_length) {
+        uint32_t header_length = 0;
+        uint32_t body_length = 0;
+        FrameStatus status = frame_length(_stream, _stream_length, header_length, body_length);
+        if(FrameIncomplete == status) {
+            return NULL;
+        }
+        uint8_t token_length = _stream[0] & 0x0F;
+        uint32_t total = header_length + token_length + body_length;
+        if(FrameInvalid == status || token_length > COAP_MAX_TOKEN_LENGTH ||
+           total > _stream_capacity) {
+            tr_error("M2MCoapTcpFramer::next_message() - invalid frame");
+            _failed = true;
+            return NULL;
+        }
+        if(_stream_length < total) {
+            return NULL;
+        }
+
+        uint8_t code = _stream[header_length - 1];
+        const uint8_t *token = _stream + header_length;
+        const uint8_t *body = token + token_length;
+        bool message = false;
+        if((code >> 5) == 7) {
+            if(!handle_signal(code, token, token_length, body, body_length)) {
+                _failed = true;
+            } else if(COAP_SIGNAL_PONG == code && _ping_pending) {
+                _ping_pending = false;
+                _message[0] = COAP_VERSION | (COAP_TYPE_RESET << 4);
+                _message[1] = 0;
+                _message[2] = _ping_msg_id >> 8;
+                _message[3] = _ping_msg_id & 0xFF;
+                length = COAP_UDP_HEADER_LENGTH;
+                message = true;
+            }
+        } else if(code) {
+            uint8_t type = COAP_TYPE_CONFIRMABLE;
+            uint16_t msg_id = _next_msg_id++;
+            if(code >= 64) {
+                for(uint8_t i = 0; i < MAX_EXCHANGES; i++) {
+                    Exchange &exchange = _exchanges[i];
+                    if(exchange.in_use && exchange.token_length == token_length &&
+                       0 == memcmp(exchange.token, token, token_length)) {
+                        type = COAP_TYPE_ACKNOWLEDGEMENT;
+                        msg_id = exchange.msg_id;
+                        exchange.in_use = false;
+                        break;
+                    }
+                }
+            }
+            _message[0] = COAP_VERSION | (type << 4) | token_length;
+            _message[1] = code;
+            _message[2] = msg_id >> 8;
+            _message[3] = msg_id & 0xFF;
+            memcpy(_message + COAP_UDP_HEADER_LENGTH, token, token_length + body_length);
+            length = COAP_UDP_HEADER_LENGTH + token_length + body_length;
+            message = true;
+        }
+        // Empty messages carry no meaning on TCP and are skipped.
+        _stream_length -= total;
+        memmove(_stream, _stream + total, _stream_length);
+        if(message) {
+            return _message;
+        }
+    }
+    return NULL;
+}
+
+const uint8_t* M2MCoapTcpFramer::next_signal(uint16_t &frame_length)
+{
+    frame_length = _signal_length;
+    _signal_length = 0;
+    return frame_length ? _signal : NULL;
+}
+
+bool M2MCoapTcpFramer::failed() const
+{
+    return _failed;
+}
+
+uint32_t M2MCoapTcpFramer::peer_max_message_size() const
+{
+    return _peer_max_message_size;
+}
+
+M2MCoapTcpFramer::FrameStatus M2MCoapTcpFramer::frame_length(const uint8_t *data,
+                                                             uint32_t available,
+                                                             uint32_t &header_length,
+                                                             uint32_t &body_length) const
+{
+    uint8_t length = data[0] >> 4;
+    uint8_t extended = (length < 13) ? 0 : ((length == 13) ? 1 : ((length == 14) ? 2 : 4));
+    header_length = 1 + extended + 1;
+    body_length = 0;
+    if(available < header_length) {
+        return FrameIncomplete;
+    }
+    const uint8_t *ext = data + 1;
+    uint32_t value = 0;
+    uint32_t offset = 0;
+    switch(length) {
+        case 13:
+            value = ext[0];
+            offset = 13;
+            break;
+        case 14:
+            value = (ext[0] << 8) | ext[1];
+            offset = 269;
+            break;
+        case 15:
+            value = ((uint32_t)ext[0] << 24) | ((uint32_t)ext[1] << 16) |
+                    ((uint32_t)ext[2] << 8) | ext[3];
+            offset = 65805;
+            break;
+        default:
+            value = length;
+            break;
+    }
+    // Bounded before the offset is added, a 32-bit extended length
+    // could otherwise wrap around to a small value.
+    if(value > _max_message_size || offset > (uint32_t)_max_message_size - value) {
+        tr_error("M2MCoapTcpFramer::frame_length() - frame too large");
+        return FrameInvalid;
+    }
+    body_length = value + offset;
+    return FrameComplete;
+}
+
+uint16_t M2MCoapTcpFramer::write_frame_header(uint8_t *frame,
+                                              uint32_t body_length,
+                                              uint8_t token_length,
+                                              uint8_t code) const
+{
+    uint16_t index = 1;
+    if(body_length < 13) {
+        frame[0] = (body_length << 4) | token_length;
+    } else if(body_length < 269) {
+        frame[0] = (13 << 4) | token_length;
+        frame[index++] = body_length - 13;
+    } else if(body_length < 65805) {
+        frame[0] = (14 << 4) | token_length;
+        frame[index++] = (body_length - 269) >> 8;
+        frame[index++] = (body_length - 269) & 0xFF;
+    } else {
+        uint32_t value = body_length - 65805;
+        frame[0] = (15 << 4) | token_length;
+        frame[index++] = value >> 24;
+        frame[index++] = (value >> 16) & 0xFF;
+        frame[index++] = (value >> 8) & 0xFF;
+        frame[index++] = value & 0xFF;
+    }
+    frame[index++] = code;
+    return index;
+}
+
+bool M2MCoapTcpFramer::handle_signal(uint8_t code,
+                                     const uint8_t *token,
+                                     uint8_t token_length,
+                                     const uint8_t *options,
+                                     uint32_t options_length)
+{
+    switch(code) {
+        case COAP_SIGNAL_CSM: {
+            uint32_t index = 0;
+            uint16_t number = 0;
+            while(index < options_length && options[index] != COAP_PAYLOAD_MARKER) {
+                uint16_t delta = options[index] >> 4;
+                uint16_t length = options[index] & 0x0F;
+                index++;
+                uint8_t extended = ((delta == 13) ? 1 : 0) + ((delta == 14) ? 2 : 0) +
+                                   ((length == 13) ? 1 : 0) + ((length == 14) ? 2 : 0);
+                if(delta == 15 || length == 15 || index + extended > options_length) {
+                    return false;
+                }
+                if(delta == 13) {
+                    delta = options[index++] + 13;
+                } else if(delta == 14) {
+                    delta = ((options[index] << 8) | options[index + 1]) + 269;
+                    index += 2;
+                }
+                if(length == 13) {
+                    length = options[index++] + 13;
+                } else if(length == 14) {
+                    length = ((options[index] << 8) | options[index + 1]) + 269;
+                    index += 2;
+                }
+                if(index + length > options_length) {
+                    return false;
+                }
+                number += delta;
+                if(COAP_OPTION_MAX_MESSAGE_SIZE == number && length <= 4) {
+                    _peer_max_message_size = 0;
+                    for(uint16_t i = 0; i < length; i++) {
+                        _peer_max_message_size = (_peer_max_message_size << 8) | options[index + i];
+                    }
+                }
+                index += length;
+            }
+            tr_debug("M2MCoapTcpFramer::handle_signal() - peer max message size %lu",
+                     (unsigned long)_peer_max_message_size);
+            return true;
+        }
+        case COAP_SIGNAL_PING:
+            _signal_length = write_frame_header(_signal, 0, token_length, COAP_SIGNAL_PONG);
+            memcpy(_signal + _signal_length, token, token_length);
+            _signal_length += token_length;
+            return true;
+        case COAP_SIGNAL_PONG:
+            return true;
+        case COAP_SIGNAL_RELEASE:
+        case COAP_SIGNAL_ABORT:
+            tr_debug("M2MCoapTcpFramer::handle_signal() - connection closed by peer");
+            return false;
+        default:
+            // Unknown signals without critical options can be ignored.
+            return true;
+    }
+}
+
+bool M2MCoapTcpFramer::was_sent(uint16_t msg_id) const
+{
+    for(uint8_t i = 0; i < _sent_count; i++) {
+        if(_sent[i] == msg_id) {
+            return true;
+        }
+    }
+    return false;
+}
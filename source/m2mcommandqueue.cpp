@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "mbed-client/m2mcommandqueue.h"
+#include "mbed-client/m2mresourceinstance.h"
+#include "include/m2matomic.h"
+#include "ns_trace.h"
+
+// The queue is an intrusive multi-producer single-consumer list. Producers
+// only swap the head pointer, the consumer alone walks the list from the
+// tail, so no lock is taken on either side.
+
+M2MCommandQueue::M2MCommandQueue()
+: _head(&_stub),
+  _tail(&_stub)
+{
+    memset(&_stub, 0, sizeof(_stub));
+}
+
+M2MCommandQueue::~M2MCommandQueue()
+{
+    Command *command = pop();
+    while(command) {
+        free(command);
+        command = pop();
+    }
+}
+
+bool M2MCommandQueue::post_value(M2MResourceInstance *resource,
+                                 const uint8_t *value,
+                                 const uint32_t value_length)
+{
+    if(!resource || !value || !value_length) {
+        return false;
+    }
+    Command *command = (Command*)malloc(offsetof(Command, value) + value_length);
+    if(!command) {
+        tr_error("M2MCommandQueue::post_value() - out of memory");
+        return false;
+    }
+    command->type = SetValue;
+    command->target = resource;
+    command->function = NULL;
+    command->argument = NULL;
+    command->value_length = value_length;
+    memcpy(command->value, value, value_length);
+    push(command);
+    return true;
+}
+
+bool M2MCommandQueue::post_call(command_function function,
+                                void *argument,
+                                M2MBase *target)
+{
+    if(!function) {
+        return false;
+    }
+    Command *command = (Command*)malloc(sizeof(Command));
+    if(!command) {
+        tr_error("M2MCommandQueue::post_call() - out of memory");
+        return false;
+    }
+    command->type = Call;
+    command->target = target;
+    command->function = function;
+    command->argument = argument;
+    command->value_length = 0;
+    push(command);
+    return true;
+}
+
+uint32_t M2MCommandQueue::process(uint32_t max_commands)
+{
+    uint32_t count = 0;
+    while(!max_commands || count < max_commands) {
+        Command *command = pop();
+        if(!command) {
+            break;
+        }
+        apply(command);
+        free(command);
+        count++;
+    }
+    if(count) {
+        tr_debug("M2MCommandQueue::process() - applied %d commands", count);
+    }
+    return count;
+}
+
+void M2MCommandQueue::cancel(M2MBase *target)
+{
+    // Only the consumer walks the list, producers never touch
+    // the commands after linking them.
+    Command *command = _tail;
+    while(command) {
+        if(command != &_stub && command->target == target) {
+            command->target = NULL;
+            command->function = NULL;
+        }
+        command = m2m_atomic_load(&command->next);
+    }
+}
+
+void M2MCommandQueue::push(Command *command)
+{
+    command->next = NULL;
+    Command *previous = m2m_atomic_exchange(&_head, command);
+    // Between the exchange and this store the list is briefly broken,
+    // the consumer sees it as empty from that point on.
+    m2m_atomic_store(&previous->next, command);
+}
+
+M2MCommandQueue::Command* M2MCommandQueue::pop()
+{
+    Command *tail = _tail;
+    Command *next = m2m_atomic_load(&tail->next);
+    if(tail == &_stub) {
+        if(!next) {
+            return NULL;
+        }
+        _tail = next;
+        tail = next;
+        next = m2m_atomic_load(&tail->next);
+    }
+    if(next) {
+        _tail = next;
+        return tail;
+    }
+    if(tail != m2m_atomic_load(&_head)) {
+        // A producer is in the middle of posting.
+        return NULL;
+    }
+    // Last command in the list, put the stub behind it to release it.
+    push(&_stub);
+    next = m2m_atomic_load(&tail->next);
+    if(next) {
+        _tail = next;
+        return tail;
+    }
+    return NULL;
+}
+
+void M2MCommandQueue::apply(Command *command)
+{
+    switch(command->type) {
+        case SetValue:
+            if(command->target) {
+                ((M2MResourceInstance*)command->target)->set_value(command->value,
+                                                                   command->value_length);
+            }
+            break;
+        case Call:
+            if(command->function) {
+                command->function(command->argument);
+            }
+            break;
+    }
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "mbed-client/m2mdnscache.h"
+#include "ns_trace.h"
+
+M2MDnsCache::M2MDnsCache(uint8_t entries, uint32_t max_ttl)
+: _capacity(entries),
+  _max_ttl(max_ttl),
+  _use_counter(0)
+{
+    memset(&_stats, 0, sizeof(_stats));
+    _entries = (Entry*)calloc(_capacity, sizeof(Entry));
+    if(!_entries) {
+        tr_error("M2MDnsCache::M2MDnsCache() - out of memory");
+        _capacity = 0;
+    }
+}
+
+M2MDnsCache::~M2MDnsCache()
+{
+    clear();
+    free(_entries);
+}
+
+bool M2MDnsCache::store(const char *host,
+                        const M2MDnsCache::Address *addresses,
+                        uint8_t count,
+                        uint32_t ttl,
+                        uint32_t now)
+{
+    if(!_capacity || !host || !*host || !addresses || !ttl) {
+        return false;
+    }
+    Address valid[MAX_ADDRESSES];
+    uint8_t valid_count = 0;
+    for(uint8_t i = 0; i < count && valid_count < MAX_ADDRESSES; i++) {
+        if(4 == addresses[i].length || 16 == addresses[i].length) {
+            valid[valid_count++] = addresses[i];
+        }
+    }
+    if(!valid_count) {
+        return false;
+    }
+    int index = find(host);
+    if(index < 0) {
+        index = 0;
+        for(uint8_t i = 0; i < _capacity; i++) {
+            if(!_entries[i].host) {
+                index = i;
+                break;
+            }
+            if(_entries[i].used < _entries[index].used) {
+                index = i;
+            }
+        }
+        Entry &entry = _entries[index];
+        if(entry.host) {
+            tr_debug("M2MDnsCache::store() - evicting %s", entry.host);
+            release(entry);
+        }
+        size_t length = strlen(host) + 1;
+        entry.host = (char*)malloc(length);
+        if(!entry.host) {
+            return false;
+        }
+        memcpy(entry.host, host, length);
+    }
+    Entry &entry = _entries[index];
+    // A refreshed entry keeps the address that connected last.
+    Address winner;
+    bool had_winner = entry.winner < entry.count;
+    if(had_winner) {
+        winner = entry.addresses[entry.winner];
+    }
+    memcpy(entry.addresses, valid, sizeof(valid));
+    entry.count = valid_count;
+    entry.winner = valid_count;
+    if(had_winner) {
+        connected(host, winner);
+    }
+    entry.expires = (ttl < _max_ttl) ? ttl : _max_ttl;
+    entry.stored = now;
+    entry.used = ++_use_counter;
+    return true;
+}
+
+uint8_t M2MDnsCache::lookup(const char *host,
+                            uint32_t now,
+                            M2MDnsCache::Address *addresses,
+                            uint8_t max_count)
+{
+    int index = find(host);
+    if(index < 0) {
+        _stats.misses++;
+        return 0;
+    }
+    Entry &entry = _entries[index];
+    if(now - entry.stored >= entry.expires) {
+        tr_debug("M2MDnsCache::lookup() - %s expired", host);
+        _stats.expired++;
+        _stats.misses++;
+        release(entry);
+        return 0;
+    }
+    _stats.hits++;
+    entry.used = ++_use_counter;
+
+    // Split per family, keeping the resolver order except for the winner.
+    uint8_t order[2][MAX_ADDRESSES];
+    uint8_t family_count[2] = { 0, 0 };     // IPv6, IPv4.
+    uint8_t preferred = 0;
+    if(entry.winner < entry.count) {
+        preferred = (4 == entry.addresses[entry.winner].length) ? 1 : 0;
+        order[preferred][family_count[preferred]++] = entry.winner;
+    }
+    for(uint8_t i = 0; i < entry.count; i++) {
+        if(i != entry.winner) {
+            uint8_t family = (4 == entry.addresses[i].length) ? 1 : 0;
+            order[family][family_count[family]++] = i;
+        }
+    }
+    if(!family_count[preferred]) {
+        preferred = 1 - preferred;
+    }
+
+    // Interleave the families, starting with the preferred one.
+    uint8_t returned = 0;
+    uint8_t next[2] = { 0, 0 };
+    uint8_t family = preferred;
+    while(returned < max_count &&
+          (next[0] < family_count[0] || next[1] < family_count[1])) {
+        if(next[family] < family_count[family]) {
+            addresses[returned++] = entry.addresses[order[family][next[family]++]];
+        }
+        family = 1 - family;
+    }
+    return returned;
+}
+
+void M2MDnsCache::connected(const char *host, const M2MDnsCache::Address &address)
+{
+    int index = find(host);
+    if(index < 0) {
+        return;
+    }
+    Entry &entry = _entries[index];
+    for(uint8_t i = 0; i < entry.count; i++) {
+        if(entry.addresses[i].length == address.length &&
+           memcmp(entry.addresses[i].address, address.address, address.length) == 0) {
+            entry.winner = i;
+            break;
+        }
+    }
+}
+
+void M2MDnsCache::remove(const char *host)
+{
+    int index = find(host);
+    if(index >= 0) {
+        release(_entries[index]);
+    }
+}
+
+void M2MDnsCache::clear()
+{
+    for(uint8_t i = 0; i < _capacity; i++) {
+        release(_entries[i]);
+    }
+}
+
+uint8_t M2MDnsCache::count() const
+{
+    uint8_t count = 0;
+    for(uint8_t i = 0; i < _capacity; i++) {
+        if(_entries[i].host) {
+            count++;
+        }
+    }
+    return count;
+}
+
+const M2MDnsCache::Stats& M2MDnsCache::stats() const
+{
+    return _stats;
+}
+
+int M2MDnsCache::find(const char *host) const
+{
+    if(!host) {
+        return -1;
+    }
+    for(uint8_t i = 0; i < _capacity; i++) {
+        if(_entries[i].host && strcmp(_entries[i].host, host) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void M2MDnsCache::release(Entry &entry)
+{
+    free(entry.host);
+    memset(&entry, 0, sizeof(entry));
+}
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "mbed-client/m2mdtlssessioncache.h"
+#include "ns_trace.h"
+
+// The session holds the master secret, so it is wiped before it is freed.
+static void wipe(uint8_t *data, uint16_t length)
+{
+    volatile uint8_t *p = data;
+    while(length--) {
+        *p++ = 0;
+    }
+}
+
+M2MDtlsSessionCache::M2MDtlsSessionCache(uint8_t entries, uint32_t lifetime)
+: _capacity(entries),
+  _lifetime(lifetime),
+  _use_counter(0)
+{
+    memset(&_stats, 0, sizeof(_stats));
+    _entries = (Entry*)calloc(_capacity, sizeof(Entry));
+    if(!_entries) {
+        tr_error("M2MDtlsSessionCache::M2MDtlsSessionCache() - out of memory");
+        _capacity = 0;
+    }
+}
+
+M2MDtlsSessionCache::~M2MDtlsSessionCache()
+{
+    clear();
+    free(_entries);
+}
+
+bool M2MDtlsSessionCache::store_session(const uint8_t *peer,
+                                        uint16_t peer_length,
+                                        const uint8_t *session,
+                                        uint16_t session_length,
+                                        uint32_t now)
+{
+    if(!_capacity || !peer || !peer_length || !session || !session_length) {
+        return false;
+    }
+    int index = find(peer, peer_length);
+    if(index < 0) {
+        index = 0;
+        for(uint8_t i = 0; i < _capacity; i++) {
+            if(!_entries[i].peer) {
+                index = i;
+                break;
+            }
+            if(_entries[i].used < _entries[index].used) {
+                index = i;
+            }
+        }
+        Entry &entry = _entries[index];
+        if(entry.peer) {
+            tr_debug("M2MDtlsSessionCache::store_session() - evicting a session");
+            release(entry);
+        }
+        entry.peer = (uint8_t*)malloc(peer_length);
+        if(!entry.peer) {
+            return false;
+        }
+        memcpy(entry.peer, peer, peer_length);
+        entry.peer_length = peer_length;
+    }
+    Entry &entry = _entries[index];
+    uint8_t *copy = (uint8_t*)malloc(session_length);
+    if(!copy) {
+        release(entry);
+        return false;
+    }
+    memcpy(copy, session, session_length);
+    if(entry.session) {
+        wipe(entry.session, entry.session_length);
+        free(entry.session);
+    }
+    entry.session = copy;
+    entry.session_length = session_length;
+    entry.stored = now;
+    entry.used = ++_use_counter;
+    return true;
+}
+
+const uint8_t* M2MDtlsSessionCache::session(const uint8_t *peer,
+                                            uint16_t peer_length,
+                                            uint32_t now,
+                                            uint16_t &session_length)
+{
+    session_length = 0;
+    int index = find(peer, peer_length);
+    if(index < 0) {
+        return NULL;
+    }
+    Entry &entry = _entries[index];
+    if(now - entry.stored >= _lifetime) {
+        tr_debug("M2MDtlsSessionCache::session() - session expired");
+        _stats.expired_sessions++;
+        release(entry);
+        return NULL;
+    }
+    entry.used = ++_use_counter;
+    session_length = entry.session_length;
+    return entry.session;
+}
+
+bool M2MDtlsSessionCache::set_connection_id(const uint8_t *peer,
+                                            uint16_t peer_length,
+                                            const uint8_t *cid,
+                                            uint8_t cid_length)
+{
+    int index = find(peer, peer_length);
+    if(index < 0 || cid_length > MAX_CID_LENGTH || (cid_length && !cid)) {
+        return false;
+    }
+    Entry &entry = _entries[index];
+    if(cid_length) {
+        memcpy(entry.cid, cid, cid_length);
+    }
+    entry.cid_length = cid_length;
+    return true;
+}
+
+const uint8_t* M2MDtlsSessionCache::connection_id(const uint8_t *peer,
+                                                  uint16_t peer_length,
+                                                  uint8_t &cid_length) const
+{
+    cid_length = 0;
+    int index = find(peer, peer_length);
+    if(index < 0 || !_entries[index].cid_length) {
+        return NULL;
+    }
+    cid_length = _entries[index].cid_length;
+    return _entries[index].cid;
+}
+
+void M2MDtlsSessionCache::remove_session(const uint8_t *peer, uint16_t peer_length)
+{
+    int index = find(peer, peer_length);
+    if(index >= 0) {
+        release(_entries[index]);
+    }
+}
+
+void M2MDtlsSessionCache::handshake_completed(bool resumed)
+{
+    if(resumed) {
+        _stats.resumed_handshakes++;
+    } else {
+        _stats.full_handshakes++;
+    }
+}
+
+void M2MDtlsSessionCache::session_rejected(const uint8_t *peer, uint16_t peer_length)
+{
+    tr_debug("M2MDtlsSessionCache::session_rejected()");
+    _stats.rejected_sessions++;
+    remove_session(peer, peer_length);
+}
+
+void M2MDtlsSessionCache::clear()
+{
+    for(uint8_t i = 0; i < _capacity; i++) {
+        release(_entries[i]);
+    }
+}
+
+uint8_t M2MDtlsSessionCache::count() const
+{
+    uint8_t count = 0;
+    for(uint8_t i = 0; i < _capacity; i++) {
+        if(_entries[i].peer) {
+            count++;
+        }
+    }
+    return count;
+}
+
+const M2MDtlsSessionCache::Stats& M2MDtlsSessionCache::stats() const
+{
+    return _stats;
+}
+
+int M2MDtlsSessionCache::find(const uint8_t *peer, uint16_t peer_length) const
+{
+    if(!peer || !peer_length) {
+        return -1;
+    }
+    for(uint8_t i = 0; i < _capacity; i++) {
+        if(_entries[i].peer && _entries[i].peer_length == peer_length &&
+           memcmp(_entries[i].peer, peer, peer_length) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void M2MDtlsSessionCache::release(Entry &entry)
+{
+    if(entry.session) {
+        wipe(entry.session, entry.session_length);
+    }
+    free(entry.session);
+    free(entry.peer);
+    wipe(entry.cid, sizeof(entry.cid));
+    memset(&entry, 0, sizeof(entry));
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifdef __linux__
+
+#include <time.h>
+#include "mbed-client/m2mdtlstimer.h"
+#include "ns_trace.h"
+
+M2MDtlsTimer::M2MDtlsTimer(M2MReactor &reactor, M2MTimerObserver &observer)
+: _reactor(reactor),
+  _observer(observer),
+  _intermediate(0),
+  _final(0)
+{
+    _timer_fd = _reactor.add_timer(this);
+    if(_timer_fd < 0) {
+        tr_error("M2MDtlsTimer::M2MDtlsTimer() - cannot create timer");
+    }
+}
+
+M2MDtlsTimer::~M2MDtlsTimer()
+{
+    if(_timer_fd >= 0) {
+        _reactor.remove_timer(_timer_fd);
+    }
+}
+
+bool M2MDtlsTimer::is_valid() const
+{
+    return _timer_fd >= 0;
+}
+
+void M2MDtlsTimer::set_delay(void *timer, uint32_t intermediate_ms, uint32_t final_ms)
+{
+    M2MDtlsTimer *self = (M2MDtlsTimer*)timer;
+    uint64_t start = now();
+    // The final deadline is published last, get_delay() reads it first.
+    __atomic_store_n(&self->_final, (uint64_t)0, __ATOMIC_RELEASE);
+    if(final_ms == 0) {
+        __atomic_store_n(&self->_intermediate, (uint64_t)0, __ATOMIC_RELEASE);
+        if(self->_timer_fd >= 0) {
+            self->_reactor.start_timer(self->_timer_fd, 0, true);
+        }
+        return;
+    }
+    __atomic_store_n(&self->_intermediate, start + intermediate_ms, __ATOMIC_RELEASE);
+    __atomic_store_n(&self->_final, start + final_ms, __ATOMIC_RELEASE);
+    if(self->_timer_fd >= 0) {
+        self->_reactor.start_timer(self->_timer_fd, final_ms, true);
+    }
+}
+
+int M2MDtlsTimer::get_delay(void *timer)
+{
+    M2MDtlsTimer *self = (M2MDtlsTimer*)timer;
+    uint64_t final_deadline = __atomic_load_n(&self->_final, __ATOMIC_ACQUIRE);
+    if(final_deadline == 0) {
+        return -1;
+    }
+    uint64_t current = now();
+    if(current >= final_deadline) {
+        return 2;
+    }
+    if(current >= __atomic_load_n(&self->_intermediate, __ATOMIC_ACQUIRE)) {
+        return 1;
+    }
+    return 0;
+}
+
+void M2MDtlsTimer::io_ready(int /*fd*/, uint32_t /*events*/)
+{
+}
+
+void M2MDtlsTimer::timer_expired(int /*timer_fd*/, uint64_t /*expirations*/)
+{
+    // A cancel or restart racing with the expiry leaves nothing to report.
+    if(get_delay(this) == 2) {
+        tr_debug("M2MDtlsTimer::timer_expired()");
+        _observer.timer_expired(M2MTimerObserver::Dtls);
+    }
+}
+
+uint64_t M2MDtlsTimer::now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+#endif // __linux__
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include "mbed-client/m2mhappyeyeballs.h"
+#include "ns_trace.h"
+
+#ifndef UINT32_MAX
+#define UINT32_MAX 0xFFFFFFFFU
+#endif
+
+M2MHappyEyeballs::M2MHappyEyeballs(uint32_t attempt_delay)
+: _count(0),
+  _started(0),
+  _winner(-1),
+  _state(Idle),
+  _attempt_delay(attempt_delay),
+  _last_start(0)
+{
+    memset(_addresses, 0, sizeof(_addresses));
+    memset(_attempts, 0, sizeof(_attempts));
+}
+
+M2MHappyEyeballs::~M2MHappyEyeballs()
+{
+}
+
+void M2MHappyEyeballs::start(const M2MDnsCache::Address *addresses, uint8_t count, uint32_t now)
+{
+    if(count > M2MDnsCache::MAX_ADDRESSES) {
+        count = M2MDnsCache::MAX_ADDRESSES;
+    }
+    _count = addresses ? count : 0;
+    if(_count) {
+        memcpy(_addresses, addresses, _count * sizeof(M2MDnsCache::Address));
+    }
+    memset(_attempts, NotStarted, sizeof(_attempts));
+    _started = 0;
+    _winner = -1;
+    _last_start = now;
+    _state = _count ? Connecting : Failed;
+}
+
+int M2MHappyEyeballs::next_attempt(uint32_t now)
+{
+    if(Connecting != _state || _started >= _count) {
+        return -1;
+    }
+    if(time_to_next_attempt(now)) {
+        return -1;
+    }
+    uint8_t index = _started++;
+    _attempts[index] = InProgress;
+    _last_start = now;
+    tr_debug("M2MHappyEyeballs::next_attempt() - attempt %d, IPv%d",
+             index, (4 == _addresses[index].length) ? 4 : 6);
+    return index;
+}
+
+uint32_t M2MHappyEyeballs::time_to_next_attempt(uint32_t now) const
+{
+    if(Connecting != _state || _started >= _count) {
+        return UINT32_MAX;
+    }
+    if(!_started) {
+        return 0;
+    }
+    for(uint8_t i = 0; i < _started; i++) {
+        if(InProgress == _attempts[i]) {
+            uint32_t elapsed = now - _last_start;
+            return (elapsed >= _attempt_delay) ? 0 : _attempt_delay - elapsed;
+        }
+    }
+    // Every started attempt failed, no reason to wait.
+    return 0;
+}
+
+void M2MHappyEyeballs::attempt_failed(uint8_t index, uint32_t /*now*/)
+{
+    if(index >= _started || InProgress != _attempts[index]) {
+        return;
+    }
+    _attempts[index] = Done;
+    update_state();
+}
+
+void M2MHappyEyeballs::attempt_connected(uint8_t index)
+{
+    if(Connecting != _state || index >= _started || InProgress != _attempts[index]) {
+        return;
+    }
+    tr_debug("M2MHappyEyeballs::attempt_connected() - attempt %d won", index);
+    _attempts[index] = Done;
+    _winner = index;
+    _state = Connected;
+}
+
+bool M2MHappyEyeballs::in_progress(uint8_t index) const
+{
+    return index < _started && InProgress == _attempts[index];
+}
+
+M2MHappyEyeballs::State M2MHappyEyeballs::state() const
+{
+    return _state;
+}
+
+const M2MDnsCache::Address* M2MHappyEyeballs::address(uint8_t index) const
+{
+    return (index < _count) ? &_addresses[index] : NULL;
+}
+
+int M2MHappyEyeballs::winner() const
+{
+    return _winner;
+}
+
+void M2MHappyEyeballs::update_state()
+{
+    if(Connecting != _state || _started < _count) {
+        return;
+    }
+    for(uint8_t i = 0; i < _count; i++) {
+        if(InProgress == _attempts[i]) {
+            return;
+        }
+    }
+    tr_debug("M2MHappyEyeballs::update_state() - all attempts failed");
+    _state = Failed;
+}
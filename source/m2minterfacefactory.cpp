@@ -92,3 +92,38 @@ M2MObject* M2MInterfaceFactory::create_object(const String &name)
     object = new M2MObject(name);
     return object;
 }
+
+M2MResourceTable* M2MInterfaceFactory::create_resource_table(const String &name)
+{
+    tr_debug("M2MInterfaceFactory::create_resource_table : Name : %s", name.c_str());
+    if( name.empty() ){
+        return NULL;
+    }
+    M2MResourceTable *table = NULL;
+    table = new M2MResourceTable(name);
+    return table;
+}
+
+M2MResourceTable* M2MInterfaceFactory::create_resource_table(const String &name,
+                                                             const M2MResourceTable::ConstResource *resources,
+                                                             uint16_t count)
+{
+    tr_debug("M2MInterfaceFactory::create_resource_table : Name : %s, Count : %d", name.c_str(), count);
+    if( name.empty() || (!resources && count > 0)){
+        return NULL;
+    }
+    // Rows are looked up with a binary search, the definitions must be sorted.
+    for(uint16_t index = 1; index < count; index++) {
+        const M2MResourceTable::ConstResource &previous = resources[index - 1];
+        const M2MResourceTable::ConstResource &current = resources[index];
+        if(previous.instance_id > current.instance_id ||
+           (previous.instance_id == current.instance_id &&
+            previous.resource_id >= current.resource_id)) {
+            tr_error("M2MInterfaceFactory::create_resource_table : Definitions not sorted");
+            return NULL;
+        }
+    }
+    M2MResourceTable *table = NULL;
+    table = new M2MResourceTable(name, resources, count);
+    return table;
+}
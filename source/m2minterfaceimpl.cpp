@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #include <assert.h>
+#include <string.h>
+#include <time.h>
 #include "include/m2minterfaceimpl.h"
 #include "include/eventdata.h"
 #include "mbed-client/m2minterfaceobserver.h"
@@ -21,9 +23,45 @@
 #include "mbed-client/m2mconnectionhandlerfactory.h"
 #include "include/m2mnsdlinterface.h"
 #include "mbed-client/m2msecurity.h"
+#include "mbed-client/m2mdevice.h"
 #include "mbed-client/m2mconstants.h"
+#include "mbed-client/m2mcoaptcpframer.h"
+#include "mbed-client/m2mregistrationstore.h"
+#include "mbed-client/m2mtimer.h"
 #include "ns_trace.h"
 
+#define STATE_BIT(state) ((uint32_t)1 << M2MInterfaceImpl::state)
+
+// Length of a socket address. A dual-stack connection handler may
+// connect over either family whatever the configured stack, so the
+// length it reports wins over the one implied by the stack.
+static uint8_t address_length(const M2MConnectionObserver::SocketAddress &address)
+{
+    if(4 == address._length || 16 == address._length) {
+        return address._length;
+    }
+    return (M2MInterface::LwIP_IPv4 == address._stack) ? 4 : 16;
+}
+
+// New state for every external event, and the states
+// in which the event is accepted.
+const M2MInterfaceImpl::Transition M2MInterfaceImpl::TRANSITIONS[EVENT_MAX_EVENTS] = {
+    // EVENT_BOOTSTRAP
+    { STATE_BOOTSTRAP,
+      STATE_BIT(STATE_IDLE) },
+    // EVENT_REGISTER
+    { STATE_REGISTER,
+      STATE_BIT(STATE_IDLE) | STATE_BIT(STATE_BOOTSTRAPPED) |
+      STATE_BIT(STATE_REGISTERED) | STATE_BIT(STATE_WAITING) },
+    // EVENT_UPDATE_REGISTRATION
+    { STATE_UPDATE_REGISTRATION,
+      STATE_BIT(STATE_REGISTERED) | STATE_BIT(STATE_WAITING) },
+    // EVENT_UNREGISTER
+    { STATE_UNREGISTER,
+      STATE_BIT(STATE_REGISTERED) | STATE_BIT(STATE_UPDATE_REGISTRATION) |
+      STATE_BIT(STATE_WAITING) }
+};
+
 M2MInterfaceImpl::M2MInterfaceImpl(M2MInterfaceObserver& observer,
                                    const String &ep_name,
                                    const String &ep_type,
@@ -35,10 +73,30 @@ M2MInterfaceImpl::M2MInterfaceImpl(M2MInterfaceObserver& observer,
                                    const String &con_addr)
 : _observer(observer),
   _nsdl_interface(new M2MNsdlInterface(*this)),
+  _device(NULL),
   _current_state(0),
   _max_states( STATE_MAX_STATES ),
-  _event_generated(false),
-  _event_data(NULL),
+  _event_head(0),
+  _event_count(0),
+  _event_insert(0),
+  _event_dispatching(false),
+  _receive_pool(RECEIVE_BUFFER_COUNT, RECEIVE_BUFFER_SIZE),
+  _tcp_framer((mode & M2MInterface::TCP) ? new M2MCoapTcpFramer(COAP_TCP_MAX_MESSAGE_SIZE) : NULL),
+  _tcp_processing(false),
+  _send_queue(SEND_QUEUE_SIZE,
+              // The stream is reliable, no NSTART limit.
+              (mode & M2MInterface::TCP) ? 0 : COAP_NSTART,
+              COAP_EXCHANGE_TIMEOUT),
+  _send_failures(0),
+  _sending(false),
+  // Q in the binding: UDP_QUEUE, SMS_QUEUE and TCP_QUEUE.
+  _queue_mode((mode & (M2MInterface::UDP_QUEUE & ~M2MInterface::UDP)) != 0),
+  _wake_window(QUEUE_MODE_LISTEN_TIME, QUEUE_MODE_WAKE_INTERVAL),
+  _coap_time(0),
+  _registration_store(NULL),
+  _resume_registration(false),
+  _keepalive(KEEPALIVE_TIMEOUT, KEEPALIVE_ATTEMPTS),
+  _poll_mode(false),
   _endpoint_name(ep_name),
   _endpoint_type(ep_type),
   _domain( dmn),
@@ -52,11 +110,15 @@ M2MInterfaceImpl::M2MInterfaceImpl(M2MInterfaceObserver& observer,
   _update_register_ongoing(false)
 {
     tr_debug("M2MInterfaceImpl::M2MInterfaceImpl() -IN");
+    memset(&_server_address, 0, sizeof(_server_address));
+    memset(_server_address_data, 0, sizeof(_server_address_data));
+    _server_address.addr_ptr = _server_address_data;
     _nsdl_interface->create_endpoint(_endpoint_name,
                                      _endpoint_type,
                                      _life_time,
                                      _domain,
-                                     (uint8_t)_binding_mode,
+                                     // Transport isn't part of the LWM2M 1.0 binding.
+                                     (uint8_t)(_binding_mode & ~M2MInterface::TCP),
                                      _context_address);
 
     _connection_handler = M2MConnectionHandlerFactory::createConnectionHandler(*this,stack);
@@ -70,6 +132,8 @@ M2MInterfaceImpl::~M2MInterfaceImpl()
 {
     tr_debug("M2MInterfaceImpl::~M2MInterfaceImpl() - IN");
     delete _nsdl_interface;
+    delete _device;
+    delete _tcp_framer;
     _connection_handler->stop_listening();
     delete _connection_handler;
     tr_debug("M2MInterfaceImpl::~M2MInterfaceImpl() - OUT");
@@ -80,28 +144,13 @@ void M2MInterfaceImpl::bootstrap(M2MSecurity *security)
     tr_debug("M2MInterfaceImpl::bootstrap(M2MSecurity *security) - IN");
     // Transition to a new state based upon
     // the current state of the state machine
-    M2MSecurityData* data = new M2MSecurityData();
-    data->_object = security;
-    BEGIN_TRANSITION_MAP                                    // - Current State -
-        TRANSITION_MAP_ENTRY (STATE_BOOTSTRAP)              // state_idle
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_bootstrap
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state__bootstrap_address_resolved
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_bootstrap_resource_created
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_bootstrapped
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_register
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_register_address_resolved
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_register_resource_created
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_registered
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_update_registration
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_unregister
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_unregistered
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_sending_coap_data
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_coap_data_sent
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_coap_data_received
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_processing_coap_data
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_coap_data_processed
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_waiting
-    END_TRANSITION_MAP(data)
+    EventSlot *slot = next_event_slot();
+    if(slot) {
+        slot->_security_data._object = security;
+        external_event(EVENT_BOOTSTRAP, &slot->_security_data);
+    } else {
+        _event_ignored = true;
+    }
     if(_event_ignored) {
         _event_ignored = false;
         _observer.error(M2MInterface::NotAllowed);
@@ -123,31 +172,18 @@ void M2MInterfaceImpl::register_object(M2MSecurity *security, const M2MObjectLis
     if(!_register_ongoing) {
        _register_ongoing = true;
         _register_server = security;
-        M2MRegisterData *data = new M2MRegisterData();
-        data->_object = security;
-        data->_object_list = object_list;
-        BEGIN_TRANSITION_MAP                                    // - Current State -
-            TRANSITION_MAP_ENTRY (STATE_REGISTER)               // state_idle
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_bootstrap
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state__bootstrap_address_resolved
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_bootstrap_resource_created
-            TRANSITION_MAP_ENTRY (STATE_REGISTER)               // state_bootstrapped
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_register
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_register_address_resolved
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_register_resource_created
-            TRANSITION_MAP_ENTRY (STATE_REGISTER)               // state_registered
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_update_registration
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_unregister
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_unregistered
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_sending_coap_data
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_coap_data_sent
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_coap_data_received
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_processing_coap_data
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_coap_data_processed
-            TRANSITION_MAP_ENTRY (STATE_REGISTER)               // state_waiting
-        END_TRANSITION_MAP(data)
+        EventSlot *slot = next_event_slot();
+        if(slot) {
+            slot->_register_data._object = security;
+            slot->_register_data._object_list = object_list;
+            external_event(EVENT_REGISTER, &slot->_register_data);
+        } else {
+            _event_ignored = true;
+        }
         if(_event_ignored) {
+            // Nothing was started, a later call may succeed.
             _event_ignored = false;
+            _register_ongoing = false;
             _observer.error(M2MInterface::NotAllowed);
         }
     } else {
@@ -166,31 +202,18 @@ void M2MInterfaceImpl::update_registration(M2MSecurity *security_object, const u
         _observer.error(M2MInterface::InvalidParameters);
     } else if(!_update_register_ongoing){
         _update_register_ongoing = true;
-        M2MUpdateRegisterData *data = new M2MUpdateRegisterData();
-        data->_object = security_object;
-        data->_lifetime = lifetime;
-        BEGIN_TRANSITION_MAP                                    // - Current State -
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_idle
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_bootstrap
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state__bootstrap_address_resolved
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_bootstrap_resource_created
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_bootstrapped
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_register
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_register_address_resolved
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_register_resource_created
-            TRANSITION_MAP_ENTRY (STATE_UPDATE_REGISTRATION)    // state_registered
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_update_registration
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_unregister
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_unregistered
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_sending_coap_data
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_coap_data_sent
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_coap_data_received
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_processing_coap_data
-            TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_coap_data_processed
-            TRANSITION_MAP_ENTRY (STATE_UPDATE_REGISTRATION)    // state_waiting
-        END_TRANSITION_MAP(data)
+        EventSlot *slot = next_event_slot();
+        if(slot) {
+            slot->_update_register_data._object = security_object;
+            slot->_update_register_data._lifetime = lifetime;
+            external_event(EVENT_UPDATE_REGISTRATION, &slot->_update_register_data);
+        } else {
+            _event_ignored = true;
+        }
         if(_event_ignored) {
+            // Nothing was started, a later call may succeed.
             _event_ignored = false;
+            _update_register_ongoing = false;
             _observer.error(M2MInterface::NotAllowed);
         }
     } else {
@@ -205,26 +228,7 @@ void M2MInterfaceImpl::unregister_object(M2MSecurity* /*security*/)
     tr_debug("M2MInterfaceImpl::unregister_object(M2MSecurity *security) - IN");
     // Transition to a new state based upon
     // the current state of the state machine
-    BEGIN_TRANSITION_MAP                                // - Current State -
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_idle
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_bootstrap
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state__bootstrap_address_resolved
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_bootstrap_resource_created
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_bootstrapped
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_register
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_register_address_resolved
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_register_resource_created
-        TRANSITION_MAP_ENTRY (STATE_UNREGISTER)             // state_registered
-        TRANSITION_MAP_ENTRY (STATE_UNREGISTER)             // state_update_registration
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_unregister
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_unregistered
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_sending_coap_data
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_coap_data_sent
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_coap_data_received
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_processing_coap_data
-        TRANSITION_MAP_ENTRY (EVENT_IGNORED)                // state_coap_data_processed
-        TRANSITION_MAP_ENTRY (STATE_UNREGISTER)             // state_waiting
-    END_TRANSITION_MAP(NULL)
+    external_event(EVENT_UNREGISTER);
     if(_event_ignored) {
         _event_ignored = false;
         _observer.error(M2MInterface::NotAllowed);
@@ -232,16 +236,193 @@ void M2MInterfaceImpl::unregister_object(M2MSecurity* /*security*/)
     tr_debug("M2MInterfaceImpl::unregister_object(M2MSecurity *security) - OUT");
 }
 
+M2MMemoryStats M2MInterfaceImpl::memory_stats() const
+{
+    M2MMemoryStats stats;
+    if(_nsdl_interface) {
+        stats = _nsdl_interface->memory_stats();
+    }
+    stats.update(M2MMemoryStats::NodeStruct, sizeof(M2MInterfaceImpl));
+    // Struct is already part of the interface, count only the buffers.
+    stats.update(M2MMemoryStats::Values,
+                 _receive_pool.memory() - sizeof(M2MReceiveBufferPool));
+    return stats;
+}
+
+void M2MInterfaceImpl::set_queue_mode_timing(uint32_t listen_time, uint32_t wake_interval)
+{
+    _wake_window.set_timing(listen_time, wake_interval);
+    _nsdl_interface->schedule_execution();
+}
+
+M2MInterface::QueueModeStats M2MInterfaceImpl::queue_mode_stats() const
+{
+    uint32_t now = _nsdl_interface->coap_time();
+    return _wake_window.stats(now > _coap_time ? now : _coap_time);
+}
+
+void M2MInterfaceImpl::set_registration_store(M2MRegistrationStore *store)
+{
+    _registration_store = store;
+    if(_registration_store) {
+        _registration_store->load();
+    }
+}
+
+void M2MInterfaceImpl::set_keepalive_interval(uint32_t interval, uint32_t max_interval)
+{
+    // A client in queue mode isn't reachable between the windows anyway.
+    _keepalive.set_interval(_queue_mode ? 0 : interval, max_interval);
+    _nsdl_interface->schedule_execution();
+}
+
+M2MInterface::KeepaliveStats M2MInterfaceImpl::keepalive_stats() const
+{
+    return _keepalive.stats();
+}
+
+void M2MInterfaceImpl::set_poll_mode(bool poll_mode)
+{
+    tr_debug("M2MInterfaceImpl::set_poll_mode(%d)", poll_mode);
+    // The timers are switched to polling for the whole process
+    // by the application, see M2MTimer::set_polled().
+    _poll_mode = poll_mode;
+}
+
+int M2MInterfaceImpl::socket_fd() const
+{
+    return _connection_handler->socket_fd();
+}
+
+bool M2MInterfaceImpl::next_deadline(uint64_t &time) const
+{
+    return _poll_mode && M2MTimer::next_expiry(time);
+}
+
+void M2MInterfaceImpl::process_io()
+{
+    if(_poll_mode) {
+        _connection_handler->process_io();
+    }
+}
+
+void M2MInterfaceImpl::process_timers(uint64_t now)
+{
+    if(_poll_mode) {
+        M2MTimer::poll(now);
+    }
+}
+
+M2MDevice* M2MInterfaceImpl::device()
+{
+    if(!_device) {
+        _device = new M2MDevice();
+    }
+    return _device;
+}
+
 void M2MInterfaceImpl::coap_message_ready(uint8_t *data_ptr,
                                           uint16_t data_len,
                                           sn_nsdl_addr_s *address_ptr)
 {
     tr_debug("M2MInterfaceImpl::coap_message_ready(uint8_t *data_ptr,uint16_t data_len,sn_nsdl_addr_s *address_ptr)");
-    internal_event(STATE_SENDING_COAP_DATA);
-    if(!_connection_handler->send_data(data_ptr,data_len,address_ptr)) {
-        internal_event( STATE_IDLE);
-        tr_error("M2MInterfaceImpl::coap_message_ready() - M2MInterface::NetworkError");
-        _observer.error(M2MInterface::NetworkError);
+    refresh_time();
+    bool deferred = false;
+    if(_queue_mode && !_wake_window.is_open()) {
+        if(M2MSendQueue::Notification == M2MSendQueue::classify(data_ptr, data_len)) {
+            // Sent when the client next wakes up.
+            deferred = true;
+        } else {
+            // Requests of the client can't wait, the CoAP library would
+            // give up on them before the next wake.
+            start_listening();
+        }
+    }
+    if(!_send_queue.enqueue(data_ptr, data_len, address_ptr)) {
+        tr_error("M2MInterfaceImpl::coap_message_ready() - message not queued");
+    } else if(deferred) {
+        _wake_window.message_deferred();
+    }
+    send_queued_messages();
+}
+
+void M2MInterfaceImpl::send_queued_messages()
+{
+    // Messages queued while sending are picked up by the loop running.
+    if(_sending) {
+        return;
+    }
+    // In queue mode nothing goes out between the wake windows.
+    if(_queue_mode && !_wake_window.is_open()) {
+        return;
+    }
+    refresh_time();
+    _sending = true;
+    uint16_t length = 0;
+    sn_nsdl_addr_s *queued_address = NULL;
+    uint8_t *data_ptr;
+    while((data_ptr = (uint8_t*)_send_queue.front(length, queued_address)) != NULL) {
+        // The queued copy goes away once sent.
+        uint8_t address_data[16];
+        sn_nsdl_addr_s address = *queued_address;
+        memcpy(address_data, queued_address->addr_ptr, sizeof(address_data));
+        address.addr_ptr = address_data;
+        uint16_t data_len = length;
+        if(_tcp_framer) {
+            uint16_t frame_length = 0;
+            const uint8_t *frame = _tcp_framer->encode(data_ptr, data_len, frame_length);
+            if(!frame) {
+                // Empty ACK or retransmission, not needed on a stream.
+                _send_queue.sent();
+                process_tcp_messages(&address);
+                continue;
+            }
+            data_ptr = (uint8_t*)frame;
+            data_len = frame_length;
+        }
+        internal_event(STATE_SENDING_COAP_DATA);
+        if(!_connection_handler->send_data(data_ptr, data_len, &address)) {
+            // A datagram socket may just be full, a broken stream can't recover.
+            if(_tcp_framer || ++_send_failures >= SEND_RETRY_LIMIT) {
+                _send_queue.clear();
+                _send_failures = 0;
+                _sending = false;
+                internal_event( STATE_IDLE);
+                tr_error("M2MInterfaceImpl::send_queued_messages() - M2MInterface::NetworkError");
+                notify(NOTIFY_ERROR, M2MInterface::NetworkError);
+                return;
+            }
+            tr_debug("M2MInterfaceImpl::send_queued_messages() - send failed, message kept queued");
+            break;
+        }
+        _send_failures = 0;
+        _send_queue.sent();
+        _keepalive.activity(_coap_time);
+        if(_queue_mode) {
+            _wake_window.message_sent(_coap_time, data_len);
+        }
+        if(_tcp_framer) {
+            // Confirmable notifications are acknowledged locally.
+            process_tcp_messages(&address);
+        }
+    }
+    _sending = false;
+}
+
+void M2MInterfaceImpl::start_listening()
+{
+    refresh_time();
+    if(!_queue_mode || _wake_window.open(_coap_time)) {
+        _connection_handler->start_listening_for_data();
+    }
+}
+
+void M2MInterfaceImpl::send_ping()
+{
+    uint8_t ping[M2MKeepalive::PING_LENGTH];
+    uint16_t length = _keepalive.ping_message(ping);
+    if(!_send_queue.enqueue(ping, length, &_server_address)) {
+        tr_error("M2MInterfaceImpl::send_ping() - ping not queued");
     }
 }
 
@@ -249,16 +430,36 @@ void M2MInterfaceImpl::client_registered(M2MServer *server_object)
 {
     tr_debug("M2MInterfaceImpl::client_registered(M2MServer *server_object)");
     internal_event(STATE_REGISTERED);
+    refresh_time();
+    _keepalive.start(_coap_time);
+    _nsdl_interface->schedule_execution();
+    if(_registration_store) {
+        uint8_t length = 0;
+        const uint8_t *location = _nsdl_interface->registration_location(length);
+        if(_registration_store->set_registration(_endpoint_name.c_str(),
+                                                 _server_uri.c_str(),
+                                                 location,
+                                                 length,
+                                                 _nsdl_interface->registration_lifetime(),
+                                                 (uint32_t)time(NULL))) {
+            _registration_store->save();
+        }
+    }
     //Inform client is registered.
     //TODO: manage register object in a list.
-    _observer.object_registered(_register_server,*server_object);
+    notify(NOTIFY_REGISTERED, M2MInterface::ErrorNone, _register_server, server_object);
 }
 
 void M2MInterfaceImpl::registration_updated(const M2MServer &server_object)
 {
     tr_debug("M2MInterfaceImpl::registration_updated(const M2MServer &server_object)");
     internal_event(STATE_REGISTERED);
-    _observer.registration_updated(_register_server,server_object);
+    if(_registration_store && _registration_store->is_registered()) {
+        _registration_store->registration_updated(_nsdl_interface->registration_lifetime(),
+                                                  (uint32_t)time(NULL));
+        _registration_store->save();
+    }
+    notify(NOTIFY_REGISTRATION_UPDATED, M2MInterface::ErrorNone, _register_server, &server_object);
 }
 
 
@@ -266,29 +467,36 @@ void M2MInterfaceImpl::registration_error(uint8_t error_code)
 {
     tr_debug("M2MInterfaceImpl::registration_error(uint8_t error_code) %d", error_code);
     internal_event(STATE_IDLE);
-    _observer.error((M2MInterface::Error)error_code);
+    if(_registration_store) {
+        // The server doesn't know the registration any more.
+        _registration_store->clear();
+    }
+    notify(NOTIFY_ERROR, (M2MInterface::Error)error_code);
 }
 
 void M2MInterfaceImpl::client_unregistered()
 {
     tr_debug("M2MInterfaceImpl::client_unregistered()");
     internal_event(STATE_UNREGISTERED);
+    if(_registration_store) {
+        _registration_store->clear();
+    }
     //TODO: manage register object in a list.
-    _observer.object_unregistered(_register_server);
+    notify(NOTIFY_UNREGISTERED, M2MInterface::ErrorNone, _register_server);
 }
 
 void M2MInterfaceImpl::bootstrap_done(M2MSecurity *security_object)
 {
     tr_debug("M2MInterfaceImpl::bootstrap_done(M2MSecurity *security_object)");
     internal_event(STATE_BOOTSTRAPPED);
-    _observer.bootstrap_done(security_object);
+    notify(NOTIFY_BOOTSTRAP_DONE, M2MInterface::ErrorNone, security_object);
 }
 
 void M2MInterfaceImpl::bootstrap_error()
 {
     tr_debug("M2MInterfaceImpl::bootstrap_error()");
     internal_event(STATE_IDLE);
-    _observer.error(M2MInterface::BootstrapFailed);
+    notify(NOTIFY_ERROR, M2MInterface::BootstrapFailed);
 }
 
 void M2MInterfaceImpl::coap_data_processed()
@@ -306,24 +514,146 @@ void M2MInterfaceImpl::value_updated(M2MBase *base)
     }
 }
 
+void M2MInterfaceImpl::coap_timer_tick(uint32_t time)
+{
+    _coap_time = time;
+    _send_queue.tick(time);
+    if(_queue_mode) {
+        bool pending = _send_queue.count() || _send_queue.in_flight();
+        M2MWakeWindow::Change change = _wake_window.tick(time, pending);
+        if(M2MWakeWindow::Opened == change) {
+            tr_debug("M2MInterfaceImpl::coap_timer_tick() - wake window opened");
+            _connection_handler->start_listening_for_data();
+        } else if(M2MWakeWindow::Closed == change) {
+            tr_debug("M2MInterfaceImpl::coap_timer_tick() - wake window closed");
+            _connection_handler->stop_listening();
+        }
+    }
+    M2MKeepalive::Action keepalive = _keepalive.tick(time);
+    if(M2MKeepalive::Ping == keepalive) {
+        send_ping();
+    } else if(M2MKeepalive::Failed == keepalive) {
+        // The NAT binding or the server's view of the client address
+        // may be gone, an update reopens the path from this end. It goes
+        // through the state machine like an update by the application,
+        // and one already ongoing serves the same purpose.
+        if(_update_register_ongoing) {
+            tr_debug("M2MInterfaceImpl::coap_timer_tick() - keepalive failed, update ongoing");
+        } else {
+            tr_error("M2MInterfaceImpl::coap_timer_tick() - keepalive failed, updating registration");
+            update_registration(NULL);
+        }
+    }
+    if(_send_queue.count()) {
+        send_queued_messages();
+    }
+}
+
+uint32_t M2MInterfaceImpl::coap_timer_delay(uint32_t time)
+{
+    bool pending = _send_queue.count() || _send_queue.in_flight();
+    bool can_send = !_queue_mode || _wake_window.is_open();
+    if(_send_queue.in_flight() || (_send_queue.count() && can_send) ||
+       _register_ongoing || _update_register_ongoing) {
+        // The CoAP library retransmits, and the queue retries and times
+        // out exchanges, with a resolution of one second.
+        return 1;
+    }
+    uint32_t delay = _queue_mode ? _wake_window.next_change(time, pending) : 0;
+    uint32_t keepalive = _keepalive.next_action(time);
+    if(keepalive && (!delay || keepalive < delay)) {
+        delay = keepalive;
+    }
+    return delay;
+}
+
+void M2MInterfaceImpl::refresh_time()
+{
+    uint32_t now = _nsdl_interface->coap_time();
+    if((int32_t)(now - _coap_time) > 0) {
+        _coap_time = now;
+        _send_queue.tick(now);
+    }
+}
+
+M2MConnectionObserver::TransportType M2MInterfaceImpl::transport_type() const
+{
+    return _tcp_framer ? M2MConnectionObserver::Stream : M2MConnectionObserver::Datagram;
+}
+
+uint8_t* M2MInterfaceImpl::receive_buffer(uint16_t &size)
+{
+    uint8_t *buffer = _receive_pool.acquire();
+    size = buffer ? _receive_pool.buffer_size() : 0;
+    return buffer;
+}
+
+void M2MInterfaceImpl::release_receive_buffer(uint8_t* buffer)
+{
+    _receive_pool.release(buffer);
+}
+
+M2MRegistrationStore* M2MInterfaceImpl::registration_store()
+{
+    return _registration_store;
+}
+
+bool M2MInterfaceImpl::poll_mode() const
+{
+    return _poll_mode;
+}
+
 void M2MInterfaceImpl::data_available(uint8_t* data,
                                       uint16_t data_size,
                                       const M2MConnectionObserver::SocketAddress &address)
 {
     tr_debug("M2MInterfaceImpl::data_available(uint8_t* data,uint16_t data_size,const M2MConnectionObserver::SocketAddress &address)");
-    ReceivedData *event = new ReceivedData();
-    event->_data = data;
-    event->_size = data_size;
-    event->_address = &address;
-    internal_event(STATE_COAP_DATA_RECEIVED, event);
+    refresh_time();
+    uint8_t *buffer = data;
+    if(!_receive_pool.owns(data)) {
+        // Socket used its own buffer, processing may be deferred
+        // so the data must outlive this call.
+        buffer = NULL;
+        if(data_size <= _receive_pool.buffer_size()) {
+            buffer = _receive_pool.acquire();
+        }
+        if(!buffer) {
+            tr_error("M2MInterfaceImpl::data_available - no receive buffer, data dropped");
+            return;
+        }
+        memcpy(buffer, data, data_size);
+    }
+
+    EventSlot *slot = NULL;
+    if(_event_count < EVENT_QUEUE_SIZE - EVENT_QUEUE_RESERVE) {
+        slot = next_event_slot();
+    }
+    if(slot) {
+        ReceivedData *event = &slot->_received_data;
+        event->_data = buffer;
+        event->_size = data_size;
+        event->_address._stack = address._stack;
+        event->_address._port = address._port;
+        event->_address._length = address_length(address);
+        memset(event->_address_data, 0, sizeof(event->_address_data));
+        if(address._address) {
+            memcpy(event->_address_data, address._address, event->_address._length);
+        }
+        internal_event(STATE_COAP_DATA_RECEIVED, event);
+    } else {
+        tr_error("M2MInterfaceImpl::data_available - event queue full, data dropped");
+        _receive_pool.release(buffer);
+    }
 }
 
 void M2MInterfaceImpl::socket_error(uint8_t /*error_code*/)
 {
     tr_debug("M2MInterfaceImpl::socket_error(uint8_t error_code)");
+    if(_tcp_framer) {
+        _tcp_framer->reset();
+    }
     internal_event(STATE_IDLE);
-    M2MInterface::Error error = M2MInterface::NetworkError;
-    _observer.error(error);
+    notify(NOTIFY_ERROR, M2MInterface::NetworkError);
 }
 
 void M2MInterfaceImpl::address_ready(const M2MConnectionObserver::SocketAddress &address,
@@ -331,8 +661,25 @@ void M2MInterfaceImpl::address_ready(const M2MConnectionObserver::SocketAddress
                                      const uint16_t server_port)
 {
     tr_debug("M2MInterfaceImpl::address_ready(const M2MConnectionObserver::SocketAddress ,M2MConnectionObserver::ServerType,const uint16_t)");
-    ResolvedAddressData *data = new ResolvedAddressData();
-    data->_address = &address;
+    if(_tcp_framer) {
+        // New connection, the stream starts over.
+        _tcp_framer->reset();
+    }
+    EventSlot *slot = next_event_slot();
+    if(!slot) {
+        tr_error("M2MInterfaceImpl::address_ready - event queue full");
+        return;
+    }
+    // The address may be gone by the time the event is processed.
+    ResolvedAddressData *data = &slot->_resolved_address_data;
+    data->_address._stack = address._stack;
+    data->_address._port = address._port;
+    data->_address._length = address_length(address);
+    data->_address._address = address._address ? data->_address_data : NULL;
+    memset(data->_address_data, 0, sizeof(data->_address_data));
+    if(address._address) {
+        memcpy(data->_address_data, address._address, data->_address._length);
+    }
     data->_port = server_port;
     if( M2MConnectionObserver::Bootstrap == server_type) {
         tr_debug("M2MInterfaceImpl::address_ready() Server Type Bootstrap");
@@ -347,6 +694,9 @@ void M2MInterfaceImpl::data_sent()
 {
     tr_debug("M2MInterfaceImpl::data_sent()");
     internal_event(STATE_COAP_DATA_SENT);
+    if(_send_queue.count()) {
+        send_queued_messages();
+    }
 }
 
 // state machine sits here.
@@ -356,6 +706,11 @@ void M2MInterfaceImpl::state_idle(EventData* /*data*/)
     // Cleanup all resources, if necessary
     _connection_handler->stop_listening();
     _nsdl_interface->stop_timers();
+    _send_queue.clear();
+    _send_failures = 0;
+    refresh_time();
+    _wake_window.stop(_coap_time);
+    _keepalive.stop();
     _register_ongoing = false;
     _update_register_ongoing = false;
     tr_debug("M2MInterfaceImpl::state_idle");
@@ -402,7 +757,7 @@ void M2MInterfaceImpl::state_bootstrap( EventData *data)
     }
     if(!success) {
         tr_error("M2MInterfaceImpl::state_bootstrap - M2MInterface::InvalidParameters");
-        _observer.error(M2MInterface::InvalidParameters);
+        notify(NOTIFY_ERROR, M2MInterface::InvalidParameters);
         internal_event(STATE_IDLE);
     }
 }
@@ -413,21 +768,17 @@ void M2MInterfaceImpl::state_bootstrap_address_resolved( EventData *data)
     ResolvedAddressData *event = (ResolvedAddressData *)data;
     sn_nsdl_addr_s address;
 
-    M2MInterface::NetworkStack stack = event->_address->_stack;
-
-    if(M2MInterface::LwIP_IPv4 == stack) {
+    address.addr_len = address_length(event->_address);
+    if(4 == address.addr_len) {
         tr_debug("M2MInterfaceImpl::state_bootstrap_address_resolved : IPv4 address");
         address.type = SN_NSDL_ADDRESS_TYPE_IPV4;
-        address.addr_len = 4;
-    } else if((M2MInterface::LwIP_IPv6 == stack) ||
-              (M2MInterface::Nanostack_IPv6 == stack)) {
+    } else {
         tr_debug("M2MInterfaceImpl::state_bootstrap_address_resolved : IPv6 address");
         address.type = SN_NSDL_ADDRESS_TYPE_IPV6;
-        address.addr_len = 16;
     }
     address.port = event->_port;
-    address.addr_ptr = (uint8_t*)event->_address->_address;
-    _connection_handler->start_listening_for_data();
+    address.addr_ptr = (uint8_t*)event->_address._address;
+    start_listening();
     if(_nsdl_interface->create_bootstrap_resource(&address)) {
        tr_debug("M2MInterfaceImpl::state_bootstrap_address_resolved : create_bootstrap_resource - success");
        internal_event(STATE_BOOTSTRAP_RESOURCE_CREATED);
@@ -435,7 +786,7 @@ void M2MInterfaceImpl::state_bootstrap_address_resolved( EventData *data)
         // If resource creation fails then inform error to application
         tr_error("M2MInterfaceImpl::state_bootstrap_address_resolved : M2MInterface::InvalidParameters");
         internal_event(STATE_IDLE);
-        _observer.error(M2MInterface::InvalidParameters);
+        notify(NOTIFY_ERROR, M2MInterface::InvalidParameters);
     }
 }
 
@@ -465,6 +816,11 @@ void M2MInterfaceImpl::state_register( EventData *data)
                     // If the nsdl resource structure is created successfully
                     String server_address = security->resource_value_string(M2MSecurity::M2MServerUri);
                     tr_debug("M2MInterfaceImpl::state_register - server_address %s", server_address.c_str());
+                    _server_uri = server_address;
+                    _resume_registration = _registration_store &&
+                                           _registration_store->can_resume(_endpoint_name.c_str(),
+                                                                           _server_uri.c_str(),
+                                                                           (uint32_t)time(NULL));
                     String ip_address;
                     uint16_t port;
                     if(server_address.compare(0,COAP.size(),COAP) == 0) {
@@ -495,7 +851,7 @@ void M2MInterfaceImpl::state_register( EventData *data)
     if(!success) {
         tr_error("M2MInterfaceImpl::state_register - M2MInterface::InvalidParameters");
         internal_event(STATE_IDLE);
-        _observer.error(M2MInterface::InvalidParameters);
+        notify(NOTIFY_ERROR, M2MInterface::InvalidParameters);
     }
 }
 
@@ -507,23 +863,46 @@ void M2MInterfaceImpl::state_register_address_resolved( EventData *data)
 
         sn_nsdl_addr_type_e address_type = SN_NSDL_ADDRESS_TYPE_IPV6;
 
-        M2MInterface::NetworkStack stack = event->_address->_stack;
-
-        if(M2MInterface::LwIP_IPv4 == stack) {
+        if(4 == address_length(event->_address)) {
             tr_debug("M2MInterfaceImpl::state_register_address_resolved : IPv4 address");
             address_type = SN_NSDL_ADDRESS_TYPE_IPV4;
-        } else if((M2MInterface::LwIP_IPv6 == stack) ||
-                  (M2MInterface::Nanostack_IPv6 == stack)) {
+        } else {
             tr_debug("M2MInterfaceImpl::state_register_address_resolved : IPv6 address");
-            address_type = SN_NSDL_ADDRESS_TYPE_IPV6;
+        }
+        if(_registration_store) {
+            _registration_store->set_server_address((const uint8_t*)event->_address._address,
+                                                    address_length(event->_address),
+                                                    event->_port);
+        }
+        _server_address.type = address_type;
+        _server_address.addr_len = address_length(event->_address);
+        _server_address.port = event->_port;
+        if(event->_address._address) {
+            memcpy(_server_address_data, event->_address._address, _server_address.addr_len);
         }
         internal_event(STATE_REGISTER_RESOURCE_CREATED);
-        _connection_handler->start_listening_for_data();
-        if(!_nsdl_interface->send_register_message((uint8_t*)event->_address->_address,event->_port, address_type)) {
+        start_listening();
+        bool success = false;
+        if(_resume_registration) {
+            // Registered before the restart, an update is enough.
+            uint8_t length = 0;
+            const uint8_t *location = _registration_store->location(length);
+            success = _nsdl_interface->send_resume_registration((uint8_t*)event->_address._address,
+                                                                event->_port,
+                                                                address_type,
+                                                                location,
+                                                                length);
+        }
+        if(!success) {
+            success = _nsdl_interface->send_register_message((uint8_t*)event->_address._address,
+                                                             event->_port,
+                                                             address_type);
+        }
+        if(!success) {
             // If resource creation fails then inform error to application
             tr_error("M2MInterfaceImpl::state_register_address_resolved : M2MInterface::InvalidParameters");
             internal_event(STATE_IDLE);
-            _observer.error(M2MInterface::InvalidParameters);
+            notify(NOTIFY_ERROR, M2MInterface::InvalidParameters);
         }
     }
 }
@@ -553,7 +932,7 @@ void M2MInterfaceImpl::state_update_registration( EventData *data)
     if(!success) {
         tr_error("M2MInterfaceImpl::state_register_address_resolved : M2MInterface::InvalidParameters");
         internal_event(STATE_IDLE);
-        _observer.error(M2MInterface::InvalidParameters);
+        notify(NOTIFY_ERROR, M2MInterface::InvalidParameters);
     }
 }
 
@@ -564,7 +943,7 @@ void M2MInterfaceImpl::state_unregister( EventData */*data*/)
     if(!_nsdl_interface->send_unregister_message()) {
         tr_error("M2MInterfaceImpl::state_unregister : M2MInterface::NotRegistered");
         internal_event(STATE_IDLE);
-        _observer.error(M2MInterface::NotRegistered);
+        notify(NOTIFY_ERROR, M2MInterface::NotRegistered);
     }
 }
 
@@ -593,26 +972,53 @@ void M2MInterfaceImpl::state_coap_data_received( EventData *data)
         ReceivedData *event = (ReceivedData*)data;
         sn_nsdl_addr_s address;
 
-        M2MInterface::NetworkStack stack = event->_address->_stack;
-
-        if(M2MInterface::LwIP_IPv4 == stack) {
+        // Length was taken from the socket address when queued.
+        address.addr_len = event->_address._length;
+        if(4 == address.addr_len) {
             tr_debug("M2MInterfaceImpl::state_coap_data_received : IPv4 address");
             address.type = SN_NSDL_ADDRESS_TYPE_IPV4;
-            address.addr_len = 4;
-        } else if((M2MInterface::LwIP_IPv6 == stack) ||
-                  (M2MInterface::Nanostack_IPv6 == stack)) {
+        } else {
             tr_debug("M2MInterfaceImpl::state_coap_data_received : IPv6 address");
             address.type = SN_NSDL_ADDRESS_TYPE_IPV6;
-            address.addr_len = 16;
         }
-        address.port = event->_address->_port;
-        address.addr_ptr = (uint8_t*)event->_address->_address;
+        address.port = event->_address._port;
+        address.addr_ptr = event->_address_data;
 
         // Process received data
         internal_event(STATE_PROCESSING_COAP_DATA);
-        if(!_nsdl_interface->process_received_data(event->_data,
-                                                  event->_size,
-                                                  &address)) {
+        if(_queue_mode) {
+            _wake_window.message_received(_coap_time);
+        }
+        _keepalive.activity(_coap_time);
+        bool processed = true;
+        if(_tcp_framer) {
+            uint16_t offset = 0;
+            while(offset < event->_size) {
+                uint16_t taken = _tcp_framer->feed(event->_data + offset,
+                                                   event->_size - offset);
+                offset += taken;
+                processed = process_tcp_messages(&address) && processed;
+                if(!taken || _tcp_framer->failed()) {
+                    break;
+                }
+            }
+        } else {
+            _send_queue.message_received(event->_data, event->_size);
+            // The reply to a ping means nothing to the CoAP library.
+            if(!_keepalive.pong_received(event->_data, event->_size, _coap_time)) {
+                processed = _nsdl_interface->process_received_data(event->_data,
+                                                                   event->_size,
+                                                                   &address);
+            }
+        }
+        // Parsed message holds no references to the datagram.
+        _receive_pool.release(event->_data);
+        event->_data = NULL;
+        // An acknowledgement may have released the next confirmable message.
+        if(_send_queue.count()) {
+            send_queued_messages();
+        }
+        if(!processed) {
            tr_error("M2MInterfaceImpl::state_coap_data_received : M2MInterface::ResponseParseFailed");
             _observer.error(M2MInterface::ResponseParseFailed);
         }
@@ -638,61 +1044,190 @@ void M2MInterfaceImpl::state_waiting( EventData */*data*/)
 
 // generates an external event. called once per external event
 // to start the state machine executing
-void M2MInterfaceImpl::external_event(uint8_t new_state,
+void M2MInterfaceImpl::external_event(uint8_t event,
                                      EventData* p_data)
 {
-    tr_debug("M2MInterfaceImpl::external_event : new state %d", new_state);
+    tr_debug("M2MInterfaceImpl::external_event : event %d", event);
     // if we are supposed to ignore this event
-    if (new_state == EVENT_IGNORED) {
+    if (event >= EVENT_MAX_EVENTS ||
+        !(TRANSITIONS[event].allowed_states & ((uint32_t)1 << _current_state))) {
         tr_debug("M2MInterfaceImpl::external_event : new state is EVENT_IGNORED");
-        // just delete the event data, if any
-        if (p_data) {
-            delete p_data;
-            p_data = NULL;
-        }
+        // event data lives in a preallocated slot, nothing to free
         _event_ignored = true;
-    }
-    else {
+    } else if(_event_count >= EVENT_QUEUE_SIZE - EVENT_QUEUE_RESERVE) {
+        tr_error("M2MInterfaceImpl::external_event : event queue full, event rejected");
+        _event_ignored = true;
+    } else {
         tr_debug("M2MInterfaceImpl::external_event : handle new state");
         // generate the event and execute the state engine
-        internal_event(new_state, p_data);
+        internal_event(TRANSITIONS[event].new_state, p_data);
     }
 }
 
 // generates an internal event. called from within a state
 // function to transition to a new state
-void M2MInterfaceImpl::internal_event(uint8_t new_state,
+bool M2MInterfaceImpl::internal_event(uint8_t new_state,
                                       EventData* p_data)
 {
     tr_debug("M2MInterfaceImpl::internal_event : new state %d", new_state);
-    _event_data = p_data;
-    _event_generated = true;
-    _current_state = new_state;
-    state_engine();
+    if(_event_count == EVENT_QUEUE_SIZE) {
+        tr_error("M2MInterfaceImpl::internal_event : event queue full, event dropped");
+        if(p_data) {
+            release_event_slot(event_slot(p_data));
+        }
+        // The state machine may be stuck, the application has to recover.
+        if(EVENT_NOTIFICATION != new_state) {
+            _observer.error(M2MInterface::UnknownError);
+        }
+        return false;
+    }
+    // Events generated by a state function run in the order they were
+    // generated, but before the events which were already pending.
+    for(uint8_t i = _event_count; i > _event_insert; i--) {
+        _event_queue[(_event_head + i) % EVENT_QUEUE_SIZE] =
+            _event_queue[(_event_head + i - 1) % EVENT_QUEUE_SIZE];
+    }
+    Event &event = _event_queue[(_event_head + _event_insert) % EVENT_QUEUE_SIZE];
+    event.state = new_state;
+    event.data = p_data;
+    if(p_data) {
+        event_slot(p_data)->_in_use = true;
+    }
+    _event_insert++;
+    _event_count++;
+    if(!_event_dispatching) {
+        state_engine();
+    }
+    return true;
+}
+
+void M2MInterfaceImpl::notify(uint8_t type,
+                              M2MInterface::Error error,
+                              M2MSecurity *security,
+                              const M2MServer *server)
+{
+    EventSlot *slot = next_event_slot();
+    NotificationData local;
+    NotificationData *data = slot ? &slot->_notification_data : &local;
+    data->_type = type;
+    data->_error = error;
+    data->_security = security;
+    data->_server = server;
+    if(!slot || !internal_event(EVENT_NOTIFICATION, data)) {
+        // No room in the queue, late is better than never.
+        tr_error("M2MInterfaceImpl::notify : event queue full, observer called directly");
+        notification(*data);
+    }
+}
+
+void M2MInterfaceImpl::notification(const NotificationData &data)
+{
+    switch(data._type) {
+        case NOTIFY_ERROR:
+            _observer.error((M2MInterface::Error)data._error);
+            break;
+        case NOTIFY_REGISTERED:
+            _observer.object_registered(data._security, *data._server);
+            break;
+        case NOTIFY_REGISTRATION_UPDATED:
+            _observer.registration_updated(data._security, *data._server);
+            break;
+        case NOTIFY_UNREGISTERED:
+            _observer.object_unregistered(data._security);
+            break;
+        case NOTIFY_BOOTSTRAP_DONE:
+            _observer.bootstrap_done(data._security);
+            break;
+    }
+}
+
+EventSlot* M2MInterfaceImpl::next_event_slot()
+{
+    for(uint8_t i = 0; i < EVENT_QUEUE_SIZE; i++) {
+        if(!_event_slots[i]._in_use) {
+            return &_event_slots[i];
+        }
+    }
+    return NULL;
+}
+
+EventSlot* M2MInterfaceImpl::event_slot(EventData *data)
+{
+    uint32_t index = ((uint8_t*)data - (uint8_t*)_event_slots) / sizeof(EventSlot);
+    assert(index < EVENT_QUEUE_SIZE);
+    return &_event_slots[index];
+}
+
+bool M2MInterfaceImpl::process_tcp_messages(sn_nsdl_addr_s *address)
+{
+    // Replies sent while a message is processed come back here,
+    // the loop already running picks up their local ACKs.
+    if(_tcp_processing) {
+        return true;
+    }
+    _tcp_processing = true;
+    bool processed = true;
+    uint16_t length = 0;
+    const uint8_t *message;
+    while((message = _tcp_framer->next_message(length)) != NULL) {
+        if(_keepalive.pong_received(message, length, _coap_time)) {
+            continue;
+        }
+        if(!_nsdl_interface->process_received_data((uint8_t*)message, length, address)) {
+            processed = false;
+        }
+    }
+    _tcp_processing = false;
+    const uint8_t *signal = _tcp_framer->next_signal(length);
+    if(signal) {
+        _connection_handler->send_data((uint8_t*)signal, length, address);
+    }
+    if(_tcp_framer->failed()) {
+        tr_error("M2MInterfaceImpl::process_tcp_messages - stream closed or broken");
+        socket_error(0);
+    }
+    return processed;
+}
+
+void M2MInterfaceImpl::release_event_slot(EventSlot *slot)
+{
+    slot->_register_data._object_list.clear();
+    if(slot->_received_data._data) {
+        _receive_pool.release(slot->_received_data._data);
+        slot->_received_data._data = NULL;
+    }
+    slot->_in_use = false;
 }
 
 // the state engine executes the state machine states
 void M2MInterfaceImpl::state_engine (void )
 {
     tr_debug("M2MInterfaceImpl::state_engine");
-    EventData* p_data_temp = NULL;
+    _event_dispatching = true;
 
-    // while events are being generated keep executing states
-    while (_event_generated) {
-        p_data_temp = _event_data;  // copy of event data pointer
-        _event_data = NULL;       // event data used up, reset ptr
-        _event_generated = false;  // event used up, reset flag
+    // while events are queued keep executing states
+    while (_event_count) {
+        Event event = _event_queue[_event_head];
+        _event_head = (_event_head + 1) % EVENT_QUEUE_SIZE;
+        _event_count--;
+        _event_insert = 0;
 
-        assert(_current_state < _max_states);
+        if(EVENT_NOTIFICATION == event.state) {
+            notification(*(NotificationData*)event.data);
+        } else {
+            assert(event.state < _max_states);
 
-        state_function( _current_state, p_data_temp );
+            _current_state = event.state;
+            state_function( event.state, event.data );
+        }
 
-        // if event data was used, then delete it
-        if (p_data_temp) {
-            delete p_data_temp;
-            p_data_temp = NULL;
+        // event data used up, release the slot
+        if(event.data) {
+            release_event_slot(event_slot(event.data));
         }
     }
+    _event_insert = 0;
+    _event_dispatching = false;
 }
 
 void M2MInterfaceImpl::state_function( uint8_t current_state, EventData* data )
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include "include/m2mkeepalive.h"
+#include "ns_trace.h"
+
+#define COAP_PING_HEADER            0x40    // Version 1, confirmable, no token.
+#define COAP_RESET_HEADER           0x70    // Version 1, reset, no token.
+// Pings are numbered from the top of the ID space, away from the
+// IDs the CoAP library hands out.
+#define PING_FIRST_MESSAGE_ID       0xF000
+
+M2MKeepalive::M2MKeepalive(uint32_t timeout, uint8_t max_attempts)
+: _timeout(timeout),
+  _max_attempts(max_attempts ? max_attempts : 1),
+  _attempts(0),
+  _step(0),
+  _interval(0),
+  _max_interval(0),
+  _good_interval(0),
+  _last_activity(0),
+  _sent_at(0),
+  _message_id(PING_FIRST_MESSAGE_ID),
+  _running(false),
+  _adapting(false)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+M2MKeepalive::~M2MKeepalive()
+{
+}
+
+void M2MKeepalive::set_interval(uint32_t interval, uint32_t max_interval)
+{
+    _step = interval;
+    _interval = interval;
+    _max_interval = (max_interval > interval) ? max_interval : interval;
+    _good_interval = 0;
+    _adapting = _max_interval > _interval;
+    _attempts = 0;
+}
+
+void M2MKeepalive::start(uint32_t now)
+{
+    _running = true;
+    _attempts = 0;
+    _last_activity = now;
+}
+
+void M2MKeepalive::stop()
+{
+    _running = false;
+    _attempts = 0;
+}
+
+void M2MKeepalive::activity(uint32_t now)
+{
+    _last_activity = now;
+}
+
+M2MKeepalive::Action M2MKeepalive::tick(uint32_t now)
+{
+    if(!_running || !_interval) {
+        return None;
+    }
+    if(_attempts) {
+        if(now - _sent_at < (_timeout << (_attempts - 1))) {
+            return None;
+        }
+        if(_attempts < _max_attempts) {
+            _attempts++;
+            _sent_at = now;
+            return Ping;
+        }
+        ping_failed();
+        _last_activity = now;
+        return Failed;
+    }
+    if(now - _last_activity < _interval) {
+        return None;
+    }
+    _message_id++;
+    _attempts = 1;
+    _sent_at = now;
+    return Ping;
+}
+
+uint32_t M2MKeepalive::next_action(uint32_t now) const
+{
+    if(!_running || !_interval) {
+        return 0;
+    }
+    uint32_t elapsed;
+    uint32_t wait;
+    if(_attempts) {
+        elapsed = now - _sent_at;
+        wait = _timeout << (_attempts - 1);
+    } else {
+        elapsed = now - _last_activity;
+        wait = _interval;
+    }
+    return (elapsed < wait) ? wait - elapsed : 1;
+}
+
+uint16_t M2MKeepalive::ping_message(uint8_t *buffer) const
+{
+    buffer[0] = COAP_PING_HEADER;
+    buffer[1] = 0;
+    buffer[2] = _message_id >> 8;
+    buffer[3] = _message_id & 0xFF;
+    return PING_LENGTH;
+}
+
+bool M2MKeepalive::pong_received(const uint8_t *data, uint16_t length, uint32_t now)
+{
+    if(!_attempts || !data || length < PING_LENGTH ||
+       (data[0] & 0xF0) != COAP_RESET_HEADER || data[1] != 0 ||
+       ((data[2] << 8) | data[3]) != _message_id) {
+        return false;
+    }
+    _attempts = 0;
+    _last_activity = now;
+    _stats.pings++;
+    if(_interval > _good_interval) {
+        _good_interval = _interval;
+    }
+    if(_adapting && _interval < _max_interval) {
+        // The path survived this idle time, try a longer one.
+        _interval += _step;
+        if(_interval > _max_interval) {
+            _interval = _max_interval;
+        }
+        tr_debug("M2MKeepalive::pong_received() - interval %lu", (unsigned long)_interval);
+    }
+    return true;
+}
+
+M2MInterface::KeepaliveStats M2MKeepalive::stats() const
+{
+    M2MInterface::KeepaliveStats stats = _stats;
+    stats.interval = _interval;
+    return stats;
+}
+
+void M2MKeepalive::ping_failed()
+{
+    tr_debug("M2MKeepalive::ping_failed() - no reply after %lu idle seconds",
+             (unsigned long)_interval);
+    _attempts = 0;
+    _stats.failures++;
+    _stats.nat_timeout = _interval;
+    // Stay below the observed timeout from now on.
+    _interval = (_good_interval && _good_interval < _interval) ? _good_interval : _step;
+    _adapting = false;
+}
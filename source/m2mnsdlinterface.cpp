@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <time.h>
 #include "include/nsdlaccesshelper.h"
 #include "include/m2mnsdlobserver.h"
 #include "mbed-client/m2msecurity.h"
@@ -20,12 +21,76 @@
 #include "mbed-client/m2mobject.h"
 #include "mbed-client/m2mobjectinstance.h"
 #include "mbed-client/m2mresource.h"
+#include "mbed-client/m2mresourcetable.h"
+#include "mbed-client/m2mstringpool.h"
 #include "mbed-client/m2mconstants.h"
 #include "include/m2mtlvserializer.h"
+#include "include/m2matomic.h"
 #include "ip6string.h"
 #include "ns_trace.h"
 #include "mbed-client/m2mtimer.h"
 
+#ifdef __linux__
+// Seconds of a clock which doesn't follow changes of the wall clock.
+static uint32_t current_seconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)now.tv_sec;
+}
+#endif
+
+// The CoAP library keeps one clock for the whole process, so every
+// interface gives it the same time.
+uint32_t M2MNsdlInterface::_clock_start = 0;
+uint32_t M2MNsdlInterface::_clock_ticks = 0;
+uint32_t M2MNsdlInterface::_exec_time = 0;
+
+// Seconds the CoAP library may keep resending a confirmable message. The
+// interval doubles on each resend and is up to 1.5 times longer at random.
+static const uint32_t COAP_RESEND_TIME = (RETRY_INTERVAL * ((2 << RETRY_COUNT) - 1) * 3 + 1) / 2;
+
+// Seconds the CoAP library keeps a received message for duplicate detection.
+static const uint32_t COAP_DUPLICATE_TIME = 60;
+
+// Moves a time forward to the given one, never back.
+static void move_time_forward(uint32_t *time, uint32_t value)
+{
+    uint32_t current = m2m_atomic_load(time);
+    while((int32_t)(value - current) > 0 &&
+          !m2m_atomic_compare_exchange(time, &current, value)) {
+    }
+}
+
+// Size of the copy the NSDL library keeps of a created resource. Its
+// resource type and interface description are interned, see
+// share_nsdl_string().
+static int32_t nsdl_resource_memory(const sn_nsdl_resource_info_s *resource)
+{
+    int32_t memory = sizeof(sn_nsdl_resource_info_s) +
+                     resource->pathlen +
+                     resource->resourcelen;
+    if(resource->resource_parameters_ptr) {
+        memory += sizeof(sn_nsdl_resource_parameters_s);
+    }
+    return memory;
+}
+
+// NSDL library copies the resource type and interface description of every
+// resource it creates. The copy is swapped for the interned value, the
+// library then holds a reference of its own which __nsdl_c_memory_free()
+// drops when the library frees the bytes.
+static void share_nsdl_string(uint8_t *&bytes, uint16_t length, const String &value)
+{
+    if(bytes && length == value.length()) {
+        const char *shared = M2MStringPool::acquire_bytes(value);
+        if(shared) {
+            free(bytes);
+            bytes = (uint8_t*)shared;
+        }
+    }
+}
+
 M2MNsdlInterface::M2MNsdlInterface(M2MNsdlObserver &observer)
 : _observer(observer),
   _server(NULL),
@@ -33,15 +98,21 @@ M2MNsdlInterface::M2MNsdlInterface(M2MNsdlObserver &observer)
   _registration_timer(new M2MTimer(*this)),
   _nsdl_handle(NULL),
   _counter_for_nsdl(0),
+  _execution_deadline(0),
+  _resend_until(0),
+  _duplicate_until(0),
   _register_id(0),
   _unregister_id(0),
   _update_id(0),
-  _bootstrap_id(0)
+  _bootstrap_id(0),
+  _location(NULL),
+  _location_length(0),
+  _resume_id(0),
+  _resumed(false)
 {
     tr_debug("M2MNsdlInterface::M2MNsdlInterface()");
     _endpoint = NULL;
     _resource = NULL;
-    __nsdl_interface = this;
 
     _bootstrap_endpoint.device_object = NULL;
     _bootstrap_endpoint.oma_bs_status_cb = NULL;
@@ -59,6 +130,10 @@ M2MNsdlInterface::M2MNsdlInterface(M2MNsdlObserver &observer)
     // and receiving purposes.
     _nsdl_handle = sn_nsdl_init(&(__nsdl_c_send_to_server), &(__nsdl_c_received_from_server),
                  &(__nsdl_c_memory_alloc), &(__nsdl_c_memory_free));
+    // Library callbacks are routed to the interface owning the handle.
+    if(_nsdl_handle) {
+        __nsdl_interface_register(_nsdl_handle, this);
+    }
 
     initialize();
 }
@@ -82,17 +157,25 @@ M2MNsdlInterface::~M2MNsdlInterface()
         memory_free(_endpoint);
         _endpoint = NULL;
     }
+    memory_free(_location);
     delete _nsdl_exceution_timer;
     delete _registration_timer;
+    // The objects outlive the NSDL library and its copies of them.
+    M2MObjectList::const_iterator it = _object_list.begin();
+    for ( ; it != _object_list.end(); it++ ) {
+        release_nsdl_memory(*it, (*it)->name());
+    }
     _object_list.clear();
 
     if(_server){
         delete _server;
         _server = NULL;
     }
+    if(_nsdl_handle) {
+        __nsdl_interface_unregister(_nsdl_handle);
+    }
     sn_nsdl_destroy(_nsdl_handle);
     _nsdl_handle = NULL;
-    __nsdl_interface = NULL;
     tr_debug("M2MNsdlInterface::~M2MNsdlInterface() - OUT");
 }
 
@@ -104,9 +187,17 @@ bool M2MNsdlInterface::initialize()
     //Sets the packet retransmission attempts and time interval
     sn_coap_protocol_set_retransmission_parameters(RETRY_COUNT,RETRY_INTERVAL);
 
+    // The first tick asks the observer for its deadlines, it may
+    // still be under construction now.
+#ifdef __linux__
+    // The first interface of the process starts the clock.
+    uint32_t start = 0;
+    m2m_atomic_compare_exchange(&_clock_start, &start, current_seconds());
+#endif
+    m2m_atomic_store(&_execution_deadline, (uint32_t)(coap_time() + ONE_SECOND_TIMER));
     _nsdl_exceution_timer->start_timer(ONE_SECOND_TIMER * 1000,
                                        M2MTimerObserver::NsdlExecution,
-                                       false);
+                                       true);
 
     // Allocate the memory for resources
     _resource = (sn_nsdl_resource_info_s*)memory_alloc(sizeof(sn_nsdl_resource_info_s));
@@ -218,6 +309,7 @@ bool M2MNsdlInterface::create_bootstrap_resource(sn_nsdl_addr_s *address)
     _bootstrap_endpoint.oma_bs_status_cb = &__nsdl_c_bootstrap_done;
 
     if(_bootstrap_id == 0) {
+        update_coap_time();
         _bootstrap_id = sn_nsdl_oma_bootstrap(_nsdl_handle,
                                                address,
                                                _endpoint,
@@ -237,6 +329,7 @@ bool M2MNsdlInterface::send_register_message(uint8_t* address,
     bool success = false;
     if(set_NSP_address(_nsdl_handle,address, port, address_type) == 0) {
         if(_register_id == 0) {
+            update_coap_time();
             _register_id = sn_nsdl_register_endpoint(_nsdl_handle,_endpoint);
             tr_debug("M2MNsdlInterface::send_register_message - _register_id %d", _register_id);
             success = _register_id != 0;
@@ -245,6 +338,47 @@ bool M2MNsdlInterface::send_register_message(uint8_t* address,
     return success;
 }
 
+bool M2MNsdlInterface::send_resume_registration(uint8_t* address,
+                                                const uint16_t port,
+                                                sn_nsdl_addr_type_e address_type,
+                                                const uint8_t *location,
+                                                uint8_t location_length)
+{
+    tr_debug("M2MNsdlInterface::send_resume_registration()");
+    bool success = false;
+    uint8_t address_length = (SN_NSDL_ADDRESS_TYPE_IPV4 == address_type) ? 4 : 16;
+    if(address && _resume_id == 0 && _register_id == 0 &&
+       set_location(location, location_length) &&
+       set_NSP_address(_nsdl_handle, address, port, address_type) == 0) {
+        // The library sends only to the address it registered with,
+        // the update goes out on its own.
+        memcpy(_server_address, address, address_length);
+        _sn_nsdl_address.type = address_type;
+        _sn_nsdl_address.addr_len = address_length;
+        _sn_nsdl_address.addr_ptr = _server_address;
+        _sn_nsdl_address.port = port;
+        _resume_id = send_location_request(COAP_MSG_CODE_REQUEST_POST, NULL, 0);
+        tr_debug("M2MNsdlInterface::send_resume_registration - _resume_id %d", _resume_id);
+        success = _resume_id != 0;
+    }
+    return success;
+}
+
+const uint8_t* M2MNsdlInterface::registration_location(uint8_t &length) const
+{
+    length = _location_length;
+    return _location;
+}
+
+uint32_t M2MNsdlInterface::registration_lifetime() const
+{
+    uint32_t value = 0;
+    if(_endpoint && _endpoint->lifetime_ptr) {
+        value = atol((const char*)_endpoint->lifetime_ptr);
+    }
+    return value;
+}
+
 bool M2MNsdlInterface::send_update_registration(const uint32_t lifetime)
 {
     tr_debug("M2MNsdlInterface::send_update_registration( lifetime %d)", lifetime);
@@ -277,15 +411,14 @@ bool M2MNsdlInterface::send_update_registration(const uint32_t lifetime)
                                          false);
         if(_nsdl_handle &&
            _endpoint && _endpoint->lifetime_ptr) {
-            _update_id = sn_nsdl_update_registration(_nsdl_handle,
-                                                     _endpoint->lifetime_ptr,
-                                                     _endpoint->lifetime_len);
+            _update_id = send_update(_endpoint->lifetime_ptr,
+                                     _endpoint->lifetime_len);
             tr_debug("M2MNsdlInterface::send_update_registration - New lifetime value _update_id %d", _update_id);
             success = _update_id != 0;
         }
     } else {
         if(_nsdl_handle) {
-            _update_id = sn_nsdl_update_registration(_nsdl_handle, NULL, 0);
+            _update_id = send_update(NULL, 0);
             tr_debug("M2MNsdlInterface::send_update_registration - regular update- _update_id %d", _update_id);
             success = _update_id != 0;
         }
@@ -299,7 +432,10 @@ bool M2MNsdlInterface::send_unregister_message()
     bool success = false;
     //Does not clean resources automatically
     if(_unregister_id == 0) {
-       _unregister_id = sn_nsdl_unregister_endpoint(_nsdl_handle);
+       update_coap_time();
+       _unregister_id = _resumed ?
+                        send_location_request(COAP_MSG_CODE_REQUEST_DELETE, NULL, 0) :
+                        sn_nsdl_unregister_endpoint(_nsdl_handle);
        tr_debug("M2MNsdlInterface::send_unregister_message - _unregister_id %d", _unregister_id);
        success = _unregister_id != 0;
     }
@@ -328,6 +464,11 @@ uint8_t M2MNsdlInterface::send_to_server_callback(struct nsdl_s * /*nsdl_handle*
 {
     tr_debug("M2MNsdlInterface::send_to_server_callback()");
     _observer.coap_message_ready(data_ptr,data_len,address);
+    // A confirmable message stays in the resend cache of the CoAP library.
+    if(data_len && COAP_MSG_TYPE_CONFIRMABLE == (data_ptr[0] & 0x30)) {
+        move_time_forward(&_resend_until, coap_time() + COAP_RESEND_TIME);
+    }
+    schedule_execution();
     return 1;
 }
 
@@ -349,8 +490,11 @@ uint8_t M2MNsdlInterface::received_from_server_callback(struct nsdl_s * /*nsdl_h
                 tr_debug("M2MNsdlInterface::received_from_server_callback - registration callback");
                 _server = new M2MServer();
                 _server->set_resource_value(M2MServer::ShortServerID,1);
-
-                _observer.client_registered(_server);
+                _resumed = false;
+                if(coap_header->options_list_ptr) {
+                    set_location(coap_header->options_list_ptr->location_path_ptr,
+                                 coap_header->options_list_ptr->location_path_len);
+                }
                 // If lifetime is less than zero then leave the field empty
                 if(coap_header->options_list_ptr &&
                     coap_header->options_list_ptr->max_age_ptr) {
@@ -385,6 +529,9 @@ uint8_t M2MNsdlInterface::received_from_server_callback(struct nsdl_s * /*nsdl_h
                                                      M2MTimerObserver::Registration,
                                                      false);
                 }
+                // Informed last so that the location and the lifetime
+                // granted by the server are already known.
+                _observer.client_registered(_server);
             } else {
                 if(_server) {
                     delete _server;
@@ -402,6 +549,8 @@ uint8_t M2MNsdlInterface::received_from_server_callback(struct nsdl_s * /*nsdl_h
                    delete _server;
                    _server = NULL;
                 }
+                _resumed = false;
+                set_location(NULL, 0);
                 tr_debug("M2MNsdlInterface::received_from_server_callback - unregistration callback");
                 _observer.client_unregistered();
             } else {
@@ -425,6 +574,33 @@ uint8_t M2MNsdlInterface::received_from_server_callback(struct nsdl_s * /*nsdl_h
                 }
                 _observer.registration_error(error);
             }
+        } else if(coap_header->msg_id == _resume_id) {
+            _resume_id = 0;
+            if(coap_header->msg_code == COAP_MSG_CODE_RESPONSE_CHANGED) {
+                tr_debug("M2MNsdlInterface::received_from_server_callback - registration resumed");
+                if(_server) {
+                    delete _server;
+                }
+                _server = new M2MServer();
+                _server->set_resource_value(M2MServer::ShortServerID,1);
+                _resumed = true;
+                if(_endpoint->lifetime_ptr) {
+                    _registration_timer->stop_timer();
+                    _registration_timer->start_timer(registration_time() * 1000,
+                                                     M2MTimerObserver::Registration,
+                                                     false);
+                }
+                _observer.client_registered(_server);
+            } else {
+                // The server has forgotten the registration, start over.
+                tr_debug("M2MNsdlInterface::received_from_server_callback - resume rejected %d, registering", coap_header->msg_code);
+                set_location(NULL, 0);
+                _register_id = sn_nsdl_register_endpoint(_nsdl_handle,_endpoint);
+                if(_register_id == 0) {
+                    tr_error("M2MNsdlInterface::received_from_server_callback - registration failed");
+                    _observer.registration_error(M2MInterface::InvalidParameters);
+                }
+            }
         }else if(coap_header->msg_id == _bootstrap_id) {
             _bootstrap_id = 0;
             M2MInterface::Error error = interface_error(coap_header);
@@ -451,7 +627,8 @@ uint8_t M2MNsdlInterface::received_from_server_callback(struct nsdl_s * /*nsdl_h
                             uint16_t instance_id = atoi(resource_name.substr(slash_found+1,
                                                      resource_name.size()-object_name.size()).c_str());
                             M2MBase* base = find_resource(object_name);
-                            if(base) {
+                            // Resource tables have a fixed set of instances.
+                            if(base && M2MBase::ResourceTable != base->base_type()) {
                                 M2MObject* object = (M2MObject*)base;
                                 object->create_object_instance(instance_id);
                                 coap_response = object->handle_post_request(_nsdl_handle,
@@ -647,10 +824,39 @@ bool M2MNsdlInterface::process_received_data(uint8_t *data,
                                              sn_nsdl_addr_s *address)
 {
     tr_debug("M2MNsdlInterface::process_received_data( data size %d)", data_size);
-    return (0 == sn_nsdl_process_coap(_nsdl_handle,
-                                      data,
-                                      data_size,
-                                      address)) ? true : false;
+    // Bootstrap status callback doesn't carry the library handle,
+    // it is delivered to the interface processing the data.
+    M2MNsdlInterface *previous = __nsdl_processing_interface;
+    __nsdl_processing_interface = this;
+    update_coap_time();
+    // Requests are kept in the duplicate cache of the CoAP library.
+    if(data_size && (data[0] & 0x30) <= COAP_MSG_TYPE_NON_CONFIRMABLE) {
+        move_time_forward(&_duplicate_until, coap_time() + COAP_DUPLICATE_TIME);
+    }
+    bool success = (0 == sn_nsdl_process_coap(_nsdl_handle,
+                                              data,
+                                              data_size,
+                                              address)) ? true : false;
+    __nsdl_processing_interface = previous;
+    return success;
+}
+
+M2MMemoryStats M2MNsdlInterface::memory_stats() const
+{
+    M2MMemoryStats stats;
+    stats.update(M2MMemoryStats::NodeStruct, sizeof(M2MNsdlInterface) +
+                 _object_list.size() * sizeof(M2MObject*));
+    stats.update(M2MMemoryStats::ContainerSlack,
+                 (_object_list.capacity() - _object_list.size()) * sizeof(M2MObject*));
+    // Interned strings are shared by all the objects.
+    stats.update(M2MMemoryStats::Strings, M2MStringPool::memory());
+    // Objects keep their own statistics up to date, only the
+    // registered top level objects need to be summed up here.
+    M2MObjectList::const_iterator it = _object_list.begin();
+    for ( ; it != _object_list.end(); it++) {
+        stats += (*it)->memory_stats();
+    }
+    return stats;
 }
 
 void M2MNsdlInterface::stop_timers()
@@ -661,11 +867,97 @@ void M2MNsdlInterface::stop_timers()
     }
 }
 
+uint32_t M2MNsdlInterface::coap_time() const
+{
+#ifdef __linux__
+    return current_seconds() - m2m_atomic_load(&_clock_start);
+#else
+    // Without a monotonic clock the time moves on with the execution
+    // timers of all the interfaces, see advance_time().
+    return m2m_atomic_load(&_clock_ticks);
+#endif
+}
+
+void M2MNsdlInterface::advance_time(uint32_t deadline)
+{
+#ifdef __linux__
+    (void)deadline;
+#else
+    // The timer expired at the deadline it was started for. A timer
+    // restarted early makes the clock run late, never ahead of time.
+    move_time_forward(&_clock_ticks, deadline);
+#endif
+    _counter_for_nsdl = coap_time();
+}
+
+void M2MNsdlInterface::update_coap_time()
+{
+    // The CoAP library learns the time only from its execution, which
+    // doesn't run while idle. A message it queued with a stale time would
+    // look overdue and be resent right away.
+    uint32_t now = coap_time();
+    if(m2m_atomic_exchange(&_exec_time, now) != now) {
+        sn_nsdl_exec(now);
+    }
+}
+
+uint32_t M2MNsdlInterface::coap_cache_delay(uint32_t now) const
+{
+    // Resends run with a resolution of one second, expired duplicates
+    // are dropped on the first execution after their time.
+    if((int32_t)(m2m_atomic_load(&_resend_until) - now) > 0) {
+        return 1;
+    }
+    uint32_t duplicate = m2m_atomic_load(&_duplicate_until);
+    return ((int32_t)(duplicate - now) > 0) ? duplicate - now : 0;
+}
+
+void M2MNsdlInterface::schedule_execution()
+{
+    uint32_t now = coap_time();
+    uint32_t delay = _observer.coap_timer_delay(now);
+    uint32_t cache = coap_cache_delay(now);
+    if(cache && (!delay || cache < delay)) {
+        delay = cache;
+    }
+    if(!delay) {
+        // Nothing to retransmit or time out, sleep until the next message.
+        return;
+    }
+    // Called from the application and from the timer, so the deadline is
+    // claimed atomically, 0 when the timer isn't running.
+    uint32_t deadline = now + delay;
+    uint32_t scheduled = m2m_atomic_load(&_execution_deadline);
+    do {
+        if(scheduled && (int32_t)(deadline - scheduled) >= 0) {
+            return;
+        }
+    } while(!m2m_atomic_compare_exchange(&_execution_deadline, &scheduled, deadline));
+    // Another thread may have claimed an earlier deadline and started the
+    // timer before this one does, so the timer is restarted until it
+    // matches the claimed deadline. An expiry in between clears it.
+    for(;;) {
+        _nsdl_exceution_timer->start_timer((uint64_t)delay * 1000,
+                                           M2MTimerObserver::NsdlExecution,
+                                           true);
+        scheduled = m2m_atomic_load(&_execution_deadline);
+        if(!scheduled || scheduled == deadline) {
+            break;
+        }
+        deadline = scheduled;
+        now = coap_time();
+        delay = ((int32_t)(deadline - now) > 0) ? deadline - now : 1;
+    }
+}
+
 void M2MNsdlInterface::timer_expired(M2MTimerObserver::Type type)
 {
     if(M2MTimerObserver::NsdlExecution == type) {
+        advance_time(m2m_atomic_exchange(&_execution_deadline, (uint32_t)0));
+        m2m_atomic_store(&_exec_time, _counter_for_nsdl);
         sn_nsdl_exec(_counter_for_nsdl);
-        _counter_for_nsdl++;
+        _observer.coap_timer_tick(_counter_for_nsdl);
+        schedule_execution();
     } else if(M2MTimerObserver::Registration == type) {
         tr_debug("M2MNsdlInterface::timer_expired - M2MTimerObserver::Registration - Send update registration");
         send_update_registration();
@@ -691,6 +983,19 @@ void M2MNsdlInterface::observation_to_be_sent(M2MBase *object)
 void M2MNsdlInterface::resource_to_be_deleted(const String &resource_name)
 {
     tr_debug("M2MNsdlInterface::resource_to_be_deleted(resource_name %s)", resource_name.c_str());
+    M2MBase *base = find_resource(resource_name);
+    // Table rows go only with the table, which releases its own entries.
+    if(base && M2MBase::ResourceTable != base->base_type()) {
+        // Deleting a path deletes also everything below it, the path of
+        // a resource instance is "object/instance/resource/id".
+        int separators = 0;
+        for(uint32_t i = 0; i < resource_name.size(); i++) {
+            if('/' == resource_name[i]) {
+                separators++;
+            }
+        }
+        release_nsdl_memory(base, resource_name, separators > 2);
+    }
     delete_nsdl_resource(resource_name);
 }
 
@@ -708,6 +1013,9 @@ void M2MNsdlInterface::value_updated(M2MBase *base)
             case M2MBase::Resource:
                 create_nsdl_resource(base,base->name());
                 break;
+            case M2MBase::ResourceTable:
+                // Table rows are registered once, values are served from the table.
+                break;
         }
     }
     _observer.value_updated(base);
@@ -737,6 +1045,9 @@ bool M2MNsdlInterface::create_nsdl_object_structure(M2MObject *object)
 {
     tr_debug("M2MNsdlInterface::create_nsdl_object_structure()");
     bool success = false;
+    if(object && M2MBase::ResourceTable == object->base_type()) {
+        return create_nsdl_table_structure((M2MResourceTable*)object);
+    }
     if(object) {
         //object->set_under_observation(false,this);
         M2MObjectInstanceList instance_list = object->instances();
@@ -875,9 +1186,10 @@ bool M2MNsdlInterface::create_nsdl_resource(M2MBase *base, const String &name)
                 // Static resource is updated
                 _resource->mode = SN_GRS_STATIC;
 
-                res->get_value(buffer,length);
-                _resource->resource = buffer;
-                _resource->resourcelen = length;
+                // NSDL library takes its own copy while creating the
+                // resource, so the value is handed over without another one.
+                _resource->resource = res->value();
+                _resource->resourcelen = res->value_length();
             }
 
             if(M2MBase::Dynamic == base->mode()){
@@ -901,31 +1213,19 @@ bool M2MNsdlInterface::create_nsdl_resource(M2MBase *base, const String &name)
                 }
             }
 
+            // Resource type and interface description are interned in the
+            // string pool, NSDL library shares them once created.
             if(!base->resource_type().empty() && _resource->resource_parameters_ptr) {
                 _resource->resource_parameters_ptr->resource_type_ptr =
-                       ((uint8_t*)memory_alloc(base->resource_type().length()+1));
-                if(_resource->resource_parameters_ptr->resource_type_ptr) {
-                    memset(_resource->resource_parameters_ptr->resource_type_ptr,
-                          0, base->resource_type().length()+1);
-                    memcpy(_resource->resource_parameters_ptr->resource_type_ptr,
-                          (uint8_t*)base->resource_type().c_str(),
-                          base->resource_type().length());
-                    _resource->resource_parameters_ptr->resource_type_len =
-                           base->resource_type().length();
-                }
+                       (uint8_t*)base->resource_type().c_str();
+                _resource->resource_parameters_ptr->resource_type_len =
+                       base->resource_type().length();
             }
             if(!base->interface_description().empty() && _resource->resource_parameters_ptr) {
                 _resource->resource_parameters_ptr->interface_description_ptr =
-                       ((uint8_t*)memory_alloc(base->interface_description().length()+1));
-                if(_resource->resource_parameters_ptr->interface_description_ptr) {
-                    memset(_resource->resource_parameters_ptr->interface_description_ptr,
-                          0, base->interface_description().length()+1);
-                    memcpy(_resource->resource_parameters_ptr->interface_description_ptr,
-                          (uint8_t*)base->interface_description().c_str(),
-                          base->interface_description().length());
-                    _resource->resource_parameters_ptr->interface_description_len =
-                           base->interface_description().length();
-                 }
+                       (uint8_t*)base->interface_description().c_str();
+                _resource->resource_parameters_ptr->interface_description_len =
+                       base->interface_description().length();
             }
             if(_resource->resource_parameters_ptr) {
                 _resource->resource_parameters_ptr->coap_content_type = base->coap_content_type();
@@ -941,16 +1241,27 @@ bool M2MNsdlInterface::create_nsdl_resource(M2MBase *base, const String &name)
                result == -2){
                 success = true;
             }
+            if(result == 0) {
+                sn_nsdl_resource_info_s *created = sn_nsdl_get_resource(_nsdl_handle,
+                                                                        name.length(),
+                                                                        (uint8_t*)name.c_str());
+                if(created && created->resource_parameters_ptr) {
+                    sn_nsdl_resource_parameters_s *parameters = created->resource_parameters_ptr;
+                    share_nsdl_string(parameters->resource_type_ptr,
+                                      parameters->resource_type_len,
+                                      base->resource_type());
+                    share_nsdl_string(parameters->interface_description_ptr,
+                                      parameters->interface_description_len,
+                                      base->interface_description());
+                }
+                // NSDL library keeps its own copy of the newly created resource.
+                base->update_memory_stats(M2MMemoryStats::NsdlEntries,
+                                          nsdl_resource_memory(_resource));
+            }
 
             if(_resource->path) {
                 memory_free(_resource->path);
             }
-            if(_resource->resource_parameters_ptr->resource_type_ptr){
-                memory_free(_resource->resource_parameters_ptr->resource_type_ptr);
-            }
-            if(_resource->resource_parameters_ptr->interface_description_ptr){
-                memory_free(_resource->resource_parameters_ptr->interface_description_ptr);
-            }
 
             //Clear up the filled resource to fill up new resource.
             clear_resource(_resource);
@@ -964,6 +1275,142 @@ bool M2MNsdlInterface::create_nsdl_resource(M2MBase *base, const String &name)
     return success;
 }
 
+bool M2MNsdlInterface::create_nsdl_table_structure(M2MResourceTable *table)
+{
+    tr_debug("M2MNsdlInterface::create_nsdl_table_structure()");
+    bool success = false;
+    if(table) {
+        success = true;
+        table->set_under_observation(false,this);
+        int32_t last_instance = -1;
+        uint32_t rows = table->row_count();
+        tr_debug("M2MNsdlInterface::create_nsdl_table_structure - Row count %d", rows);
+        for(uint32_t row = 0; row < rows && success; row++) {
+            uint16_t instance_id = table->row_instance_id(row);
+            if(instance_id != last_instance &&
+               table->operation() != M2MBase::NOT_ALLOWED) {
+                // Object instance entry, served as TLV by the table.
+                success = create_nsdl_table_entry(table, instance_id, -1,
+                                                  table->operation());
+            }
+            last_instance = instance_id;
+            if(success) {
+                success = create_nsdl_table_entry(table, instance_id,
+                                                  table->row_resource_id(row),
+                                                  table->row_operation(row));
+            }
+        }
+        if(success && table->operation() != M2MBase::NOT_ALLOWED) {
+            success = create_nsdl_resource(table,table->name());
+        }
+    }
+    return success;
+}
+
+bool M2MNsdlInterface::create_nsdl_table_entry(M2MResourceTable *table,
+                                               uint16_t instance_id,
+                                               int32_t resource_id,
+                                               uint8_t operation)
+{
+    bool success = false;
+    // Room for "/65535/65535" and the terminator after the table name.
+    uint32_t path_size = table->name().length() + 13;
+    char *path = (char*)memory_alloc(path_size);
+    if(path && _resource) {
+        int path_length = (resource_id < 0) ?
+                snprintf(path, path_size, "%s/%d", table->name().c_str(), instance_id) :
+                snprintf(path, path_size, "%s/%d/%d", table->name().c_str(), instance_id, (int)resource_id);
+        if(sn_nsdl_get_resource(_nsdl_handle, path_length, (uint8_t*)path)) {
+            success = true;
+        } else {
+            // Rows have no node of their own, all of them are routed to the
+            // table through the dynamic callback and are never observable.
+            _resource->access = (sn_grs_resource_acl_e)operation;
+            _resource->mode = SN_GRS_DYNAMIC;
+            _resource->sn_grs_dyn_res_callback = __nsdl_c_callback;
+            _resource->path = (uint8_t*)path;
+            _resource->pathlen = path_length;
+            if(_resource->resource_parameters_ptr) {
+                _resource->resource_parameters_ptr->coap_content_type =
+                        (resource_id < 0) ? COAP_CONTENT_OMA_TLV_TYPE : 0;
+                _resource->resource_parameters_ptr->observable = 0;
+            }
+            int8_t result = sn_nsdl_create_resource(_nsdl_handle,_resource);
+            if (result == 0 ||
+               result == -2){
+                success = true;
+            }
+            if(result == 0) {
+                int32_t nsdl_memory = sizeof(sn_nsdl_resource_info_s) + path_length;
+                if(_resource->resource_parameters_ptr) {
+                    nsdl_memory += sizeof(sn_nsdl_resource_parameters_s);
+                }
+                ((M2MBase*)table)->update_memory_stats(M2MMemoryStats::NsdlEntries,
+                                                       nsdl_memory);
+            }
+            //Clear up the filled resource to fill up new resource.
+            clear_resource(_resource);
+        }
+    }
+    memory_free(path);
+    return success;
+}
+
+void M2MNsdlInterface::release_nsdl_memory(M2MBase *base,
+                                           const String &path,
+                                           bool resource_instance)
+{
+    int32_t nsdl_memory = 0;
+    switch(base->base_type()) {
+        case M2MBase::Object: {
+            // Children first, each entry is then subtracted once from every owner.
+            const M2MObjectInstanceList &list = ((M2MObject*)base)->instances();
+            M2MObjectInstanceList::const_iterator it = list.begin();
+            for ( ; it != list.end(); it++ ) {
+                release_nsdl_memory(*it, path);
+            }
+            nsdl_memory = base->memory_stats().nsdl_bytes;
+            break;
+        }
+        case M2MBase::ObjectInstance:
+            // Copies of the resources are accounted on their object instance.
+        case M2MBase::ResourceTable:
+            // Rows are accounted on the table itself.
+            nsdl_memory = base->memory_stats().nsdl_bytes;
+            break;
+        case M2MBase::Resource: {
+            // Resources keep no counters, their share is read back from
+            // the copies the library holds under the path.
+            nsdl_memory = nsdl_path_memory(path);
+            M2MResource *resource = (M2MResource*)base;
+            if(!resource_instance && resource->supports_multiple_instances()) {
+                const M2MResourceInstanceList &list = resource->resource_instances();
+                M2MResourceInstanceList::const_iterator it = list.begin();
+                for ( ; it != list.end(); it++ ) {
+                    char instance_id[8];
+                    snprintf(instance_id, sizeof(instance_id), "%d", (*it)->instance_id());
+                    String instance_path = path;
+                    instance_path += String("/");
+                    instance_path += String(instance_id);
+                    nsdl_memory += nsdl_path_memory(instance_path);
+                }
+            }
+            break;
+        }
+    }
+    if(nsdl_memory) {
+        base->update_memory_stats(M2MMemoryStats::NsdlEntries, -nsdl_memory);
+    }
+}
+
+int32_t M2MNsdlInterface::nsdl_path_memory(const String &path)
+{
+    sn_nsdl_resource_info_s *resource = sn_nsdl_get_resource(_nsdl_handle,
+                                                             path.length(),
+                                                             (uint8_t*)path.c_str());
+    return resource ? nsdl_resource_memory(resource) : 0;
+}
+
 // convenience method to get the URI from its buffer field...
 String M2MNsdlInterface::coap_to_string(uint8_t *coap_data,int coap_data_length)
 {
@@ -977,6 +1424,69 @@ String M2MNsdlInterface::coap_to_string(uint8_t *coap_data,int coap_data_length)
     return value;
 }
 
+bool M2MNsdlInterface::set_location(const uint8_t *location, uint16_t length)
+{
+    memory_free(_location);
+    _location = NULL;
+    _location_length = 0;
+    if(location && length && length <= 0xFF) {
+        _location = (uint8_t*)memory_alloc(length);
+        if(_location) {
+            memcpy(_location, location, length);
+            _location_length = (uint8_t)length;
+        }
+    }
+    return _location != NULL;
+}
+
+uint16_t M2MNsdlInterface::send_update(uint8_t *lifetime, uint8_t lifetime_length)
+{
+    update_coap_time();
+    if(!_resumed) {
+        return sn_nsdl_update_registration(_nsdl_handle, lifetime, lifetime_length);
+    }
+    // The library doesn't know a resumed registration, the update is
+    // sent to the location directly.
+    uint8_t query[24];
+    uint16_t query_length = 0;
+    if(lifetime && lifetime_length && lifetime_length <= sizeof(query) - 3) {
+        memcpy(query, "lt=", 3);
+        memcpy(query + 3, lifetime, lifetime_length);
+        query_length = 3 + lifetime_length;
+    }
+    return send_location_request(COAP_MSG_CODE_REQUEST_POST,
+                                 query_length ? query : NULL,
+                                 query_length);
+}
+
+uint16_t M2MNsdlInterface::send_location_request(sn_coap_msg_code_e msg_code,
+                                                 uint8_t *query,
+                                                 uint16_t query_length)
+{
+    if(!_nsdl_handle || !_location) {
+        return 0;
+    }
+    update_coap_time();
+    sn_coap_hdr_s coap_header;
+    sn_coap_options_list_s options;
+    memset(&coap_header, 0, sizeof(sn_coap_hdr_s));
+    memset(&options, 0, sizeof(sn_coap_options_list_s));
+    coap_header.msg_type = COAP_MSG_TYPE_CONFIRMABLE;
+    coap_header.msg_code = msg_code;
+    coap_header.uri_path_ptr = _location;
+    coap_header.uri_path_len = _location_length;
+    if(query) {
+        options.uri_query_ptr = query;
+        options.uri_query_len = query_length;
+        coap_header.options_list_ptr = &options;
+    }
+    // The library assigns the message ID while building the message.
+    if(sn_nsdl_send_coap_message(_nsdl_handle, &_sn_nsdl_address, &coap_header) != 0) {
+        return 0;
+    }
+    return coap_header.msg_id;
+}
+
 uint64_t M2MNsdlInterface::registration_time()
 {
     uint64_t value = 0;
@@ -1005,6 +1515,18 @@ M2MBase* M2MNsdlInterface::find_resource(const String &object_name)
                 tr_debug("M2MNsdlInterface::find_resource(%s) found", object_name.c_str());
                 break;
             }
+            if(M2MBase::ResourceTable == (*it)->base_type()) {
+                // Everything below a table is resolved by the table itself.
+                const String &table_name = (*it)->name();
+                if(object_name.size() > table_name.size() &&
+                   object_name[table_name.size()] == '/' &&
+                   object_name.compare(0, table_name.size(), table_name) == 0) {
+                    object = (*it);
+                    tr_debug("M2MNsdlInterface::find_resource(%s) found", object_name.c_str());
+                    break;
+                }
+                continue;
+            }
             object = find_resource((*it),object_name);
             if(object != NULL) {
                 tr_debug("M2MNsdlInterface::find_resource(%s) found", object_name.c_str());
@@ -1225,6 +1747,7 @@ void M2MNsdlInterface::send_object_observation(M2MObject *object)
 
         object->get_observation_token(token,token_length);
 
+        update_coap_time();
         sn_nsdl_send_observation_notification(_nsdl_handle,
                                               token,
                                               token_length,
@@ -1265,6 +1788,7 @@ void M2MNsdlInterface::send_object_instance_observation(M2MObjectInstance *objec
 
         object_instance->get_observation_token(token,token_length);
 
+        update_coap_time();
         sn_nsdl_send_observation_notification(_nsdl_handle,
                                               token,
                                               token_length,
@@ -1300,6 +1824,7 @@ void M2MNsdlInterface::send_resource_observation(M2MResourceInstance *resource)
         resource->get_value(value,length);
         resource->get_observation_token(token,token_length);
 
+        update_coap_time();
         sn_nsdl_send_observation_notification(_nsdl_handle,
                                               token,
                                               token_length,
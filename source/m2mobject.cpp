@@ -23,12 +23,17 @@
 #include "ns_trace.h"
 
 M2MObject::M2MObject(const String &object_name)
-: M2MBase(object_name,M2MBase::Dynamic)
+: M2MBase(object_name,M2MBase::Dynamic),
+  _memory_stats(M2MBase::memory_stats())
 {
     M2MBase::set_base_type(M2MBase::Object);
     if(M2MBase::name_id() != -1) {
         M2MBase::set_coap_content_type(99);
     }
+    update_memory_stats(M2MMemoryStats::NodeStruct,
+                        sizeof(M2MObject) - sizeof(M2MBase));
+    update_list_memory_stats(0, 0, _instance_list.size(),
+                             _instance_list.capacity());
 }
 
 M2MObject::~M2MObject()
@@ -71,7 +76,7 @@ M2MObject& M2MObject::operator=(const M2MObject& other)
             it = other._instance_list.begin();
             for (; it!=other._instance_list.end(); it++ ) {
                 ins = *it;
-                _instance_list.push_back(new M2MObjectInstance(*ins));
+                add_object_instance(new M2MObjectInstance(*ins, *this));
             }
         }
     }
@@ -79,8 +84,13 @@ M2MObject& M2MObject::operator=(const M2MObject& other)
 }
 
 M2MObject::M2MObject(const M2MObject& other)
-: M2MBase(other)
+: M2MBase(other),
+  _memory_stats(M2MBase::memory_stats())
 {
+    update_memory_stats(M2MMemoryStats::NodeStruct,
+                        sizeof(M2MObject) - sizeof(M2MBase));
+    update_list_memory_stats(0, 0, _instance_list.size(),
+                             _instance_list.capacity());
     this->operator=(other);
 }
 
@@ -91,7 +101,7 @@ M2MObjectInstance* M2MObject::create_object_instance(uint16_t instance_id)
     if(!object_instance(instance_id)) {
         instance = new M2MObjectInstance(this->name(),*this);
         instance->set_instance_id(instance_id);
-        _instance_list.push_back(instance);
+        add_object_instance(instance);
     }
     return instance;
 }
@@ -125,7 +135,12 @@ bool M2MObject::remove_object_instance(uint16_t inst_id)
 
                 delete obj;
                 obj = NULL;
+                int old_size = _instance_list.size();
+                int old_capacity = _instance_list.capacity();
                 _instance_list.erase(pos);
+                update_list_memory_stats(old_size, old_capacity,
+                                         _instance_list.size(),
+                                         _instance_list.capacity());
                 success = true;
                 break;
             }
@@ -134,6 +149,17 @@ bool M2MObject::remove_object_instance(uint16_t inst_id)
     return success;
 }
 
+void M2MObject::add_object_instance(M2MObjectInstance *instance)
+{
+    int old_size = _instance_list.size();
+    int old_capacity = _instance_list.capacity();
+    _instance_list.push_back(instance);
+    update_list_memory_stats(old_size, old_capacity,
+                             _instance_list.size(),
+                             _instance_list.capacity());
+    instance->set_memory_attached(true);
+}
+
 M2MObjectInstance* M2MObject::object_instance(uint16_t inst_id) const
 {
     tr_debug("M2MObject::object_instance(inst_id %d)", inst_id);
@@ -461,3 +487,18 @@ void M2MObject::notification_update()
         report_handler->trigger_object_notification();
     }
 }
+
+M2MMemoryStats M2MObject::memory_stats() const
+{
+    return _memory_stats;
+}
+
+void M2MObject::memory_updated(M2MMemoryStats::Category category, int32_t delta)
+{
+    update_memory_stats(category, delta);
+}
+
+void M2MObject::update_memory_stats(M2MMemoryStats::Category category, int32_t delta)
+{
+    _memory_stats.update(category, delta);
+}
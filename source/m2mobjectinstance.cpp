@@ -34,7 +34,7 @@ M2MObjectInstance& M2MObjectInstance::operator=(const M2MObjectInstance& other)
             it = other._resource_list.begin();
             for (; it!=other._resource_list.end(); it++ ) {
                 ins = *it;
-                _resource_list.push_back(new M2MResource(*ins));
+                add_resource(new M2MResource(*ins, *this));
             }
         }
     }
@@ -43,24 +43,48 @@ M2MObjectInstance& M2MObjectInstance::operator=(const M2MObjectInstance& other)
 
 M2MObjectInstance::M2MObjectInstance(const M2MObjectInstance& other)
 : M2MBase(other),
-  _object_callback(other._object_callback)
+  _object_callback(other._object_callback),
+  _memory_stats(M2MBase::memory_stats())
 {
+    update_memory_stats(M2MMemoryStats::NodeStruct,
+                        sizeof(M2MObjectInstance) - sizeof(M2MBase));
+    update_list_memory_stats(0, 0, _resource_list.size(),
+                             _resource_list.capacity());
+    this->operator=(other);
+}
+
+M2MObjectInstance::M2MObjectInstance(const M2MObjectInstance &other,
+                                     M2MObjectCallback &object_callback)
+: M2MBase(other),
+  _object_callback(object_callback),
+  _memory_stats(M2MBase::memory_stats())
+{
+    update_memory_stats(M2MMemoryStats::NodeStruct,
+                        sizeof(M2MObjectInstance) - sizeof(M2MBase));
+    update_list_memory_stats(0, 0, _resource_list.size(),
+                             _resource_list.capacity());
     this->operator=(other);
 }
 
 M2MObjectInstance::M2MObjectInstance(const String &object_name,
                                      M2MObjectCallback &object_callback)
 : M2MBase(object_name,M2MBase::Dynamic),
-  _object_callback(object_callback)
+  _object_callback(object_callback),
+  _memory_stats(M2MBase::memory_stats())
 {
     M2MBase::set_base_type(M2MBase::ObjectInstance);
     if(M2MBase::name_id() != -1) {
         M2MBase::set_coap_content_type(99);
     }
+    update_memory_stats(M2MMemoryStats::NodeStruct,
+                        sizeof(M2MObjectInstance) - sizeof(M2MBase));
+    update_list_memory_stats(0, 0, _resource_list.size(),
+                             _resource_list.capacity());
 }
 
 M2MObjectInstance::~M2MObjectInstance()
 {
+    set_memory_attached(false);
     if(!_resource_list.empty()) {
         M2MResource* res = NULL;
         M2MResourceList::const_iterator it;
@@ -90,7 +114,7 @@ M2MResource* M2MObjectInstance::create_static_resource(const String &resource_na
     res = new M2MResource(*this,resource_name, resource_type, type,
                                value, value_length, multiple_instance);
     if(res) {
-        _resource_list.push_back(res);
+        add_resource(res);
     }
     return res;
 }
@@ -109,7 +133,7 @@ M2MResource* M2MObjectInstance::create_dynamic_resource(const String &resource_n
     res = new M2MResource(*this,resource_name, resource_type, type,
                           observable, multiple_instance);
     if(res) {
-        _resource_list.push_back(res);
+        add_resource(res);
     }
     return res;
 }
@@ -130,7 +154,7 @@ M2MResourceInstance* M2MObjectInstance::create_static_resource_instance(const St
     if(!res) {
         res = new M2MResource(*this,resource_name, resource_type, type,
                               value, value_length, true);
-        _resource_list.push_back(res);
+        add_resource(res);
     }
     if(res->supports_multiple_instances()&& (res->resource_instance(instance_id) == NULL)) {
         instance = new M2MResourceInstance(resource_name, resource_type, type,
@@ -160,7 +184,7 @@ M2MResourceInstance* M2MObjectInstance::create_dynamic_resource_instance(const S
     if(!res) {
         res = new M2MResource(*this,resource_name, resource_type, type,
                           observable, true);
-        _resource_list.push_back(res);
+        add_resource(res);
     }
     if(res->supports_multiple_instances() && (res->resource_instance(instance_id) == NULL)) {
         instance = new M2MResourceInstance(resource_name, resource_type, type,*this);
@@ -205,7 +229,7 @@ bool M2MObjectInstance::remove_resource(const String &resource_name)
                     remove_resource_from_coap(obj_name);
                     delete res;
                     res = NULL;
-                    _resource_list.erase(pos);
+                    erase_resource(pos);
                     success = true;
                 }
                  break;
@@ -258,7 +282,7 @@ bool M2MObjectInstance::remove_resource_instance(const String &resource_name,
                                 if(((*itr)->name() == resource_name)) {
                                     delete res;
                                     res = NULL;
-                                    _resource_list.erase(pos);
+                                    erase_resource(pos);
                                     break;
                                 }
                             }
@@ -272,6 +296,27 @@ bool M2MObjectInstance::remove_resource_instance(const String &resource_name,
     return success;
 }
 
+void M2MObjectInstance::add_resource(M2MResource *res)
+{
+    int old_size = _resource_list.size();
+    int old_capacity = _resource_list.capacity();
+    _resource_list.push_back(res);
+    update_list_memory_stats(old_size, old_capacity,
+                             _resource_list.size(),
+                             _resource_list.capacity());
+    res->set_memory_attached(true);
+}
+
+void M2MObjectInstance::erase_resource(int pos)
+{
+    int old_size = _resource_list.size();
+    int old_capacity = _resource_list.capacity();
+    _resource_list.erase(pos);
+    update_list_memory_stats(old_size, old_capacity,
+                             _resource_list.size(),
+                             _resource_list.capacity());
+}
+
 M2MResource* M2MObjectInstance::resource(const String &resource) const
 {
     M2MResource *res = NULL;
@@ -583,3 +628,25 @@ void M2MObjectInstance::notification_update(M2MBase::Observation observation_lev
         }
     }
 }
+
+M2MMemoryStats M2MObjectInstance::memory_stats() const
+{
+    return _memory_stats;
+}
+
+void M2MObjectInstance::memory_updated(M2MMemoryStats::Category category, int32_t delta)
+{
+    update_memory_stats(category, delta);
+}
+
+void M2MObjectInstance::update_memory_stats(M2MMemoryStats::Category category, int32_t delta)
+{
+    _memory_stats.update(category, delta);
+    M2MBase::update_memory_stats(category, delta);
+}
+
+void M2MObjectInstance::update_owner_memory_stats(M2MMemoryStats::Category category,
+                                                  int32_t delta)
+{
+    _object_callback.memory_updated(category, delta);
+}
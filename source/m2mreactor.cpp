@@ -0,0 +1,378 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifdef __linux__
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include "mbed-client/m2mreactor.h"
+#include "ns_trace.h"
+
+#define MAX_EVENTS 32
+
+M2MReactor *M2MReactor::_shared = NULL;
+pthread_once_t M2MReactor::_shared_once = PTHREAD_ONCE_INIT;
+
+M2MReactor* M2MReactor::shared()
+{
+    pthread_once(&_shared_once, &M2MReactor::create_shared);
+    return _shared;
+}
+
+void M2MReactor::create_shared()
+{
+    _shared = new M2MReactor(DEFAULT_LOOPS);
+    if(!_shared->start()) {
+        tr_error("M2MReactor::create_shared() - start failed");
+    }
+}
+
+M2MReactor::M2MReactor(uint8_t loop_count)
+: _loop_count(loop_count),
+  _running(false),
+  _entries(NULL),
+  _entry_count(0)
+{
+    if(_loop_count < 1) {
+        _loop_count = 1;
+    } else if(_loop_count > MAX_LOOPS) {
+        _loop_count = MAX_LOOPS;
+    }
+    pthread_mutex_init(&_entries_mutex, NULL);
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    // Handlers can remove descriptors while their loop dispatches.
+    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    for(uint8_t i = 0; i < _loop_count; i++) {
+        Loop &loop = _loops[i];
+        loop.reactor = this;
+        loop.thread_started = false;
+        loop.entry_count = 0;
+        loop.retired = NULL;
+        pthread_mutex_init(&loop.mutex, &attributes);
+        loop.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        loop.wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(loop.epoll_fd >= 0 && loop.wakeup_fd >= 0) {
+            struct epoll_event event;
+            memset(&event, 0, sizeof(event));
+            event.events = EPOLLIN;
+            event.data.ptr = NULL;
+            epoll_ctl(loop.epoll_fd, EPOLL_CTL_ADD, loop.wakeup_fd, &event);
+        } else {
+            tr_error("M2MReactor::M2MReactor() - cannot create loop %d", i);
+        }
+    }
+    pthread_mutexattr_destroy(&attributes);
+}
+
+M2MReactor::~M2MReactor()
+{
+    stop();
+    while(_entries) {
+        Entry *entry = _entries;
+        _entries = entry->next;
+        if(entry->timer) {
+            close(entry->fd);
+        }
+        free(entry);
+    }
+    for(uint8_t i = 0; i < _loop_count; i++) {
+        Loop &loop = _loops[i];
+        while(loop.retired) {
+            Entry *entry = loop.retired;
+            loop.retired = entry->next;
+            free(entry);
+        }
+        if(loop.epoll_fd >= 0) {
+            close(loop.epoll_fd);
+        }
+        if(loop.wakeup_fd >= 0) {
+            close(loop.wakeup_fd);
+        }
+        pthread_mutex_destroy(&loop.mutex);
+    }
+    pthread_mutex_destroy(&_entries_mutex);
+}
+
+bool M2MReactor::start()
+{
+    if(__atomic_load_n(&_running, __ATOMIC_ACQUIRE)) {
+        return true;
+    }
+    __atomic_store_n(&_running, true, __ATOMIC_RELEASE);
+    for(uint8_t i = 0; i < _loop_count; i++) {
+        Loop &loop = _loops[i];
+        if(loop.epoll_fd < 0 || loop.wakeup_fd < 0 ||
+           pthread_create(&loop.thread, NULL, &M2MReactor::loop_thread, &loop) != 0) {
+            tr_error("M2MReactor::start() - cannot start loop %d", i);
+            stop();
+            return false;
+        }
+        loop.thread_started = true;
+    }
+    return true;
+}
+
+void M2MReactor::stop()
+{
+    __atomic_store_n(&_running, false, __ATOMIC_RELEASE);
+    for(uint8_t i = 0; i < _loop_count; i++) {
+        Loop &loop = _loops[i];
+        if(loop.thread_started) {
+            uint64_t value = 1;
+            if(write(loop.wakeup_fd, &value, sizeof(value)) < 0) {
+                tr_error("M2MReactor::stop() - wakeup failed");
+            }
+            pthread_join(loop.thread, NULL);
+            loop.thread_started = false;
+        }
+    }
+}
+
+bool M2MReactor::add(int fd, uint32_t events, M2MReactorHandler *handler)
+{
+    return add_entry(fd, events, handler, false);
+}
+
+bool M2MReactor::add_entry(int fd, uint32_t events, M2MReactorHandler *handler, bool timer)
+{
+    if(fd < 0 || !handler) {
+        return false;
+    }
+    Entry *entry = (Entry*)malloc(sizeof(Entry));
+    if(!entry) {
+        return false;
+    }
+    entry->fd = fd;
+    entry->events = events;
+    entry->handler = handler;
+    entry->timer = timer;
+
+    pthread_mutex_lock(&_entries_mutex);
+    if(find(fd)) {
+        pthread_mutex_unlock(&_entries_mutex);
+        free(entry);
+        return false;
+    }
+    Loop *loop = &_loops[0];
+    for(uint8_t i = 1; i < _loop_count; i++) {
+        if(_loops[i].entry_count < loop->entry_count) {
+            loop = &_loops[i];
+        }
+    }
+    entry->loop = loop;
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = epoll_events(events);
+    event.data.ptr = entry;
+    if(epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        tr_error("M2MReactor::add() - epoll_ctl failed %d", errno);
+        pthread_mutex_unlock(&_entries_mutex);
+        free(entry);
+        return false;
+    }
+    entry->next = _entries;
+    _entries = entry;
+    _entry_count++;
+    loop->entry_count++;
+    pthread_mutex_unlock(&_entries_mutex);
+    return true;
+}
+
+bool M2MReactor::modify(int fd, uint32_t events)
+{
+    bool success = false;
+    pthread_mutex_lock(&_entries_mutex);
+    Entry *entry = find(fd);
+    if(entry) {
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = epoll_events(events);
+        event.data.ptr = entry;
+        success = (epoll_ctl(entry->loop->epoll_fd, EPOLL_CTL_MOD, fd, &event) == 0);
+        if(success) {
+            entry->events = events;
+        }
+    }
+    pthread_mutex_unlock(&_entries_mutex);
+    return success;
+}
+
+void M2MReactor::remove(int fd)
+{
+    pthread_mutex_lock(&_entries_mutex);
+    Entry *entry = find(fd);
+    if(entry) {
+        unlink(entry);
+    }
+    pthread_mutex_unlock(&_entries_mutex);
+    if(!entry) {
+        return;
+    }
+
+    // Waits for a handler running in the loop, unless called from it.
+    Loop *loop = entry->loop;
+    pthread_mutex_lock(&loop->mutex);
+    epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+    entry->handler = NULL;
+    entry->next = loop->retired;
+    loop->retired = entry;
+    pthread_mutex_unlock(&loop->mutex);
+}
+
+int M2MReactor::add_timer(M2MReactorHandler *handler)
+{
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if(timer_fd < 0) {
+        tr_error("M2MReactor::add_timer() - timerfd_create failed %d", errno);
+        return -1;
+    }
+    if(!add_entry(timer_fd, Readable, handler, true)) {
+        close(timer_fd);
+        return -1;
+    }
+    return timer_fd;
+}
+
+bool M2MReactor::start_timer(int timer_fd, uint64_t interval, bool single_shot)
+{
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = interval / 1000;
+    spec.it_value.tv_nsec = (interval % 1000) * 1000000;
+    if(!single_shot) {
+        spec.it_interval = spec.it_value;
+    }
+    return timerfd_settime(timer_fd, 0, &spec, NULL) == 0;
+}
+
+void M2MReactor::remove_timer(int timer_fd)
+{
+    remove(timer_fd);
+    close(timer_fd);
+}
+
+uint8_t M2MReactor::loop_count() const
+{
+    return _loop_count;
+}
+
+uint32_t M2MReactor::registered() const
+{
+    pthread_mutex_lock(&_entries_mutex);
+    uint32_t count = _entry_count;
+    pthread_mutex_unlock(&_entries_mutex);
+    return count;
+}
+
+void* M2MReactor::loop_thread(void *argument)
+{
+    Loop *loop = (Loop*)argument;
+    loop->reactor->run_loop(loop);
+    return NULL;
+}
+
+void M2MReactor::run_loop(Loop *loop)
+{
+    struct epoll_event events[MAX_EVENTS];
+    while(__atomic_load_n(&_running, __ATOMIC_ACQUIRE)) {
+        int count = epoll_wait(loop->epoll_fd, events, MAX_EVENTS, -1);
+        if(count < 0 && EINTR != errno) {
+            tr_error("M2MReactor::run_loop() - epoll_wait failed %d", errno);
+            break;
+        }
+        pthread_mutex_lock(&loop->mutex);
+        for(int i = 0; i < count; i++) {
+            Entry *entry = (Entry*)events[i].data.ptr;
+            if(!entry) {
+                uint64_t value;
+                if(read(loop->wakeup_fd, &value, sizeof(value)) < 0) {
+                    tr_debug("M2MReactor::run_loop() - wakeup already consumed");
+                }
+                continue;
+            }
+            // Entry may have been removed after epoll_wait returned it.
+            if(!entry->handler) {
+                continue;
+            }
+            if(entry->timer) {
+                uint64_t expirations = 0;
+                if(read(entry->fd, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+                    entry->handler->timer_expired(entry->fd, expirations);
+                }
+            } else {
+                uint32_t ready = 0;
+                if(events[i].events & (EPOLLIN | EPOLLRDHUP)) {
+                    ready |= Readable;
+                }
+                if(events[i].events & EPOLLOUT) {
+                    ready |= Writable;
+                }
+                if(events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    ready |= Error;
+                }
+                entry->handler->io_ready(entry->fd, ready);
+            }
+        }
+        while(loop->retired) {
+            Entry *entry = loop->retired;
+            loop->retired = entry->next;
+            free(entry);
+        }
+        pthread_mutex_unlock(&loop->mutex);
+    }
+}
+
+M2MReactor::Entry* M2MReactor::find(int fd) const
+{
+    Entry *entry = _entries;
+    while(entry && entry->fd != fd) {
+        entry = entry->next;
+    }
+    return entry;
+}
+
+void M2MReactor::unlink(Entry *entry)
+{
+    Entry **link = &_entries;
+    while(*link && *link != entry) {
+        link = &(*link)->next;
+    }
+    if(*link) {
+        *link = entry->next;
+        _entry_count--;
+        entry->loop->entry_count--;
+    }
+}
+
+uint32_t M2MReactor::epoll_events(uint32_t events)
+{
+    uint32_t result = EPOLLERR | EPOLLHUP;
+    if(events & Readable) {
+        result |= EPOLLIN;
+    }
+    if(events & Writable) {
+        result |= EPOLLOUT;
+    }
+    return result;
+}
+
+#endif // __linux__
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdlib.h>
+#include "include/m2mreceivebufferpool.h"
+#include "include/m2matomic.h"
+#include "ns_trace.h"
+
+M2MReceiveBufferPool::M2MReceiveBufferPool(uint8_t buffer_count, uint16_t buffer_size)
+: _buffers(NULL),
+  _buffer_size(buffer_size),
+  _buffer_count((buffer_count < MAX_BUFFERS) ? buffer_count : MAX_BUFFERS),
+  _free_mask(0)
+{
+    if(_buffer_count && _buffer_size) {
+        _buffers = (uint8_t*)malloc(_buffer_count * _buffer_size);
+    }
+    if(_buffers) {
+        _free_mask = (_buffer_count == 32) ? 0xFFFFFFFF : ((1UL << _buffer_count) - 1);
+    } else {
+        tr_error("M2MReceiveBufferPool::M2MReceiveBufferPool() - no buffers");
+        _buffer_count = 0;
+    }
+}
+
+M2MReceiveBufferPool::~M2MReceiveBufferPool()
+{
+    free(_buffers);
+    _buffers = NULL;
+}
+
+uint8_t* M2MReceiveBufferPool::acquire()
+{
+    uint32_t mask = m2m_atomic_load(&_free_mask);
+    while(mask) {
+        uint32_t bit = mask & (~mask + 1);
+        if(m2m_atomic_compare_exchange(&_free_mask, &mask, mask & ~bit)) {
+            return _buffers + m2m_lowest_bit(bit) * _buffer_size;
+        }
+    }
+    tr_debug("M2MReceiveBufferPool::acquire() - all buffers in use");
+    return NULL;
+}
+
+void M2MReceiveBufferPool::release(uint8_t *buffer)
+{
+    if(owns(buffer)) {
+        uint32_t index = (buffer - _buffers) / _buffer_size;
+        m2m_atomic_fetch_or(&_free_mask, (uint32_t)1 << index);
+    }
+}
+
+bool M2MReceiveBufferPool::owns(const uint8_t *data) const
+{
+    return _buffers && data >= _buffers &&
+           data < _buffers + _buffer_count * _buffer_size;
+}
+
+uint16_t M2MReceiveBufferPool::buffer_size() const
+{
+    return _buffer_size;
+}
+
+uint8_t M2MReceiveBufferPool::available() const
+{
+    return m2m_bit_count(m2m_atomic_load(&_free_mask));
+}
+
+uint32_t M2MReceiveBufferPool::memory() const
+{
+    return sizeof(M2MReceiveBufferPool) + _buffer_count * _buffer_size;
+}
@@ -0,0 +1,425 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "mbed-client/m2mregistrationstore.h"
+#include "ns_trace.h"
+
+#define RECORD_VERSION          1
+#define RECORD_HEADER_LENGTH    5       // Magic and version.
+#define RECORD_MAX_LENGTH       (RECORD_HEADER_LENGTH + \
+                                 1 + M2MRegistrationStore::MAX_NAME_LENGTH + \
+                                 1 + M2MRegistrationStore::MAX_URI_LENGTH + \
+                                 1 + M2MRegistrationStore::MAX_LOCATION_LENGTH + \
+                                 4 + 4 + 1 + 16 + 2 + \
+                                 2 + M2MRegistrationStore::MAX_SESSION_LENGTH + 4)
+
+static const uint8_t RECORD_MAGIC[4] = { 'M', '2', 'M', 'R' };
+
+// The record may hold the DTLS session, so buffers are wiped before being freed.
+static void wipe(uint8_t *data, uint32_t length)
+{
+    volatile uint8_t *p = data;
+    while(length--) {
+        *p++ = 0;
+    }
+}
+
+// Creates the file readable by the owner only, the record may hold the
+// DTLS session.
+static FILE* open_private(const char *path)
+{
+#ifdef __linux__
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if(fd < 0) {
+        return NULL;
+    }
+    FILE *file = fdopen(fd, "wb");
+    if(!file) {
+        close(fd);
+    }
+    return file;
+#else
+    return fopen(path, "wb");
+#endif
+}
+
+// FNV-1a, catches a truncated or damaged file.
+static uint32_t checksum(const uint8_t *data, uint32_t length)
+{
+    uint32_t hash = 2166136261U;
+    for(uint32_t i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 16777619U;
+    }
+    return hash;
+}
+
+static void write_u16(uint8_t *&p, uint16_t value)
+{
+    *p++ = (uint8_t)(value >> 8);
+    *p++ = (uint8_t)value;
+}
+
+static void write_u32(uint8_t *&p, uint32_t value)
+{
+    write_u16(p, (uint16_t)(value >> 16));
+    write_u16(p, (uint16_t)value);
+}
+
+static uint32_t read_u32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | p[3];
+}
+
+M2MRegistrationStore::M2MRegistrationStore(const char *path)
+: _path(NULL),
+  _location_length(0),
+  _lifetime(0),
+  _registered_at(0),
+  _address_length(0),
+  _port(0),
+  _session(NULL),
+  _session_length(0)
+{
+    memset(_endpoint_name, 0, sizeof(_endpoint_name));
+    memset(_server_uri, 0, sizeof(_server_uri));
+    memset(_location, 0, sizeof(_location));
+    memset(_address, 0, sizeof(_address));
+    if(path) {
+        size_t length = strlen(path) + 1;
+        _path = (char*)malloc(length);
+        if(_path) {
+            memcpy(_path, path, length);
+        }
+    }
+}
+
+M2MRegistrationStore::~M2MRegistrationStore()
+{
+    release_session();
+    free(_path);
+}
+
+bool M2MRegistrationStore::load()
+{
+    bool success = false;
+    FILE *file = _path ? fopen(_path, "rb") : NULL;
+    if(file) {
+        uint8_t *buffer = (uint8_t*)malloc(RECORD_MAX_LENGTH + 1);
+        if(buffer) {
+            uint32_t length = fread(buffer, 1, RECORD_MAX_LENGTH + 1, file);
+            success = length <= RECORD_MAX_LENGTH && parse(buffer, length);
+            wipe(buffer, length);
+            free(buffer);
+        }
+        fclose(file);
+    }
+    if(!success) {
+        tr_debug("M2MRegistrationStore::load() - no saved registration");
+        _location_length = 0;
+        _address_length = 0;
+        release_session();
+    }
+    return success;
+}
+
+bool M2MRegistrationStore::save()
+{
+    if(!_path) {
+        return false;
+    }
+    uint8_t *buffer = (uint8_t*)malloc(RECORD_MAX_LENGTH);
+    size_t path_length = strlen(_path);
+    char *temporary = (char*)malloc(path_length + 5);
+    bool success = false;
+    uint32_t length = 0;
+    if(buffer && temporary && serialize(buffer, length)) {
+        memcpy(temporary, _path, path_length);
+        memcpy(temporary + path_length, ".tmp", 5);
+        // Written aside, flushed to the disk and renamed, a crash never
+        // leaves half a record.
+        FILE *file = open_private(temporary);
+        if(file) {
+            success = fwrite(buffer, 1, length, file) == length;
+            success = (fflush(file) == 0) && success;
+#ifdef __linux__
+            success = success && (fsync(fileno(file)) == 0);
+#endif
+            success = (fclose(file) == 0) && success;
+            if(success) {
+                success = rename(temporary, _path) == 0;
+            }
+            if(!success) {
+                remove(temporary);
+            }
+        }
+    }
+    if(!success) {
+        tr_error("M2MRegistrationStore::save() - failed");
+    }
+    if(buffer) {
+        wipe(buffer, length);
+    }
+    free(buffer);
+    free(temporary);
+    return success;
+}
+
+void M2MRegistrationStore::clear()
+{
+    memset(_endpoint_name, 0, sizeof(_endpoint_name));
+    memset(_server_uri, 0, sizeof(_server_uri));
+    _location_length = 0;
+    _lifetime = 0;
+    _registered_at = 0;
+    _address_length = 0;
+    _port = 0;
+    release_session();
+    if(_path) {
+        remove(_path);
+    }
+}
+
+bool M2MRegistrationStore::is_registered() const
+{
+    return _location_length != 0;
+}
+
+bool M2MRegistrationStore::can_resume(const char *endpoint_name,
+                                      const char *server_uri,
+                                      uint32_t now) const
+{
+    if(!_location_length || !endpoint_name || !server_uri) {
+        return false;
+    }
+    if(strcmp(_endpoint_name, endpoint_name) != 0 ||
+       strcmp(_server_uri, server_uri) != 0) {
+        return false;
+    }
+    // A clock that went backwards can't tell how much lifetime is left.
+    return now >= _registered_at && now - _registered_at < _lifetime;
+}
+
+bool M2MRegistrationStore::set_registration(const char *endpoint_name,
+                                            const char *server_uri,
+                                            const uint8_t *location,
+                                            uint8_t location_length,
+                                            uint32_t lifetime,
+                                            uint32_t now)
+{
+    if(!endpoint_name || !server_uri || !location || !location_length ||
+       strlen(endpoint_name) > MAX_NAME_LENGTH ||
+       strlen(server_uri) > MAX_URI_LENGTH ||
+       location_length > MAX_LOCATION_LENGTH) {
+        return false;
+    }
+    memset(_endpoint_name, 0, sizeof(_endpoint_name));
+    strcpy(_endpoint_name, endpoint_name);
+    memset(_server_uri, 0, sizeof(_server_uri));
+    strcpy(_server_uri, server_uri);
+    memcpy(_location, location, location_length);
+    _location_length = location_length;
+    _lifetime = lifetime;
+    _registered_at = now;
+    return true;
+}
+
+void M2MRegistrationStore::registration_updated(uint32_t lifetime, uint32_t now)
+{
+    if(lifetime) {
+        _lifetime = lifetime;
+    }
+    _registered_at = now;
+}
+
+const uint8_t* M2MRegistrationStore::location(uint8_t &length) const
+{
+    length = _location_length;
+    return _location_length ? _location : NULL;
+}
+
+uint32_t M2MRegistrationStore::lifetime() const
+{
+    return _lifetime;
+}
+
+uint32_t M2MRegistrationStore::registered_at() const
+{
+    return _registered_at;
+}
+
+void M2MRegistrationStore::set_server_address(const uint8_t *address, uint8_t length, uint16_t port)
+{
+    _address_length = 0;
+    if(address && (4 == length || 16 == length)) {
+        memcpy(_address, address, length);
+        _address_length = length;
+        _port = port;
+    }
+}
+
+const uint8_t* M2MRegistrationStore::server_address(uint8_t &length, uint16_t &port) const
+{
+    length = _address_length;
+    port = _port;
+    return _address_length ? _address : NULL;
+}
+
+bool M2MRegistrationStore::set_dtls_session(const uint8_t *session, uint16_t length)
+{
+    if(session && length > MAX_SESSION_LENGTH) {
+        return false;
+    }
+    uint8_t *copy = NULL;
+    if(session && length) {
+        copy = (uint8_t*)malloc(length);
+        if(!copy) {
+            return false;
+        }
+        memcpy(copy, session, length);
+    }
+    release_session();
+    _session = copy;
+    _session_length = copy ? length : 0;
+    return true;
+}
+
+const uint8_t* M2MRegistrationStore::dtls_session(uint16_t &length) const
+{
+    length = _session_length;
+    return _session;
+}
+
+void M2MRegistrationStore::release_session()
+{
+    if(_session) {
+        wipe(_session, _session_length);
+        free(_session);
+    }
+    _session = NULL;
+    _session_length = 0;
+}
+
+bool M2MRegistrationStore::serialize(uint8_t *buffer, uint32_t &length) const
+{
+    if(!_location_length) {
+        return false;
+    }
+    uint8_t *p = buffer;
+    memcpy(p, RECORD_MAGIC, sizeof(RECORD_MAGIC));
+    p += sizeof(RECORD_MAGIC);
+    *p++ = RECORD_VERSION;
+    uint8_t name_length = (uint8_t)strlen(_endpoint_name);
+    *p++ = name_length;
+    memcpy(p, _endpoint_name, name_length);
+    p += name_length;
+    uint8_t uri_length = (uint8_t)strlen(_server_uri);
+    *p++ = uri_length;
+    memcpy(p, _server_uri, uri_length);
+    p += uri_length;
+    *p++ = _location_length;
+    memcpy(p, _location, _location_length);
+    p += _location_length;
+    write_u32(p, _lifetime);
+    write_u32(p, _registered_at);
+    *p++ = _address_length;
+    memcpy(p, _address, _address_length);
+    p += _address_length;
+    write_u16(p, _port);
+    write_u16(p, _session_length);
+    if(_session_length) {
+        memcpy(p, _session, _session_length);
+        p += _session_length;
+    }
+    write_u32(p, checksum(buffer, p - buffer));
+    length = p - buffer;
+    return true;
+}
+
+bool M2MRegistrationStore::parse(const uint8_t *buffer, uint32_t length)
+{
+    if(length < RECORD_HEADER_LENGTH + 4 ||
+       memcmp(buffer, RECORD_MAGIC, sizeof(RECORD_MAGIC)) != 0 ||
+       RECORD_VERSION != buffer[sizeof(RECORD_MAGIC)] ||
+       checksum(buffer, length - 4) != read_u32(buffer + length - 4)) {
+        return false;
+    }
+    const uint8_t *p = buffer + RECORD_HEADER_LENGTH;
+    const uint8_t *end = buffer + length - 4;
+
+    if(p >= end || *p > MAX_NAME_LENGTH || end - p < 1 + *p) {
+        return false;
+    }
+    uint8_t name_length = *p++;
+    const uint8_t *name = p;
+    p += name_length;
+
+    if(p >= end || *p > MAX_URI_LENGTH || end - p < 1 + *p) {
+        return false;
+    }
+    uint8_t uri_length = *p++;
+    const uint8_t *uri = p;
+    p += uri_length;
+
+    if(p >= end || !*p || *p > MAX_LOCATION_LENGTH || end - p < 1 + *p) {
+        return false;
+    }
+    uint8_t location_length = *p++;
+    const uint8_t *location = p;
+    p += location_length;
+
+    if(end - p < 9) {
+        return false;
+    }
+    uint32_t lifetime = read_u32(p);
+    uint32_t registered_at = read_u32(p + 4);
+    p += 8;
+    uint8_t address_length = *p++;
+    if((address_length && 4 != address_length && 16 != address_length) ||
+       end - p < address_length + 4) {
+        return false;
+    }
+    const uint8_t *address = p;
+    p += address_length;
+    uint16_t port = (p[0] << 8) | p[1];
+    uint16_t session_length = (p[2] << 8) | p[3];
+    p += 4;
+    if(session_length > MAX_SESSION_LENGTH || end - p != session_length) {
+        return false;
+    }
+    if(!set_dtls_session(session_length ? p : NULL, session_length)) {
+        return false;
+    }
+
+    memset(_endpoint_name, 0, sizeof(_endpoint_name));
+    memcpy(_endpoint_name, name, name_length);
+    memset(_server_uri, 0, sizeof(_server_uri));
+    memcpy(_server_uri, uri, uri_length);
+    memcpy(_location, location, location_length);
+    _location_length = location_length;
+    _lifetime = lifetime;
+    _registered_at = registered_at;
+    _address_length = address_length;
+    memcpy(_address, address, address_length);
+    _port = port;
+    return true;
+}
@@ -28,7 +28,7 @@ M2MResource& M2MResource::operator=(const M2MResource& other)
             it = other._resource_instance_list.begin();
             for (; it!=other._resource_instance_list.end(); it++ ) {
                 ins = *it;
-                _resource_instance_list.push_back(new M2MResourceInstance(*ins));
+                add_resource_instance(new M2MResourceInstance(*ins, _object_instance_callback));
             }
         }
     }
@@ -41,6 +41,13 @@ M2MResource::M2MResource(const M2MResource& other)
     this->operator=(other);
 }
 
+M2MResource::M2MResource(const M2MResource &other,
+                         M2MObjectInstanceCallback &object_instance_callback)
+: M2MResourceInstance(other, object_instance_callback)
+{
+    this->operator=(other);
+}
+
 M2MResource::M2MResource(M2MObjectInstanceCallback &object_instance_callback,
                          const String &resource_name,
                          const String &resource_type,
@@ -74,6 +81,7 @@ M2MResource::M2MResource(M2MObjectInstanceCallback &object_instance_callback,
 
 M2MResource::~M2MResource()
 {
+    set_memory_attached(false);
     if(!_resource_instance_list.empty()) {
         M2MResourceInstance* res = NULL;
         M2MResourceInstanceList::const_iterator it;
@@ -108,7 +116,12 @@ bool M2MResource::remove_resource_instance(uint16_t inst_id)
                 res = *it;
                 delete res;
                 res = NULL;
+                int old_size = _resource_instance_list.size();
+                int old_capacity = _resource_instance_list.capacity();
                 _resource_instance_list.erase(pos);
+                update_list_memory_stats(old_size, old_capacity,
+                                         _resource_instance_list.size(),
+                                         _resource_instance_list.capacity());
                 success = true;
                 break;
             }
@@ -194,6 +207,41 @@ void M2MResource::add_resource_instance(M2MResourceInstance *res)
 {
     tr_debug("M2MResource::add_resource_instance()");
     if(res) {
+        int old_size = _resource_instance_list.size();
+        int old_capacity = _resource_instance_list.capacity();
         _resource_instance_list.push_back(res);
+        update_list_memory_stats(old_size, old_capacity,
+                                 _resource_instance_list.size(),
+                                 _resource_instance_list.capacity());
+        res->set_memory_attached(memory_attached());
+    }
+}
+
+M2MMemoryStats M2MResource::memory_stats() const
+{
+    M2MMemoryStats stats = M2MResourceInstance::memory_stats();
+    stats.update(M2MMemoryStats::NodeStruct,
+                 sizeof(M2MResource) - sizeof(M2MResourceInstance) +
+                 _resource_instance_list.size() * sizeof(void*));
+    stats.update(M2MMemoryStats::ContainerSlack,
+                 (_resource_instance_list.capacity() - _resource_instance_list.size()) *
+                 sizeof(void*));
+    M2MResourceInstanceList::const_iterator it;
+    it = _resource_instance_list.begin();
+    for ( ; it != _resource_instance_list.end(); it++ ) {
+        stats += (*it)->memory_stats();
+    }
+    return stats;
+}
+
+void M2MResource::set_memory_attached(bool attached)
+{
+    // The numbers of the resource include its resource instances, which
+    // then pass their own changes to the object instance.
+    M2MResourceInstance::set_memory_attached(attached);
+    M2MResourceInstanceList::const_iterator it;
+    it = _resource_instance_list.begin();
+    for ( ; it != _resource_instance_list.end(); it++ ) {
+        (*it)->mark_memory_attached(attached);
     }
 }
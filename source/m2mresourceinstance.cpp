@@ -25,19 +25,10 @@
 M2MResourceInstance& M2MResourceInstance::operator=(const M2MResourceInstance& other)
 {
     if (this != &other) { // protect against invalid self-assignment
-
-        if(_value) {
-            free(_value);
-            _value = NULL;
-            _value_length = 0;
-        }
-        _value_length = other._value_length;
         if(other._value) {
-            _value = (uint8_t *)malloc(other._value_length+1);
-            if(_value) {
-                memset(_value, 0, other._value_length+1);
-                memcpy((uint8_t *)_value, (uint8_t *)other._value, other._value_length);
-            }
+            store_value(other._value, other._value_length);
+        } else {
+            free_value();
         }
     }
     return *this;
@@ -45,7 +36,21 @@ M2MResourceInstance& M2MResourceInstance::operator=(const M2MResourceInstance& o
 
 M2MResourceInstance::M2MResourceInstance(const M2MResourceInstance& other)
 : M2MBase(other),
-  _object_instance_callback(other._object_instance_callback)
+  _object_instance_callback(other._object_instance_callback),
+  _value(NULL),
+  _value_length(0),
+  _value_capacity(0)
+{
+    this->operator=(other);
+}
+
+M2MResourceInstance::M2MResourceInstance(const M2MResourceInstance &other,
+                                         M2MObjectInstanceCallback &object_instance_callback)
+: M2MBase(other),
+  _object_instance_callback(object_instance_callback),
+  _value(NULL),
+  _value_length(0),
+  _value_capacity(0)
 {
     this->operator=(other);
 }
@@ -60,6 +65,7 @@ M2MResourceInstance::M2MResourceInstance(const String &res_name,
   _execute_callback(NULL),
  _value(NULL),
  _value_length(0),
+ _value_capacity(0),
  _resource_type(type)
 {
     M2MBase::set_resource_type(resource_type);
@@ -78,27 +84,20 @@ M2MResourceInstance::M2MResourceInstance(const String &res_name,
   _execute_callback(NULL),
  _value(NULL),
  _value_length(0),
+ _value_capacity(0),
  _resource_type(type)
 {
     M2MBase::set_resource_type(resource_type);
     M2MBase::set_base_type(M2MBase::Resource);
     if( value != NULL && value_length > 0 ) {
-        _value = (uint8_t *)malloc(value_length+1);
-        if(_value) {
-            memset(_value, 0, value_length+1);
-            memcpy((uint8_t *)_value, (uint8_t *)value, value_length);
-            _value_length = value_length;
-        }
+        store_value(value, value_length);
     }
 }
 
 M2MResourceInstance::~M2MResourceInstance()
 {
-    if(_value) {
-        free(_value);
-        _value = NULL;
-        _value_length = 0;
-    }
+    set_memory_attached(false);
+    free_value();
 }
 
 M2MBase::BaseType M2MResourceInstance::base_type() const
@@ -134,17 +133,8 @@ bool M2MResourceInstance::set_value(const uint8_t *value,
 {
     bool success = false;
     if( value != NULL && value_length > 0 ) {
-        success = true;
-        if(_value) {
-             free(_value);
-             _value = NULL;
-             _value_length = 0;
-        }
-        _value = (uint8_t *)malloc(value_length+1);
-        if(_value) {
-            memset(_value, 0, value_length+1);
-            memcpy((uint8_t *)_value, (uint8_t *)value, value_length);
-            _value_length = value_length;
+        success = store_value(value, value_length);
+        if(success) {
             if(M2MBase::Dynamic == mode()) {
                 M2MReportHandler *report_handler = M2MBase::report_handler();
                 if( report_handler && _resource_type != M2MResourceInstance::STRING) {
@@ -202,6 +192,62 @@ uint32_t M2MResourceInstance::value_length() const
     return _value_length;
 }
 
+bool M2MResourceInstance::store_value(const uint8_t *value,
+                                      const uint32_t value_length)
+{
+    // Reuse the current buffer whenever the new value fits in it,
+    // numeric values are nearly always updated with the same length.
+    if(!_value || value_length > _value_capacity) {
+        uint8_t *buffer = _inline_value;
+        uint32_t capacity = INLINE_VALUE_SIZE;
+        if(value_length > INLINE_VALUE_SIZE) {
+            buffer = (uint8_t *)malloc(value_length+1);
+            if(!buffer) {
+                return false;
+            }
+            capacity = value_length;
+        }
+        free_value();
+        _value = buffer;
+        _value_capacity = capacity;
+        if(_value != _inline_value) {
+            update_memory_stats(M2MMemoryStats::Values, _value_capacity+1);
+        }
+    }
+    memcpy(_value, value, value_length);
+    _value[value_length] = 0;
+    _value_length = value_length;
+    return true;
+}
+
+M2MMemoryStats M2MResourceInstance::memory_stats() const
+{
+    M2MMemoryStats stats = M2MBase::memory_stats();
+    stats.update(M2MMemoryStats::NodeStruct,
+                 sizeof(M2MResourceInstance) - sizeof(M2MBase));
+    if(_value && _value != _inline_value) {
+        stats.update(M2MMemoryStats::Values, _value_capacity+1);
+    }
+    return stats;
+}
+
+void M2MResourceInstance::update_owner_memory_stats(M2MMemoryStats::Category category,
+                                                    int32_t delta)
+{
+    _object_instance_callback.memory_updated(category, delta);
+}
+
+void M2MResourceInstance::free_value()
+{
+    if(_value && _value != _inline_value) {
+        free(_value);
+        update_memory_stats(M2MMemoryStats::Values, -(_value_capacity+1));
+    }
+    _value = NULL;
+    _value_length = 0;
+    _value_capacity = 0;
+}
+
 sn_coap_hdr_s* M2MResourceInstance::handle_get_request(nsdl_s *nsdl,
                                                sn_coap_hdr_s *received_coap_header,
                                                M2MObservationHandler *observation_handler)
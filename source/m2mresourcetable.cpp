@@ -0,0 +1,548 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include "mbed-client/m2mresourcetable.h"
+#include "mbed-client/m2mobservationhandler.h"
+#include "mbed-client/m2mconstants.h"
+#include "include/m2mtlvserializer.h"
+#include "include/nsdllinker.h"
+#include "ns_trace.h"
+
+#define TABLE_INITIAL_ROWS      16
+#define TABLE_INITIAL_HEAP      128
+#define TABLE_PATH_SUFFIX_SIZE  13      // "/65535/65535" and the terminator.
+#define TABLE_ROW_SIZE          (2 * sizeof(uint32_t) + 2 * sizeof(uint8_t) + 2 * sizeof(uint16_t))
+
+static inline uint32_t table_key(uint16_t instance_id, uint16_t resource_id)
+{
+    return ((uint32_t)instance_id << 16) | resource_id;
+}
+
+M2MResourceTable::M2MResourceTable(const String &object_name)
+: M2MObject(object_name),
+  _keys(NULL),
+  _types(NULL),
+  _operations(NULL),
+  _value_offsets(NULL),
+  _value_lengths(NULL),
+  _value_capacities(NULL),
+  _row_count(0),
+  _row_capacity(0),
+  _value_heap(NULL),
+  _heap_size(0),
+  _heap_capacity(0),
+  _heap_garbage(0),
+  _const_resources(NULL)
+{
+    M2MBase::set_base_type(M2MBase::ResourceTable);
+    update_memory_stats(M2MMemoryStats::NodeStruct,
+                        sizeof(M2MResourceTable) - sizeof(M2MObject));
+}
+
+M2MResourceTable::M2MResourceTable(const String &object_name,
+                                   const M2MResourceTable::ConstResource *resources,
+                                   uint16_t count)
+: M2MObject(object_name),
+  _keys(NULL),
+  _types(NULL),
+  _operations(NULL),
+  _value_offsets(NULL),
+  _value_lengths(NULL),
+  _value_capacities(NULL),
+  _row_count(count),
+  _row_capacity(0),
+  _value_heap(NULL),
+  _heap_size(0),
+  _heap_capacity(0),
+  _heap_garbage(0),
+  _const_resources(resources)
+{
+    // The rows are the definitions themselves, nothing is copied.
+    M2MBase::set_base_type(M2MBase::ResourceTable);
+    update_memory_stats(M2MMemoryStats::NodeStruct,
+                        sizeof(M2MResourceTable) - sizeof(M2MObject));
+}
+
+M2MResourceTable::~M2MResourceTable()
+{
+    uint32_t path_size = name().length() + TABLE_PATH_SUFFIX_SIZE;
+    char *path = (char*)malloc(path_size);
+    if(path) {
+        int32_t last_instance = -1;
+        for(uint32_t row = 0; row < _row_count; row++) {
+            uint16_t instance_id = row_instance_id(row);
+            snprintf(path, path_size, "%s/%d/%d", name().c_str(),
+                     instance_id, row_resource_id(row));
+            remove_resource_from_coap(String(path));
+            if(instance_id != last_instance) {
+                snprintf(path, path_size, "%s/%d", name().c_str(), instance_id);
+                remove_resource_from_coap(String(path));
+                last_instance = instance_id;
+            }
+        }
+        free(path);
+    }
+    free(_keys);
+    free(_types);
+    free(_operations);
+    free(_value_offsets);
+    free(_value_lengths);
+    free(_value_capacities);
+    free(_value_heap);
+}
+
+bool M2MResourceTable::add_resource(uint16_t instance_id,
+                                    uint16_t resource_id,
+                                    M2MResourceInstance::ResourceType type,
+                                    M2MBase::Operation operation,
+                                    const uint8_t *value,
+                                    const uint32_t value_length)
+{
+    tr_debug("M2MResourceTable::add_resource(%d/%d)", instance_id, resource_id);
+    if(_const_resources) {
+        return false;
+    }
+    bool success = false;
+    uint32_t key = table_key(instance_id, resource_id);
+    uint32_t row = lower_bound(key);
+    if((row == _row_count || _keys[row] != key) && value_length <= 0xFFFF) {
+        if(_row_count < _row_capacity ||
+           reserve_rows(_row_capacity ? _row_capacity * 2 : TABLE_INITIAL_ROWS)) {
+            uint32_t moved = _row_count - row;
+            memmove(_keys + row + 1, _keys + row, moved * sizeof(uint32_t));
+            memmove(_types + row + 1, _types + row, moved * sizeof(uint8_t));
+            memmove(_operations + row + 1, _operations + row, moved * sizeof(uint8_t));
+            memmove(_value_offsets + row + 1, _value_offsets + row, moved * sizeof(uint32_t));
+            memmove(_value_lengths + row + 1, _value_lengths + row, moved * sizeof(uint16_t));
+            memmove(_value_capacities + row + 1, _value_capacities + row, moved * sizeof(uint16_t));
+            _keys[row] = key;
+            _types[row] = (uint8_t)type;
+            _operations[row] = (uint8_t)operation;
+            _value_offsets[row] = _heap_size;
+            _value_lengths[row] = 0;
+            _value_capacities[row] = 0;
+            _row_count++;
+
+            success = store_value(row, value, value_length);
+            if(!success) {
+                // Roll the row back, the columns keep their capacity.
+                _row_count--;
+                moved = _row_count - row;
+                memmove(_keys + row, _keys + row + 1, moved * sizeof(uint32_t));
+                memmove(_types + row, _types + row + 1, moved * sizeof(uint8_t));
+                memmove(_operations + row, _operations + row + 1, moved * sizeof(uint8_t));
+                memmove(_value_offsets + row, _value_offsets + row + 1, moved * sizeof(uint32_t));
+                memmove(_value_lengths + row, _value_lengths + row + 1, moved * sizeof(uint16_t));
+                memmove(_value_capacities + row, _value_capacities + row + 1, moved * sizeof(uint16_t));
+            }
+        }
+    }
+    update_table_memory_stats();
+    return success;
+}
+
+bool M2MResourceTable::set_resource_value(uint16_t instance_id,
+                                          uint16_t resource_id,
+                                          const uint8_t *value,
+                                          const uint32_t value_length)
+{
+    bool success = false;
+    int32_t row = find_row(instance_id, resource_id);
+    if(row >= 0 && value_length <= 0xFFFF && !_const_resources) {
+        success = store_value(row, value, value_length);
+        update_table_memory_stats();
+    }
+    return success;
+}
+
+const uint8_t* M2MResourceTable::resource_value(uint16_t instance_id,
+                                                uint16_t resource_id,
+                                                uint32_t &value_length) const
+{
+    const uint8_t *value = NULL;
+    value_length = 0;
+    int32_t row = find_row(instance_id, resource_id);
+    if(row >= 0) {
+        value = row_value(row, value_length);
+    }
+    return value;
+}
+
+int32_t M2MResourceTable::find_row(uint16_t instance_id, uint16_t resource_id) const
+{
+    uint32_t key = table_key(instance_id, resource_id);
+    uint32_t row = lower_bound(key);
+    return (row < _row_count && row_key(row) == key) ? (int32_t)row : -1;
+}
+
+uint32_t M2MResourceTable::instance_rows(uint16_t instance_id, uint32_t &first_row) const
+{
+    first_row = lower_bound(table_key(instance_id, 0));
+    uint32_t row = first_row;
+    while(row < _row_count && row_instance_id(row) == instance_id) {
+        row++;
+    }
+    return row - first_row;
+}
+
+uint32_t M2MResourceTable::row_count() const
+{
+    return _row_count;
+}
+
+uint16_t M2MResourceTable::row_instance_id(uint32_t row) const
+{
+    return (uint16_t)(row_key(row) >> 16);
+}
+
+uint16_t M2MResourceTable::row_resource_id(uint32_t row) const
+{
+    return (uint16_t)(row_key(row) & 0xFFFF);
+}
+
+M2MResourceInstance::ResourceType M2MResourceTable::row_type(uint32_t row) const
+{
+    if(_const_resources) {
+        return _const_resources[row].type;
+    }
+    return (M2MResourceInstance::ResourceType)_types[row];
+}
+
+M2MBase::Operation M2MResourceTable::row_operation(uint32_t row) const
+{
+    if(_const_resources) {
+        return M2MBase::GET_ALLOWED;
+    }
+    return (M2MBase::Operation)_operations[row];
+}
+
+const uint8_t* M2MResourceTable::row_value(uint32_t row, uint32_t &value_length) const
+{
+    if(_const_resources) {
+        value_length = _const_resources[row].value_length;
+        return _const_resources[row].value;
+    }
+    value_length = _value_lengths[row];
+    return _value_heap ? _value_heap + _value_offsets[row] : NULL;
+}
+
+sn_coap_hdr_s* M2MResourceTable::handle_get_request(nsdl_s *nsdl,
+                                                    sn_coap_hdr_s *received_coap_header,
+                                                    M2MObservationHandler */*observation_handler*/)
+{
+    tr_debug("M2MResourceTable::handle_get_request()");
+    sn_coap_hdr_s *coap_response = NULL;
+    if(received_coap_header) {
+        sn_coap_msg_code_e msg_code = COAP_MSG_CODE_RESPONSE_CONTENT;
+        int32_t instance_id = -1;
+        int32_t resource_id = -1;
+        uint8_t *data = NULL;
+        uint32_t data_length = 0;
+        bool tlv = false;
+
+        if(!parse_path(received_coap_header, instance_id, resource_id)) {
+            msg_code = COAP_MSG_CODE_RESPONSE_BAD_REQUEST;
+        } else if(resource_id >= 0) {
+            int32_t row = find_row(instance_id, resource_id);
+            if(row < 0) {
+                msg_code = COAP_MSG_CODE_RESPONSE_NOT_FOUND;
+            } else if((row_operation(row) & SN_GRS_GET_ALLOWED) == 0) {
+                msg_code = COAP_MSG_CODE_RESPONSE_BAD_REQUEST;
+            } else {
+                data = (uint8_t*)row_value(row, data_length);
+            }
+        } else if((operation() & SN_GRS_GET_ALLOWED) == 0) {
+            msg_code = COAP_MSG_CODE_RESPONSE_BAD_REQUEST;
+        } else {
+            uint32_t first_row = 0;
+            M2MTLVSerializer *serializer = new M2MTLVSerializer();
+            if(instance_id < 0) {
+                data = serializer->serialize(this, data_length);
+            } else if(instance_rows(instance_id, first_row) > 0) {
+                data = serializer->serialize(this, (uint16_t)instance_id, data_length);
+            } else {
+                msg_code = COAP_MSG_CODE_RESPONSE_NOT_FOUND;
+            }
+            delete serializer;
+            tlv = true;
+        }
+
+        if(COAP_MSG_CODE_RESPONSE_CONTENT != msg_code) {
+            tr_error("M2MResourceTable::handle_get_request - Return error %d", msg_code);
+        }
+        coap_response = sn_nsdl_build_response(nsdl,
+                                               received_coap_header,
+                                               msg_code);
+        if(coap_response && COAP_MSG_CODE_RESPONSE_CONTENT == msg_code) {
+            if(tlv) {
+                coap_response->content_type_ptr = (uint8_t*)malloc(1);
+                if(coap_response->content_type_ptr) {
+                    *coap_response->content_type_ptr = COAP_CONTENT_OMA_TLV_TYPE;
+                    coap_response->content_type_len = 1;
+                }
+            }
+            // fill in the CoAP response payload
+            coap_response->payload_len = data_length;
+            coap_response->payload_ptr = data;
+
+            coap_response->options_list_ptr = (sn_coap_options_list_s*)malloc(sizeof(sn_coap_options_list_s));
+            if(coap_response->options_list_ptr) {
+                memset(coap_response->options_list_ptr, 0, sizeof(sn_coap_options_list_s));
+                coap_response->options_list_ptr->max_age_ptr = (uint8_t*)malloc(1);
+                if(coap_response->options_list_ptr->max_age_ptr) {
+                    memset(coap_response->options_list_ptr->max_age_ptr,0,1);
+                    coap_response->options_list_ptr->max_age_len = 1;
+                }
+            }
+        } else if(tlv) {
+            free(data);
+        }
+    }
+    return coap_response;
+}
+
+sn_coap_hdr_s* M2MResourceTable::handle_put_request(nsdl_s *nsdl,
+                                                    sn_coap_hdr_s *received_coap_header,
+                                                    M2MObservationHandler *observation_handler)
+{
+    tr_debug("M2MResourceTable::handle_put_request()");
+    sn_coap_hdr_s *coap_response = NULL;
+    if(received_coap_header) {
+        sn_coap_msg_code_e msg_code = COAP_MSG_CODE_RESPONSE_CHANGED; // 2.04
+        int32_t instance_id = -1;
+        int32_t resource_id = -1;
+        int32_t row = -1;
+        if(!parse_path(received_coap_header, instance_id, resource_id) ||
+           resource_id < 0) {
+            msg_code = COAP_MSG_CODE_RESPONSE_BAD_REQUEST; // 4.00
+        } else if((row = find_row(instance_id, resource_id)) < 0) {
+            msg_code = COAP_MSG_CODE_RESPONSE_NOT_FOUND; // 4.04
+        } else if((row_operation(row) & SN_GRS_PUT_ALLOWED) == 0) {
+            msg_code = COAP_MSG_CODE_RESPONSE_BAD_REQUEST; // 4.00
+        } else if(!set_resource_value(instance_id, resource_id,
+                                      received_coap_header->payload_ptr,
+                                      received_coap_header->payload_len)) {
+            msg_code = COAP_MSG_CODE_RESPONSE_INTERNAL_SERVER_ERROR; // 5.00
+        } else if(received_coap_header->payload_ptr) {
+            tr_debug("M2MResourceTable::handle_put_request() - Updated %d/%d", instance_id, resource_id);
+            if(observation_handler) {
+                observation_handler->value_updated(this);
+            }
+        }
+        if(COAP_MSG_CODE_RESPONSE_CHANGED != msg_code) {
+            tr_error("M2MResourceTable::handle_put_request() - Return error %d", msg_code);
+        }
+        coap_response = sn_nsdl_build_response(nsdl,
+                                               received_coap_header,
+                                               msg_code);
+    }
+    return coap_response;
+}
+
+sn_coap_hdr_s* M2MResourceTable::handle_post_request(nsdl_s *nsdl,
+                                                     sn_coap_hdr_s *received_coap_header,
+                                                     M2MObservationHandler */*observation_handler*/)
+{
+    tr_debug("M2MResourceTable::handle_post_request()");
+    sn_coap_hdr_s *coap_response = NULL;
+    if(received_coap_header) {
+        tr_error("M2MResourceTable::handle_post_request - COAP_MSG_CODE_RESPONSE_METHOD_NOT_ALLOWED");
+        coap_response = sn_nsdl_build_response(nsdl,
+                                               received_coap_header,
+                                               COAP_MSG_CODE_RESPONSE_METHOD_NOT_ALLOWED);
+    }
+    return coap_response;
+}
+
+uint32_t M2MResourceTable::lower_bound(uint32_t key) const
+{
+    uint32_t low = 0;
+    uint32_t high = _row_count;
+    while(low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if(row_key(middle) < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+uint32_t M2MResourceTable::row_key(uint32_t row) const
+{
+    if(_const_resources) {
+        return table_key(_const_resources[row].instance_id,
+                         _const_resources[row].resource_id);
+    }
+    return _keys[row];
+}
+
+bool M2MResourceTable::reserve_rows(uint32_t capacity)
+{
+    bool success = true;
+    if(capacity > _row_capacity) {
+        // Every column keeps the old capacity until all of them have
+        // been grown, so a failure in between leaves the table intact.
+        uint32_t *keys = (uint32_t*)realloc(_keys, capacity * sizeof(uint32_t));
+        if(keys) {
+            _keys = keys;
+        }
+        uint8_t *types = (uint8_t*)realloc(_types, capacity * sizeof(uint8_t));
+        if(types) {
+            _types = types;
+        }
+        uint8_t *operations = (uint8_t*)realloc(_operations, capacity * sizeof(uint8_t));
+        if(operations) {
+            _operations = operations;
+        }
+        uint32_t *offsets = (uint32_t*)realloc(_value_offsets, capacity * sizeof(uint32_t));
+        if(offsets) {
+            _value_offsets = offsets;
+        }
+        uint16_t *lengths = (uint16_t*)realloc(_value_lengths, capacity * sizeof(uint16_t));
+        if(lengths) {
+            _value_lengths = lengths;
+        }
+        uint16_t *capacities = (uint16_t*)realloc(_value_capacities, capacity * sizeof(uint16_t));
+        if(capacities) {
+            _value_capacities = capacities;
+        }
+        success = keys && types && operations && offsets && lengths && capacities;
+        if(success) {
+            _row_capacity = capacity;
+        }
+    }
+    return success;
+}
+
+bool M2MResourceTable::store_value(uint32_t row, const uint8_t *value, uint32_t value_length)
+{
+    bool success = true;
+    if(!value) {
+        value_length = 0;
+    }
+    if(value_length > _value_capacities[row]) {
+        // The value doesn't fit in its slot anymore, move it to the end of
+        // the heap and leave the old slot as garbage for the next compaction.
+        if(_heap_size + value_length > _heap_capacity) {
+            success = compact_value_heap(value_length);
+        }
+        if(success) {
+            _heap_garbage += _value_capacities[row];
+            _value_offsets[row] = _heap_size;
+            _value_capacities[row] = (uint16_t)value_length;
+            _heap_size += value_length;
+        }
+    }
+    if(success) {
+        if(value_length > 0) {
+            memcpy(_value_heap + _value_offsets[row], value, value_length);
+        }
+        _value_lengths[row] = (uint16_t)value_length;
+    }
+    return success;
+}
+
+bool M2MResourceTable::compact_value_heap(uint32_t extra)
+{
+    bool success = false;
+    uint32_t live = _heap_size - _heap_garbage;
+    uint32_t capacity = (live + extra) * 2;
+    if(capacity < TABLE_INITIAL_HEAP) {
+        capacity = TABLE_INITIAL_HEAP;
+    }
+    uint8_t *heap = (uint8_t*)malloc(capacity);
+    if(heap) {
+        // Values are laid out again in row order, so that encoding
+        // an instance or the whole table reads the heap sequentially.
+        uint32_t size = 0;
+        for(uint32_t row = 0; row < _row_count; row++) {
+            if(_value_capacities[row] > 0) {
+                memcpy(heap + size, _value_heap + _value_offsets[row], _value_lengths[row]);
+            }
+            _value_offsets[row] = size;
+            _value_capacities[row] = _value_lengths[row];
+            size += _value_lengths[row];
+        }
+        free(_value_heap);
+        _value_heap = heap;
+        _heap_size = size;
+        _heap_capacity = capacity;
+        _heap_garbage = 0;
+        success = true;
+    }
+    return success;
+}
+
+bool M2MResourceTable::parse_path(sn_coap_hdr_s *coap_header,
+                                  int32_t &instance_id,
+                                  int32_t &resource_id) const
+{
+    instance_id = -1;
+    resource_id = -1;
+    if(!coap_header || !coap_header->uri_path_ptr) {
+        return false;
+    }
+    const uint8_t *path = coap_header->uri_path_ptr;
+    uint32_t length = coap_header->uri_path_len;
+    uint32_t index = 0;
+    if(index < length && path[index] == '/') {
+        index++;
+    }
+    const String &object_name = name();
+    if(length - index < object_name.length() ||
+       memcmp(path + index, object_name.c_str(), object_name.length()) != 0) {
+        return false;
+    }
+    index += object_name.length();
+
+    // Path is "object", "object/instance" or "object/instance/resource".
+    int32_t *ids[2] = { &instance_id, &resource_id };
+    for(int level = 0; level < 2 && index < length; level++) {
+        if(path[index] != '/') {
+            return false;
+        }
+        index++;
+        while(index < length && path[index] != '/') {
+            if(path[index] < '0' || path[index] > '9') {
+                return false;
+            }
+            *ids[level] = (*ids[level] < 0 ? 0 : *ids[level] * 10) + (path[index] - '0');
+            if(*ids[level] > 0xFFFF) {
+                return false;
+            }
+            index++;
+        }
+    }
+    return index == length && !(instance_id < 0 && resource_id >= 0);
+}
+
+void M2MResourceTable::update_table_memory_stats()
+{
+    M2MMemoryStats current;
+    current.node_bytes = _row_count * TABLE_ROW_SIZE;
+    current.value_bytes = _heap_size - _heap_garbage;
+    current.container_slack_bytes = (_row_capacity - _row_count) * TABLE_ROW_SIZE +
+                                    (_heap_capacity - _heap_size) + _heap_garbage;
+    update_memory_stats(M2MMemoryStats::NodeStruct,
+                        (int32_t)(current.node_bytes - _table_memory.node_bytes));
+    update_memory_stats(M2MMemoryStats::Values,
+                        (int32_t)(current.value_bytes - _table_memory.value_bytes));
+    update_memory_stats(M2MMemoryStats::ContainerSlack,
+                        (int32_t)(current.container_slack_bytes - _table_memory.container_slack_bytes));
+    _table_memory = current;
+}
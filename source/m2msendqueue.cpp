@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "include/m2msendqueue.h"
+#include "ns_trace.h"
+
+#define COAP_VERSION            1
+#define COAP_TYPE_CON           0
+#define COAP_TYPE_ACK           2
+#define COAP_TYPE_RST           3
+#define COAP_OPTION_OBSERVE     6
+#define COAP_PAYLOAD_MARKER     0xFF
+#define COAP_HEADER_LENGTH      4
+
+// Reads an option delta or length nibble with its extended bytes.
+static bool read_option_value(const uint8_t *data, uint16_t length,
+                              uint16_t &position, uint32_t &value)
+{
+    if(value == 13) {
+        if(position >= length) {
+            return false;
+        }
+        value = data[position++] + 13;
+    } else if(value == 14) {
+        if(position + 1 >= length) {
+            return false;
+        }
+        value = ((data[position] << 8) | data[position + 1]) + 269;
+        position += 2;
+    } else if(value == 15) {
+        return false;
+    }
+    return true;
+}
+
+static bool has_observe_option(const uint8_t *data, uint16_t length, uint16_t position)
+{
+    uint32_t number = 0;
+    while(position < length && data[position] != COAP_PAYLOAD_MARKER) {
+        uint32_t delta = data[position] >> 4;
+        uint32_t option_length = data[position] & 0x0F;
+        position++;
+        if(!read_option_value(data, length, position, delta) ||
+           !read_option_value(data, length, position, option_length)) {
+            return false;
+        }
+        number += delta;
+        if(number >= COAP_OPTION_OBSERVE) {
+            return number == COAP_OPTION_OBSERVE;
+        }
+        position += option_length;
+    }
+    return false;
+}
+
+M2MSendQueue::M2MSendQueue(uint8_t max_messages, uint8_t max_in_flight, uint32_t exchange_timeout)
+: _max_messages(max_messages),
+  _max_in_flight(max_in_flight),
+  _count(0),
+  _in_flight(0),
+  _exchange_timeout(exchange_timeout),
+  _now(0),
+  _sequence(0),
+  _front(-1)
+{
+    if(_max_messages > MAX_MESSAGES) {
+        _max_messages = MAX_MESSAGES;
+    }
+    if(_max_in_flight > MAX_IN_FLIGHT) {
+        _max_in_flight = MAX_IN_FLIGHT;
+    }
+    memset(_exchanges, 0, sizeof(_exchanges));
+    memset(&_stats, 0, sizeof(_stats));
+    _messages = (Message*)calloc(_max_messages, sizeof(Message));
+    if(!_messages) {
+        tr_error("M2MSendQueue::M2MSendQueue() - out of memory");
+        _max_messages = 0;
+    }
+}
+
+M2MSendQueue::~M2MSendQueue()
+{
+    clear();
+    free(_messages);
+}
+
+bool M2MSendQueue::enqueue(const uint8_t *data, uint16_t length, const sn_nsdl_addr_s *address)
+{
+    Priority priority = classify(data, length);
+    if(PRIORITY_COUNT == priority || !address || address->addr_len > 16) {
+        tr_error("M2MSendQueue::enqueue() - invalid message");
+        return false;
+    }
+    if(is_confirmable(data)) {
+        uint16_t id = message_id(data);
+        if(find_message(id) >= 0) {
+            // Retransmitted before the first copy got out.
+            return false;
+        }
+        if(find_exchange(id) >= 0) {
+            // Retransmission of a message in flight, not held back.
+            priority = Control;
+        }
+    }
+    if(Notification == priority) {
+        int index = find_notification(data, length);
+        if(index >= 0) {
+            tr_debug("M2MSendQueue::enqueue() - notification superseded");
+            remove(index);
+            _stats.superseded++;
+        }
+    }
+    if(_count >= _max_messages) {
+        int index = eviction_candidate(priority);
+        _stats.dropped++;
+        if(index < 0) {
+            tr_error("M2MSendQueue::enqueue() - queue full, message dropped");
+            return false;
+        }
+        tr_debug("M2MSendQueue::enqueue() - queue full, oldest message dropped");
+        remove(index);
+    }
+    for(uint8_t i = 0; i < _max_messages; i++) {
+        Message &message = _messages[i];
+        if(message.data) {
+            continue;
+        }
+        message.data = (uint8_t*)malloc(length);
+        if(!message.data) {
+            tr_error("M2MSendQueue::enqueue() - out of memory");
+            return false;
+        }
+        memcpy(message.data, data, length);
+        message.length = length;
+        message.sequence = _sequence++;
+        message.priority = priority;
+        message.address = *address;
+        message.address.addr_ptr = message.address_data;
+        memset(message.address_data, 0, sizeof(message.address_data));
+        if(address->addr_ptr) {
+            memcpy(message.address_data, address->addr_ptr, address->addr_len);
+        }
+        _count++;
+        _stats.queued++;
+        if(_count > _stats.largest_depth) {
+            _stats.largest_depth = _count;
+        }
+        return true;
+    }
+    return false;
+}
+
+const uint8_t* M2MSendQueue::front(uint16_t &length, sn_nsdl_addr_s *&address)
+{
+    _front = -1;
+    bool limited = _max_in_flight && _in_flight >= _max_in_flight;
+    for(uint8_t i = 0; i < _max_messages; i++) {
+        const Message &message = _messages[i];
+        if(!message.data) {
+            continue;
+        }
+        if(limited && is_confirmable(message.data) &&
+           find_exchange(message_id(message.data)) < 0) {
+            continue;
+        }
+        if(_front < 0 || message.priority < _messages[_front].priority ||
+           (message.priority == _messages[_front].priority &&
+            (int32_t)(message.sequence - _messages[_front].sequence) < 0)) {
+            _front = i;
+        }
+    }
+    if(_front < 0) {
+        length = 0;
+        address = NULL;
+        return NULL;
+    }
+    length = _messages[_front].length;
+    address = &_messages[_front].address;
+    return _messages[_front].data;
+}
+
+void M2MSendQueue::sent()
+{
+    if(_front < 0) {
+        return;
+    }
+    const Message &message = _messages[_front];
+    if(_max_in_flight && is_confirmable(message.data)) {
+        uint16_t id = message_id(message.data);
+        if(find_exchange(id) < 0 && _in_flight < _max_in_flight) {
+            _exchanges[_in_flight].message_id = id;
+            _exchanges[_in_flight].sent = _now;
+            _in_flight++;
+        }
+    }
+    _stats.sent++;
+    remove(_front);
+}
+
+void M2MSendQueue::message_received(const uint8_t *data, uint16_t length)
+{
+    if(!data || length < COAP_HEADER_LENGTH) {
+        return;
+    }
+    uint8_t type = (data[0] >> 4) & 0x03;
+    if(COAP_TYPE_ACK != type && COAP_TYPE_RST != type) {
+        return;
+    }
+    int index = find_exchange(message_id(data));
+    if(index >= 0) {
+        _exchanges[index] = _exchanges[--_in_flight];
+    }
+}
+
+void M2MSendQueue::tick(uint32_t now)
+{
+    _now = now;
+    for(uint8_t i = 0; i < _in_flight;) {
+        if(_now - _exchanges[i].sent >= _exchange_timeout) {
+            tr_debug("M2MSendQueue::tick() - exchange timed out");
+            _stats.in_flight_timeouts++;
+            _exchanges[i] = _exchanges[--_in_flight];
+        } else {
+            i++;
+        }
+    }
+}
+
+void M2MSendQueue::clear()
+{
+    for(uint8_t i = 0; i < _max_messages; i++) {
+        if(_messages[i].data) {
+            remove(i);
+        }
+    }
+    _in_flight = 0;
+}
+
+uint8_t M2MSendQueue::count() const
+{
+    return _count;
+}
+
+uint8_t M2MSendQueue::in_flight() const
+{
+    return _in_flight;
+}
+
+const M2MSendQueue::Stats& M2MSendQueue::stats() const
+{
+    return _stats;
+}
+
+M2MSendQueue::Priority M2MSendQueue::classify(const uint8_t *data, uint16_t length)
+{
+    if(!data || length < COAP_HEADER_LENGTH || (data[0] >> 6) != COAP_VERSION) {
+        return PRIORITY_COUNT;
+    }
+    uint8_t token_length = data[0] & 0x0F;
+    if(token_length > 8 || COAP_HEADER_LENGTH + token_length > length) {
+        return PRIORITY_COUNT;
+    }
+    uint8_t type = (data[0] >> 4) & 0x03;
+    uint8_t code = data[1];
+    if(COAP_TYPE_ACK == type || COAP_TYPE_RST == type || 0 == code) {
+        return Control;
+    }
+    if((code >> 5) == 0) {
+        return Registration;
+    }
+    if(has_observe_option(data, length, COAP_HEADER_LENGTH + token_length)) {
+        return Notification;
+    }
+    return Response;
+}
+
+int M2MSendQueue::find_exchange(uint16_t id) const
+{
+    for(uint8_t i = 0; i < _in_flight; i++) {
+        if(_exchanges[i].message_id == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int M2MSendQueue::find_message(uint16_t id) const
+{
+    for(uint8_t i = 0; i < _max_messages; i++) {
+        if(_messages[i].data && is_confirmable(_messages[i].data) &&
+           message_id(_messages[i].data) == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int M2MSendQueue::find_notification(const uint8_t *data, uint16_t /*length*/) const
+{
+    // Notifications of one observation share the token.
+    uint8_t token_length = data[0] & 0x0F;
+    for(uint8_t i = 0; i < _max_messages; i++) {
+        const Message &message = _messages[i];
+        if(message.data && Notification == message.priority && i != _front &&
+           (message.data[0] & 0x0F) == token_length &&
+           memcmp(message.data + COAP_HEADER_LENGTH,
+                  data + COAP_HEADER_LENGTH, token_length) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int M2MSendQueue::eviction_candidate(Priority priority) const
+{
+    int index = -1;
+    for(uint8_t i = 0; i < _max_messages; i++) {
+        const Message &message = _messages[i];
+        if(!message.data || i == _front || message.priority < priority) {
+            continue;
+        }
+        if(index < 0 || message.priority > _messages[index].priority ||
+           (message.priority == _messages[index].priority &&
+            (int32_t)(message.sequence - _messages[index].sequence) < 0)) {
+            index = i;
+        }
+    }
+    return index;
+}
+
+void M2MSendQueue::remove(int index)
+{
+    free(_messages[index].data);
+    memset(&_messages[index], 0, sizeof(Message));
+    _count--;
+    if(index == _front) {
+        _front = -1;
+    }
+}
+
+bool M2MSendQueue::is_confirmable(const uint8_t *data)
+{
+    return ((data[0] >> 4) & 0x03) == COAP_TYPE_CON;
+}
+
+uint16_t M2MSendQueue::message_id(const uint8_t *data)
+{
+    return (data[2] << 8) | data[3];
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "mbed-client/m2mstringpool.h"
+#include "include/m2matomic.h"
+#include "ns_trace.h"
+
+#define STRING_POOL_INITIAL_CAPACITY    8
+
+static const String empty_string;
+
+M2MStringPool::Entry **M2MStringPool::_entries = NULL;
+uint16_t M2MStringPool::_size = 0;
+uint16_t M2MStringPool::_capacity = 0;
+
+// Nodes are created and destroyed on the application threads while the
+// NSDL library releases its references from the network thread.
+static m2m_lock_t string_pool_lock = M2M_LOCK_INITIALIZER;
+
+M2MStringPool::Handle M2MStringPool::acquire(const String &value)
+{
+    if(value.empty()) {
+        return EMPTY;
+    }
+    m2m_lock(&string_pool_lock);
+    Handle handle = add(value);
+    m2m_unlock(&string_pool_lock);
+    return handle;
+}
+
+const char* M2MStringPool::acquire_bytes(const String &value)
+{
+    const char *bytes = NULL;
+    if(!value.empty()) {
+        m2m_lock(&string_pool_lock);
+        Handle handle = add(value);
+        if(handle != EMPTY) {
+            bytes = _entries[handle - 1]->value.c_str();
+        }
+        m2m_unlock(&string_pool_lock);
+    }
+    return bytes;
+}
+
+bool M2MStringPool::release_bytes(const void *bytes)
+{
+    bool found = false;
+    if(bytes) {
+        m2m_lock(&string_pool_lock);
+        for(uint16_t index = 0; index < _capacity && !found; index++) {
+            if(_entries[index] && _entries[index]->value.c_str() == bytes) {
+                remove(index + 1);
+                found = true;
+            }
+        }
+        m2m_unlock(&string_pool_lock);
+    }
+    return found;
+}
+
+M2MStringPool::Handle M2MStringPool::add(const String &value)
+{
+    // Distinct values are few, a linear search is cheaper than any index.
+    uint16_t free_slot = _capacity;
+    for(uint16_t index = 0; index < _capacity; index++) {
+        if(!_entries[index]) {
+            if(free_slot == _capacity) {
+                free_slot = index;
+            }
+        } else if(_entries[index]->value == value) {
+            _entries[index]->references++;
+            return index + 1;
+        }
+    }
+    if(free_slot == _capacity) {
+        if(_capacity == 0xFFFF) {
+            tr_error("M2MStringPool::acquire() - pool full");
+            return EMPTY;
+        }
+        uint32_t capacity = _capacity ? (uint32_t)_capacity * 2 : STRING_POOL_INITIAL_CAPACITY;
+        if(capacity > 0xFFFF) {
+            capacity = 0xFFFF;
+        }
+        Entry **entries = (Entry**)malloc(capacity * sizeof(Entry*));
+        if(!entries) {
+            return EMPTY;
+        }
+        memset(entries, 0, capacity * sizeof(Entry*));
+        if(_entries) {
+            memcpy(entries, _entries, _capacity * sizeof(Entry*));
+            free(_entries);
+        }
+        _entries = entries;
+        _capacity = (uint16_t)capacity;
+    }
+    Entry *entry = new Entry;
+    entry->value = value;
+    entry->references = 1;
+    _entries[free_slot] = entry;
+    _size++;
+    return free_slot + 1;
+}
+
+M2MStringPool::Handle M2MStringPool::acquire(M2MStringPool::Handle handle)
+{
+    m2m_lock(&string_pool_lock);
+    if(handle != EMPTY && handle <= _capacity && _entries[handle - 1]) {
+        _entries[handle - 1]->references++;
+    }
+    m2m_unlock(&string_pool_lock);
+    return handle;
+}
+
+void M2MStringPool::release(M2MStringPool::Handle handle)
+{
+    m2m_lock(&string_pool_lock);
+    remove(handle);
+    m2m_unlock(&string_pool_lock);
+}
+
+void M2MStringPool::remove(M2MStringPool::Handle handle)
+{
+    if(handle != EMPTY && handle <= _capacity && _entries[handle - 1]) {
+        Entry *entry = _entries[handle - 1];
+        if(--entry->references == 0) {
+            delete entry;
+            _entries[handle - 1] = NULL;
+            _size--;
+            if(_size == 0) {
+                free(_entries);
+                _entries = NULL;
+                _capacity = 0;
+            }
+        }
+    }
+}
+
+const String& M2MStringPool::string(M2MStringPool::Handle handle)
+{
+    // Entries don't move, only the table pointing at them is reallocated.
+    const String *value = &empty_string;
+    m2m_lock(&string_pool_lock);
+    if(handle != EMPTY && handle <= _capacity && _entries[handle - 1]) {
+        value = &_entries[handle - 1]->value;
+    }
+    m2m_unlock(&string_pool_lock);
+    return *value;
+}
+
+uint16_t M2MStringPool::size()
+{
+    m2m_lock(&string_pool_lock);
+    uint16_t size = _size;
+    m2m_unlock(&string_pool_lock);
+    return size;
+}
+
+uint32_t M2MStringPool::memory()
+{
+    m2m_lock(&string_pool_lock);
+    uint32_t memory = _capacity * sizeof(Entry*);
+    for(uint16_t index = 0; index < _capacity; index++) {
+        if(_entries[index]) {
+            // Strings always hold a terminating NUL on top of their capacity.
+            memory += sizeof(Entry) + _entries[index]->value.capacity() + 1;
+        }
+    }
+    m2m_unlock(&string_pool_lock);
+    return memory;
+}
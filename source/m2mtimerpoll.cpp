@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Polling of the process timers. On Linux the timers run on the shared
+// M2MTimingWheel, elsewhere they can't be polled. A platform with timers
+// of its own that can be polled defines M2M_PLATFORM_TIMER_POLL and
+// implements these in its M2MTimerPimpl instead.
+#ifndef M2M_PLATFORM_TIMER_POLL
+
+#include "mbed-client/m2mtimer.h"
+#ifdef __linux__
+#include "mbed-client/m2mtimingwheel.h"
+#endif
+
+void M2MTimer::set_polled(bool polled)
+{
+#ifdef __linux__
+    M2MTimingWheel::set_shared_polled(polled);
+#else
+    (void)polled;
+#endif
+}
+
+bool M2MTimer::next_expiry(uint64_t &time)
+{
+#ifdef __linux__
+    // Checked first so that an unpolled process doesn't create the wheel.
+    if(M2MTimingWheel::shared_polled()) {
+        return M2MTimingWheel::shared()->next_expiry(time);
+    }
+#else
+    (void)time;
+#endif
+    return false;
+}
+
+void M2MTimer::poll(uint64_t time)
+{
+#ifdef __linux__
+    if(M2MTimingWheel::shared_polled()) {
+        M2MTimingWheel::shared()->poll(time);
+    }
+#else
+    (void)time;
+#endif
+}
+
+#endif // M2M_PLATFORM_TIMER_POLL
@@ -0,0 +1,388 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifdef __linux__
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include "mbed-client/m2mtimingwheel.h"
+#include "ns_trace.h"
+
+#define SLOT_MASK   (M2MTimingWheel::SLOTS - 1)
+#define WHEEL_SPAN  (1ULL << (M2MTimingWheel::LEVELS * M2MTimingWheel::SLOT_BITS))
+#define NO_WAKE     0xFFFFFFFFFFFFFFFFULL
+
+M2MTimingWheel *M2MTimingWheel::_shared = NULL;
+pthread_once_t M2MTimingWheel::_shared_once = PTHREAD_ONCE_INIT;
+bool M2MTimingWheel::_shared_polled = false;
+
+M2MTimingWheel* M2MTimingWheel::shared()
+{
+    pthread_once(&_shared_once, &M2MTimingWheel::create_shared);
+    return _shared;
+}
+
+void M2MTimingWheel::set_shared_polled(bool polled)
+{
+    __atomic_store_n(&_shared_polled, polled, __ATOMIC_RELEASE);
+    M2MTimingWheel *wheel = shared();
+    if(polled) {
+        wheel->stop();
+    } else if(!wheel->start()) {
+        tr_error("M2MTimingWheel::set_shared_polled() - start failed");
+    }
+}
+
+bool M2MTimingWheel::shared_polled()
+{
+    return __atomic_load_n(&_shared_polled, __ATOMIC_ACQUIRE);
+}
+
+void M2MTimingWheel::create_shared()
+{
+    _shared = new M2MTimingWheel(DEFAULT_TICK);
+    if(!__atomic_load_n(&_shared_polled, __ATOMIC_ACQUIRE) && !_shared->start()) {
+        tr_error("M2MTimingWheel::create_shared() - start failed");
+    }
+}
+
+uint64_t M2MTimingWheel::now()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000 + time.tv_nsec / 1000000;
+}
+
+void M2MTimingWheel::init_timer(Timer *timer,
+                                M2MTimerObserver &observer,
+                                M2MTimerObserver::Type type)
+{
+    memset(timer, 0, sizeof(Timer));
+    timer->observer = &observer;
+    timer->type = type;
+}
+
+M2MTimingWheel::M2MTimingWheel(uint32_t tick)
+: _expired(NULL),
+  _expired_tail(&_expired),
+  _tick(tick ? tick : 1),
+  _current(0),
+  _count(0),
+  _running(NULL),
+  _dispatching(false),
+  _wake_tick(0),
+  _thread_running(false),
+  _thread_started(false)
+{
+    memset(_slots, 0, sizeof(_slots));
+    pthread_mutex_init(&_mutex, NULL);
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&_wake_cond, &attributes);
+    pthread_condattr_destroy(&attributes);
+    pthread_cond_init(&_dispatch_cond, NULL);
+}
+
+M2MTimingWheel::~M2MTimingWheel()
+{
+    stop();
+    pthread_cond_destroy(&_dispatch_cond);
+    pthread_cond_destroy(&_wake_cond);
+    pthread_mutex_destroy(&_mutex);
+}
+
+bool M2MTimingWheel::start()
+{
+    pthread_mutex_lock(&_mutex);
+    if(_thread_running) {
+        pthread_mutex_unlock(&_mutex);
+        return true;
+    }
+    _thread_running = true;
+    if(pthread_create(&_thread, NULL, &M2MTimingWheel::wheel_thread, this) != 0) {
+        tr_error("M2MTimingWheel::start() - cannot create thread %d", errno);
+        _thread_running = false;
+    }
+    _thread_started = _thread_running;
+    pthread_mutex_unlock(&_mutex);
+    return _thread_started;
+}
+
+void M2MTimingWheel::stop()
+{
+    pthread_mutex_lock(&_mutex);
+    bool started = _thread_started;
+    _thread_running = false;
+    _thread_started = false;
+    pthread_cond_signal(&_wake_cond);
+    pthread_mutex_unlock(&_mutex);
+    if(started) {
+        pthread_join(_thread, NULL);
+    }
+}
+
+void M2MTimingWheel::start_timer(Timer *timer, uint64_t interval, bool single_shot, uint64_t time)
+{
+    pthread_mutex_lock(&_mutex);
+    remove(timer);
+    if(!_count && !_expired && time / _tick > _current) {
+        // Nothing pending, skip the idle ticks instead of turning through them.
+        _current = time / _tick;
+    }
+    uint64_t ticks = (interval + _tick - 1) / _tick;
+    timer->expires = (time + interval + _tick - 1) / _tick;
+    timer->period = single_shot ? 0 : (ticks ? ticks : 1);
+    add(timer);
+    if(timer->expires < _wake_tick) {
+        pthread_cond_signal(&_wake_cond);
+    }
+    pthread_mutex_unlock(&_mutex);
+}
+
+void M2MTimingWheel::stop_timer(Timer *timer)
+{
+    pthread_mutex_lock(&_mutex);
+    remove(timer);
+    while(_dispatching && _running == timer &&
+          !pthread_equal(_dispatch_thread, pthread_self())) {
+        pthread_cond_wait(&_dispatch_cond, &_mutex);
+    }
+    pthread_mutex_unlock(&_mutex);
+}
+
+bool M2MTimingWheel::is_pending(const Timer *timer) const
+{
+    pthread_mutex_lock(&_mutex);
+    bool pending = timer->pprev != NULL;
+    pthread_mutex_unlock(&_mutex);
+    return pending;
+}
+
+uint32_t M2MTimingWheel::poll(uint64_t time)
+{
+    uint32_t dispatched = 0;
+    pthread_mutex_lock(&_mutex);
+    advance(time / _tick);
+    if(_dispatching) {
+        // Another thread is dispatching, it takes the new batch too.
+        pthread_mutex_unlock(&_mutex);
+        return 0;
+    }
+    _dispatching = true;
+    _dispatch_thread = pthread_self();
+    while(_expired) {
+        Timer *timer = _expired;
+        remove(timer);
+        if(timer->period) {
+            timer->expires += timer->period;
+            if(timer->expires < _current) {
+                // Polled late, don't replay the missed periods.
+                timer->expires = _current - 1 + timer->period;
+            }
+            add(timer);
+        }
+        _running = timer;
+        pthread_mutex_unlock(&_mutex);
+        timer->observer->timer_expired(timer->type);
+        pthread_mutex_lock(&_mutex);
+        _running = NULL;
+        pthread_cond_broadcast(&_dispatch_cond);
+        dispatched++;
+    }
+    _dispatching = false;
+    pthread_mutex_unlock(&_mutex);
+    return dispatched;
+}
+
+bool M2MTimingWheel::next_expiry(uint64_t &time) const
+{
+    pthread_mutex_lock(&_mutex);
+    bool pending = _count || _expired;
+    if(pending) {
+        time = _expired ? 0 : next_tick() * _tick;
+    }
+    pthread_mutex_unlock(&_mutex);
+    return pending;
+}
+
+uint32_t M2MTimingWheel::pending() const
+{
+    pthread_mutex_lock(&_mutex);
+    uint32_t count = _count;
+    for(const Timer *timer = _expired; timer; timer = timer->next) {
+        count++;
+    }
+    pthread_mutex_unlock(&_mutex);
+    return count;
+}
+
+void M2MTimingWheel::add(Timer *timer)
+{
+    Timer **head;
+    if(timer->expires < _current) {
+        head = &_slots[0][_current & SLOT_MASK];
+    } else {
+        uint64_t delta = timer->expires - _current;
+        uint64_t expires = timer->expires;
+        if(delta >= WHEEL_SPAN) {
+            // Beyond the wheel, parked in the slot turned last. The
+            // timer keeps its real expiry and is placed again from there.
+            expires = _current + WHEEL_SPAN - 1;
+            delta = WHEEL_SPAN - 1;
+        }
+        uint8_t level = 0;
+        while(level < LEVELS - 1 && delta >= (1ULL << ((level + 1) * SLOT_BITS))) {
+            level++;
+        }
+        head = &_slots[level][(expires >> (level * SLOT_BITS)) & SLOT_MASK];
+    }
+    link(head, timer);
+    _count++;
+}
+
+void M2MTimingWheel::remove(Timer *timer)
+{
+    if(!timer->pprev) {
+        return;
+    }
+    if(timer->due) {
+        if(_expired_tail == &timer->next) {
+            _expired_tail = timer->pprev;
+        }
+        timer->due = false;
+    } else {
+        _count--;
+    }
+    unlink(timer);
+}
+
+void M2MTimingWheel::advance(uint64_t target)
+{
+    while(_current <= target) {
+        if(!_count) {
+            _current = target + 1;
+            break;
+        }
+        uint32_t index = _current & SLOT_MASK;
+        if(!index) {
+            // Level 0 wrapped, move the timers of the next slot of each
+            // upper level down, as far as that level wrapped too.
+            for(uint8_t level = 1; level < LEVELS; level++) {
+                uint32_t slot = (_current >> (level * SLOT_BITS)) & SLOT_MASK;
+                cascade(level, slot);
+                if(slot) {
+                    break;
+                }
+            }
+        }
+        while(_slots[0][index]) {
+            Timer *timer = _slots[0][index];
+            unlink(timer);
+            _count--;
+            // Appended, so the batch is dispatched in expiry order.
+            timer->next = NULL;
+            timer->pprev = _expired_tail;
+            *_expired_tail = timer;
+            _expired_tail = &timer->next;
+            timer->due = true;
+        }
+        _current++;
+    }
+}
+
+void M2MTimingWheel::cascade(uint8_t level, uint32_t slot)
+{
+    Timer *timer = _slots[level][slot];
+    _slots[level][slot] = NULL;
+    while(timer) {
+        Timer *next = timer->next;
+        timer->pprev = NULL;
+        _count--;
+        add(timer);
+        timer = next;
+    }
+}
+
+uint64_t M2MTimingWheel::next_tick() const
+{
+    // Bounded by the next wrap of level 0, where an upper level may
+    // move timers down.
+    for(uint32_t i = 0; i < SLOTS; i++) {
+        uint64_t tick = _current + i;
+        if(!(tick & SLOT_MASK) || _slots[0][tick & SLOT_MASK]) {
+            return tick;
+        }
+    }
+    return _current + SLOTS;
+}
+
+void M2MTimingWheel::link(Timer **head, Timer *timer)
+{
+    timer->next = *head;
+    if(timer->next) {
+        timer->next->pprev = &timer->next;
+    }
+    timer->pprev = head;
+    *head = timer;
+}
+
+void M2MTimingWheel::unlink(Timer *timer)
+{
+    *timer->pprev = timer->next;
+    if(timer->next) {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+void* M2MTimingWheel::wheel_thread(void *argument)
+{
+    static_cast<M2MTimingWheel*>(argument)->run();
+    return NULL;
+}
+
+void M2MTimingWheel::run()
+{
+    pthread_mutex_lock(&_mutex);
+    while(_thread_running) {
+        if(_count || _expired) {
+            _wake_tick = _expired ? 0 : next_tick();
+            uint64_t wake = _wake_tick * _tick;
+            if(wake > now()) {
+                struct timespec time;
+                time.tv_sec = wake / 1000;
+                time.tv_nsec = (wake % 1000) * 1000000;
+                pthread_cond_timedwait(&_wake_cond, &_mutex, &time);
+            }
+        } else {
+            _wake_tick = NO_WAKE;
+            pthread_cond_wait(&_wake_cond, &_mutex);
+        }
+        // Awake, no need to signal until the next wait.
+        _wake_tick = 0;
+        if(!_thread_running) {
+            break;
+        }
+        pthread_mutex_unlock(&_mutex);
+        poll(now());
+        pthread_mutex_lock(&_mutex);
+    }
+    pthread_mutex_unlock(&_mutex);
+}
+
+#endif // __linux__
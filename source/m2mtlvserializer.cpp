@@ -15,6 +15,7 @@
  */
 #include <stdio.h>
 #include "include/m2mtlvserializer.h"
+#include "mbed-client/m2mresourcetable.h"
 #include "mbed-client/m2mconstants.h"
 
 M2MTLVSerializer::M2MTLVSerializer()
@@ -36,6 +37,61 @@ uint8_t* M2MTLVSerializer::serialize(M2MResourceList resource_list, uint32_t &si
     return serialize_resources(resource_list, size,valid);
 }
 
+uint8_t* M2MTLVSerializer::serialize(const M2MResourceTable *table, uint32_t &size)
+{
+    uint8_t *data = NULL;
+    uint32_t rows = table ? table->row_count() : 0;
+    if(rows > 0) {
+        // First pass computes the size of every instance, second pass writes them.
+        uint32_t data_size = 0;
+        uint32_t first_row = 0;
+        while(first_row < rows) {
+            uint16_t id = table->row_instance_id(first_row);
+            uint32_t last_row = first_row;
+            while(last_row < rows && table->row_instance_id(last_row) == id) {
+                last_row++;
+            }
+            uint32_t instance_size = table_rows_size(table, first_row, last_row);
+            data_size += TL_size(id, instance_size) + instance_size;
+            first_row = last_row;
+        }
+        data = (uint8_t*)malloc(data_size);
+        if(data) {
+            uint8_t *ptr = data;
+            first_row = 0;
+            while(first_row < rows) {
+                uint16_t id = table->row_instance_id(first_row);
+                uint32_t last_row = first_row;
+                while(last_row < rows && table->row_instance_id(last_row) == id) {
+                    last_row++;
+                }
+                ptr = serialize_TL(TYPE_OBJECT_INSTANCE, id,
+                                   table_rows_size(table, first_row, last_row), ptr);
+                ptr = serialize_table_rows(table, first_row, last_row, ptr);
+                first_row = last_row;
+            }
+            size = data_size;
+        }
+    }
+    return data;
+}
+
+uint8_t* M2MTLVSerializer::serialize(const M2MResourceTable *table, uint16_t instance_id, uint32_t &size)
+{
+    uint8_t *data = NULL;
+    uint32_t first_row = 0;
+    uint32_t rows = table ? table->instance_rows(instance_id, first_row) : 0;
+    if(rows > 0) {
+        uint32_t data_size = table_rows_size(table, first_row, first_row + rows);
+        data = (uint8_t*)malloc(data_size);
+        if(data) {
+            serialize_table_rows(table, first_row, first_row + rows, data);
+            size = data_size;
+        }
+    }
+    return data;
+}
+
 uint8_t* M2MTLVSerializer::serialize_object_instances(M2MObjectInstanceList object_instance_list, uint32_t &size)
 {
     uint8_t *data = NULL;
@@ -177,6 +233,60 @@ void M2MTLVSerializer::serialize_TILV(uint8_t type, uint16_t id, uint8_t *value,
     size += type_length + id_size + length_size + value_length;
 }
 
+uint32_t M2MTLVSerializer::table_rows_size(const M2MResourceTable *table, uint32_t first_row, uint32_t last_row)
+{
+    uint32_t size = 0;
+    uint32_t value_length = 0;
+    for(uint32_t row = first_row; row < last_row; row++) {
+        table->row_value(row, value_length);
+        size += TL_size(table->row_resource_id(row), value_length) + value_length;
+    }
+    return size;
+}
+
+uint8_t* M2MTLVSerializer::serialize_table_rows(const M2MResourceTable *table, uint32_t first_row, uint32_t last_row, uint8_t *ptr)
+{
+    uint32_t value_length = 0;
+    for(uint32_t row = first_row; row < last_row; row++) {
+        const uint8_t *value = table->row_value(row, value_length);
+        ptr = serialize_TL(TYPE_RESOURCE, table->row_resource_id(row), value_length, ptr);
+        if(value_length > 0) {
+            memcpy(ptr, value, value_length);
+            ptr += value_length;
+        }
+    }
+    return ptr;
+}
+
+uint32_t M2MTLVSerializer::TL_size(uint16_t id, uint32_t value_length)
+{
+    return 1 + (id > 255 ? 2 : 1) +
+           (value_length > 65535 ? 3 : value_length > 255 ? 2 : value_length > 7 ? 1 : 0);
+}
+
+uint8_t* M2MTLVSerializer::serialize_TL(uint8_t type, uint16_t id, uint32_t value_length, uint8_t *ptr)
+{
+    type += id < 256 ? 0 : ID16;
+    type += value_length < 8 ? value_length :
+            value_length < 256 ? LENGTH8 :
+            value_length < 65536 ? LENGTH16 : LENGTH24;
+    *ptr++ = type & 0xFF;
+    if(id > 255) {
+        *ptr++ = (id & 0xFF00) >> 8;
+    }
+    *ptr++ = id & 0xFF;
+    if(value_length > 65535) {
+        *ptr++ = (value_length & 0xFF0000) >> 16;
+    }
+    if(value_length > 255) {
+        *ptr++ = (value_length & 0xFF00) >> 8;
+    }
+    if(value_length > 7) {
+        *ptr++ = value_length & 0xFF;
+    }
+    return ptr;
+}
+
 uint8_t* M2MTLVSerializer::serialize_id(uint16_t id, uint32_t &size)
 {
     uint32_t id_size = id > 255 ? 2 : 1;
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifdef __linux__
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mbed-client/m2mudpbatch.h"
+#include "ns_trace.h"
+
+M2MUdpBatch::M2MUdpBatch(int socket, uint16_t datagram_size)
+: _socket(socket),
+  _datagram_size(datagram_size),
+  _send_head(0),
+  _send_count(0)
+{
+    memset(&_stats, 0, sizeof(_stats));
+    _send_data = (uint8_t*)malloc(MAX_BATCH * _datagram_size);
+    _send_headers = (struct mmsghdr*)calloc(MAX_BATCH, sizeof(struct mmsghdr));
+    _send_iovecs = (struct iovec*)calloc(MAX_BATCH, sizeof(struct iovec));
+    _send_addresses = (struct sockaddr_storage*)calloc(MAX_BATCH, sizeof(struct sockaddr_storage));
+    _receive_headers = (struct mmsghdr*)calloc(MAX_BATCH, sizeof(struct mmsghdr));
+    _receive_iovecs = (struct iovec*)calloc(MAX_BATCH, sizeof(struct iovec));
+    _receive_addresses = (struct sockaddr_storage*)calloc(MAX_BATCH, sizeof(struct sockaddr_storage));
+    if(!_send_data || !_send_headers || !_send_iovecs || !_send_addresses ||
+       !_receive_headers || !_receive_iovecs || !_receive_addresses) {
+        tr_error("M2MUdpBatch::M2MUdpBatch() - out of memory");
+        _datagram_size = 0;
+    }
+}
+
+M2MUdpBatch::~M2MUdpBatch()
+{
+    free(_send_data);
+    free(_send_headers);
+    free(_send_iovecs);
+    free(_send_addresses);
+    free(_receive_headers);
+    free(_receive_iovecs);
+    free(_receive_addresses);
+}
+
+bool M2MUdpBatch::queue(const uint8_t *data,
+                        uint16_t length,
+                        const struct sockaddr *address,
+                        socklen_t address_length)
+{
+    if(!_datagram_size || length > _datagram_size ||
+       address_length > sizeof(struct sockaddr_storage)) {
+        tr_error("M2MUdpBatch::queue() - datagram too large");
+        return false;
+    }
+    if(_send_head + _send_count == MAX_BATCH) {
+        flush();
+        if(_send_count == MAX_BATCH) {
+            return false;
+        }
+    }
+    if(_send_head && _send_head + _send_count == MAX_BATCH) {
+        // Socket took only part of the batch, move the rest to the front.
+        for(uint8_t i = 0; i < _send_count; i++) {
+            uint8_t from = _send_head + i;
+            memcpy(_send_data + i * _datagram_size, _send_data + from * _datagram_size,
+                   _send_iovecs[from].iov_len);
+            _send_iovecs[i].iov_len = _send_iovecs[from].iov_len;
+            _send_addresses[i] = _send_addresses[from];
+            _send_headers[i].msg_hdr.msg_namelen = _send_headers[from].msg_hdr.msg_namelen;
+        }
+        _send_head = 0;
+    }
+
+    uint8_t index = _send_head + _send_count;
+    uint8_t *slot = _send_data + index * _datagram_size;
+    memcpy(slot, data, length);
+    memcpy(&_send_addresses[index], address, address_length);
+    _send_iovecs[index].iov_base = slot;
+    _send_iovecs[index].iov_len = length;
+    struct msghdr &header = _send_headers[index].msg_hdr;
+    header.msg_name = &_send_addresses[index];
+    header.msg_namelen = address_length;
+    header.msg_iov = &_send_iovecs[index];
+    header.msg_iovlen = 1;
+    _send_count++;
+    return true;
+}
+
+int M2MUdpBatch::flush()
+{
+    int total = 0;
+    while(_send_count) {
+        int sent = sendmmsg(_socket, &_send_headers[_send_head], _send_count, MSG_DONTWAIT);
+        if(sent < 0) {
+            if(EINTR == errno) {
+                continue;
+            }
+            if(EAGAIN == errno || EWOULDBLOCK == errno) {
+                break;
+            }
+            // Datagram can't be sent, drop it so the rest isn't held up.
+            tr_error("M2MUdpBatch::flush() - sendmmsg failed %d", errno);
+            _stats.send_errors++;
+            _send_head++;
+            _send_count--;
+            total = -1;
+            continue;
+        }
+        _stats.send_calls++;
+        _stats.datagrams_sent += sent;
+        if((uint32_t)sent > _stats.largest_send_batch) {
+            _stats.largest_send_batch = sent;
+        }
+        _send_head += sent;
+        _send_count -= sent;
+        if(total >= 0) {
+            total += sent;
+        }
+    }
+    if(!_send_count) {
+        _send_head = 0;
+    }
+    return total;
+}
+
+uint8_t M2MUdpBatch::pending() const
+{
+    return _send_count;
+}
+
+int M2MUdpBatch::receive(uint8_t *const *buffers, uint8_t count, uint16_t buffer_size)
+{
+    if(!_datagram_size) {
+        return -1;
+    }
+    if(count > MAX_BATCH) {
+        count = MAX_BATCH;
+    }
+    for(uint8_t i = 0; i < count; i++) {
+        _receive_iovecs[i].iov_base = buffers[i];
+        _receive_iovecs[i].iov_len = buffer_size;
+        struct msghdr &header = _receive_headers[i].msg_hdr;
+        header.msg_name = &_receive_addresses[i];
+        header.msg_namelen = sizeof(struct sockaddr_storage);
+        header.msg_iov = &_receive_iovecs[i];
+        header.msg_iovlen = 1;
+        _receive_headers[i].msg_len = 0;
+    }
+    int received;
+    do {
+        received = recvmmsg(_socket, _receive_headers, count, MSG_DONTWAIT, NULL);
+    } while(received < 0 && EINTR == errno);
+    if(received < 0) {
+        return (EAGAIN == errno || EWOULDBLOCK == errno) ? 0 : -1;
+    }
+    if(received) {
+        _stats.receive_calls++;
+        _stats.datagrams_received += received;
+        if((uint32_t)received > _stats.largest_receive_batch) {
+            _stats.largest_receive_batch = received;
+        }
+    }
+    return received;
+}
+
+uint16_t M2MUdpBatch::received_length(uint8_t index) const
+{
+    return (index < MAX_BATCH) ? (uint16_t)_receive_headers[index].msg_len : 0;
+}
+
+const struct sockaddr* M2MUdpBatch::received_address(uint8_t index,
+                                                     socklen_t &address_length) const
+{
+    if(index >= MAX_BATCH) {
+        address_length = 0;
+        return NULL;
+    }
+    address_length = _receive_headers[index].msg_hdr.msg_namelen;
+    return (const struct sockaddr*)&_receive_addresses[index];
+}
+
+const M2MUdpBatch::Stats& M2MUdpBatch::stats() const
+{
+    return _stats;
+}
+
+#endif // __linux__
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include "include/m2mwakewindow.h"
+#include "ns_trace.h"
+
+M2MWakeWindow::M2MWakeWindow(uint32_t listen_time, uint32_t wake_interval)
+: _state(Stopped),
+  _listen_time(listen_time),
+  _wake_interval(wake_interval),
+  _last_activity(0),
+  _closed_at(0)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+M2MWakeWindow::~M2MWakeWindow()
+{
+}
+
+void M2MWakeWindow::set_timing(uint32_t listen_time, uint32_t wake_interval)
+{
+    _listen_time = listen_time;
+    _wake_interval = wake_interval;
+}
+
+bool M2MWakeWindow::open(uint32_t now)
+{
+    if(Open == _state) {
+        return false;
+    }
+    tr_debug("M2MWakeWindow::open()");
+    if(Idle == _state) {
+        _stats.idle_time += now - _closed_at;
+    }
+    _state = Open;
+    _last_activity = now;
+    _stats.windows++;
+    _stats.window_bytes = 0;
+    return true;
+}
+
+void M2MWakeWindow::stop(uint32_t now)
+{
+    if(Idle == _state) {
+        _stats.idle_time += now - _closed_at;
+    }
+    _state = Stopped;
+}
+
+bool M2MWakeWindow::is_open() const
+{
+    return Open == _state;
+}
+
+void M2MWakeWindow::message_received(uint32_t now)
+{
+    _last_activity = now;
+}
+
+void M2MWakeWindow::message_sent(uint32_t now, uint16_t bytes)
+{
+    _last_activity = now;
+    _stats.bytes_sent += bytes;
+    _stats.window_bytes += bytes;
+    if(_stats.window_bytes > _stats.largest_window_bytes) {
+        _stats.largest_window_bytes = _stats.window_bytes;
+    }
+}
+
+void M2MWakeWindow::message_deferred()
+{
+    _stats.messages_deferred++;
+}
+
+M2MWakeWindow::Change M2MWakeWindow::tick(uint32_t now, bool pending)
+{
+    Change change = None;
+    if(Open == _state) {
+        // Pending exchanges keep the window open until they complete.
+        if(!pending && now - _last_activity >= _listen_time) {
+            close(now);
+            change = Closed;
+        }
+    } else if(Idle == _state) {
+        if(pending && now - _closed_at >= _wake_interval) {
+            open(now);
+            change = Opened;
+        }
+    }
+    return change;
+}
+
+uint32_t M2MWakeWindow::next_change(uint32_t now, bool pending) const
+{
+    uint32_t elapsed;
+    uint32_t wait;
+    if(Open == _state && !pending) {
+        elapsed = now - _last_activity;
+        wait = _listen_time;
+    } else if(Idle == _state && pending) {
+        elapsed = now - _closed_at;
+        wait = _wake_interval;
+    } else {
+        return 0;
+    }
+    return (elapsed < wait) ? wait - elapsed : 1;
+}
+
+M2MInterface::QueueModeStats M2MWakeWindow::stats(uint32_t now) const
+{
+    M2MInterface::QueueModeStats stats = _stats;
+    if(Idle == _state) {
+        stats.idle_time += now - _closed_at;
+    }
+    return stats;
+}
+
+void M2MWakeWindow::close(uint32_t now)
+{
+    tr_debug("M2MWakeWindow::close() - %lu bytes sent in the window",
+             (unsigned long)_stats.window_bytes);
+    _state = Idle;
+    _closed_at = now;
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifdef __linux__
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "mbed-client/m2mworkerpool.h"
+#include "ns_trace.h"
+
+M2MWorkerPool::M2MWorkerPool(M2MReactor &reactor, uint8_t workers)
+: _reactor(reactor),
+  _worker_count(workers),
+  _threads_started(0),
+  _running(false),
+  _sequence(0)
+{
+    if(_worker_count < 1) {
+        _worker_count = 1;
+    } else if(_worker_count > MAX_WORKERS) {
+        _worker_count = MAX_WORKERS;
+    }
+    memset(_slots, 0, sizeof(_slots));
+    pthread_mutex_init(&_mutex, NULL);
+    pthread_cond_init(&_work_available, NULL);
+    pthread_cond_init(&_job_finished, NULL);
+    _event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(_event_fd < 0) {
+        tr_error("M2MWorkerPool::M2MWorkerPool() - cannot create eventfd");
+    }
+}
+
+M2MWorkerPool::~M2MWorkerPool()
+{
+    stop();
+    if(_event_fd >= 0) {
+        close(_event_fd);
+    }
+    pthread_cond_destroy(&_job_finished);
+    pthread_cond_destroy(&_work_available);
+    pthread_mutex_destroy(&_mutex);
+}
+
+bool M2MWorkerPool::start()
+{
+    pthread_mutex_lock(&_mutex);
+    bool running = _running;
+    pthread_mutex_unlock(&_mutex);
+    if(running) {
+        return true;
+    }
+    if(_event_fd < 0 || !_reactor.add(_event_fd, M2MReactor::Readable, this)) {
+        tr_error("M2MWorkerPool::start() - cannot register to the reactor");
+        return false;
+    }
+    pthread_mutex_lock(&_mutex);
+    _running = true;
+    pthread_mutex_unlock(&_mutex);
+    for(uint8_t i = 0; i < _worker_count; i++) {
+        if(pthread_create(&_threads[i], NULL, &M2MWorkerPool::worker_thread, this) != 0) {
+            tr_error("M2MWorkerPool::start() - cannot start worker %d", i);
+            stop();
+            return false;
+        }
+        _threads_started++;
+    }
+    return true;
+}
+
+void M2MWorkerPool::stop()
+{
+    pthread_mutex_lock(&_mutex);
+    bool running = _running;
+    _running = false;
+    pthread_cond_broadcast(&_work_available);
+    pthread_mutex_unlock(&_mutex);
+    for(uint8_t i = 0; i < _threads_started; i++) {
+        pthread_join(_threads[i], NULL);
+    }
+    _threads_started = 0;
+    if(running) {
+        _reactor.remove(_event_fd);
+    }
+}
+
+bool M2MWorkerPool::submit(M2MWorkerJob *job)
+{
+    if(!job) {
+        return false;
+    }
+    bool queued = false;
+    pthread_mutex_lock(&_mutex);
+    if(_running) {
+        for(uint8_t i = 0; i < MAX_JOBS; i++) {
+            if(_slots[i].state == Free) {
+                _slots[i].job = job;
+                _slots[i].state = Queued;
+                _slots[i].sequence = _sequence++;
+                pthread_cond_signal(&_work_available);
+                queued = true;
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&_mutex);
+    if(!queued) {
+        tr_debug("M2MWorkerPool::submit() - not queued");
+    }
+    return queued;
+}
+
+bool M2MWorkerPool::cancel(M2MWorkerJob *job)
+{
+    bool cancelled = false;
+    pthread_mutex_lock(&_mutex);
+    for(uint8_t i = 0; i < MAX_JOBS; i++) {
+        Slot &slot = _slots[i];
+        if(slot.job != job || slot.state == Free || slot.state == Cancelling) {
+            continue;
+        }
+        if(slot.state == Running) {
+            // The worker frees the slot without reporting completion.
+            slot.state = Cancelling;
+            while(slot.state == Cancelling) {
+                pthread_cond_wait(&_job_finished, &_mutex);
+            }
+        } else {
+            slot.state = Free;
+            slot.job = NULL;
+        }
+        cancelled = true;
+        break;
+    }
+    pthread_mutex_unlock(&_mutex);
+    return cancelled;
+}
+
+uint8_t M2MWorkerPool::pending() const
+{
+    uint8_t count = 0;
+    pthread_mutex_lock(&_mutex);
+    for(uint8_t i = 0; i < MAX_JOBS; i++) {
+        if(_slots[i].state != Free) {
+            count++;
+        }
+    }
+    pthread_mutex_unlock(&_mutex);
+    return count;
+}
+
+void M2MWorkerPool::io_ready(int fd, uint32_t /*events*/)
+{
+    uint64_t value;
+    while(read(fd, &value, sizeof(value)) < 0 && errno == EINTR) {
+    }
+    for(;;) {
+        pthread_mutex_lock(&_mutex);
+        int index = oldest(Done);
+        M2MWorkerJob *job = NULL;
+        if(index >= 0) {
+            job = _slots[index].job;
+            _slots[index].state = Free;
+            _slots[index].job = NULL;
+        }
+        pthread_mutex_unlock(&_mutex);
+        if(!job) {
+            break;
+        }
+        job->completed();
+    }
+}
+
+void* M2MWorkerPool::worker_thread(void *argument)
+{
+    ((M2MWorkerPool*)argument)->run_worker();
+    return NULL;
+}
+
+void M2MWorkerPool::run_worker()
+{
+    pthread_mutex_lock(&_mutex);
+    for(;;) {
+        int index = oldest(Queued);
+        while(_running && index < 0) {
+            pthread_cond_wait(&_work_available, &_mutex);
+            index = oldest(Queued);
+        }
+        if(!_running) {
+            break;
+        }
+        Slot &slot = _slots[index];
+        slot.state = Running;
+        M2MWorkerJob *job = slot.job;
+        pthread_mutex_unlock(&_mutex);
+
+        job->run();
+
+        pthread_mutex_lock(&_mutex);
+        if(slot.state == Cancelling) {
+            slot.state = Free;
+            slot.job = NULL;
+            pthread_cond_broadcast(&_job_finished);
+            continue;
+        }
+        slot.state = Done;
+        uint64_t value = 1;
+        if(write(_event_fd, &value, sizeof(value)) < 0) {
+            tr_error("M2MWorkerPool::run_worker() - cannot signal completion");
+        }
+    }
+    pthread_mutex_unlock(&_mutex);
+}
+
+int M2MWorkerPool::oldest(State state) const
+{
+    int index = -1;
+    for(uint8_t i = 0; i < MAX_JOBS; i++) {
+        // Sequence numbers are compared by difference to survive wrapping.
+        if(_slots[i].state == state &&
+           (index < 0 || (int32_t)(_slots[i].sequence - _slots[index].sequence) < 0)) {
+            index = i;
+        }
+    }
+    return index;
+}
+
+#endif // __linux__
@@ -15,9 +15,111 @@
  */
 #include "include/nsdlaccesshelper.h"
 #include "include/m2mnsdlinterface.h"
+#include "include/m2matomic.h"
+#include "mbed-client/m2mstringpool.h"
 
-// callback function for NSDL library to call into
-M2MNsdlInterface  *__nsdl_interface = NULL;
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    struct nsdl_s       *handle;
+    M2MNsdlInterface    *nsdl_interface;
+} NsdlInterfaceEntry;
+
+// Interfaces sorted by their NSDL library handle, one entry per
+// M2MNsdlInterface alive in the process. Interfaces are created and
+// their callbacks run on any thread, so the table is used under the lock.
+static NsdlInterfaceEntry *__nsdl_interfaces = NULL;
+static size_t __nsdl_interface_count = 0;
+static size_t __nsdl_interface_capacity = 0;
+static m2m_lock_t __nsdl_interface_lock = M2M_LOCK_INITIALIZER;
+
+M2M_THREAD_LOCAL M2MNsdlInterface  *__nsdl_processing_interface = NULL;
+
+static size_t __nsdl_interface_lower_bound(struct nsdl_s *nsdl_handle)
+{
+    size_t low = 0;
+    size_t high = __nsdl_interface_count;
+    while(low < high) {
+        size_t mid = low + ((high - low) >> 1);
+        if(__nsdl_interfaces[mid].handle < nsdl_handle) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+bool __nsdl_interface_register(struct nsdl_s *nsdl_handle,
+                               M2MNsdlInterface *nsdl_interface)
+{
+    bool success = true;
+    m2m_lock(&__nsdl_interface_lock);
+    size_t index = __nsdl_interface_lower_bound(nsdl_handle);
+    if(index < __nsdl_interface_count &&
+       __nsdl_interfaces[index].handle == nsdl_handle) {
+        __nsdl_interfaces[index].nsdl_interface = nsdl_interface;
+    } else {
+        if(__nsdl_interface_count == __nsdl_interface_capacity) {
+            success = false;
+            // Doubling stops before the size in bytes would overflow.
+            if(__nsdl_interface_capacity <= ((size_t)-1) / 2 / sizeof(NsdlInterfaceEntry)) {
+                size_t capacity = __nsdl_interface_capacity ? __nsdl_interface_capacity * 2 : 2;
+                NsdlInterfaceEntry *entries = (NsdlInterfaceEntry*)realloc(__nsdl_interfaces,
+                                                    capacity * sizeof(NsdlInterfaceEntry));
+                if(entries) {
+                    __nsdl_interfaces = entries;
+                    __nsdl_interface_capacity = capacity;
+                    success = true;
+                }
+            }
+        }
+        if(success) {
+            memmove(&__nsdl_interfaces[index + 1], &__nsdl_interfaces[index],
+                    (__nsdl_interface_count - index) * sizeof(NsdlInterfaceEntry));
+            __nsdl_interfaces[index].handle = nsdl_handle;
+            __nsdl_interfaces[index].nsdl_interface = nsdl_interface;
+            __nsdl_interface_count++;
+        }
+    }
+    m2m_unlock(&__nsdl_interface_lock);
+    return success;
+}
+
+void __nsdl_interface_unregister(struct nsdl_s *nsdl_handle)
+{
+    m2m_lock(&__nsdl_interface_lock);
+    size_t index = __nsdl_interface_lower_bound(nsdl_handle);
+    if(index < __nsdl_interface_count &&
+       __nsdl_interfaces[index].handle == nsdl_handle) {
+        if(__nsdl_processing_interface == __nsdl_interfaces[index].nsdl_interface) {
+            __nsdl_processing_interface = NULL;
+        }
+        __nsdl_interface_count--;
+        memmove(&__nsdl_interfaces[index], &__nsdl_interfaces[index + 1],
+                (__nsdl_interface_count - index) * sizeof(NsdlInterfaceEntry));
+        if(__nsdl_interface_count == 0) {
+            free(__nsdl_interfaces);
+            __nsdl_interfaces = NULL;
+            __nsdl_interface_capacity = 0;
+        }
+    }
+    m2m_unlock(&__nsdl_interface_lock);
+}
+
+M2MNsdlInterface* __nsdl_interface_find(struct nsdl_s *nsdl_handle)
+{
+    M2MNsdlInterface *nsdl_interface = NULL;
+    m2m_lock(&__nsdl_interface_lock);
+    size_t index = __nsdl_interface_lower_bound(nsdl_handle);
+    if(index < __nsdl_interface_count &&
+       __nsdl_interfaces[index].handle == nsdl_handle) {
+        nsdl_interface = __nsdl_interfaces[index].nsdl_interface;
+    }
+    m2m_unlock(&__nsdl_interface_lock);
+    return nsdl_interface;
+}
 
 uint8_t __nsdl_c_callback(struct nsdl_s *nsdl_handle,
                           sn_coap_hdr_s *received_coap_ptr,
@@ -25,26 +127,31 @@ uint8_t __nsdl_c_callback(struct nsdl_s *nsdl_handle,
                           sn_nsdl_capab_e nsdl_capab)
 {
     uint8_t status = 0;
-    if(__nsdl_interface) {
-        status = __nsdl_interface->resource_callback(nsdl_handle,received_coap_ptr,
-                                                     address, nsdl_capab);
+    M2MNsdlInterface *nsdl_interface = __nsdl_interface_find(nsdl_handle);
+    if(nsdl_interface) {
+        status = nsdl_interface->resource_callback(nsdl_handle,received_coap_ptr,
+                                                   address, nsdl_capab);
     }
     return status;
 }
 
+// The library allocates before the handle exists and doesn't pass it
+// to the memory functions, so they are shared by all the interfaces.
 void* __nsdl_c_memory_alloc(uint16_t size)
 {
     void * val = NULL;
-    if(__nsdl_interface) {
-        val = __nsdl_interface->memory_alloc(size);
+    if(size) {
+        val = malloc(size);
     }
     return val;
 }
 
 void __nsdl_c_memory_free(void *ptr)
 {
-    if(__nsdl_interface) {
-        __nsdl_interface->memory_free(ptr);
+    // Resource types and interface descriptions of the created resources
+    // are interned, see M2MNsdlInterface::create_nsdl_resource().
+    if(!M2MStringPool::release_bytes(ptr)) {
+        free(ptr);
     }
 }
 
@@ -55,10 +162,11 @@ uint8_t __nsdl_c_send_to_server(struct nsdl_s * nsdl_handle,
                                 sn_nsdl_addr_s *address_ptr)
 {
     uint8_t status = 0;
-    if(__nsdl_interface) {
-        status = __nsdl_interface->send_to_server_callback(nsdl_handle,
-                                                           protocol, data_ptr,
-                                                           data_len, address_ptr);
+    M2MNsdlInterface *nsdl_interface = __nsdl_interface_find(nsdl_handle);
+    if(nsdl_interface) {
+        status = nsdl_interface->send_to_server_callback(nsdl_handle,
+                                                         protocol, data_ptr,
+                                                         data_len, address_ptr);
     }
     return status;
 }
@@ -68,18 +176,22 @@ uint8_t __nsdl_c_received_from_server(struct nsdl_s * nsdl_handle,
                                       sn_nsdl_addr_s *address_ptr)
 {
     uint8_t status = 0;
-    if(__nsdl_interface) {
-        status = __nsdl_interface->received_from_server_callback(nsdl_handle,
-                                                                 coap_header,
-                                                                 address_ptr);
+    M2MNsdlInterface *nsdl_interface = __nsdl_interface_find(nsdl_handle);
+    if(nsdl_interface) {
+        status = nsdl_interface->received_from_server_callback(nsdl_handle,
+                                                               coap_header,
+                                                               address_ptr);
     }
     return status;
 }
 
+// The bootstrap status callback carries no handle, it is only called
+// while an interface is processing data on the calling thread, see
+// __nsdl_processing_interface.
 void __nsdl_c_bootstrap_done(sn_nsdl_oma_server_info_t *server_info_ptr)
 {
-    if(__nsdl_interface) {
-        __nsdl_interface->bootstrap_done_callback(server_info_ptr);
+    if(__nsdl_processing_interface) {
+        __nsdl_processing_interface->bootstrap_done_callback(server_info_ptr);
     }
 }
 
@@ -3,6 +3,7 @@ SRCS += \
 	source/m2mconnectionhandlerfactory.cpp \
 	source/m2mconstants.cpp \
 	source/m2mdevice.cpp \
+	source/m2mdnscache.cpp \
 	source/m2minterfacefactory.cpp \
 	source/m2minterfaceimpl.cpp \
 	source/m2mnsdlinterface.cpp \
@@ -11,11 +12,28 @@ SRCS += \
 	source/m2mreporthandler.cpp \
 	source/m2mresource.cpp \
 	source/m2mresourceinstance.cpp \
+	source/m2mresourcetable.cpp \
+	source/m2msendqueue.cpp \
 	source/m2msecurity.cpp \
 	source/m2mserver.cpp \
 	source/m2mstring.cpp \
+	source/m2mstringpool.cpp \
+	source/m2mcoaptcpframer.cpp \
+	source/m2mcommandqueue.cpp \
+	source/m2mdtlssessioncache.cpp \
+	source/m2mdtlstimer.cpp \
+	source/m2mhappyeyeballs.cpp \
+	source/m2mkeepalive.cpp \
+	source/m2mreactor.cpp \
+	source/m2mreceivebufferpool.cpp \
+	source/m2mregistrationstore.cpp \
+	source/m2mtimingwheel.cpp \
+	source/m2mtimerpoll.cpp \
 	source/m2mtlvdeserializer.cpp \
 	source/m2mtlvserializer.cpp \
+	source/m2mudpbatch.cpp \
+	source/m2mwakewindow.cpp \
+	source/m2mworkerpool.cpp \
 	source/nsdlaccesshelper.cpp \
 	../lwm2m-client-linux/source/m2mconnectionhandler.cpp \
 	../lwm2m-client-linux/source/m2mconnectionhandlerpimpl.cpp \
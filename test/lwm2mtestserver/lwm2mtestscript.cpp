@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "lwm2mtestscript.h"
+
+#define WHITESPACE  " \t\r"
+
+LWM2MTestScript::LWM2MTestScript(LWM2MTestServer &server)
+: _server(server),
+  _commands(NULL),
+  _command_count(0),
+  _command_capacity(0),
+  _current(0),
+  _rounds(0),
+  _started(0),
+  _running(false),
+  _failed(false),
+  _error_line(0)
+{
+}
+
+LWM2MTestScript::~LWM2MTestScript()
+{
+    clear();
+}
+
+bool LWM2MTestScript::load(const char *text)
+{
+    clear();
+    char *copy = text ? strdup(text) : NULL;
+    if(!copy) {
+        return false;
+    }
+    bool success = true;
+    uint32_t line_number = 1;
+    char *line = copy;
+    while(line && success) {
+        char *next = strchr(line, '\n');
+        if(next) {
+            *next++ = '\0';
+        }
+        char *comment = strchr(line, '#');
+        if(comment) {
+            *comment = '\0';
+        }
+        success = parse_line(line, line_number);
+        if(!success) {
+            _error_line = line_number;
+        }
+        line = next;
+        line_number++;
+    }
+    free(copy);
+    return success;
+}
+
+bool LWM2MTestScript::load_file(const char *file_name)
+{
+    FILE *file = fopen(file_name, "rb");
+    if(!file) {
+        return false;
+    }
+    bool success = false;
+    if(fseek(file, 0, SEEK_END) == 0) {
+        long size = ftell(file);
+        char *text = (size >= 0) ? (char*)malloc(size + 1) : NULL;
+        if(text) {
+            rewind(file);
+            if(fread(text, 1, size, file) == (size_t)size) {
+                text[size] = '\0';
+                success = load(text);
+            }
+            free(text);
+        }
+    }
+    fclose(file);
+    return success;
+}
+
+bool LWM2MTestScript::run()
+{
+    while(_current < _command_count && !_failed) {
+        const Command &command = _commands[_current];
+        uint64_t time = LWM2MTestServer::now();
+        if(!_running) {
+            _running = true;
+            _started = time;
+            _rounds = 0;
+        }
+        bool done = false;
+        switch(command.type) {
+            case Wait:
+                done = _server.registered_count() >= command.count;
+                break;
+            case Sleep:
+                done = (time - _started) >= (uint64_t)command.timeout * 1000;
+                break;
+            case Sync:
+                done = _server.pending_count() == 0;
+                break;
+            case Report:
+                _server.print_report(stdout);
+                done = true;
+                break;
+            case Request:
+                if(_server.pending_count() == 0) {
+                    if(_rounds == command.count) {
+                        done = true;
+                    } else if(send_round(command)) {
+                        _rounds++;
+                    } else {
+                        printf("Script line %u: no endpoint to send to\n", command.line);
+                        _failed = true;
+                    }
+                }
+                break;
+        }
+        if(!done && !_failed && Sleep != command.type && command.timeout &&
+           (time - _started) >= (uint64_t)command.timeout * 1000) {
+            printf("Script line %u: timed out\n", command.line);
+            _failed = true;
+        }
+        if(_failed) {
+            _error_line = command.line;
+        }
+        if(!done) {
+            return !_failed;
+        }
+        _current++;
+        _running = false;
+    }
+    return false;
+}
+
+bool LWM2MTestScript::failed() const
+{
+    return _failed;
+}
+
+uint32_t LWM2MTestScript::error_line() const
+{
+    return _error_line;
+}
+
+bool LWM2MTestScript::parse_line(char *line, uint32_t line_number)
+{
+    char *save = NULL;
+    char *tokens[5];
+    uint8_t count = 0;
+    char *token = strtok_r(line, WHITESPACE, &save);
+    while(token && count < 5) {
+        tokens[count++] = token;
+        token = strtok_r(NULL, WHITESPACE, &save);
+    }
+    if(token) {
+        return false;
+    }
+    if(0 == count) {
+        return true;
+    }
+
+    Command command;
+    memset(&command, 0, sizeof(Command));
+    command.line = line_number;
+    command.count = 1;
+    const char *name = tokens[0];
+    // Position of the optional rounds argument.
+    uint8_t rounds = 0;
+
+    if(strcmp(name, "wait") == 0 && count >= 2 && count <= 3) {
+        command.type = Wait;
+        command.count = strtoul(tokens[1], NULL, 10);
+        command.timeout = (count == 3) ? strtoul(tokens[2], NULL, 10) : 0;
+    } else if(strcmp(name, "sleep") == 0 && count == 2) {
+        command.type = Sleep;
+        command.timeout = strtoul(tokens[1], NULL, 10);
+    } else if(strcmp(name, "sync") == 0 && count <= 2) {
+        command.type = Sync;
+        command.timeout = (count == 2) ? strtoul(tokens[1], NULL, 10) : 0;
+    } else if(strcmp(name, "report") == 0 && count == 1) {
+        command.type = Report;
+    } else if(count >= 3) {
+        command.type = Request;
+        if(strcmp(name, "get") == 0 && count <= 4) {
+            command.request_type = LWM2MTestServer::Get;
+            rounds = 3;
+        } else if(strcmp(name, "put") == 0 && count >= 4) {
+            command.request_type = LWM2MTestServer::Put;
+            command.payload = tokens[3];
+            rounds = 4;
+        } else if(strcmp(name, "post") == 0) {
+            command.request_type = LWM2MTestServer::Post;
+            if(count >= 4 && strcmp(tokens[3], "-") != 0) {
+                command.payload = tokens[3];
+            }
+            rounds = 4;
+        } else if(strcmp(name, "delete") == 0 && count <= 4) {
+            command.request_type = LWM2MTestServer::Delete;
+            rounds = 3;
+        } else if(strcmp(name, "observe") == 0 && count == 3) {
+            command.request_type = LWM2MTestServer::Observe;
+        } else if(strcmp(name, "cancel") == 0 && count == 3) {
+            command.request_type = LWM2MTestServer::CancelObserve;
+        } else {
+            return false;
+        }
+        if(rounds && count > rounds) {
+            command.count = strtoul(tokens[rounds], NULL, 10);
+        }
+        command.target = strdup(tokens[1]);
+        command.path = strdup(tokens[2]);
+        command.payload = command.payload ? strdup(command.payload) : NULL;
+        if(!command.target || !command.path) {
+            free(command.target);
+            free(command.path);
+            free(command.payload);
+            return false;
+        }
+    } else {
+        return false;
+    }
+
+    if(_command_count == _command_capacity) {
+        uint32_t capacity = _command_capacity ? _command_capacity * 2 : 16;
+        Command *commands = (Command*)realloc(_commands, capacity * sizeof(Command));
+        if(!commands) {
+            free(command.target);
+            free(command.path);
+            free(command.payload);
+            return false;
+        }
+        _commands = commands;
+        _command_capacity = capacity;
+    }
+    _commands[_command_count++] = command;
+    return true;
+}
+
+bool LWM2MTestScript::send_round(const Command &command)
+{
+    bool sent = false;
+    LWM2MTestServer::RequestType type = (LWM2MTestServer::RequestType)command.request_type;
+    uint16_t payload_length = command.payload ? strlen(command.payload) : 0;
+    if(strcmp(command.target, "*") == 0) {
+        for(uint16_t i = 0; i < _server.endpoint_count(); i++) {
+            if(_server.endpoint_registered(i)) {
+                sent |= _server.send_request(i, type, command.path,
+                                             (const uint8_t*)command.payload,
+                                             payload_length);
+            }
+        }
+    } else {
+        int32_t endpoint = _server.find_endpoint(command.target);
+        if(endpoint >= 0) {
+            sent = _server.send_request(endpoint, type, command.path,
+                                        (const uint8_t*)command.payload,
+                                        payload_length);
+        }
+    }
+    return sent;
+}
+
+void LWM2MTestScript::clear()
+{
+    for(uint32_t i = 0; i < _command_count; i++) {
+        free(_commands[i].target);
+        free(_commands[i].path);
+        free(_commands[i].payload);
+    }
+    free(_commands);
+    _commands = NULL;
+    _command_count = 0;
+    _command_capacity = 0;
+    _current = 0;
+    _running = false;
+    _failed = false;
+    _error_line = 0;
+}
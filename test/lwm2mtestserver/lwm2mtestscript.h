@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LWM2M_TEST_SCRIPT_H
+#define LWM2M_TEST_SCRIPT_H
+
+#include "lwm2mtestserver.h"
+
+/**
+ *  @brief LWM2MTestScript.
+ *  Runs a scripted request workload against the clients registered to
+ *  an LWM2MTestServer. One command per line, '#' starts a comment:
+ *
+ *  wait <count> [timeout-ms]                  Waits until count endpoints are registered.
+ *  sleep <ms>                                 Waits the given time.
+ *  sync [timeout-ms]                          Waits until no requests are pending.
+ *  get <endpoint|*> <path> [rounds]           Reads a resource.
+ *  put <endpoint|*> <path> <value> [rounds]   Writes a resource.
+ *  post <endpoint|*> <path> [payload|-] [rounds]  Executes a resource.
+ *  delete <endpoint|*> <path> [rounds]        Deletes an object instance.
+ *  observe <endpoint|*> <path>                Starts observing a resource.
+ *  cancel <endpoint|*> <path>                 Stops observing a resource.
+ *  report                                     Prints the latency report.
+ *
+ *  "*" sends the request to every registered endpoint. The rounds of a
+ *  request are run one after the other, a round starts only when no
+ *  requests are pending, so the latencies measure single round trips.
+ */
+class LWM2MTestScript {
+
+public:
+
+    /**
+     * @brief Constructor
+     * @param server, Server the requests are sent through.
+     */
+    LWM2MTestScript(LWM2MTestServer &server);
+
+    /**
+     * @brief Destructor
+     */
+    ~LWM2MTestScript();
+
+    /**
+     * @brief Parses a script.
+     * @param text, Script text.
+     * @return True if successful, false on syntax error, see error_line().
+     */
+    bool load(const char *text);
+
+    /**
+     * @brief Reads and parses a script file.
+     * @param file_name, Name of the script file.
+     * @return True if successful, else false.
+     */
+    bool load_file(const char *file_name);
+
+    /**
+     * @brief Advances the script, must be called periodically.
+     * @return True while the script is running, false once finished or failed.
+     */
+    bool run();
+
+    /**
+     * @brief Returns whether a command failed or timed out.
+     */
+    bool failed() const;
+
+    /**
+     * @brief Returns the line of the syntax error or of the failed command.
+     */
+    uint32_t error_line() const;
+
+private:
+
+    typedef enum {
+        Wait,
+        Sleep,
+        Sync,
+        Request,
+        Report
+    } CommandType;
+
+    typedef struct {
+        uint8_t     type;
+        uint8_t     request_type;
+        uint32_t    line;
+        uint32_t    count;
+        uint32_t    timeout;    // Milliseconds, 0 waits forever.
+        char        *target;
+        char        *path;
+        char        *payload;
+    } Command;
+
+    // Prevents the use of assignment operator.
+    LWM2MTestScript& operator=( const LWM2MTestScript& /*other*/ );
+
+    // Prevents the use of copy constructor
+    LWM2MTestScript( const LWM2MTestScript& /*other*/ );
+
+    bool parse_line(char *line, uint32_t line_number);
+
+    bool send_round(const Command &command);
+
+    void clear();
+
+private:
+
+    LWM2MTestServer             &_server;
+    Command                     *_commands;
+    uint32_t                    _command_count;
+    uint32_t                    _command_capacity;
+    uint32_t                    _current;
+    uint32_t                    _rounds;
+    uint64_t                    _started;
+    bool                        _running;
+    bool                        _failed;
+    uint32_t                    _error_line;
+};
+
+#endif // LWM2M_TEST_SCRIPT_H
@@ -0,0 +1,830 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lwm2mtestserver.h"
+
+#define RD_PATH                     "rd"
+#define DEFAULT_LIFE_TIME           86400
+
+// CoAP transmission parameters (RFC 7252), without the random factor so
+// that runs are reproducible.
+const uint64_t ACK_TIMEOUT = 2000000;
+const uint8_t MAX_RETRANSMIT = 4;
+const uint64_t SEPARATE_RESPONSE_TIMEOUT = 30000000;
+const uint8_t TOKEN_LENGTH = 4;
+
+static const char *REQUEST_TYPE_NAMES[LWM2MTestServer::RequestTypeCount] = {
+    "register",
+    "update",
+    "deregister",
+    "get",
+    "put",
+    "post",
+    "observe",
+    "cancel",
+    "delete",
+    "notification"
+};
+
+LWM2MTestServer::LWM2MTestServer(send_function send, void *context)
+: _send(send),
+  _context(context),
+  _coap(NULL),
+  _endpoints(NULL),
+  _endpoint_count(0),
+  _endpoint_capacity(0),
+  _pending(NULL),
+  _pending_count(0),
+  _pending_capacity(0),
+  _observations(NULL),
+  _observation_count(0),
+  _observation_capacity(0),
+  _records(NULL),
+  _record_count(0),
+  _record_capacity(0),
+  _msg_id(0),
+  _token(0),
+  _next_location(0),
+  _last_response_code(0)
+{
+}
+
+LWM2MTestServer::~LWM2MTestServer()
+{
+    for(uint32_t i = 0; i < _endpoint_count; i++) {
+        free(_endpoints[i].name);
+        free(_endpoints[i].links);
+    }
+    for(uint32_t i = 0; i < _pending_count; i++) {
+        free(_pending[i].packet);
+        free(_pending[i].path);
+    }
+    for(uint32_t i = 0; i < _observation_count; i++) {
+        free(_observations[i].path);
+    }
+    free(_endpoints);
+    free(_pending);
+    free(_observations);
+    free(_records);
+    if(_coap) {
+        sn_coap_protocol_destroy(_coap);
+    }
+}
+
+bool LWM2MTestServer::initialize()
+{
+    // Only the parser and the builder are used, messaging is handled here
+    // so that every request can be timed.
+    _coap = sn_coap_protocol_init(&memory_alloc, &memory_free,
+                                  &coap_tx_callback, &coap_rx_callback);
+    return _coap != NULL;
+}
+
+void LWM2MTestServer::process_datagram(uint8_t *data, uint16_t length,
+                                       const sn_nsdl_addr_s &address)
+{
+    if(!_coap || !data || !length) {
+        return;
+    }
+    coap_version_e version = COAP_VERSION_1;
+    sn_coap_hdr_s *coap_header = sn_coap_parser(_coap, length, data, &version);
+    if(!coap_header) {
+        return;
+    }
+    if(COAP_STATUS_OK == coap_header->coap_status) {
+        if(coap_header->msg_code >= COAP_MSG_CODE_REQUEST_GET &&
+           coap_header->msg_code <= COAP_MSG_CODE_REQUEST_DELETE) {
+            handle_request(coap_header, address);
+        } else {
+            handle_response(coap_header, address);
+        }
+    }
+    sn_coap_parser_release_allocated_coap_msg_mem(_coap, coap_header);
+}
+
+void LWM2MTestServer::run()
+{
+    uint64_t time = now();
+    uint32_t index = 0;
+    while(index < _pending_count) {
+        PendingRequest &pending = _pending[index];
+        if(time < pending.timeout) {
+            index++;
+        } else if(!pending.acknowledged && pending.retransmissions < MAX_RETRANSMIT) {
+            sn_nsdl_addr_s address;
+            endpoint_address(pending.endpoint, address);
+            pending.retransmissions++;
+            pending.timeout = time + (ACK_TIMEOUT << pending.retransmissions);
+            _send(pending.packet, pending.packet_length, &address, _context);
+            index++;
+        } else {
+            // Removing moves the last request to this index.
+            complete_request(index, 0, NULL);
+        }
+    }
+}
+
+bool LWM2MTestServer::send_request(uint16_t endpoint,
+                                   LWM2MTestServer::RequestType type,
+                                   const char *path,
+                                   const uint8_t *payload,
+                                   uint16_t payload_length)
+{
+    if(endpoint >= _endpoint_count || !_endpoints[endpoint].registered || !path) {
+        return false;
+    }
+    while('/' == *path) {
+        path++;
+    }
+
+    sn_coap_hdr_s coap_header;
+    sn_coap_options_list_s options;
+    memset(&coap_header, 0, sizeof(sn_coap_hdr_s));
+    memset(&options, 0, sizeof(sn_coap_options_list_s));
+
+    uint32_t token = ++_token;
+    uint32_t observation = 0;
+    uint8_t observe = 0;
+    switch(type) {
+        case Get:
+            coap_header.msg_code = COAP_MSG_CODE_REQUEST_GET;
+            break;
+        case Observe:
+            coap_header.msg_code = COAP_MSG_CODE_REQUEST_GET;
+            coap_header.options_list_ptr = &options;
+            break;
+        case CancelObserve: {
+            // Observation is cancelled with a GET carrying its token.
+            for(uint32_t i = 0; i < _observation_count && !observation; i++) {
+                if(_observations[i].endpoint == endpoint &&
+                   strcmp(_observations[i].path, path) == 0) {
+                    observation = _observations[i].token;
+                }
+            }
+            if(!observation) {
+                return false;
+            }
+            token = observation;
+            observe = 1;
+            coap_header.msg_code = COAP_MSG_CODE_REQUEST_GET;
+            coap_header.options_list_ptr = &options;
+            break;
+        }
+        case Put:
+            coap_header.msg_code = COAP_MSG_CODE_REQUEST_PUT;
+            break;
+        case Post:
+            coap_header.msg_code = COAP_MSG_CODE_REQUEST_POST;
+            break;
+        case Delete:
+            coap_header.msg_code = COAP_MSG_CODE_REQUEST_DELETE;
+            break;
+        default:
+            return false;
+    }
+    if(coap_header.options_list_ptr) {
+        options.observe = 1;
+        options.observe_ptr = &observe;
+        options.observe_len = 1;
+    }
+
+    uint8_t token_bytes[TOKEN_LENGTH];
+    for(uint8_t i = 0; i < TOKEN_LENGTH; i++) {
+        token_bytes[i] = (uint8_t)(token >> (8 * (TOKEN_LENGTH - 1 - i)));
+    }
+    coap_header.msg_type = COAP_MSG_TYPE_CONFIRMABLE;
+    coap_header.msg_id = ++_msg_id;
+    coap_header.token_ptr = token_bytes;
+    coap_header.token_len = TOKEN_LENGTH;
+    coap_header.uri_path_ptr = (uint8_t*)path;
+    coap_header.uri_path_len = strlen(path);
+    coap_header.payload_ptr = (uint8_t*)payload;
+    coap_header.payload_len = payload ? payload_length : 0;
+
+    if(!grow((void**)&_pending, _pending_capacity, _pending_count, sizeof(PendingRequest))) {
+        return false;
+    }
+    PendingRequest &pending = _pending[_pending_count];
+    memset(&pending, 0, sizeof(PendingRequest));
+    pending.msg_id = coap_header.msg_id;
+    pending.token = token;
+    pending.endpoint = endpoint;
+    pending.type = type;
+    pending.observation = observation;
+    if(Observe == type) {
+        pending.path = strdup(path);
+        if(!pending.path) {
+            return false;
+        }
+    }
+    sn_nsdl_addr_s address;
+    endpoint_address(endpoint, address);
+    if(!send_message(&coap_header, address, &pending)) {
+        free(pending.path);
+        return false;
+    }
+    _pending_count++;
+    return true;
+}
+
+uint16_t LWM2MTestServer::endpoint_count() const
+{
+    return _endpoint_count;
+}
+
+uint16_t LWM2MTestServer::registered_count() const
+{
+    uint16_t count = 0;
+    for(uint32_t i = 0; i < _endpoint_count; i++) {
+        if(_endpoints[i].registered) {
+            count++;
+        }
+    }
+    return count;
+}
+
+int32_t LWM2MTestServer::find_endpoint(const char *name) const
+{
+    for(uint32_t i = 0; name && i < _endpoint_count; i++) {
+        if(strcmp(_endpoints[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const char* LWM2MTestServer::endpoint_name(uint16_t endpoint) const
+{
+    return (endpoint < _endpoint_count) ? _endpoints[endpoint].name : NULL;
+}
+
+bool LWM2MTestServer::endpoint_registered(uint16_t endpoint) const
+{
+    return (endpoint < _endpoint_count) ? _endpoints[endpoint].registered : false;
+}
+
+const char* LWM2MTestServer::endpoint_links(uint16_t endpoint) const
+{
+    return (endpoint < _endpoint_count) ? _endpoints[endpoint].links : NULL;
+}
+
+uint32_t LWM2MTestServer::endpoint_notifications(uint16_t endpoint) const
+{
+    return (endpoint < _endpoint_count) ? _endpoints[endpoint].notifications : 0;
+}
+
+uint16_t LWM2MTestServer::pending_count() const
+{
+    return _pending_count;
+}
+
+uint8_t LWM2MTestServer::last_response_code() const
+{
+    return _last_response_code;
+}
+
+static int compare_latency(const void *a, const void *b)
+{
+    uint32_t first = *(const uint32_t*)a;
+    uint32_t second = *(const uint32_t*)b;
+    return (first > second) - (first < second);
+}
+
+void LWM2MTestServer::latency_summary(LWM2MTestServer::RequestType type,
+                                      LWM2MTestServer::LatencySummary &summary) const
+{
+    memset(&summary, 0, sizeof(LatencySummary));
+    uint32_t *latencies = (uint32_t*)malloc((_record_count ? _record_count : 1) * sizeof(uint32_t));
+    if(!latencies) {
+        return;
+    }
+    uint64_t sum = 0;
+    for(uint32_t i = 0; i < _record_count; i++) {
+        const LatencyRecord &record = _records[i];
+        if(record.type != type) {
+            continue;
+        }
+        // Timeouts, resets and error responses aren't part of the latency.
+        if(0 == record.response_code ||
+           record.response_code >= COAP_MSG_CODE_RESPONSE_BAD_REQUEST) {
+            summary.failures++;
+        } else {
+            latencies[summary.count++] = record.latency;
+            sum += record.latency;
+        }
+    }
+    if(summary.count) {
+        qsort(latencies, summary.count, sizeof(uint32_t), compare_latency);
+        summary.min = latencies[0];
+        summary.max = latencies[summary.count - 1];
+        summary.average = (uint32_t)(sum / summary.count);
+        summary.p50 = latencies[(summary.count - 1) * 50 / 100];
+        summary.p95 = latencies[(summary.count - 1) * 95 / 100];
+        summary.p99 = latencies[(summary.count - 1) * 99 / 100];
+    }
+    free(latencies);
+}
+
+const LWM2MTestServer::LatencyRecord* LWM2MTestServer::latency_records(uint32_t &count) const
+{
+    count = _record_count;
+    return _records;
+}
+
+void LWM2MTestServer::print_report(FILE *file) const
+{
+    fprintf(file, "Endpoints registered: %u/%u\n", registered_count(), endpoint_count());
+    fprintf(file, "%-13s %8s %8s %10s %10s %10s %10s %10s %10s\n", "request", "count",
+            "failed", "min(us)", "avg(us)", "p50(us)", "p95(us)", "p99(us)", "max(us)");
+    for(int type = 0; type < RequestTypeCount; type++) {
+        LatencySummary summary;
+        latency_summary((RequestType)type, summary);
+        if(summary.count || summary.failures) {
+            fprintf(file, "%-13s %8u %8u %10u %10u %10u %10u %10u %10u\n",
+                    REQUEST_TYPE_NAMES[type], summary.count, summary.failures,
+                    summary.min, summary.average, summary.p50, summary.p95,
+                    summary.p99, summary.max);
+        }
+    }
+}
+
+void LWM2MTestServer::write_latency_csv(FILE *file) const
+{
+    fprintf(file, "request,endpoint,response_code,latency_us\n");
+    for(uint32_t i = 0; i < _record_count; i++) {
+        const LatencyRecord &record = _records[i];
+        fprintf(file, "%s,%s,%u.%02u,%u\n", REQUEST_TYPE_NAMES[record.type],
+                endpoint_name(record.endpoint) ? endpoint_name(record.endpoint) : "",
+                record.response_code >> 5, record.response_code & 0x1F, record.latency);
+    }
+}
+
+const char* LWM2MTestServer::request_type_name(LWM2MTestServer::RequestType type)
+{
+    return (type < RequestTypeCount) ? REQUEST_TYPE_NAMES[type] : "";
+}
+
+uint64_t LWM2MTestServer::now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+}
+
+void LWM2MTestServer::handle_request(sn_coap_hdr_s *coap_header,
+                                     const sn_nsdl_addr_s &address)
+{
+    uint64_t start = now();
+    uint8_t response_code = COAP_MSG_CODE_RESPONSE_NOT_FOUND;
+    RequestType type = RequestTypeCount;
+    int32_t endpoint = -1;
+    const uint8_t *path = coap_header->uri_path_ptr;
+    uint16_t path_length = path ? coap_header->uri_path_len : 0;
+    uint16_t rd_length = strlen(RD_PATH);
+
+    if(path_length == rd_length && memcmp(path, RD_PATH, rd_length) == 0) {
+        if(COAP_MSG_CODE_REQUEST_POST == coap_header->msg_code) {
+            type = Register;
+            response_code = handle_register(coap_header, address, endpoint);
+        } else {
+            response_code = COAP_MSG_CODE_RESPONSE_METHOD_NOT_ALLOWED;
+        }
+    } else if(path_length > rd_length + 1 && memcmp(path, RD_PATH "/", rd_length + 1) == 0) {
+        endpoint = find_endpoint_by_location(path + rd_length + 1,
+                                             path_length - rd_length - 1);
+        if(endpoint < 0) {
+            response_code = COAP_MSG_CODE_RESPONSE_NOT_FOUND;
+        } else if(COAP_MSG_CODE_REQUEST_POST == coap_header->msg_code) {
+            type = Update;
+            response_code = handle_update(coap_header, address, endpoint);
+        } else if(COAP_MSG_CODE_REQUEST_DELETE == coap_header->msg_code) {
+            type = Deregister;
+            _endpoints[endpoint].registered = false;
+            remove_observations(endpoint);
+            response_code = COAP_MSG_CODE_RESPONSE_DELETED;
+        } else {
+            response_code = COAP_MSG_CODE_RESPONSE_METHOD_NOT_ALLOWED;
+        }
+    }
+
+    uint32_t location = 0;
+    if(Register == type && endpoint >= 0) {
+        location = _endpoints[endpoint].location;
+    }
+    send_response(coap_header, address, response_code, location);
+    if(type != RequestTypeCount) {
+        record_latency(type, (endpoint >= 0) ? endpoint : 0, now() - start, response_code);
+    }
+}
+
+void LWM2MTestServer::handle_response(sn_coap_hdr_s *coap_header,
+                                      const sn_nsdl_addr_s &address)
+{
+    if(COAP_MSG_TYPE_ACKNOWLEDGEMENT == coap_header->msg_type ||
+       COAP_MSG_TYPE_RESET == coap_header->msg_type) {
+        int32_t index = find_pending_by_msg_id(coap_header->msg_id);
+        if(index < 0) {
+            return;
+        }
+        if(COAP_MSG_TYPE_RESET == coap_header->msg_type) {
+            complete_request(index, 0, NULL);
+        } else if(COAP_MSG_CODE_EMPTY == coap_header->msg_code) {
+            // Response follows separately.
+            _pending[index].acknowledged = true;
+            _pending[index].timeout = now() + SEPARATE_RESPONSE_TIMEOUT;
+        } else {
+            complete_request(index, coap_header->msg_code, coap_header);
+        }
+        return;
+    }
+
+    // Separate response or notification.
+    uint32_t token = token_value(coap_header);
+    bool known = true;
+    int32_t index = find_pending_by_token(token);
+    if(index >= 0 && _pending[index].acknowledged) {
+        complete_request(index, coap_header->msg_code, coap_header);
+    } else {
+        index = find_observation(token);
+        if(index >= 0) {
+            Observation &observation = _observations[index];
+            uint64_t time = now();
+            _endpoints[observation.endpoint].notifications++;
+            record_latency(Notification, observation.endpoint,
+                           time - observation.last, coap_header->msg_code);
+            observation.last = time;
+        } else {
+            known = false;
+        }
+    }
+    if(COAP_MSG_TYPE_CONFIRMABLE == coap_header->msg_type) {
+        // Reset tells the client to stop unknown observations.
+        send_empty(known ? COAP_MSG_TYPE_ACKNOWLEDGEMENT : COAP_MSG_TYPE_RESET,
+                   coap_header->msg_id, address);
+    }
+}
+
+uint8_t LWM2MTestServer::handle_register(sn_coap_hdr_s *coap_header,
+                                         const sn_nsdl_addr_s &address,
+                                         int32_t &endpoint)
+{
+    uint16_t name_length = 0;
+    const uint8_t *name = query_value(coap_header, "ep", name_length);
+    if(!name || !name_length) {
+        return COAP_MSG_CODE_RESPONSE_BAD_REQUEST;
+    }
+    endpoint = -1;
+    for(uint32_t i = 0; i < _endpoint_count && endpoint < 0; i++) {
+        if(strlen(_endpoints[i].name) == name_length &&
+           memcmp(_endpoints[i].name, name, name_length) == 0) {
+            endpoint = i;
+        }
+    }
+    if(endpoint < 0) {
+        if(!grow((void**)&_endpoints, _endpoint_capacity, _endpoint_count, sizeof(Endpoint))) {
+            return COAP_MSG_CODE_RESPONSE_INTERNAL_SERVER_ERROR;
+        }
+        Endpoint &new_endpoint = _endpoints[_endpoint_count];
+        memset(&new_endpoint, 0, sizeof(Endpoint));
+        new_endpoint.name = (char*)malloc(name_length + 1);
+        if(!new_endpoint.name) {
+            return COAP_MSG_CODE_RESPONSE_INTERNAL_SERVER_ERROR;
+        }
+        memcpy(new_endpoint.name, name, name_length);
+        new_endpoint.name[name_length] = '\0';
+        endpoint = _endpoint_count++;
+    } else {
+        // Registering again drops the earlier observations.
+        remove_observations(endpoint);
+    }
+
+    Endpoint &registered = _endpoints[endpoint];
+    registered.location = ++_next_location;
+    registered.life_time = DEFAULT_LIFE_TIME;
+    registered.registered = true;
+    uint8_t code = handle_update(coap_header, address, endpoint);
+    return (COAP_MSG_CODE_RESPONSE_CHANGED == code) ?
+            (uint8_t)COAP_MSG_CODE_RESPONSE_CREATED : code;
+}
+
+uint8_t LWM2MTestServer::handle_update(sn_coap_hdr_s *coap_header,
+                                       const sn_nsdl_addr_s &address,
+                                       int32_t endpoint)
+{
+    Endpoint &updated = _endpoints[endpoint];
+    uint16_t length = 0;
+    const uint8_t *life_time = query_value(coap_header, "lt", length);
+    if(life_time && length) {
+        int32_t value = 0;
+        for(uint16_t i = 0; i < length && life_time[i] >= '0' && life_time[i] <= '9'; i++) {
+            value = value * 10 + (life_time[i] - '0');
+        }
+        updated.life_time = value;
+    }
+    set_endpoint_address(updated, address);
+    if(coap_header->payload_ptr && coap_header->payload_len) {
+        char *links = (char*)malloc(coap_header->payload_len + 1);
+        if(!links) {
+            return COAP_MSG_CODE_RESPONSE_INTERNAL_SERVER_ERROR;
+        }
+        memcpy(links, coap_header->payload_ptr, coap_header->payload_len);
+        links[coap_header->payload_len] = '\0';
+        free(updated.links);
+        updated.links = links;
+    }
+    return COAP_MSG_CODE_RESPONSE_CHANGED;
+}
+
+void LWM2MTestServer::complete_request(uint16_t index, uint8_t response_code,
+                                       sn_coap_hdr_s *coap_header)
+{
+    PendingRequest &pending = _pending[index];
+    uint64_t time = now();
+    _last_response_code = response_code;
+    record_latency((RequestType)pending.type, pending.endpoint,
+                   time - pending.sent, response_code);
+
+    if(Observe == pending.type &&
+       COAP_MSG_CODE_RESPONSE_CONTENT == response_code &&
+       coap_header && coap_header->options_list_ptr &&
+       (coap_header->options_list_ptr->observe || coap_header->options_list_ptr->observe_ptr) &&
+       grow((void**)&_observations, _observation_capacity, _observation_count, sizeof(Observation))) {
+        Observation &observation = _observations[_observation_count++];
+        observation.token = pending.token;
+        observation.endpoint = pending.endpoint;
+        observation.last = time;
+        observation.path = pending.path;
+        pending.path = NULL;
+    } else if(CancelObserve == pending.type) {
+        int32_t observation = find_observation(pending.observation);
+        if(observation >= 0) {
+            remove_observation(observation);
+        }
+    }
+    remove_pending(index);
+}
+
+void LWM2MTestServer::send_response(sn_coap_hdr_s *request,
+                                    const sn_nsdl_addr_s &address,
+                                    uint8_t response_code,
+                                    uint32_t location)
+{
+    sn_coap_hdr_s coap_header;
+    sn_coap_options_list_s options;
+    memset(&coap_header, 0, sizeof(sn_coap_hdr_s));
+    memset(&options, 0, sizeof(sn_coap_options_list_s));
+
+    if(COAP_MSG_TYPE_CONFIRMABLE == request->msg_type) {
+        coap_header.msg_type = COAP_MSG_TYPE_ACKNOWLEDGEMENT;
+        coap_header.msg_id = request->msg_id;
+    } else {
+        coap_header.msg_type = COAP_MSG_TYPE_NON_CONFIRMABLE;
+        coap_header.msg_id = ++_msg_id;
+    }
+    coap_header.msg_code = (sn_coap_msg_code_e)response_code;
+    coap_header.token_ptr = request->token_ptr;
+    coap_header.token_len = request->token_len;
+
+    char location_path[16];
+    if(location) {
+        int length = snprintf(location_path, sizeof(location_path), RD_PATH "/%u", location);
+        options.location_path_ptr = (uint8_t*)location_path;
+        options.location_path_len = length;
+        coap_header.options_list_ptr = &options;
+    }
+    send_message(&coap_header, address, NULL);
+}
+
+void LWM2MTestServer::send_empty(sn_coap_msg_type_e type, uint16_t msg_id,
+                                 const sn_nsdl_addr_s &address)
+{
+    sn_coap_hdr_s coap_header;
+    memset(&coap_header, 0, sizeof(sn_coap_hdr_s));
+    coap_header.msg_type = type;
+    coap_header.msg_code = COAP_MSG_CODE_EMPTY;
+    coap_header.msg_id = msg_id;
+    send_message(&coap_header, address, NULL);
+}
+
+bool LWM2MTestServer::send_message(sn_coap_hdr_s *coap_header,
+                                   const sn_nsdl_addr_s &address,
+                                   PendingRequest *pending)
+{
+    uint16_t size = sn_coap_builder_calc_needed_packet_data_size(coap_header);
+    uint8_t *packet = size ? (uint8_t*)malloc(size) : NULL;
+    if(!packet) {
+        return false;
+    }
+    int16_t length = sn_coap_builder(packet, coap_header);
+    if(length <= 0) {
+        free(packet);
+        return false;
+    }
+    _send(packet, length, &address, _context);
+    if(pending) {
+        // Kept for retransmissions.
+        pending->packet = packet;
+        pending->packet_length = length;
+        pending->sent = now();
+        pending->timeout = pending->sent + ACK_TIMEOUT;
+    } else {
+        free(packet);
+    }
+    return true;
+}
+
+void LWM2MTestServer::endpoint_address(uint16_t endpoint, sn_nsdl_addr_s &address) const
+{
+    const Endpoint &target = _endpoints[endpoint];
+    address.type = target.address_type;
+    address.addr_len = target.address_length;
+    address.addr_ptr = (uint8_t*)target.address;
+    address.port = target.port;
+}
+
+void LWM2MTestServer::set_endpoint_address(Endpoint &endpoint, const sn_nsdl_addr_s &address)
+{
+    endpoint.address_length = (address.addr_len < sizeof(endpoint.address)) ?
+                               address.addr_len : sizeof(endpoint.address);
+    if(address.addr_ptr) {
+        memcpy(endpoint.address, address.addr_ptr, endpoint.address_length);
+    }
+    endpoint.address_type = address.type;
+    endpoint.port = address.port;
+}
+
+int32_t LWM2MTestServer::find_endpoint_by_location(const uint8_t *path, uint16_t length) const
+{
+    uint32_t location = 0;
+    for(uint16_t i = 0; i < length; i++) {
+        if(path[i] < '0' || path[i] > '9') {
+            return -1;
+        }
+        location = location * 10 + (path[i] - '0');
+    }
+    for(uint32_t i = 0; i < _endpoint_count; i++) {
+        if(_endpoints[i].registered && _endpoints[i].location == location) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int32_t LWM2MTestServer::find_pending_by_msg_id(uint16_t msg_id) const
+{
+    for(uint32_t i = 0; i < _pending_count; i++) {
+        if(_pending[i].msg_id == msg_id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int32_t LWM2MTestServer::find_pending_by_token(uint32_t token) const
+{
+    for(uint32_t i = 0; i < _pending_count; i++) {
+        if(_pending[i].token == token) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int32_t LWM2MTestServer::find_observation(uint32_t token) const
+{
+    for(uint32_t i = 0; i < _observation_count; i++) {
+        if(_observations[i].token == token) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void LWM2MTestServer::remove_pending(uint16_t index)
+{
+    free(_pending[index].packet);
+    free(_pending[index].path);
+    _pending[index] = _pending[--_pending_count];
+}
+
+void LWM2MTestServer::remove_observation(uint16_t index)
+{
+    free(_observations[index].path);
+    _observations[index] = _observations[--_observation_count];
+}
+
+void LWM2MTestServer::remove_observations(uint16_t endpoint)
+{
+    uint32_t index = 0;
+    while(index < _observation_count) {
+        if(_observations[index].endpoint == endpoint) {
+            remove_observation(index);
+        } else {
+            index++;
+        }
+    }
+}
+
+void LWM2MTestServer::record_latency(LWM2MTestServer::RequestType type,
+                                     uint16_t endpoint,
+                                     uint64_t latency,
+                                     uint8_t response_code)
+{
+    if(!grow((void**)&_records, _record_capacity, _record_count, sizeof(LatencyRecord))) {
+        return;
+    }
+    LatencyRecord &record = _records[_record_count++];
+    record.type = type;
+    record.response_code = response_code;
+    record.endpoint = endpoint;
+    record.latency = (latency > 0xFFFFFFFFULL) ? 0xFFFFFFFF : (uint32_t)latency;
+}
+
+bool LWM2MTestServer::grow(void **array, uint32_t &capacity, uint32_t count, size_t element_size)
+{
+    if(count < capacity) {
+        return true;
+    }
+    uint32_t new_capacity = capacity ? capacity * 2 : 8;
+    void *grown = realloc(*array, new_capacity * element_size);
+    if(!grown) {
+        return false;
+    }
+    *array = grown;
+    capacity = new_capacity;
+    return true;
+}
+
+uint32_t LWM2MTestServer::token_value(const sn_coap_hdr_s *coap_header)
+{
+    uint32_t token = 0;
+    if(coap_header->token_ptr && TOKEN_LENGTH == coap_header->token_len) {
+        for(uint8_t i = 0; i < TOKEN_LENGTH; i++) {
+            token = (token << 8) | coap_header->token_ptr[i];
+        }
+    }
+    return token;
+}
+
+const uint8_t* LWM2MTestServer::query_value(const sn_coap_hdr_s *coap_header,
+                                            const char *key,
+                                            uint16_t &length)
+{
+    length = 0;
+    if(!coap_header->options_list_ptr || !coap_header->options_list_ptr->uri_query_ptr) {
+        return NULL;
+    }
+    // Parser joins the query options with '&'.
+    const uint8_t *query = coap_header->options_list_ptr->uri_query_ptr;
+    uint16_t query_length = coap_header->options_list_ptr->uri_query_len;
+    uint16_t key_length = strlen(key);
+    uint16_t start = 0;
+    while(start < query_length) {
+        uint16_t end = start;
+        while(end < query_length && query[end] != '&') {
+            end++;
+        }
+        if(end - start > key_length && memcmp(query + start, key, key_length) == 0 &&
+           '=' == query[start + key_length]) {
+            length = end - start - key_length - 1;
+            return query + start + key_length + 1;
+        }
+        start = end + 1;
+    }
+    return NULL;
+}
+
+void* LWM2MTestServer::memory_alloc(uint16_t size)
+{
+    return size ? malloc(size) : NULL;
+}
+
+void LWM2MTestServer::memory_free(void *ptr)
+{
+    free(ptr);
+}
+
+uint8_t LWM2MTestServer::coap_tx_callback(uint8_t *, uint16_t, sn_nsdl_addr_s *, void *)
+{
+    return 0;
+}
+
+int8_t LWM2MTestServer::coap_rx_callback(sn_coap_hdr_s *, sn_nsdl_addr_s *, void *)
+{
+    return 0;
+}
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LWM2M_TEST_SERVER_H
+#define LWM2M_TEST_SERVER_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "nsdl-c/sn_nsdl.h"
+#include "nsdl-c/sn_coap_header.h"
+#include "nsdl-c/sn_coap_protocol.h"
+
+/**
+ *  @brief LWM2MTestServer.
+ *  Minimal stand-in for an LWM2M server, built on the nsdl-c CoAP parser
+ *  and builder. It accepts registrations, registration updates and
+ *  deregistrations from clients, sends GET, PUT, POST, DELETE and observe
+ *  requests to them and records the latency of every request.
+ *  The server doesn't own a socket: datagrams are fed in with
+ *  process_datagram() and sent out through the send function, so it can
+ *  be linked into a test or driven by a loopback UDP process.
+ *  Not thread safe, all the calls must come from the same thread.
+ */
+class LWM2MTestServer {
+
+public:
+
+    /**
+     * Enum defining the request types the server keeps statistics for.
+     */
+    typedef enum {
+        Register = 0,
+        Update,
+        Deregister,
+        Get,
+        Put,
+        Post,
+        Observe,
+        CancelObserve,
+        Delete,
+        Notification,
+        RequestTypeCount
+    } RequestType;
+
+    /**
+     * @brief Function sending a datagram to a client.
+     * @param data, Datagram to be sent.
+     * @param length, Length of the datagram.
+     * @param address, Address of the client.
+     * @param context, Context given to the constructor.
+     */
+    typedef void (*send_function)(const uint8_t *data,
+                                  uint16_t length,
+                                  const sn_nsdl_addr_s *address,
+                                  void *context);
+
+    /**
+     * Latency of one request. Registrations, updates and deregistrations
+     * are timed inside the server, requests sent to the clients from sending
+     * to receiving the response, notifications from the previous
+     * notification of the same observation.
+     */
+    typedef struct {
+        uint8_t     type;
+        uint8_t     response_code;  // 0 when the request failed or timed out.
+        uint16_t    endpoint;
+        uint32_t    latency;        // Microseconds.
+    } LatencyRecord;
+
+    /**
+     * Latency summary of one request type, in microseconds.
+     */
+    typedef struct {
+        uint32_t    count;
+        uint32_t    failures;
+        uint32_t    min;
+        uint32_t    max;
+        uint32_t    average;
+        uint32_t    p50;
+        uint32_t    p95;
+        uint32_t    p99;
+    } LatencySummary;
+
+    /**
+     * @brief Constructor
+     * @param send, Function used for sending datagrams.
+     * @param context, Context passed to the send function.
+     */
+    LWM2MTestServer(send_function send, void *context);
+
+    /**
+     * @brief Destructor
+     */
+    ~LWM2MTestServer();
+
+    /**
+     * @brief Initializes the CoAP library.
+     * @return True if successful, else false.
+     */
+    bool initialize();
+
+    /**
+     * @brief Handles a datagram received from a client.
+     * @param data, Received datagram.
+     * @param length, Length of the datagram.
+     * @param address, Address of the sender.
+     */
+    void process_datagram(uint8_t *data, uint16_t length,
+                          const sn_nsdl_addr_s &address);
+
+    /**
+     * @brief Retransmits and times out pending requests,
+     * must be called periodically.
+     */
+    void run();
+
+    /**
+     * @brief Sends a request to a registered client.
+     * @param endpoint, Index of the endpoint.
+     * @param type, Get, Put, Post, Observe, CancelObserve or Delete.
+     * @param path, Path of the resource, for example "3/0/0".
+     * @param payload, Payload of the request, can be NULL.
+     * @param payload_length, Length of the payload.
+     * @return True if sent, else false.
+     */
+    bool send_request(uint16_t endpoint,
+                      LWM2MTestServer::RequestType type,
+                      const char *path,
+                      const uint8_t *payload = NULL,
+                      uint16_t payload_length = 0);
+
+    /**
+     * @brief Returns the number of endpoints that have registered,
+     * including the ones that have deregistered since.
+     */
+    uint16_t endpoint_count() const;
+
+    /**
+     * @brief Returns the number of endpoints currently registered.
+     */
+    uint16_t registered_count() const;
+
+    /**
+     * @brief Returns the index of the given endpoint.
+     * @param name, Endpoint name.
+     * @return Index of the endpoint, -1 if not found.
+     */
+    int32_t find_endpoint(const char *name) const;
+
+    /**
+     * @brief Returns the name of the given endpoint.
+     */
+    const char* endpoint_name(uint16_t endpoint) const;
+
+    /**
+     * @brief Returns whether the given endpoint is registered.
+     */
+    bool endpoint_registered(uint16_t endpoint) const;
+
+    /**
+     * @brief Returns the link format payload of the last registration
+     * or update of the given endpoint.
+     */
+    const char* endpoint_links(uint16_t endpoint) const;
+
+    /**
+     * @brief Returns the number of notifications received from the
+     * given endpoint.
+     */
+    uint32_t endpoint_notifications(uint16_t endpoint) const;
+
+    /**
+     * @brief Returns the number of requests waiting for a response.
+     */
+    uint16_t pending_count() const;
+
+    /**
+     * @brief Returns the response code of the last completed request
+     * sent to a client, 0 if it failed.
+     */
+    uint8_t last_response_code() const;
+
+    /**
+     * @brief Computes the latency summary of the given request type.
+     * @param type, Request type.
+     * @param summary[OUT], Latency summary.
+     */
+    void latency_summary(LWM2MTestServer::RequestType type,
+                         LWM2MTestServer::LatencySummary &summary) const;
+
+    /**
+     * @brief Returns the recorded latencies, in the order they completed.
+     * @param count[OUT], Number of records.
+     */
+    const LatencyRecord* latency_records(uint32_t &count) const;
+
+    /**
+     * @brief Prints the latency summary of all request types.
+     * @param file, Output stream.
+     */
+    void print_report(FILE *file) const;
+
+    /**
+     * @brief Writes all the latency records as comma separated values.
+     * @param file, Output stream.
+     */
+    void write_latency_csv(FILE *file) const;
+
+    /**
+     * @brief Returns the name of the given request type.
+     */
+    static const char* request_type_name(LWM2MTestServer::RequestType type);
+
+    /**
+     * @brief Returns a monotonic timestamp in microseconds.
+     */
+    static uint64_t now();
+
+private:
+
+    typedef struct {
+        char                    *name;
+        char                    *links;
+        uint32_t                location;
+        int32_t                 life_time;
+        uint8_t                 address[16];
+        uint8_t                 address_length;
+        sn_nsdl_addr_type_e     address_type;
+        uint16_t                port;
+        bool                    registered;
+        uint32_t                notifications;
+    } Endpoint;
+
+    typedef struct {
+        uint8_t     *packet;
+        uint16_t    packet_length;
+        uint16_t    msg_id;
+        uint32_t    token;
+        uint16_t    endpoint;
+        uint8_t     type;
+        uint8_t     retransmissions;
+        bool        acknowledged;
+        uint64_t    sent;
+        uint64_t    timeout;
+        uint32_t    observation;    // Token of the observation being cancelled.
+        char        *path;
+    } PendingRequest;
+
+    typedef struct {
+        uint32_t    token;
+        uint16_t    endpoint;
+        uint64_t    last;
+        char        *path;
+    } Observation;
+
+    // Prevents the use of assignment operator.
+    LWM2MTestServer& operator=( const LWM2MTestServer& /*other*/ );
+
+    // Prevents the use of copy constructor
+    LWM2MTestServer( const LWM2MTestServer& /*other*/ );
+
+    void handle_request(sn_coap_hdr_s *coap_header,
+                        const sn_nsdl_addr_s &address);
+
+    void handle_response(sn_coap_hdr_s *coap_header,
+                         const sn_nsdl_addr_s &address);
+
+    uint8_t handle_register(sn_coap_hdr_s *coap_header,
+                            const sn_nsdl_addr_s &address,
+                            int32_t &endpoint);
+
+    uint8_t handle_update(sn_coap_hdr_s *coap_header,
+                          const sn_nsdl_addr_s &address,
+                          int32_t endpoint);
+
+    void complete_request(uint16_t index, uint8_t response_code,
+                          sn_coap_hdr_s *coap_header);
+
+    void send_response(sn_coap_hdr_s *request,
+                       const sn_nsdl_addr_s &address,
+                       uint8_t response_code,
+                       uint32_t location = 0);
+
+    void send_empty(sn_coap_msg_type_e type, uint16_t msg_id,
+                    const sn_nsdl_addr_s &address);
+
+    bool send_message(sn_coap_hdr_s *coap_header,
+                      const sn_nsdl_addr_s &address,
+                      PendingRequest *pending);
+
+    void endpoint_address(uint16_t endpoint, sn_nsdl_addr_s &address) const;
+
+    void set_endpoint_address(Endpoint &endpoint, const sn_nsdl_addr_s &address);
+
+    int32_t find_endpoint_by_location(const uint8_t *path, uint16_t length) const;
+
+    int32_t find_pending_by_msg_id(uint16_t msg_id) const;
+
+    int32_t find_pending_by_token(uint32_t token) const;
+
+    int32_t find_observation(uint32_t token) const;
+
+    void remove_pending(uint16_t index);
+
+    void remove_observation(uint16_t index);
+
+    void remove_observations(uint16_t endpoint);
+
+    void record_latency(LWM2MTestServer::RequestType type,
+                        uint16_t endpoint,
+                        uint64_t latency,
+                        uint8_t response_code);
+
+    bool grow(void **array, uint32_t &capacity, uint32_t count, size_t element_size);
+
+    static uint32_t token_value(const sn_coap_hdr_s *coap_header);
+
+    static const uint8_t* query_value(const sn_coap_hdr_s *coap_header,
+                                      const char *key,
+                                      uint16_t &length);
+
+    static void* memory_alloc(uint16_t size);
+
+    static void memory_free(void *ptr);
+
+    static uint8_t coap_tx_callback(uint8_t *, uint16_t, sn_nsdl_addr_s *, void *);
+
+    static int8_t coap_rx_callback(sn_coap_hdr_s *, sn_nsdl_addr_s *, void *);
+
+private:
+
+    send_function               _send;
+    void                        *_context;
+    struct coap_s               *_coap;
+    Endpoint                    *_endpoints;
+    uint32_t                    _endpoint_count;
+    uint32_t                    _endpoint_capacity;
+    PendingRequest              *_pending;
+    uint32_t                    _pending_count;
+    uint32_t                    _pending_capacity;
+    Observation                 *_observations;
+    uint32_t                    _observation_count;
+    uint32_t                    _observation_capacity;
+    LatencyRecord               *_records;
+    uint32_t                    _record_count;
+    uint32_t                    _record_capacity;
+    uint16_t                    _msg_id;
+    uint32_t                    _token;
+    uint32_t                    _next_location;
+    uint8_t                     _last_response_code;
+};
+
+#endif // LWM2M_TEST_SERVER_H
@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * Loopback LWM2M server stand-in. Serves registrations on a UDP socket,
+ * or on TCP with RFC 8323 framing when started with -T, and optionally
+ * runs a scripted request workload, see lwm2mtestscript.h.
+ * The latency report is printed at exit and can be written as CSV.
+ */
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <poll.h>
+#include <errno.h>
+#include <signal.h> /* For SIGIGN and SIGINT */
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "lwm2mtestserver.h"
+#include "lwm2mtestscript.h"
+#include "mbed-client/m2mudpbatch.h"
+#include "mbed-client/m2mcoaptcpframer.h"
+#include "mbed-client/m2mconstants.h"
+
+typedef void (*signalhandler_t)(int); /* Function pointer type for ctrl-c */
+
+const int POLL_INTERVAL = 10;
+const uint16_t MAX_DATAGRAM_SIZE = 1280;
+const int MAX_CONNECTIONS = 64;
+
+typedef struct {
+    int                  fd;
+    struct sockaddr_in   peer;
+    M2MCoapTcpFramer    *framer;
+    bool                 processing;
+} TcpConnection;
+
+typedef struct {
+    LWM2MTestServer     *server;
+    TcpConnection        connections[MAX_CONNECTIONS];
+} TcpTransport;
+
+static volatile bool running = true;
+
+static void ctrl_c_handle_function(void)
+{
+    running = false;
+}
+
+// Responses are queued while a loop turn runs and sent in one batch at its end.
+static void send_datagram(const uint8_t *data, uint16_t length,
+                          const sn_nsdl_addr_s *address, void *context)
+{
+    M2MUdpBatch *batch = (M2MUdpBatch*)context;
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(address->port);
+    if(address->addr_ptr && address->addr_len >= 4) {
+        memcpy(&to.sin_addr, address->addr_ptr, 4);
+    }
+    if(!batch->queue(data, length, (struct sockaddr*)&to, sizeof(to))) {
+        printf("Datagram to port %u dropped\n", address->port);
+    }
+}
+
+static bool send_stream(int fd, const uint8_t *data, uint16_t length)
+{
+    while(length > 0) {
+        ssize_t sent = send(fd, data, length, MSG_NOSIGNAL);
+        if(sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if(sent <= 0) {
+            return false;
+        }
+        data += sent;
+        length -= (uint16_t)sent;
+    }
+    return true;
+}
+
+static void close_connection(TcpConnection &connection)
+{
+    if(connection.fd >= 0) {
+        close(connection.fd);
+    }
+    delete connection.framer;
+    connection.fd = -1;
+    connection.framer = NULL;
+    connection.processing = false;
+}
+
+// Hands every complete message of the stream to the server as if it had
+// arrived in a datagram. Responses sent from inside process_datagram() may
+// produce local ACKs, those are picked up by the same loop.
+static void process_stream(TcpTransport *transport, TcpConnection &connection)
+{
+    if(connection.processing) {
+        return;
+    }
+    connection.processing = true;
+    sn_nsdl_addr_s address;
+    address.type = SN_NSDL_ADDRESS_TYPE_IPV4;
+    address.addr_len = 4;
+    address.addr_ptr = (uint8_t*)&connection.peer.sin_addr;
+    address.port = ntohs(connection.peer.sin_port);
+    uint16_t length = 0;
+    const uint8_t *message;
+    while(connection.framer && (message = connection.framer->next_message(length)) != NULL) {
+        transport->server->process_datagram((uint8_t*)message, length, address);
+    }
+    const uint8_t *signal;
+    while(connection.framer && (signal = connection.framer->next_signal(length)) != NULL) {
+        if(!send_stream(connection.fd, signal, length)) {
+            break;
+        }
+    }
+    connection.processing = false;
+}
+
+// TCP mode, the response is framed and written to the connection of the peer.
+static void send_stream_message(const uint8_t *data, uint16_t length,
+                                const sn_nsdl_addr_s *address, void *context)
+{
+    TcpTransport *transport = (TcpTransport*)context;
+    for(int i = 0; i < MAX_CONNECTIONS; i++) {
+        TcpConnection &connection = transport->connections[i];
+        if(connection.fd < 0 || !address->addr_ptr || address->addr_len < 4 ||
+           ntohs(connection.peer.sin_port) != address->port ||
+           memcmp(&connection.peer.sin_addr, address->addr_ptr, 4) != 0) {
+            continue;
+        }
+        uint16_t frame_length = 0;
+        const uint8_t *frame = connection.framer->encode(data, length, frame_length);
+        if(frame && !send_stream(connection.fd, frame, frame_length)) {
+            printf("Connection from port %u lost\n", address->port);
+            close_connection(connection);
+            return;
+        }
+        process_stream(transport, connection);
+        return;
+    }
+    printf("Message to port %u dropped, no connection\n", address->port);
+}
+
+static void accept_connection(TcpTransport *transport, int listen_fd)
+{
+    struct sockaddr_in peer;
+    socklen_t peer_length = sizeof(peer);
+    int fd = accept(listen_fd, (struct sockaddr*)&peer, &peer_length);
+    if(fd < 0) {
+        return;
+    }
+    for(int i = 0; i < MAX_CONNECTIONS; i++) {
+        TcpConnection &connection = transport->connections[i];
+        if(connection.fd < 0) {
+            connection.fd = fd;
+            connection.peer = peer;
+            connection.framer = new M2MCoapTcpFramer(COAP_TCP_MAX_MESSAGE_SIZE);
+            connection.processing = false;
+            return;
+        }
+    }
+    printf("Too many connections, port %u refused\n", ntohs(peer.sin_port));
+    close(fd);
+}
+
+static void receive_stream(TcpTransport *transport, TcpConnection &connection)
+{
+    uint8_t buffer[MAX_DATAGRAM_SIZE];
+    ssize_t received = recv(connection.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if(received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return;
+    }
+    if(received <= 0) {
+        close_connection(connection);
+        return;
+    }
+    uint16_t offset = 0;
+    while(connection.framer && offset < received) {
+        uint16_t taken = connection.framer->feed(buffer + offset, (uint16_t)(received - offset));
+        offset += taken;
+        process_stream(transport, connection);
+        if(!taken || !connection.framer || connection.framer->failed()) {
+            break;
+        }
+    }
+    if(connection.framer && connection.framer->failed()) {
+        printf("Invalid stream from port %u, connection closed\n",
+               ntohs(connection.peer.sin_port));
+        close_connection(connection);
+    }
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  -a <address>   IPv4 address to listen on (default 127.0.0.1)\n");
+    printf("  -p <port>      UDP or TCP port to listen on (default 5683)\n");
+    printf("  -T             Listens on TCP and frames messages as in RFC 8323\n");
+    printf("  -s <file>      Request script to run, exits when it has finished\n");
+    printf("  -c <file>      Writes every request latency to a CSV file\n");
+    printf("  -t <seconds>   Run time without a script, 0 runs until ctrl-c (default 0)\n");
+}
+
+int main(int argc, char **argv) {
+
+    const char *listen_address = "127.0.0.1";
+    uint16_t port = 5683;
+    const char *script_file = NULL;
+    const char *csv_file = NULL;
+    uint32_t duration = 0;
+    bool tcp = false;
+
+    int opt;
+    while((opt = getopt(argc, argv, "a:p:s:c:t:Th")) != -1) {
+        switch(opt) {
+            case 'a': listen_address = optarg; break;
+            case 'p': port = (uint16_t)strtoul(optarg, NULL, 10); break;
+            case 's': script_file = optarg; break;
+            case 'c': csv_file = optarg; break;
+            case 't': duration = strtoul(optarg, NULL, 10); break;
+            case 'T': tcp = true; break;
+            default:
+                usage(argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    signal(SIGINT, (signalhandler_t)ctrl_c_handle_function);
+
+    int socket_fd = socket(AF_INET, tcp ? SOCK_STREAM : SOCK_DGRAM, 0);
+    if(tcp && socket_fd >= 0) {
+        int reuse = 1;
+        setsockopt(socket_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    }
+    struct sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_port = htons(port);
+    if(socket_fd < 0 || inet_pton(AF_INET, listen_address, &local.sin_addr) != 1 ||
+       bind(socket_fd, (struct sockaddr*)&local, sizeof(local)) != 0 ||
+       (tcp && listen(socket_fd, MAX_CONNECTIONS) != 0)) {
+        printf("Cannot listen on %s:%u\n", listen_address, port);
+        exit(EXIT_FAILURE);
+    }
+
+    M2MUdpBatch batch(socket_fd, MAX_DATAGRAM_SIZE);
+    TcpTransport transport;
+    for(int i = 0; i < MAX_CONNECTIONS; i++) {
+        transport.connections[i].fd = -1;
+        transport.connections[i].framer = NULL;
+        transport.connections[i].processing = false;
+    }
+    LWM2MTestServer server(tcp ? &send_stream_message : &send_datagram,
+                           tcp ? (void*)&transport : (void*)&batch);
+    transport.server = &server;
+    if(!server.initialize()) {
+        printf("Cannot initialize the CoAP library\n");
+        exit(EXIT_FAILURE);
+    }
+    LWM2MTestScript script(server);
+    if(script_file && !script.load_file(script_file)) {
+        printf("Cannot load script %s, error on line %u\n", script_file, script.error_line());
+        exit(EXIT_FAILURE);
+    }
+    printf("Listening on %s:%u (%s)\n", listen_address, port, tcp ? "TCP" : "UDP");
+
+    uint64_t start = LWM2MTestServer::now();
+    uint8_t buffer[M2MUdpBatch::MAX_BATCH][MAX_DATAGRAM_SIZE];
+    uint8_t *buffers[M2MUdpBatch::MAX_BATCH];
+    for(uint8_t i = 0; i < M2MUdpBatch::MAX_BATCH; i++) {
+        buffers[i] = buffer[i];
+    }
+    struct pollfd poll_fd;
+    poll_fd.fd = socket_fd;
+    struct pollfd poll_fds[MAX_CONNECTIONS + 1];
+    int connection_index[MAX_CONNECTIONS + 1];
+    while(running) {
+        if(tcp) {
+            nfds_t count = 0;
+            poll_fds[count].fd = socket_fd;
+            poll_fds[count].events = POLLIN;
+            connection_index[count++] = -1;
+            for(int i = 0; i < MAX_CONNECTIONS; i++) {
+                if(transport.connections[i].fd >= 0) {
+                    poll_fds[count].fd = transport.connections[i].fd;
+                    poll_fds[count].events = POLLIN;
+                    connection_index[count++] = i;
+                }
+            }
+            if(poll(poll_fds, count, POLL_INTERVAL) > 0) {
+                for(nfds_t i = 0; i < count; i++) {
+                    if(!(poll_fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                        continue;
+                    }
+                    if(connection_index[i] < 0) {
+                        accept_connection(&transport, socket_fd);
+                    } else if(transport.connections[connection_index[i]].fd == poll_fds[i].fd) {
+                        receive_stream(&transport, transport.connections[connection_index[i]]);
+                    }
+                }
+            }
+        } else {
+            poll_fd.events = batch.pending() ? (POLLIN | POLLOUT) : POLLIN;
+            if(poll(&poll_fd, 1, POLL_INTERVAL) > 0 && (poll_fd.revents & POLLIN)) {
+                int count;
+                while((count = batch.receive(buffers, M2MUdpBatch::MAX_BATCH, MAX_DATAGRAM_SIZE)) > 0) {
+                    for(int i = 0; i < count; i++) {
+                        socklen_t from_length = 0;
+                        const struct sockaddr_in *from =
+                            (const struct sockaddr_in*)batch.received_address(i, from_length);
+                        sn_nsdl_addr_s address;
+                        address.type = SN_NSDL_ADDRESS_TYPE_IPV4;
+                        address.addr_len = 4;
+                        address.addr_ptr = (uint8_t*)&from->sin_addr;
+                        address.port = ntohs(from->sin_port);
+                        server.process_datagram(buffers[i], batch.received_length(i), address);
+                    }
+                }
+            }
+        }
+        server.run();
+        if(script_file) {
+            running = running && script.run();
+        } else if(duration &&
+                  LWM2MTestServer::now() - start >= (uint64_t)duration * 1000000ULL) {
+            running = false;
+        }
+        batch.flush();
+    }
+    batch.flush();
+
+    printf("\n============== LWM2M test server results ==============\n");
+    server.print_report(stdout);
+    if(!tcp) {
+        const M2MUdpBatch::Stats &stats = batch.stats();
+        printf("Datagrams sent %u in %u calls (largest batch %u, dropped %u)\n",
+               stats.datagrams_sent, stats.send_calls, stats.largest_send_batch, stats.send_errors);
+        printf("Datagrams received %u in %u calls (largest batch %u)\n",
+               stats.datagrams_received, stats.receive_calls, stats.largest_receive_batch);
+    }
+    if(csv_file) {
+        FILE *file = fopen(csv_file, "w");
+        if(file) {
+            server.write_latency_csv(file);
+            fclose(file);
+        } else {
+            printf("Cannot write %s\n", csv_file);
+        }
+    }
+    for(int i = 0; i < MAX_CONNECTIONS; i++) {
+        close_connection(transport.connections[i]);
+    }
+    close(socket_fd);
+
+    if(script.failed()) {
+        printf("Script failed on line %u\n", script.error_line());
+        exit(EXIT_FAILURE);
+    }
+    exit(EXIT_SUCCESS);
+}
@@ -232,3 +232,7 @@ TEST(M2MBase, test_id_number)
     m2m_base->test_id_number();
 }
 
+TEST(M2MBase, test_memory_stats)
+{
+    m2m_base->test_memory_stats();
+}
@@ -67,21 +67,27 @@ void Test_M2MBase::test_copy_constructor()
 
     //Test heap constructor
     Test_M2MBase* test = new Test_M2MBase();
-    test->_interface_description = test_string;
+    test->set_interface_description(test_string);
 
-    test->_token_length = 3;
-    test->_token = (u_int8_t *)malloc(test->_token_length);
+    u_int8_t token[] = {"tok"};
+    test->set_observation_token(token, 3);
 
-    Observer obs;
-    test->_report_handler = new M2MReportHandler(obs);
+    Handler handler;
+    test->set_under_observation(true, &handler);
+    test->set_observation_number(2);
 
     Test_M2MBase* copy = new Test_M2MBase(*test);
 
-    CHECK(copy->_interface_description.compare(0,test_string.size(),test_string) == 0);
+    CHECK(copy->interface_description().compare(0,test_string.size(),test_string) == 0);
+    CHECK(copy->_interface_description == test->_interface_description);
 
-    CHECK(copy->_token != NULL);
+    CHECK(copy->_observation != NULL);
+    CHECK(copy->_observation != test->_observation);
+    CHECK(copy->_observation->token != NULL);
+    CHECK(copy->_observation->token_length == 3);
+    CHECK(copy->observation_number() == 2);
 
-    CHECK(copy->_report_handler != NULL);
+    CHECK(copy->report_handler() != NULL);
 
     delete test;
     delete copy;    
@@ -103,23 +109,29 @@ void Test_M2MBase::test_assignment_operator()
     test->operator=(*test3);
     delete test3;
 
-    test->_token_length = 3;
-    test->_token = (u_int8_t *)malloc(test->_token_length);
-
-    Observer obs;
-    test->_report_handler = new M2MReportHandler(obs);
+    u_int8_t token[] = {"token123"};
+    test->set_observation_token(token, 3);
 
-    test2->_token_length = 8;
-    test2->_token = (u_int8_t *)malloc(test2->_token_length);
+    Handler handler;
+    test->set_under_observation(true, &handler);
 
-    Observer obs2;
-    test2->_report_handler = new M2MReportHandler(obs2);
+    test2->set_observation_token(token, 8);
+    test2->set_under_observation(true, &handler);
 
     *test = *test2;
 
-    CHECK(test->_token != NULL);
+    CHECK(test->_observation != NULL);
+    CHECK(test->_observation->token != NULL);
+    CHECK(test->_observation->token_length == 8);
 
-    CHECK(test->_report_handler != NULL);
+    CHECK(test->report_handler() != NULL);
+
+    // Assigning an unobserved object releases the observation state.
+    Test_M2MBase* test4 = new Test_M2MBase();
+    *test = *test4;
+    CHECK(test->_observation == NULL);
+    CHECK(test->report_handler() == NULL);
+    delete test4;
 
     delete test2;
     delete test;
@@ -151,7 +163,17 @@ void Test_M2MBase::test_set_interface_description()
     String test = "interface_description";
     set_interface_description(test);
 
-    CHECK(test == this->_interface_description);
+    CHECK(test == M2MStringPool::string(this->_interface_description));
+
+    // Same value is shared, not copied.
+    M2MBase other("other", M2MBase::Dynamic);
+    uint16_t size = M2MStringPool::size();
+    other.set_interface_description(test);
+    CHECK(other._interface_description == this->_interface_description);
+    CHECK(M2MStringPool::size() == size);
+
+    set_interface_description("");
+    CHECK(this->_interface_description == M2MStringPool::EMPTY);
 }
 
 void Test_M2MBase::test_set_resource_type()
@@ -159,7 +181,10 @@ void Test_M2MBase::test_set_resource_type()
     String test = "resource_type";
     set_resource_type(test);
 
-    CHECK(test == this->_resource_type);
+    CHECK(test == M2MStringPool::string(this->_resource_type));
+
+    set_resource_type(test);
+    CHECK(test == resource_type());
 }
 
 void Test_M2MBase::test_set_coap_content_type()
@@ -215,8 +240,11 @@ void Test_M2MBase::test_set_under_observation()
     set_under_observation(test,&handler);
 
     CHECK(&handler == this->_observation_handler);
+    CHECK(report_handler() != NULL);
 
     set_under_observation(test,NULL);
+    CHECK(report_handler() == NULL);
+    CHECK(_observation == NULL);
 
     test = false;
     set_under_observation(test,NULL);
@@ -224,17 +252,27 @@ void Test_M2MBase::test_set_under_observation()
     test = false;
     set_under_observation(test,&handler);
 
+    // Registration alone doesn't allocate the observation state.
+    CHECK(&handler == this->_observation_handler);
+    CHECK(report_handler() == NULL);
+    CHECK(_observation == NULL);
+
     set_under_observation(test,&handler);
 }
 
 void Test_M2MBase::test_set_observation_token()
 {
-    this->_token_length = 4;
-    this->_token = (u_int8_t *)malloc(this->_token_length);
-    String test = "token";
+    String test = "tok1";
     set_observation_token((const u_int8_t*)test.c_str(), (u_int8_t)test.size());
+    CHECK(this->_observation->token_length == 4);
 
-    CHECK(this->_token_length == 5);
+    test = "token";
+    set_observation_token((const u_int8_t*)test.c_str(), (u_int8_t)test.size());
+
+    CHECK(this->_observation->token_length == 5);
+
+    set_observation_token(NULL, 0);
+    CHECK(this->_observation == NULL);
 }
 
 void Test_M2MBase::test_is_observable()
@@ -260,14 +298,16 @@ void Test_M2MBase::test_get_observation_token()
     u_int32_t out_size = value_length;
     memcpy((u_int8_t *)out_value, (u_int8_t *)test_value, value_length);
 
+    get_observation_token(out_value,out_size);
+    CHECK(out_size == 0);
+
     u_int8_t test[] = {"token"};
-    this->_token_length = (u_int8_t)sizeof(test);
-    this->_token = (u_int8_t *)malloc(this->_token_length);
-    memcpy((u_int8_t *)this->_token, (u_int8_t *)test, this->_token_length);
+    set_observation_token(test, (u_int8_t)sizeof(test));
 
     get_observation_token(out_value,out_size);
 
     CHECK(out_size == 6);
+    CHECK(memcmp(out_value, test, out_size) == 0);
 
     free(out_value);
 }
@@ -279,8 +319,10 @@ void Test_M2MBase::test_mode()
 
 void Test_M2MBase::test_observation_number()
 {
+    CHECK(0 == observation_number());
+
     u_int8_t test = 1;
-    this->_observation_number = test;
+    set_observation_number(test);
 
     CHECK(test == observation_number());
 }
@@ -296,7 +338,8 @@ void Test_M2MBase::test_operation()
 void Test_M2MBase::test_name()
 {
     String test = "name";
-    this->_name = test;
+    M2MStringPool::release(_name);
+    _name = M2MStringPool::acquire(test);
 
     CHECK(test == name());
 }
@@ -320,7 +363,7 @@ void Test_M2MBase::test_instance_id()
 void Test_M2MBase::test_interface_description()
 {
     String test = "interface_description";
-    this->_interface_description = test;
+    set_interface_description(test);
 
     CHECK(test == interface_description());
 }
@@ -328,7 +371,7 @@ void Test_M2MBase::test_interface_description()
 void Test_M2MBase::test_resource_type()
 {
     String test = "resource_type";
-    this->_resource_type = test;
+    set_resource_type(test);
 
     CHECK(test == resource_type());
 }
@@ -369,7 +412,10 @@ void Test_M2MBase::test_set_observation_number()
     u_int16_t test = 1;
     set_observation_number(test);
 
-    CHECK(test == this->_observation_number);
+    CHECK(test == this->_observation->observation_number);
+
+    set_observation_number(0);
+    CHECK(this->_observation == NULL);
 }
 
 //void Test_M2MBase::test_get_value()
@@ -398,13 +444,16 @@ void Test_M2MBase::test_handle_observation_attribute()
     bool ret = handle_observation_attribute(s);
     CHECK(ret == false);
 
-    Observer obs;
-    this->_report_handler = new M2MReportHandler(obs);
+    // Attributes written before observation create the report handler.
+    Handler handler;
+    set_under_observation(false, &handler);
+    CHECK(report_handler() == NULL);
 
     m2mreporthandler_stub::bool_return = true;
     ret = handle_observation_attribute(s);
 
     CHECK(ret == true);
+    CHECK(report_handler() != NULL);
 }
 
 void Test_M2MBase::test_observation_to_be_sent()
@@ -498,3 +547,32 @@ void Test_M2MBase::test_id_number()
     printf("name ID %d", b.name_id());
     CHECK(b.name_id() == 10);
 }
+
+void Test_M2MBase::test_memory_stats()
+{
+    M2MBase *base = new M2MBase("name", M2MBase::Dynamic);
+
+    // Names are interned, they are not held by the node.
+    CHECK(base->memory_stats().node_bytes == sizeof(M2MBase));
+    CHECK(base->memory_stats().string_bytes == 0);
+    CHECK(!base->memory_attached());
+
+    String token = "token";
+    base->set_observation_token((const u_int8_t*)token.c_str(), (u_int8_t)token.size());
+    CHECK(base->memory_stats().token_bytes == 6);
+    CHECK(base->memory_stats().node_bytes == sizeof(M2MBase) + sizeof(M2MBase::ObservationData));
+
+    base->set_observation_token(NULL, 0);
+    CHECK(base->memory_stats().token_bytes == 0);
+    CHECK(base->memory_stats().node_bytes == sizeof(M2MBase));
+
+    base->set_resource_type("type");
+    CHECK(base->memory_stats().string_bytes == 0);
+
+    base->set_memory_attached(true);
+    CHECK(base->memory_attached());
+    base->set_memory_attached(false);
+    CHECK(!base->memory_attached());
+
+    delete base;
+}
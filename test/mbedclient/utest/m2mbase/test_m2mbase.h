@@ -102,6 +102,8 @@ public:
     void test_observation_handler();
 
     void test_id_number();
+
+    void test_memory_stats();
 };
 
 
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2mcoaptcpframer.h"
+
+TEST_GROUP(M2MCoapTcpFramer)
+{
+  Test_M2MCoapTcpFramer* m2m_coap_tcp_framer;
+
+  void setup()
+  {
+    m2m_coap_tcp_framer = new Test_M2MCoapTcpFramer();
+  }
+  void teardown()
+  {
+    delete m2m_coap_tcp_framer;
+  }
+};
+
+TEST(M2MCoapTcpFramer, create)
+{
+    CHECK(m2m_coap_tcp_framer->framer != NULL);
+}
+
+TEST(M2MCoapTcpFramer, encode)
+{
+    m2m_coap_tcp_framer->test_encode();
+}
+
+TEST(M2MCoapTcpFramer, encode_extended_length)
+{
+    m2m_coap_tcp_framer->test_encode_extended_length();
+}
+
+TEST(M2MCoapTcpFramer, encode_drops_udp_messages)
+{
+    m2m_coap_tcp_framer->test_encode_drops_udp_messages();
+}
+
+TEST(M2MCoapTcpFramer, reassembly)
+{
+    m2m_coap_tcp_framer->test_reassembly();
+}
+
+TEST(M2MCoapTcpFramer, response_matching)
+{
+    m2m_coap_tcp_framer->test_response_matching();
+}
+
+TEST(M2MCoapTcpFramer, local_ack)
+{
+    m2m_coap_tcp_framer->test_local_ack();
+}
+
+TEST(M2MCoapTcpFramer, signals)
+{
+    m2m_coap_tcp_framer->test_signals();
+}
+
+TEST(M2MCoapTcpFramer, ping)
+{
+    m2m_coap_tcp_framer->test_ping();
+}
+
+TEST(M2MCoapTcpFramer, invalid_frames)
+{
+    m2m_coap_tcp_framer->test_invalid_frames();
+}
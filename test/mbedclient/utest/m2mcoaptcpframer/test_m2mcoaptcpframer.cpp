@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2mcoaptcpframer.h"
+#include <string.h>
+
+// CSM with Max-Message-Size 1152, sent before the first frame.
+static const uint8_t CSM[] = { 0x30, 0xE1, 0x22, 0x04, 0x80 };
+
+// Confirmable GET /3/0 with token 0xAB 0xCD and message ID 0x1234.
+static const uint8_t REQUEST[] = { 0x42, 0x01, 0x12, 0x34, 0xAB, 0xCD,
+                                   0xB1, '3', 0x01, '0' };
+
+// Request above as a TCP frame.
+static const uint8_t REQUEST_FRAME[] = { 0x42, 0x01, 0xAB, 0xCD,
+                                         0xB1, '3', 0x01, '0' };
+
+// 2.05 Content with the same token and payload "ab".
+static const uint8_t RESPONSE_FRAME[] = { 0x32, 0x45, 0xAB, 0xCD,
+                                          0xFF, 'a', 'b' };
+
+static const uint8_t* encode(M2MCoapTcpFramer *framer,
+                             const uint8_t *message,
+                             uint16_t length,
+                             uint16_t &frame_length)
+{
+    const uint8_t *frame = framer->encode(message, length, frame_length);
+    // Skip the CSM leading the first frame.
+    if(frame && frame_length > sizeof(CSM) && 0 == memcmp(frame, CSM, sizeof(CSM))) {
+        frame += sizeof(CSM);
+        frame_length -= sizeof(CSM);
+    }
+    return frame;
+}
+
+Test_M2MCoapTcpFramer::Test_M2MCoapTcpFramer()
+{
+    framer = new M2MCoapTcpFramer(1152);
+}
+
+Test_M2MCoapTcpFramer::~Test_M2MCoapTcpFramer()
+{
+    delete framer;
+}
+
+void Test_M2MCoapTcpFramer::test_encode()
+{
+    uint16_t length = 0;
+    const uint8_t *frame = framer->encode(REQUEST, sizeof(REQUEST), length);
+    CHECK(frame != NULL);
+    CHECK(length == sizeof(CSM) + sizeof(REQUEST_FRAME));
+    CHECK(0 == memcmp(frame, CSM, sizeof(CSM)));
+    CHECK(0 == memcmp(frame + sizeof(CSM), REQUEST_FRAME, sizeof(REQUEST_FRAME)));
+
+    // CSM is sent only once per connection.
+    uint8_t second[sizeof(REQUEST)];
+    memcpy(second, REQUEST, sizeof(REQUEST));
+    second[3] = 0x35;
+    frame = framer->encode(second, sizeof(second), length);
+    CHECK(length == sizeof(REQUEST_FRAME));
+    CHECK(0 == memcmp(frame, REQUEST_FRAME, sizeof(REQUEST_FRAME)));
+
+    framer->reset();
+    frame = framer->encode(REQUEST, sizeof(REQUEST), length);
+    CHECK(length == sizeof(CSM) + sizeof(REQUEST_FRAME));
+}
+
+void Test_M2MCoapTcpFramer::test_encode_extended_length()
+{
+    uint8_t message[4 + 300];
+    memset(message, 0x11, sizeof(message));
+    message[0] = 0x50;      // NON, no token
+    message[1] = 0x45;
+    message[2] = 0;
+    message[3] = 1;
+    uint16_t length = 0;
+
+    // 13 - 268 byte body, one extended length byte.
+    const uint8_t *frame = encode(framer, message, 4 + 20, length);
+    CHECK(length == 3 + 20);
+    CHECK(frame[0] == 0xD0);
+    CHECK(frame[1] == 20 - 13);
+    CHECK(frame[2] == 0x45);
+
+    // 269 bytes and more, two extended length bytes.
+    frame = encode(framer, message, 4 + 300, length);
+    CHECK(length == 4 + 300);
+    CHECK(frame[0] == 0xE0);
+    CHECK(frame[1] == 0);
+    CHECK(frame[2] == 300 - 269);
+    CHECK(frame[3] == 0x45);
+
+    // Extended length frames are reassembled back.
+    CHECK(framer->feed(frame, length) == length);
+    uint16_t message_length = 0;
+    const uint8_t *decoded = framer->next_message(message_length);
+    CHECK(decoded != NULL);
+    CHECK(message_length == 4 + 300);
+    CHECK(0 == memcmp(decoded + 4, message + 4, 300));
+
+    // Larger than the maximum message size.
+    M2MCoapTcpFramer *small = new M2MCoapTcpFramer(32);
+    CHECK(small->encode(message, 40, length) == NULL);
+    delete small;
+}
+
+void Test_M2MCoapTcpFramer::test_encode_drops_udp_messages()
+{
+    uint16_t length = 0;
+
+    // Empty ACK and RST.
+    const uint8_t ack[] = { 0x60, 0x00, 0x12, 0x34 };
+    CHECK(framer->encode(ack, sizeof(ack), length) == NULL);
+    const uint8_t reset[] = { 0x70, 0x00, 0x12, 0x34 };
+    CHECK(framer->encode(reset, sizeof(reset), length) == NULL);
+    CHECK(length == 0);
+
+    // Retransmission of a confirmable message.
+    CHECK(framer->encode(REQUEST, sizeof(REQUEST), length) != NULL);
+    CHECK(framer->encode(REQUEST, sizeof(REQUEST), length) == NULL);
+
+    // Piggybacked response is sent.
+    const uint8_t piggybacked[] = { 0x61, 0x44, 0x00, 0x07, 0x01 };
+    CHECK(encode(framer, piggybacked, sizeof(piggybacked), length) != NULL);
+    CHECK(length == 3);
+
+    // Invalid messages.
+    const uint8_t version[] = { 0x82, 0x01, 0x00, 0x01 };
+    CHECK(framer->encode(version, sizeof(version), length) == NULL);
+    const uint8_t token[] = { 0x49, 0x01, 0x00, 0x01 };
+    CHECK(framer->encode(token, sizeof(token), length) == NULL);
+    CHECK(framer->encode(token, 3, length) == NULL);
+    CHECK(framer->encode(NULL, 4, length) == NULL);
+}
+
+void Test_M2MCoapTcpFramer::test_reassembly()
+{
+    uint8_t stream[2 * sizeof(RESPONSE_FRAME) + sizeof(CSM)];
+    memcpy(stream, CSM, sizeof(CSM));
+    memcpy(stream + sizeof(CSM), RESPONSE_FRAME, sizeof(RESPONSE_FRAME));
+    memcpy(stream + sizeof(CSM) + sizeof(RESPONSE_FRAME), RESPONSE_FRAME,
+           sizeof(RESPONSE_FRAME));
+    uint16_t length = 0;
+
+    // Stream arrives a byte at a time.
+    uint8_t messages = 0;
+    for(uint16_t i = 0; i < sizeof(stream); i++) {
+        CHECK(framer->feed(stream + i, 1) == 1);
+        const uint8_t *message;
+        while((message = framer->next_message(length)) != NULL) {
+            CHECK(length == 4 + 2 + 3);
+            CHECK(message[0] == 0x42);      // CON, unknown token
+            CHECK(message[1] == 0x45);
+            CHECK(message[4] == 0xAB);
+            CHECK(message[6] == 0xFF);
+            messages++;
+        }
+    }
+    CHECK(messages == 2);
+    CHECK(framer->peer_max_message_size() == 1152);
+    CHECK(framer->failed() == false);
+
+    // Full buffer takes only what fits.
+    M2MCoapTcpFramer *small = new M2MCoapTcpFramer(8);
+    uint8_t data[20];
+    memset(data, 0, sizeof(data));
+    CHECK(small->feed(data, sizeof(data)) == 8 + 6);
+    // Empty messages are skipped.
+    CHECK(small->next_message(length) == NULL);
+    CHECK(small->feed(data, sizeof(data)) == 8 + 6);
+    delete small;
+}
+
+void Test_M2MCoapTcpFramer::test_response_matching()
+{
+    uint16_t length = 0;
+    CHECK(framer->encode(REQUEST, sizeof(REQUEST), length) != NULL);
+
+    // Response becomes a piggybacked ACK with the request's message ID.
+    CHECK(framer->feed(RESPONSE_FRAME, sizeof(RESPONSE_FRAME)) == sizeof(RESPONSE_FRAME));
+    const uint8_t *message = framer->next_message(length);
+    CHECK(message != NULL);
+    CHECK(length == 4 + 2 + 3);
+    CHECK(message[0] == 0x62);
+    CHECK(message[1] == 0x45);
+    CHECK(message[2] == 0x12);
+    CHECK(message[3] == 0x34);
+    CHECK(message[4] == 0xAB && message[5] == 0xCD);
+    CHECK(message[6] == 0xFF && message[7] == 'a' && message[8] == 'b');
+
+    // Further responses with the token, e.g. notifications, are confirmable.
+    framer->feed(RESPONSE_FRAME, sizeof(RESPONSE_FRAME));
+    message = framer->next_message(length);
+    CHECK(message[0] == 0x42);
+    uint16_t msg_id = (message[2] << 8) | message[3];
+
+    // Requests from the peer are confirmable with a new message ID.
+    framer->feed(REQUEST_FRAME, sizeof(REQUEST_FRAME));
+    message = framer->next_message(length);
+    CHECK(length == sizeof(REQUEST));
+    CHECK(message[0] == 0x42);
+    CHECK(message[1] == 0x01);
+    CHECK(((message[2] << 8) | message[3]) != msg_id);
+    CHECK(0 == memcmp(message + 4, REQUEST + 4, sizeof(REQUEST) - 4));
+}
+
+void Test_M2MCoapTcpFramer::test_local_ack()
+{
+    // Confirmable notification.
+    const uint8_t notification[] = { 0x42, 0x45, 0x00, 0x09, 0xAB, 0xCD, 0x61, 0x01 };
+    uint16_t length = 0;
+    CHECK(framer->encode(notification, sizeof(notification), length) != NULL);
+
+    const uint8_t *message = framer->next_message(length);
+    CHECK(message != NULL);
+    CHECK(length == 4);
+    CHECK(message[0] == 0x60);
+    CHECK(message[1] == 0x00);
+    CHECK(message[2] == 0x00);
+    CHECK(message[3] == 0x09);
+    CHECK(framer->next_message(length) == NULL);
+
+    // Non-confirmable notification needs no acknowledgement.
+    const uint8_t non[] = { 0x52, 0x45, 0x00, 0x0A, 0xAB, 0xCD };
+    CHECK(framer->encode(non, sizeof(non), length) != NULL);
+    CHECK(framer->next_message(length) == NULL);
+}
+
+void Test_M2MCoapTcpFramer::test_signals()
+{
+    uint16_t length = 0;
+    CHECK(framer->next_signal(length) == NULL);
+    CHECK(length == 0);
+
+    // CSM with Max-Message-Size 512 and an unknown option after it.
+    const uint8_t csm[] = { 0x50, 0xE1, 0x22, 0x02, 0x00, 0x21, 0x01 };
+    framer->feed(csm, sizeof(csm));
+    CHECK(framer->next_message(length) == NULL);
+    CHECK(framer->peer_max_message_size() == 512);
+
+    // Ping is answered with a Pong carrying its token.
+    const uint8_t ping[] = { 0x01, 0xE2, 0x77 };
+    framer->feed(ping, sizeof(ping));
+    CHECK(framer->next_message(length) == NULL);
+    const uint8_t *signal = framer->next_signal(length);
+    CHECK(signal != NULL);
+    CHECK(length == 3);
+    CHECK(signal[0] == 0x01);
+    CHECK(signal[1] == 0xE3);
+    CHECK(signal[2] == 0x77);
+    CHECK(framer->next_signal(length) == NULL);
+
+    // Pong and unknown signals are ignored.
+    const uint8_t pong[] = { 0x00, 0xE3, 0x00, 0xE6 };
+    framer->feed(pong, sizeof(pong));
+    CHECK(framer->next_message(length) == NULL);
+    CHECK(framer->failed() == false);
+
+    // Release closes the stream.
+    const uint8_t release[] = { 0x00, 0xE4 };
+    framer->feed(release, sizeof(release));
+    CHECK(framer->next_message(length) == NULL);
+    CHECK(framer->failed() == true);
+
+    framer->reset();
+    CHECK(framer->failed() == false);
+    CHECK(framer->peer_max_message_size() == 1152);
+    const uint8_t abort[] = { 0x00, 0xE5 };
+    framer->feed(abort, sizeof(abort));
+    CHECK(framer->next_message(length) == NULL);
+    CHECK(framer->failed() == true);
+}
+
+void Test_M2MCoapTcpFramer::test_ping()
+{
+    uint16_t length = 0;
+
+    // An empty confirmable message goes out as a Ping signal.
+    const uint8_t ping[] = { 0x40, 0x00, 0xF0, 0x01 };
+    const uint8_t *frame = encode(framer, ping, sizeof(ping), length);
+    CHECK(frame != NULL);
+    CHECK(length == 2);
+    CHECK(frame[0] == 0x00);
+    CHECK(frame[1] == 0xE2);
+    CHECK(framer->encode(ping, sizeof(ping), length) == NULL);
+
+    // The Pong comes back as a reset with the ping's message ID.
+    const uint8_t pong[] = { 0x00, 0xE3 };
+    framer->feed(pong, sizeof(pong));
+    const uint8_t *message = framer->next_message(length);
+    CHECK(message != NULL);
+    CHECK(length == 4);
+    CHECK(message[0] == 0x70);
+    CHECK(message[1] == 0x00);
+    CHECK(message[2] == 0xF0);
+    CHECK(message[3] == 0x01);
+
+    // Unsolicited Pong.
+    framer->feed(pong, sizeof(pong));
+    CHECK(framer->next_message(length) == NULL);
+    CHECK(framer->failed() == false);
+}
+
+void Test_M2MCoapTcpFramer::test_invalid_frames()
+{
+    uint16_t length = 0;
+
+    // Token longer than 8 bytes.
+    const uint8_t token[] = { 0x09, 0x01 };
+    framer->feed(token, sizeof(token));
+    CHECK(framer->next_message(length) == NULL);
+    CHECK(framer->failed() == true);
+
+    // Frame larger than the reassembly buffer.
+    framer->reset();
+    const uint8_t large[] = { 0xF0, 0x00, 0x01, 0x00, 0x00, 0x01 };
+    framer->feed(large, sizeof(large));
+    CHECK(framer->next_message(length) == NULL);
+    CHECK(framer->failed() == true);
+
+    // Extended length which wraps around to 5 when the offset is added.
+    framer->reset();
+    const uint8_t wrapping[] = { 0xF0, 0xFF, 0xFE, 0xFE, 0xF8, 0x45,
+                                 0xFF, 0x31, 0x32, 0x33, 0x34 };
+    framer->feed(wrapping, sizeof(wrapping));
+    CHECK(framer->next_message(length) == NULL);
+    CHECK(framer->failed() == true);
+
+    // Malformed CSM option.
+    framer->reset();
+    const uint8_t csm[] = { 0x20, 0xE1, 0x2F, 0x00 };
+    framer->feed(csm, sizeof(csm));
+    CHECK(framer->next_message(length) == NULL);
+    CHECK(framer->failed() == true);
+
+    // Incomplete extended length waits for more data.
+    framer->reset();
+    const uint8_t partial[] = { 0xE0 };
+    framer->feed(partial, sizeof(partial));
+    CHECK(framer->next_message(length) == NULL);
+    CHECK(framer->failed() == false);
+}
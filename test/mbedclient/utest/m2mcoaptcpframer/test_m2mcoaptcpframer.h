@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TEST_M2M_COAP_TCP_FRAMER_H
+#define TEST_M2M_COAP_TCP_FRAMER_H
+
+#include "m2mcoaptcpframer.h"
+
+class Test_M2MCoapTcpFramer
+{
+public:
+    Test_M2MCoapTcpFramer();
+    virtual ~Test_M2MCoapTcpFramer();
+
+    void test_encode();
+
+    void test_encode_extended_length();
+
+    void test_encode_drops_udp_messages();
+
+    void test_reassembly();
+
+    void test_response_matching();
+
+    void test_local_ack();
+
+    void test_signals();
+
+    void test_ping();
+
+    void test_invalid_frames();
+
+    M2MCoapTcpFramer* framer;
+};
+
+#endif // TEST_M2M_COAP_TCP_FRAMER_H
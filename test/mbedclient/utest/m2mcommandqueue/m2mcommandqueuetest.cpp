@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2mcommandqueue.h"
+
+TEST_GROUP(M2MCommandQueue)
+{
+  Test_M2MCommandQueue* m2m_command_queue;
+
+  void setup()
+  {
+    m2m_command_queue = new Test_M2MCommandQueue();
+  }
+  void teardown()
+  {
+    delete m2m_command_queue;
+  }
+};
+
+TEST(M2MCommandQueue, create)
+{
+    CHECK(m2m_command_queue->queue != NULL);
+}
+
+TEST(M2MCommandQueue, post_value)
+{
+    m2m_command_queue->test_post_value();
+}
+
+TEST(M2MCommandQueue, post_call)
+{
+    m2m_command_queue->test_post_call();
+}
+
+TEST(M2MCommandQueue, process_batch)
+{
+    m2m_command_queue->test_process_batch();
+}
+
+TEST(M2MCommandQueue, cancel)
+{
+    m2m_command_queue->test_cancel();
+}
+
+TEST(M2MCommandQueue, concurrent_producers)
+{
+    m2m_command_queue->test_concurrent_producers();
+}
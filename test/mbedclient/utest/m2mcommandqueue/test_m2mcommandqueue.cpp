@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2mcommandqueue.h"
+#include "m2mresourceinstance.h"
+#include "m2mresourceinstance_stub.h"
+#include <pthread.h>
+
+class Callback : public M2MObjectInstanceCallback {
+public:
+    Callback(){}
+    ~Callback(){}
+    void notification_update(M2MBase::Observation){}
+    void memory_updated(M2MMemoryStats::Category, int32_t){}
+};
+
+static void count_call(void *argument)
+{
+    (*(uint32_t*)argument)++;
+}
+
+#define PRODUCER_COUNT      4
+#define PRODUCER_COMMANDS   10000
+
+typedef struct {
+    M2MCommandQueue     *queue;
+    uint32_t            *counter;
+} Producer;
+
+static void* produce(void *argument)
+{
+    Producer *producer = (Producer*)argument;
+    for(int i = 0; i < PRODUCER_COMMANDS; i++) {
+        while(!producer->queue->post_call(count_call, producer->counter)) {
+        }
+    }
+    return NULL;
+}
+
+Test_M2MCommandQueue::Test_M2MCommandQueue()
+{
+    m2mresourceinstance_stub::clear();
+    queue = new M2MCommandQueue();
+}
+
+Test_M2MCommandQueue::~Test_M2MCommandQueue()
+{
+    delete queue;
+    m2mresourceinstance_stub::clear();
+}
+
+void Test_M2MCommandQueue::test_post_value()
+{
+    Callback callback;
+    M2MResourceInstance *res = new M2MResourceInstance("name",
+                                                       "type",
+                                                       M2MResourceInstance::INTEGER,
+                                                       callback);
+    uint8_t value[] = {"12"};
+
+    CHECK(queue->post_value(NULL, value, sizeof(value)) == false);
+    CHECK(queue->post_value(res, NULL, sizeof(value)) == false);
+    CHECK(queue->process() == 0);
+
+    CHECK(queue->post_value(res, value, sizeof(value)) == true);
+    // Nothing is applied before the client thread processes the queue.
+    CHECK(m2mresourceinstance_stub::set_value_count == 0);
+
+    CHECK(queue->process() == 1);
+    CHECK(m2mresourceinstance_stub::set_value_count == 1);
+    CHECK(m2mresourceinstance_stub::set_value_length == sizeof(value));
+
+    CHECK(queue->process() == 0);
+    delete res;
+}
+
+void Test_M2MCommandQueue::test_post_call()
+{
+    uint32_t counter = 0;
+    CHECK(queue->post_call(NULL, &counter) == false);
+
+    CHECK(queue->post_call(count_call, &counter) == true);
+    CHECK(queue->post_call(count_call, &counter) == true);
+    CHECK(counter == 0);
+
+    CHECK(queue->process() == 2);
+    CHECK(counter == 2);
+}
+
+void Test_M2MCommandQueue::test_process_batch()
+{
+    uint32_t counter = 0;
+    for(int i = 0; i < 5; i++) {
+        queue->post_call(count_call, &counter);
+    }
+    CHECK(queue->process(2) == 2);
+    CHECK(counter == 2);
+    CHECK(queue->process(2) == 2);
+    CHECK(queue->process(2) == 1);
+    CHECK(counter == 5);
+    CHECK(queue->process(2) == 0);
+
+    // Pending commands are freed with the queue.
+    queue->post_call(count_call, &counter);
+    uint8_t value[] = {"1"};
+    Callback callback;
+    M2MResourceInstance *res = new M2MResourceInstance("name",
+                                                       "type",
+                                                       M2MResourceInstance::INTEGER,
+                                                       callback);
+    queue->post_value(res, value, sizeof(value));
+    delete queue;
+    queue = NULL;
+    CHECK(counter == 5);
+    CHECK(m2mresourceinstance_stub::set_value_count == 0);
+    delete res;
+    queue = new M2MCommandQueue();
+}
+
+void Test_M2MCommandQueue::test_cancel()
+{
+    Callback callback;
+    M2MResourceInstance *res = new M2MResourceInstance("name",
+                                                       "type",
+                                                       M2MResourceInstance::INTEGER,
+                                                       callback);
+    uint32_t counter = 0;
+    uint8_t value[] = {"1"};
+    queue->post_value(res, value, sizeof(value));
+    queue->post_call(count_call, &counter, res);
+    queue->post_call(count_call, &counter);
+
+    queue->cancel(res);
+    delete res;
+
+    // Cancelled commands are still consumed but have no effect.
+    CHECK(queue->process() == 3);
+    CHECK(m2mresourceinstance_stub::set_value_count == 0);
+    CHECK(counter == 1);
+}
+
+void Test_M2MCommandQueue::test_concurrent_producers()
+{
+    uint32_t counter = 0;
+    Producer producer;
+    producer.queue = queue;
+    producer.counter = &counter;
+
+    pthread_t threads[PRODUCER_COUNT];
+    for(int i = 0; i < PRODUCER_COUNT; i++) {
+        pthread_create(&threads[i], NULL, produce, &producer);
+    }
+    // Consume while the producers are still posting.
+    uint32_t processed = 0;
+    while(processed < PRODUCER_COUNT * PRODUCER_COMMANDS) {
+        processed += queue->process(64);
+    }
+    for(int i = 0; i < PRODUCER_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    CHECK(queue->process() == 0);
+    CHECK(counter == PRODUCER_COUNT * PRODUCER_COMMANDS);
+}
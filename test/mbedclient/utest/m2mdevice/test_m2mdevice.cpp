@@ -31,6 +31,9 @@ public:
         visited = true;
     }
 
+    void memory_updated(M2MMemoryStats::Category, int32_t) {
+    }
+
     void clear() {visited = false;}
     bool visited;
 };
@@ -64,6 +67,9 @@ Test_M2MDevice::~Test_M2MDevice()
     M2MDevice::delete_instance();
     device = NULL;
     delete callback;
+
+    // Tests free the buffer they hand out from the stub.
+    m2mbase_stub::void_value = NULL;
 }
 
 void Test_M2MDevice::test_create_resource_instance()
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2mdnscache.h"
+
+TEST_GROUP(M2MDnsCache)
+{
+  Test_M2MDnsCache* m2m_dns_cache;
+
+  void setup()
+  {
+    m2m_dns_cache = new Test_M2MDnsCache();
+  }
+  void teardown()
+  {
+    delete m2m_dns_cache;
+  }
+};
+
+TEST(M2MDnsCache, create)
+{
+    CHECK(m2m_dns_cache->cache != NULL);
+    CHECK(m2m_dns_cache->cache->count() == 0);
+}
+
+TEST(M2MDnsCache, store_and_lookup)
+{
+    m2m_dns_cache->test_store_and_lookup();
+}
+
+TEST(M2MDnsCache, expiry)
+{
+    m2m_dns_cache->test_expiry();
+}
+
+TEST(M2MDnsCache, connection_order)
+{
+    m2m_dns_cache->test_connection_order();
+}
+
+TEST(M2MDnsCache, eviction)
+{
+    m2m_dns_cache->test_eviction();
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2mdnscache.h"
+#include <string.h>
+
+#define CACHE_SIZE      2
+#define MAX_TTL         3600
+
+static M2MDnsCache::Address ipv4(uint8_t last)
+{
+    M2MDnsCache::Address address;
+    memset(&address, 0, sizeof(address));
+    address.address[0] = 192;
+    address.address[1] = 0;
+    address.address[2] = 2;
+    address.address[3] = last;
+    address.length = 4;
+    return address;
+}
+
+static M2MDnsCache::Address ipv6(uint8_t last)
+{
+    M2MDnsCache::Address address;
+    memset(&address, 0, sizeof(address));
+    address.address[0] = 0x20;
+    address.address[1] = 0x01;
+    address.address[2] = 0x0d;
+    address.address[3] = 0xb8;
+    address.address[15] = last;
+    address.length = 16;
+    return address;
+}
+
+static bool same(const M2MDnsCache::Address &a, const M2MDnsCache::Address &b)
+{
+    return a.length == b.length && memcmp(a.address, b.address, a.length) == 0;
+}
+
+Test_M2MDnsCache::Test_M2MDnsCache()
+{
+    cache = new M2MDnsCache(CACHE_SIZE, MAX_TTL);
+}
+
+Test_M2MDnsCache::~Test_M2MDnsCache()
+{
+    delete cache;
+}
+
+void Test_M2MDnsCache::test_store_and_lookup()
+{
+    M2MDnsCache::Address result[M2MDnsCache::MAX_ADDRESSES];
+    CHECK(cache->lookup("server", 0, result, M2MDnsCache::MAX_ADDRESSES) == 0);
+    CHECK(cache->stats().misses == 1);
+
+    M2MDnsCache::Address addresses[2] = { ipv4(1), ipv4(2) };
+    CHECK(!cache->store(NULL, addresses, 2, 60, 0));
+    CHECK(!cache->store("", addresses, 2, 60, 0));
+    CHECK(!cache->store("server", addresses, 2, 0, 0));
+    addresses[0].length = 5;
+    addresses[1].length = 0;
+    CHECK(!cache->store("server", addresses, 2, 60, 0));
+
+    addresses[0] = ipv4(1);
+    addresses[1] = ipv4(2);
+    CHECK(cache->store("server", addresses, 2, 60, 0));
+    CHECK(cache->count() == 1);
+    CHECK(cache->lookup("server", 10, result, M2MDnsCache::MAX_ADDRESSES) == 2);
+    CHECK(same(result[0], ipv4(1)));
+    CHECK(same(result[1], ipv4(2)));
+    CHECK(cache->stats().hits == 1);
+
+    // Result is limited to the array given.
+    CHECK(cache->lookup("server", 10, result, 1) == 1);
+    CHECK(cache->lookup("other", 10, result, M2MDnsCache::MAX_ADDRESSES) == 0);
+
+    // Storing again replaces the addresses.
+    addresses[0] = ipv6(1);
+    CHECK(cache->store("server", addresses, 1, 60, 20));
+    CHECK(cache->count() == 1);
+    CHECK(cache->lookup("server", 30, result, M2MDnsCache::MAX_ADDRESSES) == 1);
+    CHECK(same(result[0], ipv6(1)));
+
+    cache->remove("server");
+    CHECK(cache->count() == 0);
+    CHECK(cache->lookup("server", 30, result, M2MDnsCache::MAX_ADDRESSES) == 0);
+}
+
+void Test_M2MDnsCache::test_expiry()
+{
+    M2MDnsCache::Address result[M2MDnsCache::MAX_ADDRESSES];
+    M2MDnsCache::Address address = ipv4(1);
+    CHECK(cache->store("server", &address, 1, 60, 100));
+    CHECK(cache->lookup("server", 159, result, M2MDnsCache::MAX_ADDRESSES) == 1);
+    CHECK(cache->lookup("server", 160, result, M2MDnsCache::MAX_ADDRESSES) == 0);
+    CHECK(cache->count() == 0);
+    CHECK(cache->stats().expired == 1);
+
+    // TTL is capped.
+    CHECK(cache->store("server", &address, 1, 0xFFFFFFFF, 0));
+    CHECK(cache->lookup("server", MAX_TTL - 1, result, M2MDnsCache::MAX_ADDRESSES) == 1);
+    CHECK(cache->lookup("server", MAX_TTL, result, M2MDnsCache::MAX_ADDRESSES) == 0);
+}
+
+void Test_M2MDnsCache::test_connection_order()
+{
+    M2MDnsCache::Address result[M2MDnsCache::MAX_ADDRESSES];
+    M2MDnsCache::Address addresses[5] = { ipv4(1), ipv4(2), ipv6(1), ipv6(2), ipv6(3) };
+    CHECK(cache->store("server", addresses, 5, 60, 0));
+
+    // IPv6 first, families interleaved, extra addresses dropped.
+    CHECK(cache->lookup("server", 0, result, M2MDnsCache::MAX_ADDRESSES) == 4);
+    CHECK(same(result[0], ipv6(1)));
+    CHECK(same(result[1], ipv4(1)));
+    CHECK(same(result[2], ipv6(2)));
+    CHECK(same(result[3], ipv4(2)));
+
+    // The address that connected goes first, its family leads.
+    cache->connected("server", ipv4(2));
+    CHECK(cache->lookup("server", 0, result, M2MDnsCache::MAX_ADDRESSES) == 4);
+    CHECK(same(result[0], ipv4(2)));
+    CHECK(same(result[1], ipv6(1)));
+    CHECK(same(result[2], ipv4(1)));
+    CHECK(same(result[3], ipv6(2)));
+
+    // Unknown addresses and hosts are ignored.
+    cache->connected("server", ipv6(9));
+    cache->connected("other", ipv6(1));
+    CHECK(cache->lookup("server", 0, result, M2MDnsCache::MAX_ADDRESSES) == 4);
+    CHECK(same(result[0], ipv4(2)));
+
+    // Refreshed addresses keep the winner if it is still there.
+    CHECK(cache->store("server", addresses, 4, 60, 10));
+    CHECK(cache->lookup("server", 10, result, M2MDnsCache::MAX_ADDRESSES) == 4);
+    CHECK(same(result[0], ipv4(2)));
+    CHECK(cache->store("server", &addresses[2], 2, 60, 10));
+    CHECK(cache->lookup("server", 10, result, M2MDnsCache::MAX_ADDRESSES) == 2);
+    CHECK(same(result[0], ipv6(1)));
+    CHECK(same(result[1], ipv6(2)));
+}
+
+void Test_M2MDnsCache::test_eviction()
+{
+    M2MDnsCache::Address result[M2MDnsCache::MAX_ADDRESSES];
+    M2MDnsCache::Address address = ipv4(1);
+    CHECK(cache->store("first", &address, 1, 60, 0));
+    CHECK(cache->store("second", &address, 1, 60, 0));
+    CHECK(cache->lookup("first", 1, result, M2MDnsCache::MAX_ADDRESSES) == 1);
+
+    // Least recently used host goes.
+    CHECK(cache->store("third", &address, 1, 60, 2));
+    CHECK(cache->count() == CACHE_SIZE);
+    CHECK(cache->lookup("second", 3, result, M2MDnsCache::MAX_ADDRESSES) == 0);
+    CHECK(cache->lookup("first", 3, result, M2MDnsCache::MAX_ADDRESSES) == 1);
+    CHECK(cache->lookup("third", 3, result, M2MDnsCache::MAX_ADDRESSES) == 1);
+
+    cache->clear();
+    CHECK(cache->count() == 0);
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2mdtlssessioncache.h"
+
+TEST_GROUP(M2MDtlsSessionCache)
+{
+  Test_M2MDtlsSessionCache* m2m_dtls_session_cache;
+
+  void setup()
+  {
+    m2m_dtls_session_cache = new Test_M2MDtlsSessionCache();
+  }
+  void teardown()
+  {
+    delete m2m_dtls_session_cache;
+  }
+};
+
+TEST(M2MDtlsSessionCache, create)
+{
+    CHECK(m2m_dtls_session_cache->cache != NULL);
+}
+
+TEST(M2MDtlsSessionCache, store_session)
+{
+    m2m_dtls_session_cache->test_store_session();
+}
+
+TEST(M2MDtlsSessionCache, expiry)
+{
+    m2m_dtls_session_cache->test_expiry();
+}
+
+TEST(M2MDtlsSessionCache, eviction)
+{
+    m2m_dtls_session_cache->test_eviction();
+}
+
+TEST(M2MDtlsSessionCache, connection_id)
+{
+    m2m_dtls_session_cache->test_connection_id();
+}
+
+TEST(M2MDtlsSessionCache, rejected_session)
+{
+    m2m_dtls_session_cache->test_rejected_session();
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2mdtlssessioncache.h"
+#include <string.h>
+
+#define LIFETIME    100
+
+static const uint8_t server_a[] = "coaps://a.example:5684";
+static const uint8_t server_b[] = "coaps://b.example:5684";
+static const uint8_t server_c[] = "coaps://c.example:5684";
+static const uint8_t session_1[] = { 0x01, 0x02, 0x03, 0x04 };
+static const uint8_t session_2[] = { 0x05, 0x06 };
+
+Test_M2MDtlsSessionCache::Test_M2MDtlsSessionCache()
+{
+    cache = new M2MDtlsSessionCache(2, LIFETIME);
+}
+
+Test_M2MDtlsSessionCache::~Test_M2MDtlsSessionCache()
+{
+    delete cache;
+}
+
+void Test_M2MDtlsSessionCache::test_store_session()
+{
+    uint16_t length = 0;
+    CHECK(cache->session(server_a, sizeof(server_a), 0, length) == NULL);
+    CHECK(!cache->store_session(server_a, sizeof(server_a), NULL, 0, 0));
+
+    CHECK(cache->store_session(server_a, sizeof(server_a), session_1, sizeof(session_1), 10));
+    const uint8_t *session = cache->session(server_a, sizeof(server_a), 20, length);
+    CHECK(session != NULL);
+    CHECK(length == sizeof(session_1));
+    CHECK(memcmp(session, session_1, length) == 0);
+    CHECK(cache->session(server_b, sizeof(server_b), 20, length) == NULL);
+    CHECK(length == 0);
+
+    // A new handshake with the same peer replaces the session.
+    CHECK(cache->store_session(server_a, sizeof(server_a), session_2, sizeof(session_2), 30));
+    session = cache->session(server_a, sizeof(server_a), 30, length);
+    CHECK(length == sizeof(session_2));
+    CHECK(memcmp(session, session_2, length) == 0);
+    CHECK(cache->count() == 1);
+
+    cache->handshake_completed(false);
+    cache->handshake_completed(true);
+    cache->handshake_completed(true);
+    CHECK(cache->stats().full_handshakes == 1);
+    CHECK(cache->stats().resumed_handshakes == 2);
+
+    cache->clear();
+    CHECK(cache->count() == 0);
+    CHECK(cache->session(server_a, sizeof(server_a), 30, length) == NULL);
+}
+
+void Test_M2MDtlsSessionCache::test_expiry()
+{
+    uint16_t length = 0;
+    CHECK(cache->store_session(server_a, sizeof(server_a), session_1, sizeof(session_1), 1000));
+    CHECK(cache->session(server_a, sizeof(server_a), 1000 + LIFETIME - 1, length) != NULL);
+    CHECK(cache->session(server_a, sizeof(server_a), 1000 + LIFETIME, length) == NULL);
+    CHECK(cache->count() == 0);
+    CHECK(cache->stats().expired_sessions == 1);
+
+    // The clock wrapping around doesn't extend the lifetime.
+    CHECK(cache->store_session(server_a, sizeof(server_a), session_1, sizeof(session_1), 0xFFFFFFF0));
+    CHECK(cache->session(server_a, sizeof(server_a), 0x10, length) != NULL);
+    CHECK(cache->session(server_a, sizeof(server_a), LIFETIME, length) == NULL);
+}
+
+void Test_M2MDtlsSessionCache::test_eviction()
+{
+    uint16_t length = 0;
+    CHECK(cache->store_session(server_a, sizeof(server_a), session_1, sizeof(session_1), 0));
+    CHECK(cache->store_session(server_b, sizeof(server_b), session_1, sizeof(session_1), 0));
+    // Using the first one makes the second the least recently used.
+    CHECK(cache->session(server_a, sizeof(server_a), 1, length) != NULL);
+    CHECK(cache->store_session(server_c, sizeof(server_c), session_2, sizeof(session_2), 2));
+    CHECK(cache->count() == 2);
+    CHECK(cache->session(server_a, sizeof(server_a), 3, length) != NULL);
+    CHECK(cache->session(server_b, sizeof(server_b), 3, length) == NULL);
+    CHECK(cache->session(server_c, sizeof(server_c), 3, length) != NULL);
+}
+
+void Test_M2MDtlsSessionCache::test_connection_id()
+{
+    uint8_t cid[M2MDtlsSessionCache::MAX_CID_LENGTH + 1];
+    memset(cid, 0xA5, sizeof(cid));
+    uint8_t length = 0;
+    CHECK(!cache->set_connection_id(server_a, sizeof(server_a), cid, 4));
+    CHECK(cache->connection_id(server_a, sizeof(server_a), length) == NULL);
+
+    CHECK(cache->store_session(server_a, sizeof(server_a), session_1, sizeof(session_1), 0));
+    CHECK(!cache->set_connection_id(server_a, sizeof(server_a), cid, sizeof(cid)));
+    CHECK(cache->set_connection_id(server_a, sizeof(server_a), cid, 4));
+    const uint8_t *stored = cache->connection_id(server_a, sizeof(server_a), length);
+    CHECK(stored != NULL);
+    CHECK(length == 4);
+    CHECK(memcmp(stored, cid, length) == 0);
+
+    // Resuming keeps the Connection ID, a new session keeps it too until
+    // the security implementation clears it.
+    CHECK(cache->store_session(server_a, sizeof(server_a), session_2, sizeof(session_2), 1));
+    CHECK(cache->connection_id(server_a, sizeof(server_a), length) != NULL);
+    CHECK(cache->set_connection_id(server_a, sizeof(server_a), NULL, 0));
+    CHECK(cache->connection_id(server_a, sizeof(server_a), length) == NULL);
+    CHECK(length == 0);
+}
+
+void Test_M2MDtlsSessionCache::test_rejected_session()
+{
+    uint16_t length = 0;
+    CHECK(cache->store_session(server_a, sizeof(server_a), session_1, sizeof(session_1), 0));
+    cache->session_rejected(server_a, sizeof(server_a));
+    CHECK(cache->session(server_a, sizeof(server_a), 1, length) == NULL);
+    CHECK(cache->stats().rejected_sessions == 1);
+
+    // Removing an unknown peer is harmless.
+    cache->remove_session(server_b, sizeof(server_b));
+    CHECK(cache->count() == 0);
+}
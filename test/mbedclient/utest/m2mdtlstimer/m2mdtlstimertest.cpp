@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2mdtlstimer.h"
+
+TEST_GROUP(M2MDtlsTimer)
+{
+  Test_M2MDtlsTimer* m2m_dtls_timer;
+
+  void setup()
+  {
+    m2m_dtls_timer = new Test_M2MDtlsTimer();
+  }
+  void teardown()
+  {
+    delete m2m_dtls_timer;
+  }
+};
+
+TEST(M2MDtlsTimer, create)
+{
+    CHECK(m2m_dtls_timer->timer != NULL);
+    CHECK(m2m_dtls_timer->timer->is_valid());
+}
+
+TEST(M2MDtlsTimer, delays)
+{
+    m2m_dtls_timer->test_delays();
+}
+
+TEST(M2MDtlsTimer, cancel)
+{
+    m2m_dtls_timer->test_cancel();
+}
+
+TEST(M2MDtlsTimer, restart)
+{
+    m2m_dtls_timer->test_restart();
+}
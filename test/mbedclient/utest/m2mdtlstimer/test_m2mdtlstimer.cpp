@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2mdtlstimer.h"
+#include <unistd.h>
+
+class TimerObserver : public M2MTimerObserver {
+public:
+    TimerObserver() : expired(0), type(Notdefined) {}
+    ~TimerObserver() {}
+
+    void timer_expired(M2MTimerObserver::Type timer_type)
+    {
+        __atomic_store_n(&type, timer_type, __ATOMIC_SEQ_CST);
+        __atomic_fetch_add(&expired, 1, __ATOMIC_SEQ_CST);
+    }
+
+    uint32_t count()
+    {
+        return __atomic_load_n(&expired, __ATOMIC_SEQ_CST);
+    }
+
+    volatile uint32_t           expired;
+    M2MTimerObserver::Type      type;
+};
+
+static bool wait_for(TimerObserver *observer, uint32_t value)
+{
+    for(int i = 0; i < 1000; i++) {
+        if(observer->count() >= value) {
+            return true;
+        }
+        usleep(1000);
+    }
+    return false;
+}
+
+Test_M2MDtlsTimer::Test_M2MDtlsTimer()
+{
+    reactor = new M2MReactor(1);
+    reactor->start();
+    observer = new TimerObserver();
+    timer = new M2MDtlsTimer(*reactor, *observer);
+}
+
+Test_M2MDtlsTimer::~Test_M2MDtlsTimer()
+{
+    delete timer;
+    delete reactor;
+    delete observer;
+}
+
+void Test_M2MDtlsTimer::test_delays()
+{
+    CHECK(M2MDtlsTimer::get_delay(timer) == -1);
+    M2MDtlsTimer::set_delay(timer, 20, 60);
+    CHECK(M2MDtlsTimer::get_delay(timer) == 0);
+    usleep(30000);
+    CHECK(M2MDtlsTimer::get_delay(timer) == 1);
+    CHECK(wait_for(observer, 1));
+    CHECK(M2MDtlsTimer::get_delay(timer) == 2);
+    CHECK(__atomic_load_n(&observer->type, __ATOMIC_SEQ_CST) == M2MTimerObserver::Dtls);
+    usleep(20000);
+    CHECK(observer->count() == 1);
+}
+
+void Test_M2MDtlsTimer::test_cancel()
+{
+    M2MDtlsTimer::set_delay(timer, 10, 30);
+    M2MDtlsTimer::set_delay(timer, 0, 0);
+    CHECK(M2MDtlsTimer::get_delay(timer) == -1);
+    usleep(60000);
+    CHECK(observer->count() == 0);
+    CHECK(M2MDtlsTimer::get_delay(timer) == -1);
+}
+
+void Test_M2MDtlsTimer::test_restart()
+{
+    // A retransmission restarts the timer before it expires.
+    M2MDtlsTimer::set_delay(timer, 10, 40);
+    usleep(20000);
+    M2MDtlsTimer::set_delay(timer, 50, 200);
+    CHECK(M2MDtlsTimer::get_delay(timer) == 0);
+    usleep(60000);
+    CHECK(observer->count() == 0);
+    CHECK(M2MDtlsTimer::get_delay(timer) == 1);
+    CHECK(wait_for(observer, 1));
+    CHECK(M2MDtlsTimer::get_delay(timer) == 2);
+}
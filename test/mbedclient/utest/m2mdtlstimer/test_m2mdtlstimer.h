@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TEST_M2M_DTLS_TIMER_H
+#define TEST_M2M_DTLS_TIMER_H
+
+#include "m2mdtlstimer.h"
+
+class TimerObserver;
+
+class Test_M2MDtlsTimer
+{
+public:
+    Test_M2MDtlsTimer();
+    virtual ~Test_M2MDtlsTimer();
+
+    void test_delays();
+
+    void test_cancel();
+
+    void test_restart();
+
+    M2MReactor* reactor;
+    TimerObserver* observer;
+    M2MDtlsTimer* timer;
+};
+
+#endif // TEST_M2M_DTLS_TIMER_H
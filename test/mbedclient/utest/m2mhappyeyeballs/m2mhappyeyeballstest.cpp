@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2mhappyeyeballs.h"
+
+TEST_GROUP(M2MHappyEyeballs)
+{
+  Test_M2MHappyEyeballs* m2m_happy_eyeballs;
+
+  void setup()
+  {
+    m2m_happy_eyeballs = new Test_M2MHappyEyeballs();
+  }
+  void teardown()
+  {
+    delete m2m_happy_eyeballs;
+  }
+};
+
+TEST(M2MHappyEyeballs, create)
+{
+    CHECK(m2m_happy_eyeballs->race != NULL);
+    CHECK(m2m_happy_eyeballs->race->state() == M2MHappyEyeballs::Idle);
+    CHECK(m2m_happy_eyeballs->race->next_attempt(0) == -1);
+}
+
+TEST(M2MHappyEyeballs, attempt_delay)
+{
+    m2m_happy_eyeballs->test_attempt_delay();
+}
+
+TEST(M2MHappyEyeballs, failed_attempt)
+{
+    m2m_happy_eyeballs->test_failed_attempt();
+}
+
+TEST(M2MHappyEyeballs, all_failed)
+{
+    m2m_happy_eyeballs->test_all_failed();
+}
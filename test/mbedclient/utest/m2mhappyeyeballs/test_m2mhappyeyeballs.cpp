@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2mhappyeyeballs.h"
+#include <string.h>
+
+#define DELAY       250
+
+Test_M2MHappyEyeballs::Test_M2MHappyEyeballs()
+{
+    race = new M2MHappyEyeballs(DELAY);
+    memset(addresses, 0, sizeof(addresses));
+    addresses[0].length = 16;
+    addresses[0].address[15] = 1;
+    addresses[1].length = 4;
+    addresses[1].address[3] = 1;
+    addresses[2].length = 16;
+    addresses[2].address[15] = 2;
+}
+
+Test_M2MHappyEyeballs::~Test_M2MHappyEyeballs()
+{
+    delete race;
+}
+
+void Test_M2MHappyEyeballs::test_attempt_delay()
+{
+    race->start(addresses, 3, 1000);
+    CHECK(race->state() == M2MHappyEyeballs::Connecting);
+    CHECK(race->time_to_next_attempt(1000) == 0);
+    CHECK(race->next_attempt(1000) == 0);
+    CHECK(race->in_progress(0) == true);
+    CHECK(race->address(0)->length == 16);
+    CHECK(race->address(3) == NULL);
+
+    // Second family starts after the delay.
+    CHECK(race->next_attempt(1100) == -1);
+    CHECK(race->time_to_next_attempt(1100) == DELAY - 100);
+    CHECK(race->next_attempt(1000 + DELAY) == 1);
+    CHECK(race->next_attempt(1000 + DELAY) == -1);
+
+    // First to connect wins, the other is left to close.
+    race->attempt_connected(1);
+    CHECK(race->state() == M2MHappyEyeballs::Connected);
+    CHECK(race->winner() == 1);
+    CHECK(race->in_progress(0) == true);
+    CHECK(race->in_progress(1) == false);
+    CHECK(race->next_attempt(5000) == -1);
+    CHECK(race->time_to_next_attempt(5000) == 0xFFFFFFFF);
+
+    // Late result doesn't change the winner.
+    race->attempt_connected(0);
+    CHECK(race->winner() == 1);
+
+    // Time wraps around.
+    race->start(addresses, 2, 0xFFFFFFF0);
+    CHECK(race->next_attempt(0xFFFFFFF0) == 0);
+    CHECK(race->next_attempt(DELAY - 0x11) == -1);
+    CHECK(race->next_attempt(DELAY - 0x10) == 1);
+}
+
+void Test_M2MHappyEyeballs::test_failed_attempt()
+{
+    race->start(addresses, 3, 0);
+    CHECK(race->next_attempt(0) == 0);
+
+    // Failure starts the next one right away.
+    race->attempt_failed(0, 10);
+    CHECK(race->in_progress(0) == false);
+    CHECK(race->state() == M2MHappyEyeballs::Connecting);
+    CHECK(race->time_to_next_attempt(10) == 0);
+    CHECK(race->next_attempt(10) == 1);
+    CHECK(race->next_attempt(10) == -1);
+
+    // Attempts not started are ignored.
+    race->attempt_failed(2, 20);
+    race->attempt_connected(2);
+    CHECK(race->state() == M2MHappyEyeballs::Connecting);
+
+    race->attempt_connected(1);
+    CHECK(race->winner() == 1);
+}
+
+void Test_M2MHappyEyeballs::test_all_failed()
+{
+    race->start(NULL, 3, 0);
+    CHECK(race->state() == M2MHappyEyeballs::Failed);
+
+    race->start(addresses, 2, 0);
+    CHECK(race->next_attempt(0) == 0);
+    CHECK(race->next_attempt(DELAY) == 1);
+    race->attempt_failed(1, DELAY + 1);
+    CHECK(race->state() == M2MHappyEyeballs::Connecting);
+    race->attempt_failed(0, DELAY + 2);
+    CHECK(race->state() == M2MHappyEyeballs::Failed);
+    CHECK(race->winner() == -1);
+    CHECK(race->next_attempt(DELAY + 2) == -1);
+}
@@ -18,6 +18,7 @@
 #include "m2minterfaceobserver.h"
 #include "m2mserver.h"
 #include "m2mdevice.h"
+#include "m2mresourcetable.h"
 
 class TestObserver : public M2MInterfaceObserver {
 
@@ -103,3 +104,35 @@ void Test_M2MInterfaceFactory::test_create_object()
     test = NULL;
     CHECK(M2MInterfaceFactory::create_object("") == NULL);
 }
+
+void Test_M2MInterfaceFactory::test_create_resource_table()
+{
+    M2MResourceTable *test = M2MInterfaceFactory::create_resource_table("name");
+    CHECK(test != NULL);
+    delete test;
+    test = NULL;
+    CHECK(M2MInterfaceFactory::create_resource_table("") == NULL);
+
+    const uint8_t value[] = {"value"};
+    const M2MResourceTable::ConstResource sorted[] = {
+        { 0, 0, M2MResourceInstance::STRING, value, 5 },
+        { 0, 2, M2MResourceInstance::STRING, value, 5 },
+        { 1, 1, M2MResourceInstance::STRING, value, 5 }
+    };
+    const M2MResourceTable::ConstResource unsorted[] = {
+        { 1, 0, M2MResourceInstance::STRING, value, 5 },
+        { 0, 2, M2MResourceInstance::STRING, value, 5 }
+    };
+    const M2MResourceTable::ConstResource duplicate[] = {
+        { 0, 2, M2MResourceInstance::STRING, value, 5 },
+        { 0, 2, M2MResourceInstance::STRING, value, 5 }
+    };
+    test = M2MInterfaceFactory::create_resource_table("name", sorted, 3);
+    CHECK(test != NULL);
+    delete test;
+    test = NULL;
+    CHECK(M2MInterfaceFactory::create_resource_table("name", unsorted, 2) == NULL);
+    CHECK(M2MInterfaceFactory::create_resource_table("name", duplicate, 2) == NULL);
+    CHECK(M2MInterfaceFactory::create_resource_table("name", NULL, 2) == NULL);
+    CHECK(M2MInterfaceFactory::create_resource_table("", sorted, 3) == NULL);
+}
@@ -34,6 +34,8 @@ public:
     void test_create_server();
 
     void test_create_object();
+
+    void test_create_resource_table();
 };
 
 #endif // TEST_M2M_SECURITY_H
@@ -127,3 +127,52 @@ TEST(M2MInterfaceImpl, data_sent)
     m2m_interface_impl->test_data_sent();
 }
 
+TEST(M2MInterfaceImpl, event_queue)
+{
+    m2m_interface_impl->test_event_queue();
+}
+
+TEST(M2MInterfaceImpl, device)
+{
+    m2m_interface_impl->test_device();
+}
+
+TEST(M2MInterfaceImpl, tcp_binding)
+{
+    m2m_interface_impl->test_tcp_binding();
+}
+
+TEST(M2MInterfaceImpl, queue_mode)
+{
+    m2m_interface_impl->test_queue_mode();
+}
+
+TEST(M2MInterfaceImpl, registration_store)
+{
+    m2m_interface_impl->test_registration_store();
+}
+
+TEST(M2MInterfaceImpl, keepalive)
+{
+    m2m_interface_impl->test_keepalive();
+}
+
+TEST(M2MInterfaceImpl, poll_mode)
+{
+    m2m_interface_impl->test_poll_mode();
+}
+
+TEST(M2MInterfaceImpl, coap_timer_delay)
+{
+    m2m_interface_impl->test_coap_timer_delay();
+}
+
+TEST(M2MInterfaceImpl, callbacks_reenter)
+{
+    m2m_interface_impl->test_callbacks_reenter();
+}
+
+TEST(M2MInterfaceImpl, event_queue_full)
+{
+    m2m_interface_impl->test_event_queue_full();
+}
@@ -19,14 +19,23 @@
 #include "m2mconnectionhandler_stub.h"
 #include "m2msecurity_stub.h"
 #include "m2mnsdlinterface_stub.h"
+#include "m2mreceivebufferpool_stub.h"
+#include "m2mcoaptcpframer_stub.h"
+#include "m2msendqueue_stub.h"
+#include "m2mwakewindow_stub.h"
+#include "m2mregistrationstore_stub.h"
+#include "m2mkeepalive_stub.h"
+#include "m2mtimer_stub.h"
+#include "m2mconstants.h"
 #include "m2mobject_stub.h"
 #include "m2mobjectinstance_stub.h"
 #include "m2mbase.h"
+#include "m2mdevice.h"
 
 class TestObserver : public M2MInterfaceObserver {
 
 public:
-    TestObserver(){}
+    TestObserver() : interface(NULL), security(NULL) {}
     virtual ~TestObserver(){}
     void bootstrap_done(M2MSecurity */*server_object*/){
         bootstrapped = true;
@@ -34,6 +43,9 @@ public:
     void object_registered(M2MSecurity */*security_object*/,
                            const M2MServer &/*server_object*/) {
         registered = true;
+        if(interface) {
+            interface->unregister_object(NULL);
+        }
     }
 
     void object_unregistered(M2MSecurity */*server_object*/){
@@ -43,10 +55,20 @@ public:
     void registration_updated(M2MSecurity */*security_object*/,
                               const M2MServer &/*server_object*/){
         registered = true;
+        if(interface) {
+            interface->update_registration(NULL, 0);
+        }
     }
 
-    void error(M2MInterface::Error /*error*/){
+    void error(M2MInterface::Error error){
         error_occured = true;
+        last_error = error;
+        if(interface && security) {
+            // Retries once.
+            M2MSecurity *retry = security;
+            security = NULL;
+            interface->register_object(retry, objects);
+        }
     }
 
     void value_updated(M2MBase *, M2MBase::BaseType ){
@@ -58,6 +80,10 @@ public:
     bool registered;
     bool unregistered;
     bool bootstrapped;
+    M2MInterface::Error last_error;
+    M2MInterface *interface;        // Called back from the callbacks when set.
+    M2MSecurity *security;
+    M2MObjectList objects;
 };
 
 class M2MBaseTest : public M2MBase
@@ -182,7 +208,10 @@ void Test_M2MInterfaceImpl::test_register_object()
 
     CHECK(impl->_current_state == M2MInterfaceImpl::STATE_BOOTSTRAP);
     CHECK(observer->error_occured == true);
+    // A rejected request leaves nothing ongoing.
+    CHECK(impl->_register_ongoing == false);
 
+    impl->_register_ongoing = true;
     impl->_current_state =  M2MInterfaceImpl::STATE_IDLE;
     m2mconnectionhandler_stub::bool_value = true;
     m2mnsdlinterface_stub::bool_value = true;
@@ -283,15 +312,49 @@ void Test_M2MInterfaceImpl::test_coap_message_ready()
     uint16_t data_len = sizeof(uint8_t);
     sn_nsdl_addr_s *address_ptr = (sn_nsdl_addr_s*)malloc(sizeof(sn_nsdl_addr_s));
 
+    m2msendqueue_stub::clear();
     impl->coap_message_ready(data_ptr,data_len,address_ptr);
 
     CHECK(impl->_current_state == M2MInterfaceImpl::STATE_WAITING);
+    CHECK(m2msendqueue_stub::sent_count == 1);
+    CHECK(m2msendqueue_stub::count_value == 0);
 
+    // Socket that can't take the message keeps it queued.
+    m2mconnectionhandler_stub::bool_value = false;
+    observer->error_occured = false;
+    impl->coap_message_ready(data_ptr,data_len,address_ptr);
+
+    CHECK(impl->_current_state == M2MInterfaceImpl::STATE_WAITING);
+    CHECK(observer->error_occured == false);
+    CHECK(m2msendqueue_stub::count_value == 1);
+
+    // Retried on the timer tick, sent once the socket takes it.
+    m2mconnectionhandler_stub::bool_value = true;
+    impl->coap_timer_tick(7);
+    CHECK(m2msendqueue_stub::tick_value == 7);
+    CHECK(m2msendqueue_stub::sent_count == 2);
+    CHECK(impl->_send_failures == 0);
+
+    // Network error once the retries are used up.
     m2mconnectionhandler_stub::bool_value = false;
     impl->coap_message_ready(data_ptr,data_len,address_ptr);
+    for(uint8_t i = 1; i < SEND_RETRY_LIMIT; i++) {
+        CHECK(observer->error_occured == false);
+        impl->coap_timer_tick(7 + i);
+    }
 
     CHECK(impl->_current_state == M2MInterfaceImpl::STATE_IDLE);
     CHECK(observer->error_occured == true);
+    CHECK(m2msendqueue_stub::cleared == true);
+    CHECK(m2msendqueue_stub::count_value == 0);
+
+    // Message the queue refuses isn't sent.
+    m2msendqueue_stub::clear();
+    m2msendqueue_stub::enqueue_value = false;
+    m2mconnectionhandler_stub::bool_value = true;
+    impl->coap_message_ready(data_ptr,data_len,address_ptr);
+    CHECK(m2msendqueue_stub::sent_count == 0);
+    m2msendqueue_stub::clear();
 
     free(address_ptr);
     free(data_ptr);
@@ -369,15 +432,28 @@ void Test_M2MInterfaceImpl::test_data_available()
 {
     uint8_t* data = (uint8_t*)malloc(sizeof(uint8_t));
     uint16_t data_size = sizeof(uint8_t);
+    uint8_t address_data[16];
+    memset(address_data, 1, sizeof(address_data));
     M2MConnectionObserver::SocketAddress *address = (M2MConnectionObserver::SocketAddress*)
                                                     malloc(sizeof(M2MConnectionObserver::SocketAddress));
 
+    m2mreceivebufferpool_stub::clear();
+    m2msendqueue_stub::clear();
     address->_stack = M2MInterface::LwIP_IPv4;
+    address->_address = address_data;
+    address->_length = 0;
+    address->_port = 5683;
     m2mnsdlinterface_stub::bool_value = true;
 
+    // Data from the socket's own buffer is copied into the pool.
+    *data = 0x42;
     impl->data_available(data,data_size,*address);
 
     CHECK(impl->_current_state == M2MInterfaceImpl::STATE_WAITING);
+    CHECK(m2mreceivebufferpool_stub::buffer[0] == 0x42);
+    CHECK(m2mreceivebufferpool_stub::released == m2mreceivebufferpool_stub::buffer);
+    // Received messages are shown to the send queue for acknowledgements.
+    CHECK(m2msendqueue_stub::received_count == 1);
 
     address->_stack = M2MInterface::LwIP_IPv6;
     m2mnsdlinterface_stub::bool_value = true;
@@ -394,6 +470,35 @@ void Test_M2MInterfaceImpl::test_data_available()
     CHECK(impl->_current_state == M2MInterfaceImpl::STATE_WAITING);
     CHECK(observer->error_occured == true);
 
+    // Data received into a pool buffer is processed in place.
+    m2mreceivebufferpool_stub::clear();
+    m2mreceivebufferpool_stub::owns_value = true;
+    m2mreceivebufferpool_stub::acquire_value = NULL;
+    m2mnsdlinterface_stub::bool_value = true;
+    uint16_t size = 0;
+    impl->receive_buffer(size);
+    CHECK(size == 0);
+
+    impl->data_available(data,data_size,*address);
+    CHECK(m2mreceivebufferpool_stub::released == data);
+
+    // No buffer to copy into, data dropped.
+    m2mreceivebufferpool_stub::clear();
+    m2mreceivebufferpool_stub::acquire_value = NULL;
+    impl->data_available(data,data_size,*address);
+    CHECK(m2mreceivebufferpool_stub::released == NULL);
+
+    // Datagram larger than the buffers, data dropped.
+    m2mreceivebufferpool_stub::clear();
+    m2mreceivebufferpool_stub::size_value = 0;
+    impl->data_available(data,data_size,*address);
+    CHECK(m2mreceivebufferpool_stub::released == NULL);
+
+    m2mreceivebufferpool_stub::clear();
+    impl->release_receive_buffer(data);
+    CHECK(m2mreceivebufferpool_stub::released == data);
+
+    m2mreceivebufferpool_stub::clear();
     free(data);
     free(address);
 }
@@ -419,6 +524,7 @@ void Test_M2MInterfaceImpl::test_address_ready()
     M2MConnectionObserver::ServerType server_type = M2MConnectionObserver::Bootstrap;
     uint16_t server_port = 5685;
 
+    address->_length = 0;
     address->_stack = M2MInterface::LwIP_IPv6;
     m2mnsdlinterface_stub::bool_value = true;
 
@@ -453,7 +559,19 @@ void Test_M2MInterfaceImpl::test_address_ready()
 
     impl->address_ready(*address,server_type,server_port);
     CHECK(impl->_current_state == M2MInterfaceImpl::STATE_REGISTER_RESOURCE_CREATED);
+    CHECK(m2mnsdlinterface_stub::address_type == SN_NSDL_ADDRESS_TYPE_IPV4);
+
+    // Family follows the resolved address on a dual-stack connection.
+    address->_stack = M2MInterface::LwIP_IPv6;
+    address->_length = 4;
+    impl->address_ready(*address,server_type,server_port);
+    CHECK(m2mnsdlinterface_stub::address_type == SN_NSDL_ADDRESS_TYPE_IPV4);
 
+    address->_stack = M2MInterface::LwIP_IPv4;
+    address->_length = 16;
+    impl->address_ready(*address,server_type,server_port);
+    CHECK(m2mnsdlinterface_stub::address_type == SN_NSDL_ADDRESS_TYPE_IPV6);
+    address->_length = 0;
 
     address->_stack = M2MInterface::LwIP_IPv6;
     m2mnsdlinterface_stub::bool_value = false;
@@ -481,3 +599,508 @@ void Test_M2MInterfaceImpl::test_data_sent()
     CHECK(observer->error_occured == false);
 
 }
+
+void Test_M2MInterfaceImpl::test_event_queue()
+{
+    // Events generated while dispatching are queued, not run re-entrantly.
+    impl->_current_state = M2MInterfaceImpl::STATE_REGISTERED;
+    impl->_event_dispatching = true;
+    impl->internal_event(M2MInterfaceImpl::STATE_SENDING_COAP_DATA);
+    impl->internal_event(M2MInterfaceImpl::STATE_IDLE);
+    CHECK(impl->_event_count == 2);
+    CHECK(impl->_current_state == M2MInterfaceImpl::STATE_REGISTERED);
+
+    // Sending goes to waiting before the pending idle event is run.
+    impl->_event_dispatching = false;
+    impl->state_engine();
+    CHECK(impl->_event_count == 0);
+    CHECK(impl->_current_state == M2MInterfaceImpl::STATE_IDLE);
+
+    // Event data is stored in a preallocated slot, released once used.
+    uint8_t data[] = {1};
+    M2MConnectionObserver::SocketAddress address;
+    address._stack = M2MInterface::LwIP_IPv4;
+    address._port = 5683;
+    address._address = data;
+    m2mnsdlinterface_stub::bool_value = true;
+
+    impl->data_available(data, sizeof(data), address);
+    CHECK(impl->_current_state == M2MInterfaceImpl::STATE_WAITING);
+    CHECK(impl->next_event_slot() == &impl->_event_slots[0]);
+
+    // A full queue drops the event.
+    impl->_event_dispatching = true;
+    for(int i = 0; i <= M2MInterfaceImpl::EVENT_QUEUE_SIZE; i++) {
+        impl->internal_event(M2MInterfaceImpl::STATE_WAITING);
+    }
+    CHECK(impl->_event_count == M2MInterfaceImpl::EVENT_QUEUE_SIZE);
+    impl->_event_dispatching = false;
+    impl->state_engine();
+    CHECK(impl->_event_count == 0);
+}
+
+void Test_M2MInterfaceImpl::test_device()
+{
+    M2MDevice *device = impl->device();
+    CHECK(device != NULL);
+    CHECK(impl->device() == device);
+
+    // Every interface owns its own Device Object.
+    M2MInterfaceImpl *other = new M2MInterfaceImpl(*observer,
+                                                   "endpoint_name",
+                                                   "endpoint_type",
+                                                   120,
+                                                   8000,
+                                                   "domain");
+    CHECK(other->device() != NULL);
+    CHECK(other->device() != device);
+    delete other;
+}
+
+void Test_M2MInterfaceImpl::test_tcp_binding()
+{
+    CHECK(impl->transport_type() == M2MConnectionObserver::Datagram);
+    CHECK(impl->_tcp_framer == NULL);
+
+    M2MInterfaceImpl *tcp = new M2MInterfaceImpl(*observer,
+                                                 "endpoint_name",
+                                                 "endpoint_type",
+                                                 120,
+                                                 8000,
+                                                 "domain",
+                                                 M2MInterface::TCP);
+    CHECK(tcp->transport_type() == M2MConnectionObserver::Stream);
+    CHECK(tcp->_tcp_framer != NULL);
+
+    m2mcoaptcpframer_stub::clear();
+    m2mreceivebufferpool_stub::clear();
+    m2mconnectionhandler_stub::bool_value = true;
+    uint8_t data[4] = { 0x60, 0x00, 0x00, 0x01 };
+    sn_nsdl_addr_s address;
+    memset(&address, 0, sizeof(address));
+
+    // Message not needed on the stream isn't sent.
+    tcp->_current_state = M2MInterfaceImpl::STATE_REGISTERED;
+    tcp->coap_message_ready(data, sizeof(data), &address);
+    CHECK(tcp->_current_state == M2MInterfaceImpl::STATE_REGISTERED);
+
+    // Framed message is sent, local acknowledgements are processed.
+    m2mcoaptcpframer_stub::frame_value = m2mcoaptcpframer_stub::buffer;
+    m2mcoaptcpframer_stub::message_count = 1;
+    tcp->coap_message_ready(data, sizeof(data), &address);
+    CHECK(tcp->_current_state == M2MInterfaceImpl::STATE_WAITING);
+    CHECK(m2mcoaptcpframer_stub::message_count == 0);
+
+    // Stream data is reassembled and the messages processed.
+    uint8_t address_data[4] = { 127, 0, 0, 1 };
+    M2MConnectionObserver::SocketAddress socket_address;
+    socket_address._stack = M2MInterface::LwIP_IPv4;
+    socket_address._address = address_data;
+    socket_address._length = 4;
+    socket_address._port = 5683;
+    m2mnsdlinterface_stub::bool_value = true;
+    m2mcoaptcpframer_stub::message_count = 2;
+    m2mcoaptcpframer_stub::signal_value = m2mcoaptcpframer_stub::buffer;
+    observer->error_occured = false;
+    tcp->data_available(data, sizeof(data), socket_address);
+    CHECK(m2mcoaptcpframer_stub::fed == sizeof(data));
+    CHECK(m2mcoaptcpframer_stub::message_count == 0);
+    CHECK(m2mcoaptcpframer_stub::signal_value == NULL);
+    CHECK(observer->error_occured == false);
+
+    // Broken stream is reported as a network error.
+    m2mcoaptcpframer_stub::failed_value = true;
+    tcp->data_available(data, sizeof(data), socket_address);
+    CHECK(observer->error_occured == true);
+    CHECK(m2mcoaptcpframer_stub::reset_called == true);
+    CHECK(tcp->_current_state == M2MInterfaceImpl::STATE_IDLE);
+
+    // New connection resets the stream.
+    m2mcoaptcpframer_stub::reset_called = false;
+    tcp->address_ready(socket_address, M2MConnectionObserver::LWM2MServer, 5683);
+    CHECK(m2mcoaptcpframer_stub::reset_called == true);
+
+    m2mcoaptcpframer_stub::clear();
+    delete tcp;
+}
+
+void Test_M2MInterfaceImpl::test_queue_mode()
+{
+    CHECK(impl->_queue_mode == false);
+
+    M2MInterfaceImpl *queue = new M2MInterfaceImpl(*observer,
+                                                   "endpoint_name",
+                                                   "endpoint_type",
+                                                   120,
+                                                   8000,
+                                                   "domain",
+                                                   M2MInterface::UDP_QUEUE);
+    CHECK(queue->_queue_mode == true);
+
+    m2msendqueue_stub::clear();
+    m2mwakewindow_stub::clear();
+    m2mconnectionhandler_stub::bool_value = true;
+    uint8_t data[4] = { 0x40, 0x02, 0x00, 0x01 };
+    sn_nsdl_addr_s address;
+    memset(&address, 0, sizeof(address));
+
+    // Notification waits for the next window.
+    m2msendqueue_stub::classify_value = M2MSendQueue::Notification;
+    queue->coap_message_ready(data, sizeof(data), &address);
+    CHECK(m2mwakewindow_stub::deferred_count == 1);
+    CHECK(m2mwakewindow_stub::open_count == 0);
+    CHECK(m2msendqueue_stub::sent_count == 0);
+    CHECK(m2msendqueue_stub::count_value == 1);
+
+    // Window opens on the timer, the queue is flushed.
+    m2mwakewindow_stub::tick_value = M2MWakeWindow::Opened;
+    queue->coap_timer_tick(60);
+    CHECK(m2mwakewindow_stub::tick_pending == true);
+    CHECK(m2msendqueue_stub::sent_count == 1);
+    CHECK(m2mwakewindow_stub::sent_count == 1);
+    CHECK(m2mwakewindow_stub::sent_bytes == sizeof(data));
+
+    // Sent right away while the window is open.
+    m2mwakewindow_stub::tick_value = M2MWakeWindow::None;
+    queue->coap_message_ready(data, sizeof(data), &address);
+    CHECK(m2mwakewindow_stub::deferred_count == 1);
+    CHECK(m2msendqueue_stub::sent_count == 2);
+
+    // Window closes, a request of the client opens it again.
+    m2mwakewindow_stub::tick_value = M2MWakeWindow::Closed;
+    queue->coap_timer_tick(160);
+    CHECK(m2mwakewindow_stub::tick_pending == false);
+    CHECK(m2mwakewindow_stub::is_open_value == false);
+    m2mwakewindow_stub::tick_value = M2MWakeWindow::None;
+    m2msendqueue_stub::classify_value = M2MSendQueue::Registration;
+    queue->coap_message_ready(data, sizeof(data), &address);
+    CHECK(m2mwakewindow_stub::open_count == 1);
+    CHECK(m2mwakewindow_stub::deferred_count == 1);
+    CHECK(m2msendqueue_stub::sent_count == 3);
+
+    // Exchange in flight is reported as pending.
+    m2msendqueue_stub::in_flight_value = 1;
+    queue->coap_timer_tick(161);
+    CHECK(m2mwakewindow_stub::tick_pending == true);
+
+    queue->set_queue_mode_timing(30, 600);
+    CHECK(m2mwakewindow_stub::listen_time == 30);
+    CHECK(m2mwakewindow_stub::wake_interval == 600);
+
+    m2mwakewindow_stub::stats.windows = 2;
+    CHECK(queue->queue_mode_stats().windows == 2);
+
+    // Going idle stops the windows.
+    queue->state_idle(NULL);
+    CHECK(m2mwakewindow_stub::stop_count == 1);
+
+    // Other bindings don't use the window.
+    m2mwakewindow_stub::clear();
+    m2msendqueue_stub::clear();
+    m2msendqueue_stub::classify_value = M2MSendQueue::Notification;
+    impl->coap_message_ready(data, sizeof(data), &address);
+    CHECK(m2mwakewindow_stub::deferred_count == 0);
+    CHECK(m2msendqueue_stub::sent_count == 1);
+
+    m2msendqueue_stub::clear();
+    m2mwakewindow_stub::clear();
+    delete queue;
+}
+
+void Test_M2MInterfaceImpl::test_registration_store()
+{
+    M2MRegistrationStore store("registration.dat");
+    m2mregistrationstore_stub::clear();
+    m2mnsdlinterface_stub::clear();
+    impl->set_registration_store(&store);
+    CHECK(m2mregistrationstore_stub::load_count == 1);
+    CHECK(impl->registration_store() == &store);
+
+    M2MSecurity *sec = new M2MSecurity(M2MSecurity::M2MServer);
+    M2MObjectList list;
+    String *val = new String("coap://10.45.3.83:5685");
+    m2msecurity_stub::string_value = val;
+    m2mnsdlinterface_stub::bool_value = true;
+    m2mconnectionhandler_stub::bool_value = true;
+
+    uint8_t address_data[4] = {10, 45, 3, 83};
+    M2MConnectionObserver::SocketAddress address;
+    address._stack = M2MInterface::LwIP_IPv4;
+    address._address = address_data;
+    address._length = 4;
+    address._port = 5685;
+
+    // A saved registration is resumed with an update.
+    m2mregistrationstore_stub::bool_value = true;
+    impl->register_object(sec, list);
+    CHECK(impl->_resume_registration == true);
+    impl->address_ready(address, M2MConnectionObserver::LWM2MServer, 5685);
+    CHECK(impl->_current_state == M2MInterfaceImpl::STATE_REGISTER_RESOURCE_CREATED);
+    CHECK(m2mnsdlinterface_stub::resumed == true);
+    CHECK(m2mnsdlinterface_stub::address_type == SN_NSDL_ADDRESS_TYPE_IPV4);
+    CHECK(m2mregistrationstore_stub::address_length == 4);
+
+    // The state is saved on every registration and update.
+    impl->client_registered(NULL);
+    CHECK(m2mregistrationstore_stub::save_count == 1);
+    M2MServer *server = NULL;
+    impl->registration_updated(*server);
+    CHECK(m2mregistrationstore_stub::save_count == 2);
+
+    impl->client_unregistered();
+    CHECK(m2mregistrationstore_stub::clear_count == 1);
+
+    // Nothing to resume, the client registers.
+    m2mnsdlinterface_stub::resumed = false;
+    m2mregistrationstore_stub::bool_value = false;
+    impl->_register_ongoing = false;
+    impl->_current_state = M2MInterfaceImpl::STATE_IDLE;
+    impl->register_object(sec, list);
+    CHECK(impl->_resume_registration == false);
+    impl->address_ready(address, M2MConnectionObserver::LWM2MServer, 5685);
+    CHECK(m2mnsdlinterface_stub::resumed == false);
+
+    // A registration the server rejects is forgotten.
+    impl->registration_error(M2MInterface::NotRegistered);
+    CHECK(m2mregistrationstore_stub::clear_count == 2);
+
+    impl->set_registration_store(NULL);
+    CHECK(impl->registration_store() == NULL);
+
+    delete val;
+    m2msecurity_stub::string_value = NULL;
+    delete sec;
+}
+
+void Test_M2MInterfaceImpl::test_keepalive()
+{
+    m2mkeepalive_stub::clear();
+    m2msendqueue_stub::clear();
+    m2mnsdlinterface_stub::clear();
+    m2mreceivebufferpool_stub::clear();
+    m2mconnectionhandler_stub::bool_value = true;
+
+    impl->set_keepalive_interval(30, 600);
+    CHECK(m2mkeepalive_stub::interval == 30);
+    CHECK(m2mkeepalive_stub::max_interval == 600);
+    CHECK(impl->keepalive_stats().interval == 30);
+
+    impl->client_registered(NULL);
+    CHECK(m2mkeepalive_stub::running == true);
+
+    // A due ping goes to the server like any other message.
+    impl->_server_address.port = 5683;
+    m2mkeepalive_stub::tick_value = M2MKeepalive::Ping;
+    impl->coap_timer_tick(100);
+    CHECK(m2msendqueue_stub::front_length == M2MKeepalive::PING_LENGTH);
+    CHECK(m2msendqueue_stub::address.port == 5683);
+    CHECK(m2msendqueue_stub::sent_count == 1);
+    CHECK(m2mkeepalive_stub::activity_count == 1);
+
+    // The reply is consumed before the CoAP library sees it.
+    uint8_t pong[] = { 0x70, 0x00, 0xF0, 0x01 };
+    uint8_t address_data[4] = { 10, 45, 3, 83 };
+    M2MConnectionObserver::SocketAddress address;
+    address._stack = M2MInterface::LwIP_IPv4;
+    address._address = address_data;
+    address._length = 4;
+    address._port = 5683;
+    m2mnsdlinterface_stub::bool_value = false;
+    m2mkeepalive_stub::pong_value = true;
+    observer->error_occured = false;
+    impl->data_available(pong, sizeof(pong), address);
+    CHECK(observer->error_occured == false);
+    CHECK(m2mkeepalive_stub::activity_count == 2);
+
+    m2mkeepalive_stub::pong_value = false;
+    impl->data_available(pong, sizeof(pong), address);
+    CHECK(observer->error_occured == true);
+
+    // An unanswered ping updates the registration through the state machine.
+    m2msendqueue_stub::clear();
+    m2mnsdlinterface_stub::bool_value = true;
+    m2mkeepalive_stub::tick_value = M2MKeepalive::Failed;
+    observer->error_occured = false;
+    impl->coap_timer_tick(130);
+    CHECK(m2mnsdlinterface_stub::update_count == 1);
+    CHECK(impl->_update_register_ongoing == true);
+    CHECK(impl->_current_state == M2MInterfaceImpl::STATE_UPDATE_REGISTRATION);
+    CHECK(m2msendqueue_stub::front_length == 0);
+
+    // Not while an update is ongoing already.
+    impl->coap_timer_tick(160);
+    CHECK(m2mnsdlinterface_stub::update_count == 1);
+    CHECK(observer->error_occured == false);
+
+    impl->registration_error(M2MInterface::NetworkError);
+    CHECK(m2mkeepalive_stub::running == false);
+
+    // No keepalive in queue mode.
+    impl->_queue_mode = true;
+    impl->set_keepalive_interval(30, 600);
+    CHECK(m2mkeepalive_stub::interval == 0);
+    impl->_queue_mode = false;
+}
+
+void Test_M2MInterfaceImpl::test_poll_mode()
+{
+    m2mtimer_stub::clear();
+    m2mconnectionhandler_stub::clear();
+    uint64_t time = 0;
+
+    // Nothing is polled with the default threads.
+    m2mtimer_stub::expiry_value = true;
+    CHECK(impl->poll_mode() == false);
+    CHECK(impl->next_deadline(time) == false);
+    impl->process_io();
+    impl->process_timers(1000);
+    CHECK(m2mconnectionhandler_stub::process_io_count == 0);
+    CHECK(m2mtimer_stub::poll_count == 0);
+
+    // The timers of the process are switched by the application only.
+    impl->set_poll_mode(true);
+    CHECK(impl->poll_mode() == true);
+    CHECK(m2mtimer_stub::polled == false);
+
+    m2mconnectionhandler_stub::fd_value = 7;
+    CHECK(impl->socket_fd() == 7);
+
+    m2mtimer_stub::expiry = 12340;
+    CHECK(impl->next_deadline(time) == true);
+    CHECK(time == 12340);
+    m2mtimer_stub::expiry_value = false;
+    CHECK(impl->next_deadline(time) == false);
+
+    impl->process_io();
+    CHECK(m2mconnectionhandler_stub::process_io_count == 1);
+
+    impl->process_timers(12345);
+    CHECK(m2mtimer_stub::poll_count == 1);
+    CHECK(m2mtimer_stub::poll_time == 12345);
+
+    impl->set_poll_mode(false);
+    CHECK(impl->poll_mode() == false);
+    CHECK(m2mtimer_stub::polled == false);
+}
+
+void Test_M2MInterfaceImpl::test_coap_timer_delay()
+{
+    m2msendqueue_stub::clear();
+    m2mwakewindow_stub::clear();
+    m2mkeepalive_stub::clear();
+    m2mnsdlinterface_stub::clear();
+
+    // Nothing pending, the tick can sleep.
+    CHECK(impl->coap_timer_delay(100) == 0);
+
+    // Outstanding exchanges are retransmitted every second.
+    m2msendqueue_stub::in_flight_value = 1;
+    CHECK(impl->coap_timer_delay(100) == 1);
+    m2msendqueue_stub::in_flight_value = 0;
+
+    impl->_register_ongoing = true;
+    CHECK(impl->coap_timer_delay(100) == 1);
+    impl->_register_ongoing = false;
+
+    // Next keepalive ping.
+    m2mkeepalive_stub::next_action_value = 25;
+    CHECK(impl->coap_timer_delay(100) == 25);
+
+    // A deferred message waits for the next wake window.
+    impl->_queue_mode = true;
+    m2msendqueue_stub::count_value = 1;
+    m2mwakewindow_stub::is_open_value = false;
+    m2mwakewindow_stub::next_change_value = 10;
+    CHECK(impl->coap_timer_delay(100) == 10);
+    m2mwakewindow_stub::next_change_value = 40;
+    CHECK(impl->coap_timer_delay(100) == 25);
+
+    // Sendable messages need the tick.
+    m2mwakewindow_stub::is_open_value = true;
+    CHECK(impl->coap_timer_delay(100) == 1);
+    impl->_queue_mode = false;
+
+    // Changed timing takes effect without waiting for the current tick.
+    impl->set_keepalive_interval(30, 600);
+    CHECK(m2mnsdlinterface_stub::schedule_count == 1);
+    impl->set_queue_mode_timing(10, 300);
+    CHECK(m2mnsdlinterface_stub::schedule_count == 2);
+}
+
+void Test_M2MInterfaceImpl::test_callbacks_reenter()
+{
+    m2mnsdlinterface_stub::bool_value = true;
+    m2mconnectionhandler_stub::bool_value = true;
+    observer->interface = impl;
+    M2MServer *server = NULL;
+
+    // Replies are processed while the state machine is dispatching,
+    // the observer sees the state the reply led to.
+    impl->_current_state = M2MInterfaceImpl::STATE_WAITING;
+    impl->_register_ongoing = true;
+    impl->_event_dispatching = true;
+    observer->registered = false;
+    observer->error_occured = false;
+    impl->client_registered(server);
+    CHECK(observer->registered == false);
+    impl->state_engine();
+    CHECK(observer->registered == true);
+    CHECK(observer->error_occured == false);
+    CHECK(impl->_current_state == M2MInterfaceImpl::STATE_WAITING);
+
+    impl->_current_state = M2MInterfaceImpl::STATE_WAITING;
+    impl->_update_register_ongoing = true;
+    impl->_event_dispatching = true;
+    observer->registered = false;
+    impl->registration_updated(*server);
+    impl->state_engine();
+    CHECK(observer->registered == true);
+    CHECK(observer->error_occured == false);
+    CHECK(impl->_update_register_ongoing == true);
+
+    M2MSecurity *sec = new M2MSecurity(M2MSecurity::M2MServer);
+    String *val = new String("coap://10.45.3.83:5685");
+    m2msecurity_stub::string_value = val;
+    observer->security = sec;
+    impl->_current_state = M2MInterfaceImpl::STATE_WAITING;
+    impl->_register_ongoing = true;
+    impl->_event_dispatching = true;
+    impl->registration_error(M2MInterface::NetworkError);
+    impl->state_engine();
+    CHECK(observer->last_error == M2MInterface::NetworkError);
+    CHECK(impl->_current_state == M2MInterfaceImpl::STATE_REGISTER);
+
+    observer->interface = NULL;
+    delete val;
+    m2msecurity_stub::string_value = NULL;
+    delete sec;
+}
+
+void Test_M2MInterfaceImpl::test_event_queue_full()
+{
+    // Application calls can't take the entries reserved for the state machine.
+    impl->_current_state = M2MInterfaceImpl::STATE_IDLE;
+    impl->_event_dispatching = true;
+    impl->_event_count = M2MInterfaceImpl::EVENT_QUEUE_SIZE - M2MInterfaceImpl::EVENT_QUEUE_RESERVE;
+    observer->error_occured = false;
+    M2MSecurity *sec = new M2MSecurity(M2MSecurity::M2MServer);
+    M2MObjectList list;
+    impl->register_object(sec, list);
+    CHECK(observer->error_occured == true);
+    CHECK(impl->_register_ongoing == false);
+
+    // A dropped state change is reported.
+    impl->_event_count = M2MInterfaceImpl::EVENT_QUEUE_SIZE;
+    observer->error_occured = false;
+    CHECK(impl->internal_event(M2MInterfaceImpl::STATE_IDLE) == false);
+    CHECK(observer->error_occured == true);
+
+    // A notification is delivered even without room in the queue.
+    observer->bootstrapped = false;
+    impl->bootstrap_done(sec);
+    CHECK(observer->bootstrapped == true);
+
+    impl->_event_count = 0;
+    impl->_event_dispatching = false;
+    delete sec;
+}
@@ -63,6 +63,26 @@ public:
 
     void test_data_sent();
 
+    void test_event_queue();
+
+    void test_device();
+
+    void test_tcp_binding();
+
+    void test_queue_mode();
+
+    void test_registration_store();
+
+    void test_keepalive();
+
+    void test_poll_mode();
+
+    void test_coap_timer_delay();
+
+    void test_callbacks_reenter();
+
+    void test_event_queue_full();
+
     M2MInterfaceImpl*   impl;
     TestObserver        *observer;
 };
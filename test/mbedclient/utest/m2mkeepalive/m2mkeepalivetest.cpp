@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2mkeepalive.h"
+
+TEST_GROUP(M2MKeepalive)
+{
+  Test_M2MKeepalive* m2m_keepalive;
+
+  void setup()
+  {
+    m2m_keepalive = new Test_M2MKeepalive();
+  }
+  void teardown()
+  {
+    delete m2m_keepalive;
+  }
+};
+
+TEST(M2MKeepalive, create)
+{
+    CHECK(m2m_keepalive->keepalive != NULL);
+    CHECK(m2m_keepalive->keepalive->tick(1000) == M2MKeepalive::None);
+}
+
+TEST(M2MKeepalive, ping_after_idle)
+{
+    m2m_keepalive->test_ping_after_idle();
+}
+
+TEST(M2MKeepalive, retransmission)
+{
+    m2m_keepalive->test_retransmission();
+}
+
+TEST(M2MKeepalive, adaptation)
+{
+    m2m_keepalive->test_adaptation();
+}
+
+TEST(M2MKeepalive, pong_received)
+{
+    m2m_keepalive->test_pong_received();
+}
+
+TEST(M2MKeepalive, next_action)
+{
+    m2m_keepalive->test_next_action();
+}
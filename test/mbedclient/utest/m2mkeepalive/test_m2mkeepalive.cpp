@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2mkeepalive.h"
+
+Test_M2MKeepalive::Test_M2MKeepalive()
+{
+    keepalive = new M2MKeepalive(3, 3);
+}
+
+Test_M2MKeepalive::~Test_M2MKeepalive()
+{
+    delete keepalive;
+}
+
+static void answer(M2MKeepalive *keepalive, uint32_t now)
+{
+    uint8_t ping[M2MKeepalive::PING_LENGTH];
+    CHECK(keepalive->ping_message(ping) == M2MKeepalive::PING_LENGTH);
+    uint8_t pong[M2MKeepalive::PING_LENGTH] = { 0x70, 0x00, ping[2], ping[3] };
+    CHECK(keepalive->pong_received(pong, sizeof(pong), now) == true);
+}
+
+void Test_M2MKeepalive::test_ping_after_idle()
+{
+    // Disabled until an interval is set.
+    keepalive->start(0);
+    CHECK(keepalive->tick(100) == M2MKeepalive::None);
+
+    keepalive->set_interval(30, 0);
+    keepalive->start(100);
+    CHECK(keepalive->tick(129) == M2MKeepalive::None);
+
+    // Traffic restarts the idle time.
+    keepalive->activity(120);
+    CHECK(keepalive->tick(149) == M2MKeepalive::None);
+    CHECK(keepalive->tick(150) == M2MKeepalive::Ping);
+
+    uint8_t ping[M2MKeepalive::PING_LENGTH];
+    keepalive->ping_message(ping);
+    CHECK(ping[0] == 0x40);
+    CHECK(ping[1] == 0x00);
+
+    answer(keepalive, 151);
+    CHECK(keepalive->stats().pings == 1);
+    CHECK(keepalive->stats().interval == 30);
+    CHECK(keepalive->tick(180) == M2MKeepalive::None);
+    CHECK(keepalive->tick(181) == M2MKeepalive::Ping);
+
+    // Each ping gets a new message ID.
+    uint8_t next[M2MKeepalive::PING_LENGTH];
+    keepalive->ping_message(next);
+    CHECK(((next[2] << 8) | next[3]) == ((ping[2] << 8) | ping[3]) + 1);
+
+    keepalive->stop();
+    CHECK(keepalive->tick(1000) == M2MKeepalive::None);
+}
+
+void Test_M2MKeepalive::test_retransmission()
+{
+    keepalive->set_interval(30, 0);
+    keepalive->start(0);
+    CHECK(keepalive->tick(30) == M2MKeepalive::Ping);
+
+    // Timeouts of 3, 6 and 12 seconds.
+    CHECK(keepalive->tick(32) == M2MKeepalive::None);
+    CHECK(keepalive->tick(33) == M2MKeepalive::Ping);
+    CHECK(keepalive->tick(38) == M2MKeepalive::None);
+    CHECK(keepalive->tick(39) == M2MKeepalive::Ping);
+    CHECK(keepalive->tick(50) == M2MKeepalive::None);
+    CHECK(keepalive->tick(51) == M2MKeepalive::Failed);
+
+    M2MInterface::KeepaliveStats stats = keepalive->stats();
+    CHECK(stats.failures == 1);
+    CHECK(stats.nat_timeout == 30);
+    CHECK(stats.interval == 30);
+
+    // A new ping after the interval.
+    CHECK(keepalive->tick(80) == M2MKeepalive::None);
+    CHECK(keepalive->tick(81) == M2MKeepalive::Ping);
+    answer(keepalive, 82);
+}
+
+void Test_M2MKeepalive::test_adaptation()
+{
+    keepalive->set_interval(30, 100);
+    keepalive->start(0);
+
+    uint32_t now = 0;
+    CHECK(keepalive->tick(now += 30) == M2MKeepalive::Ping);
+    answer(keepalive, now);
+    CHECK(keepalive->stats().interval == 60);
+    CHECK(keepalive->tick(now += 59) == M2MKeepalive::None);
+    CHECK(keepalive->tick(now += 1) == M2MKeepalive::Ping);
+    answer(keepalive, now);
+    CHECK(keepalive->stats().interval == 90);
+    CHECK(keepalive->tick(now += 90) == M2MKeepalive::Ping);
+    answer(keepalive, now);
+
+    // Capped at the maximum.
+    CHECK(keepalive->stats().interval == 100);
+
+    // The NAT drops the mapping at 100 seconds, fall back to 90.
+    CHECK(keepalive->tick(now += 100) == M2MKeepalive::Ping);
+    CHECK(keepalive->tick(now += 3) == M2MKeepalive::Ping);
+    CHECK(keepalive->tick(now += 6) == M2MKeepalive::Ping);
+    CHECK(keepalive->tick(now += 12) == M2MKeepalive::Failed);
+    M2MInterface::KeepaliveStats stats = keepalive->stats();
+    CHECK(stats.nat_timeout == 100);
+    CHECK(stats.interval == 90);
+    CHECK(stats.pings == 3);
+
+    // No more adaptation after a failure.
+    CHECK(keepalive->tick(now += 90) == M2MKeepalive::Ping);
+    answer(keepalive, now);
+    CHECK(keepalive->stats().interval == 90);
+
+    // A new interval restarts it.
+    keepalive->set_interval(30, 100);
+    CHECK(keepalive->stats().interval == 30);
+}
+
+void Test_M2MKeepalive::test_pong_received()
+{
+    uint8_t pong[] = { 0x70, 0x00, 0x00, 0x00 };
+    // Nothing pending.
+    CHECK(keepalive->pong_received(pong, sizeof(pong), 0) == false);
+
+    keepalive->set_interval(30, 0);
+    keepalive->start(0);
+    CHECK(keepalive->tick(30) == M2MKeepalive::Ping);
+
+    uint8_t ping[M2MKeepalive::PING_LENGTH];
+    keepalive->ping_message(ping);
+    pong[2] = ping[2];
+    pong[3] = ping[3];
+
+    CHECK(keepalive->pong_received(NULL, 0, 31) == false);
+    CHECK(keepalive->pong_received(pong, 2, 31) == false);
+
+    // Wrong message ID.
+    pong[3]++;
+    CHECK(keepalive->pong_received(pong, sizeof(pong), 31) == false);
+    pong[3]--;
+
+    // Acknowledgement instead of reset.
+    pong[0] = 0x60;
+    CHECK(keepalive->pong_received(pong, sizeof(pong), 31) == false);
+
+    // Reset with a response code.
+    pong[0] = 0x70;
+    pong[1] = 0x44;
+    CHECK(keepalive->pong_received(pong, sizeof(pong), 31) == false);
+
+    pong[1] = 0x00;
+    CHECK(keepalive->pong_received(pong, sizeof(pong), 31) == true);
+    // Only once.
+    CHECK(keepalive->pong_received(pong, sizeof(pong), 31) == false);
+    CHECK(keepalive->stats().pings == 1);
+}
+
+void Test_M2MKeepalive::test_next_action()
+{
+    // Nothing to wait for until started with an interval.
+    CHECK(keepalive->next_action(0) == 0);
+    keepalive->start(0);
+    CHECK(keepalive->next_action(0) == 0);
+
+    keepalive->set_interval(30, 0);
+    keepalive->start(100);
+    CHECK(keepalive->next_action(100) == 30);
+    keepalive->activity(110);
+    CHECK(keepalive->next_action(120) == 20);
+
+    // An overdue ping is due on the next tick.
+    CHECK(keepalive->next_action(200) == 1);
+
+    // Unanswered pings wait for the retransmission timeout.
+    CHECK(keepalive->tick(140) == M2MKeepalive::Ping);
+    CHECK(keepalive->next_action(141) == 2);
+
+    keepalive->stop();
+    CHECK(keepalive->next_action(141) == 0);
+}
@@ -43,6 +43,11 @@ TEST(M2MNsdlInterface, memory_free)
     m2m_nsdl_interface->test_memory_free();
 }
 
+TEST(M2MNsdlInterface, resume_registration)
+{
+    m2m_nsdl_interface->test_resume_registration();
+}
+
 TEST(M2MNsdlInterface, memory_alloc)
 {
     m2m_nsdl_interface->test_memory_alloc();
@@ -138,6 +143,16 @@ TEST(M2MNsdlInterface, process_received_data)
     m2m_nsdl_interface->test_process_received_data();
 }
 
+TEST(M2MNsdlInterface, schedule_execution)
+{
+    m2m_nsdl_interface->test_schedule_execution();
+}
+
+TEST(M2MNsdlInterface, shared_clock)
+{
+    m2m_nsdl_interface->test_shared_clock();
+}
+
 TEST(M2MNsdlInterface, stop_timers)
 {
     m2m_nsdl_interface->test_stop_timers();
@@ -163,6 +178,11 @@ TEST(M2MNsdlInterface, find_resource)
     m2m_nsdl_interface->test_find_resource();
 }
 
+TEST(M2MNsdlInterface, create_nsdl_table_structure)
+{
+    m2m_nsdl_interface->test_create_nsdl_table_structure();
+}
+
 TEST(M2MNsdlInterface, remove_object)
 {
     m2m_nsdl_interface->test_remove_object();
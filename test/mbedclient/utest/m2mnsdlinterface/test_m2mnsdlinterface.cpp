@@ -22,14 +22,16 @@
 #include "m2mresource_stub.h"
 #include "m2mresourceinstance_stub.h"
 #include "m2mresource.h"
+#include "m2mresourcetable_stub.h"
 #include "m2mbase_stub.h"
+#include "m2mtimer_stub.h"
 #include "m2mserver.h"
 #include "m2msecurity.h"
 
 class TestObserver : public M2MNsdlObserver {
 
 public:
-    TestObserver(){}
+    TestObserver() : timer_delay(1) {}
     virtual ~TestObserver(){}
     void coap_message_ready(uint8_t *,
                             uint16_t,
@@ -73,6 +75,10 @@ public:
         value_update = true;
     }
 
+    uint32_t coap_timer_delay(uint32_t){
+        return timer_delay;
+    }
+
     bool register_error;
     bool boot_error;
     bool boot_done;
@@ -82,6 +88,7 @@ public:
     bool unregistered;
     bool message_ready;
     bool value_update;
+    uint32_t timer_delay;
 };
 
 Test_M2MNsdlInterface::Test_M2MNsdlInterface()
@@ -93,6 +100,8 @@ Test_M2MNsdlInterface::Test_M2MNsdlInterface()
 
 Test_M2MNsdlInterface:: ~Test_M2MNsdlInterface()
 {
+    // Objects of the tests are deleted without the stubs removing them.
+    nsdl->_object_list.clear();
     delete nsdl;
     nsdl = NULL;
     delete observer;
@@ -238,6 +247,81 @@ void Test_M2MNsdlInterface::test_send_unregister_message()
 
 }
 
+void Test_M2MNsdlInterface::test_resume_registration()
+{
+    uint8_t address[] = {127, 0, 0, 1};
+    uint8_t location[] = {"rd/4b2c"};
+    uint8_t length = 0;
+    nsdl->_nsdl_handle = (nsdl_s*)malloc(sizeof(1));
+
+    common_stub::int_value = 0;
+    common_stub::uint_value = 31;
+    CHECK(nsdl->send_resume_registration(address, 5683, SN_NSDL_ADDRESS_TYPE_IPV4,
+                                         location, sizeof(location) - 1) == true);
+    CHECK(nsdl->_resume_id == 31);
+    CHECK(nsdl->_sn_nsdl_address.addr_len == 4);
+    CHECK(nsdl->registration_location(length) != NULL);
+    CHECK(length == sizeof(location) - 1);
+
+    sn_coap_hdr_s *coap_header = (sn_coap_hdr_s *)malloc(sizeof(sn_coap_hdr_s));
+    memset(coap_header, 0, sizeof(sn_coap_hdr_s));
+    coap_header->msg_id = 31;
+    coap_header->msg_code = COAP_MSG_CODE_RESPONSE_CHANGED;
+    observer->registered = false;
+    nsdl->received_from_server_callback(NULL, coap_header, NULL);
+    CHECK(observer->registered == true);
+    CHECK(nsdl->_resumed == true);
+
+    // The library doesn't know the registration, the update and
+    // the unregistration are sent to the location.
+    common_stub::uint_value = 32;
+    CHECK(nsdl->send_update_registration(120) == true);
+    CHECK(nsdl->_update_id == 32);
+    common_stub::uint_value = 33;
+    CHECK(nsdl->send_unregister_message() == true);
+    CHECK(nsdl->_unregister_id == 33);
+
+    coap_header->msg_id = 33;
+    coap_header->msg_code = COAP_MSG_CODE_RESPONSE_DELETED;
+    observer->unregistered = false;
+    nsdl->received_from_server_callback(NULL, coap_header, NULL);
+    CHECK(observer->unregistered == true);
+    CHECK(nsdl->_resumed == false);
+    CHECK(nsdl->registration_location(length) == NULL);
+
+    // A rejected update falls back to a full registration.
+    common_stub::uint_value = 34;
+    CHECK(nsdl->send_resume_registration(address, 5683, SN_NSDL_ADDRESS_TYPE_IPV4,
+                                         location, sizeof(location) - 1) == true);
+    coap_header->msg_id = 34;
+    coap_header->msg_code = COAP_MSG_CODE_RESPONSE_NOT_FOUND;
+    common_stub::uint_value = 35;
+    observer->registered = false;
+    nsdl->received_from_server_callback(NULL, coap_header, NULL);
+    CHECK(observer->registered == false);
+    CHECK(nsdl->_register_id == 35);
+    CHECK(nsdl->_resumed == false);
+
+    // The location of the new registration is kept.
+    uint8_t new_location[] = {"rd/77aa"};
+    coap_header->options_list_ptr = (sn_coap_options_list_s *)malloc(sizeof(sn_coap_options_list_s));
+    memset(coap_header->options_list_ptr, 0, sizeof(sn_coap_options_list_s));
+    coap_header->options_list_ptr->location_path_ptr = new_location;
+    coap_header->options_list_ptr->location_path_len = sizeof(new_location) - 1;
+    coap_header->msg_id = 35;
+    coap_header->msg_code = COAP_MSG_CODE_RESPONSE_CREATED;
+    nsdl->received_from_server_callback(NULL, coap_header, NULL);
+    CHECK(observer->registered == true);
+    const uint8_t *saved = nsdl->registration_location(length);
+    CHECK(length == sizeof(new_location) - 1);
+    CHECK(memcmp(saved, new_location, length) == 0);
+
+    free(coap_header->options_list_ptr);
+    free(coap_header);
+    free(nsdl->_nsdl_handle);
+    nsdl->_nsdl_handle = NULL;
+}
+
 void Test_M2MNsdlInterface::test_memory_alloc()
 {
     CHECK(nsdl->memory_alloc(0) == 0);
@@ -1028,6 +1112,98 @@ void Test_M2MNsdlInterface::test_process_received_data()
     common_stub::clear();
 }
 
+void Test_M2MNsdlInterface::test_schedule_execution()
+{
+    m2mtimer_stub::clear();
+#ifdef __linux__
+    M2MNsdlInterface::_clock_start -= 10;
+#else
+    M2MNsdlInterface::_clock_ticks += 10;
+#endif
+    CHECK(nsdl->coap_time() >= 10);
+
+    // Ticks every second while the observer has something pending.
+    observer->timer_delay = 1;
+    nsdl->timer_expired(M2MTimerObserver::NsdlExecution);
+    CHECK(m2mtimer_stub::start_count == 1);
+    CHECK(m2mtimer_stub::interval == 1000);
+    CHECK(m2mtimer_stub::single_shot == true);
+
+    // Sleeps while nothing is pending.
+    observer->timer_delay = 0;
+    nsdl->timer_expired(M2MTimerObserver::NsdlExecution);
+    CHECK(m2mtimer_stub::start_count == 1);
+    CHECK(nsdl->_execution_deadline == 0);
+
+    // Wakes up for the next deadline of the observer.
+    observer->timer_delay = 300;
+    nsdl->schedule_execution();
+    CHECK(m2mtimer_stub::start_count == 2);
+    CHECK(m2mtimer_stub::interval == 300000);
+    CHECK(nsdl->_execution_deadline == nsdl->coap_time() + 300);
+
+    // A later deadline doesn't postpone it, an earlier one brings it forward.
+    observer->timer_delay = 600;
+    nsdl->schedule_execution();
+    CHECK(m2mtimer_stub::start_count == 2);
+    observer->timer_delay = 5;
+    nsdl->schedule_execution();
+    CHECK(m2mtimer_stub::start_count == 3);
+    CHECK(m2mtimer_stub::interval == 5000);
+
+    // A sent message may need retransmitting.
+    uint8_t data[] = { 0x40, 0x02, 0x12, 0x34 };
+    sn_nsdl_addr_s address;
+    memset(&address, 0, sizeof(address));
+    observer->timer_delay = 1;
+    nsdl->send_to_server_callback(NULL, SN_NSDL_PROTOCOL_COAP, data, sizeof(data), &address);
+    CHECK(observer->message_ready == true);
+    CHECK(m2mtimer_stub::start_count == 4);
+    CHECK(m2mtimer_stub::interval == 1000);
+
+    // The CoAP library may resend it, also when the observer has nothing pending.
+    observer->timer_delay = 0;
+    nsdl->timer_expired(M2MTimerObserver::NsdlExecution);
+    CHECK(m2mtimer_stub::start_count == 5);
+    CHECK(m2mtimer_stub::interval == 1000);
+
+    // A received request is kept for duplicate detection.
+    nsdl->_resend_until = 0;
+    uint8_t request[] = { 0x40, 0x01, 0x12, 0x35 };
+    nsdl->process_received_data(request, sizeof(request), &address);
+    nsdl->timer_expired(M2MTimerObserver::NsdlExecution);
+    CHECK(m2mtimer_stub::start_count == 6);
+    CHECK(m2mtimer_stub::interval <= 60000);
+    CHECK(m2mtimer_stub::interval >= 59000);
+
+    // After being idle the CoAP library is brought up to date before
+    // it queues a message.
+    nsdl->_duplicate_until = 0;
+    common_stub::clear();
+#ifdef __linux__
+    M2MNsdlInterface::_clock_start -= 30;
+#else
+    M2MNsdlInterface::_clock_ticks += 30;
+#endif
+    nsdl->send_update(NULL, 0);
+    CHECK(common_stub::exec_count == 1);
+    CHECK(common_stub::exec_time == nsdl->coap_time());
+}
+
+void Test_M2MNsdlInterface::test_shared_clock()
+{
+    // An interface created later gives the CoAP library the same time.
+#ifdef __linux__
+    M2MNsdlInterface::_clock_start -= 100;
+#else
+    M2MNsdlInterface::_clock_ticks += 100;
+#endif
+    M2MNsdlInterface *other = new M2MNsdlInterface(*observer);
+    CHECK(other->coap_time() >= 100);
+    CHECK(other->coap_time() - nsdl->coap_time() <= 1);
+    delete other;
+}
+
 void Test_M2MNsdlInterface::test_stop_timers()
 {
     // Check if there is no memory leak or crash
@@ -1036,8 +1212,17 @@ void Test_M2MNsdlInterface::test_stop_timers()
 
 void Test_M2MNsdlInterface::test_timer_expired()
 {
+    // The CoAP library gets the seconds elapsed since the start.
+#ifdef __linux__
+    M2MNsdlInterface::_clock_start -= 1;
+#else
+    // Without a monotonic clock the time moves on to the deadline
+    // the timer expired at.
+    nsdl->_execution_deadline = nsdl->coap_time() + 1;
+#endif
     nsdl->timer_expired(M2MTimerObserver::NsdlExecution);
-    CHECK(nsdl->_counter_for_nsdl == 1);
+    CHECK(nsdl->_counter_for_nsdl >= 1);
+    CHECK(nsdl->coap_time() >= 1);
 
     if( nsdl->_endpoint == NULL){
         nsdl->_endpoint = (sn_nsdl_ep_parameters_s*)nsdl->memory_alloc(sizeof(sn_nsdl_ep_parameters_s));
@@ -1118,6 +1303,25 @@ void Test_M2MNsdlInterface::test_resource_to_be_deleted()
 {
     //Checking coverage for the code
     nsdl->resource_to_be_deleted("name");
+
+    // The NSDL copies of a deleted path are no longer accounted.
+    m2mbase_stub::string_value = new String("name");
+    M2MObject *object = new M2MObject("name");
+    m2mobject_stub::base_type = M2MBase::Object;
+    object->update_memory_stats(M2MMemoryStats::NsdlEntries, 100);
+    nsdl->_object_list.push_back(object);
+    nsdl->resource_to_be_deleted("name");
+    CHECK(object->memory_stats().nsdl_bytes == 0);
+
+    // Objects outliving the interface are not accounted twice when
+    // registered again.
+    object->update_memory_stats(M2MMemoryStats::NsdlEntries, 100);
+    delete nsdl;
+    nsdl = new M2MNsdlInterface(*observer);
+    CHECK(object->memory_stats().nsdl_bytes == 0);
+    delete object;
+    delete m2mbase_stub::string_value;
+    m2mbase_stub::string_value = NULL;
 }
 
 void Test_M2MNsdlInterface::test_value_updated()
@@ -1234,6 +1438,47 @@ void Test_M2MNsdlInterface::test_find_resource()
     delete object;
 }
 
+void Test_M2MNsdlInterface::test_create_nsdl_table_structure()
+{
+    String *name = new String("name");
+    m2mbase_stub::string_value = name;
+    common_stub::int_value = 0;
+    m2mobject_stub::base_type = M2MBase::ResourceTable;
+    M2MResourceTable *table = new M2MResourceTable(*name);
+
+    m2mresourcetable_stub::row_count = 2;
+    m2mresourcetable_stub::resource_id = 1;
+    m2mresourcetable_stub::operation = M2MBase::GET_ALLOWED;
+
+    M2MObjectList list;
+    list.push_back(table);
+
+    // Rows and instances are created without any object instance nodes.
+    m2mbase_stub::operation = M2MBase::GET_ALLOWED;
+    CHECK(nsdl->create_nsdl_list_structure(list) == true);
+    CHECK(m2mobject_stub::instance_list.empty() == true);
+
+    m2mbase_stub::operation = M2MBase::NOT_ALLOWED;
+    common_stub::int_value = -1;
+    CHECK(nsdl->create_nsdl_list_structure(list) == false);
+
+    // Everything below the table resolves to the table.
+    CHECK(nsdl->find_resource("name") == table);
+    CHECK(nsdl->find_resource("name/0") == table);
+    CHECK(nsdl->find_resource("name/0/1") == table);
+    CHECK(nsdl->find_resource("name1/0") == NULL);
+    CHECK(nsdl->find_resource("nam") == NULL);
+
+    list.clear();
+    nsdl->_object_list.clear();
+    delete table;
+    delete name;
+    m2mbase_stub::string_value = NULL;
+    m2mresourcetable_stub::clear();
+    m2mobject_stub::clear();
+    common_stub::clear();
+}
+
 void Test_M2MNsdlInterface::test_remove_object()
 {
     String name = "name";
@@ -44,6 +44,8 @@ public:
 
     void test_send_unregister_message();
 
+    void test_resume_registration();
+
     void test_memory_alloc();
 
     void test_memory_free();
@@ -70,6 +72,10 @@ public:
 
     void test_timer_expired();
 
+    void test_schedule_execution();
+
+    void test_shared_clock();
+
     void test_observation_to_be_sent();
 
     void test_resource_to_be_deleted();
@@ -78,6 +84,8 @@ public:
 
     void test_find_resource();
 
+    void test_create_nsdl_table_structure();
+
     void test_remove_object();
 
     void test_add_object_to_list(); //Special: Would be too difficult to test in normal ways
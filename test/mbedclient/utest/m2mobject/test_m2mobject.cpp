@@ -92,13 +92,19 @@ void Test_M2MObject::test_create_object_instance()
 
 void Test_M2MObject::test_remove_object_instance()
 {
-    M2MObjectInstance *ins = new M2MObjectInstance("name",*object);
+    String *test = new String("name");
+    m2mbase_stub::string_value = test;
+
+    M2MObjectInstance *ins = new M2MObjectInstance(*test,*object);
     object->set_instance_id(0);
     object->_instance_list.push_back(ins);
 
     CHECK(true == object->remove_object_instance(0));
 
     CHECK(false == object->remove_object_instance(0));
+
+    m2mbase_stub::string_value = NULL;
+    delete test;
 }
 
 void Test_M2MObject::test_object_instance()
@@ -57,8 +57,13 @@ public:
         visited = true;
     }
 
+    void memory_updated(M2MMemoryStats::Category category, int32_t delta) {
+        memory.update(category, delta);
+    }
+
     void clear() {visited = false;}
     bool visited;
+    M2MMemoryStats memory;
 };
 
 Test_M2MObjectInstance::Test_M2MObjectInstance()
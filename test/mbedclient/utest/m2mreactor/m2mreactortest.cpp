@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2mreactor.h"
+
+TEST_GROUP(M2MReactor)
+{
+  Test_M2MReactor* m2m_reactor;
+
+  void setup()
+  {
+    m2m_reactor = new Test_M2MReactor();
+  }
+  void teardown()
+  {
+    delete m2m_reactor;
+  }
+};
+
+TEST(M2MReactor, create)
+{
+    CHECK(m2m_reactor->reactor != NULL);
+}
+
+TEST(M2MReactor, add_remove)
+{
+    m2m_reactor->test_add_remove();
+}
+
+TEST(M2MReactor, dispatch)
+{
+    m2m_reactor->test_dispatch();
+}
+
+TEST(M2MReactor, modify)
+{
+    m2m_reactor->test_modify();
+}
+
+TEST(M2MReactor, timer)
+{
+    m2m_reactor->test_timer();
+}
+
+TEST(M2MReactor, remove_from_handler)
+{
+    m2m_reactor->test_remove_from_handler();
+}
+
+TEST(M2MReactor, many_descriptors)
+{
+    m2m_reactor->test_many_descriptors();
+}
+
+TEST(M2MReactor, shared)
+{
+    m2m_reactor->test_shared();
+}
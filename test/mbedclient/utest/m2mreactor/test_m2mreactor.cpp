@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2mreactor.h"
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/socket.h>
+
+#define DESCRIPTOR_COUNT    200
+
+class Handler : public M2MReactorHandler {
+public:
+    Handler()
+    : reactor(NULL), io_count(0), timer_count(0), last_events(0),
+      remove_on_ready(false) {}
+    ~Handler() {}
+
+    void io_ready(int fd, uint32_t events)
+    {
+        char buffer[16];
+        if(events & M2MReactor::Readable) {
+            while(recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {}
+        }
+        __atomic_store_n(&last_events, events, __ATOMIC_SEQ_CST);
+        if(remove_on_ready) {
+            reactor->remove(fd);
+        }
+        __atomic_fetch_add(&io_count, 1, __ATOMIC_SEQ_CST);
+    }
+
+    void timer_expired(int, uint64_t expirations)
+    {
+        __atomic_fetch_add(&timer_count, (uint32_t)expirations, __ATOMIC_SEQ_CST);
+    }
+
+    M2MReactor          *reactor;
+    volatile uint32_t   io_count;
+    volatile uint32_t   timer_count;
+    volatile uint32_t   last_events;
+    bool                remove_on_ready;
+};
+
+static bool wait_for(volatile uint32_t *counter, uint32_t value)
+{
+    for(int i = 0; i < 1000; i++) {
+        if(__atomic_load_n(counter, __ATOMIC_SEQ_CST) >= value) {
+            return true;
+        }
+        usleep(1000);
+    }
+    return false;
+}
+
+static uint32_t value(volatile uint32_t *counter)
+{
+    return __atomic_load_n(counter, __ATOMIC_SEQ_CST);
+}
+
+static uint32_t thread_count()
+{
+    uint32_t count = 0;
+    DIR *dir = opendir("/proc/self/task");
+    if(dir) {
+        while(readdir(dir)) {
+            count++;
+        }
+        closedir(dir);
+    }
+    return count;
+}
+
+Test_M2MReactor::Test_M2MReactor()
+{
+    reactor = new M2MReactor(2);
+}
+
+Test_M2MReactor::~Test_M2MReactor()
+{
+    delete reactor;
+}
+
+void Test_M2MReactor::test_add_remove()
+{
+    Handler handler;
+    int fds[2];
+    socketpair(AF_UNIX, SOCK_DGRAM, 0, fds);
+
+    CHECK(reactor->loop_count() == 2);
+    CHECK(reactor->add(fds[0], M2MReactor::Readable, &handler) == true);
+    CHECK(reactor->add(fds[0], M2MReactor::Readable, &handler) == false);
+    CHECK(reactor->add(-1, M2MReactor::Readable, &handler) == false);
+    CHECK(reactor->add(fds[1], M2MReactor::Readable, NULL) == false);
+    CHECK(reactor->registered() == 1);
+
+    // Descriptors are spread over the loops.
+    CHECK(reactor->add(fds[1], M2MReactor::Readable, &handler) == true);
+    CHECK(reactor->_loops[0].entry_count == 1);
+    CHECK(reactor->_loops[1].entry_count == 1);
+
+    reactor->remove(fds[0]);
+    reactor->remove(fds[1]);
+    reactor->remove(fds[1]);
+    CHECK(reactor->registered() == 0);
+    CHECK(reactor->modify(fds[0], M2MReactor::Writable) == false);
+
+    M2MReactor *clamped = new M2MReactor(0);
+    CHECK(clamped->loop_count() == 1);
+    delete clamped;
+    clamped = new M2MReactor(100);
+    CHECK(clamped->loop_count() == M2MReactor::MAX_LOOPS);
+    delete clamped;
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+void Test_M2MReactor::test_dispatch()
+{
+    Handler handler;
+    int fds[2];
+    socketpair(AF_UNIX, SOCK_DGRAM, 0, fds);
+
+    CHECK(reactor->start() == true);
+    CHECK(reactor->start() == true);
+    CHECK(reactor->add(fds[0], M2MReactor::Readable, &handler) == true);
+
+    CHECK(send(fds[1], "a", 1, 0) == 1);
+    CHECK(wait_for(&handler.io_count, 1) == true);
+    CHECK(value(&handler.last_events) == M2MReactor::Readable);
+
+    // Once removed, the handler is not called anymore.
+    reactor->remove(fds[0]);
+    uint32_t count = value(&handler.io_count);
+    CHECK(send(fds[1], "b", 1, 0) == 1);
+    usleep(20000);
+    CHECK(value(&handler.io_count) == count);
+
+    reactor->stop();
+    close(fds[0]);
+    close(fds[1]);
+}
+
+void Test_M2MReactor::test_modify()
+{
+    Handler handler;
+    int fds[2];
+    socketpair(AF_UNIX, SOCK_DGRAM, 0, fds);
+
+    CHECK(reactor->start() == true);
+    CHECK(reactor->add(fds[0], M2MReactor::Readable, &handler) == true);
+    usleep(20000);
+    CHECK(value(&handler.io_count) == 0);
+
+    // Socket is writable right away.
+    CHECK(reactor->modify(fds[0], M2MReactor::Writable) == true);
+    CHECK(wait_for(&handler.io_count, 1) == true);
+    CHECK((value(&handler.last_events) & M2MReactor::Writable) != 0);
+
+    reactor->remove(fds[0]);
+    reactor->stop();
+    close(fds[0]);
+    close(fds[1]);
+}
+
+void Test_M2MReactor::test_timer()
+{
+    Handler handler;
+    CHECK(reactor->start() == true);
+
+    int timer = reactor->add_timer(&handler);
+    CHECK(timer >= 0);
+    CHECK(reactor->start_timer(timer, 5, true) == true);
+    CHECK(wait_for(&handler.timer_count, 1) == true);
+    usleep(20000);
+    CHECK(value(&handler.timer_count) == 1);
+
+    CHECK(reactor->start_timer(timer, 2, false) == true);
+    CHECK(wait_for(&handler.timer_count, 4) == true);
+
+    // Zero interval stops the timer.
+    CHECK(reactor->start_timer(timer, 0, false) == true);
+    usleep(5000);
+    uint32_t count = value(&handler.timer_count);
+    usleep(20000);
+    CHECK(value(&handler.timer_count) == count);
+
+    reactor->remove_timer(timer);
+    CHECK(reactor->registered() == 0);
+
+    // Timers left registered are closed with the reactor.
+    CHECK(reactor->add_timer(&handler) >= 0);
+    reactor->stop();
+}
+
+void Test_M2MReactor::test_remove_from_handler()
+{
+    Handler handler;
+    handler.reactor = reactor;
+    handler.remove_on_ready = true;
+    int fds[2];
+    socketpair(AF_UNIX, SOCK_DGRAM, 0, fds);
+
+    CHECK(reactor->start() == true);
+    CHECK(reactor->add(fds[0], M2MReactor::Readable, &handler) == true);
+    CHECK(send(fds[1], "a", 1, 0) == 1);
+    CHECK(wait_for(&handler.io_count, 1) == true);
+    CHECK(reactor->registered() == 0);
+
+    CHECK(send(fds[1], "b", 1, 0) == 1);
+    usleep(20000);
+    CHECK(value(&handler.io_count) == 1);
+
+    reactor->stop();
+    close(fds[0]);
+    close(fds[1]);
+}
+
+void Test_M2MReactor::test_many_descriptors()
+{
+    Handler handler;
+    int fds[DESCRIPTOR_COUNT][2];
+
+    CHECK(reactor->start() == true);
+    uint32_t threads = thread_count();
+    for(int i = 0; i < DESCRIPTOR_COUNT; i++) {
+        socketpair(AF_UNIX, SOCK_DGRAM, 0, fds[i]);
+        CHECK(reactor->add(fds[i][0], M2MReactor::Readable, &handler) == true);
+    }
+    CHECK(reactor->registered() == DESCRIPTOR_COUNT);
+    // Thread count doesn't grow with the number of descriptors.
+    CHECK(thread_count() == threads);
+
+    for(int i = 0; i < DESCRIPTOR_COUNT; i++) {
+        CHECK(send(fds[i][1], "a", 1, 0) == 1);
+    }
+    CHECK(wait_for(&handler.io_count, DESCRIPTOR_COUNT) == true);
+
+    for(int i = 0; i < DESCRIPTOR_COUNT; i++) {
+        reactor->remove(fds[i][0]);
+        close(fds[i][0]);
+        close(fds[i][1]);
+    }
+    CHECK(reactor->registered() == 0);
+    reactor->stop();
+}
+
+void Test_M2MReactor::test_shared()
+{
+    M2MReactor *shared = M2MReactor::shared();
+    CHECK(shared != NULL);
+    CHECK(shared == M2MReactor::shared());
+    CHECK(shared->loop_count() == M2MReactor::DEFAULT_LOOPS);
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TEST_M2M_REACTOR_H
+#define TEST_M2M_REACTOR_H
+
+#include "m2mreactor.h"
+
+class Test_M2MReactor
+{
+public:
+    Test_M2MReactor();
+    virtual ~Test_M2MReactor();
+
+    void test_add_remove();
+
+    void test_dispatch();
+
+    void test_modify();
+
+    void test_timer();
+
+    void test_remove_from_handler();
+
+    void test_many_descriptors();
+
+    void test_shared();
+
+    M2MReactor* reactor;
+};
+
+#endif // TEST_M2M_REACTOR_H
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2mreceivebufferpool.h"
+
+TEST_GROUP(M2MReceiveBufferPool)
+{
+  Test_M2MReceiveBufferPool* m2m_receive_buffer_pool;
+
+  void setup()
+  {
+    m2m_receive_buffer_pool = new Test_M2MReceiveBufferPool();
+  }
+  void teardown()
+  {
+    delete m2m_receive_buffer_pool;
+  }
+};
+
+TEST(M2MReceiveBufferPool, create)
+{
+    CHECK(m2m_receive_buffer_pool->pool != NULL);
+}
+
+TEST(M2MReceiveBufferPool, acquire_release)
+{
+    m2m_receive_buffer_pool->test_acquire_release();
+}
+
+TEST(M2MReceiveBufferPool, owns)
+{
+    m2m_receive_buffer_pool->test_owns();
+}
+
+TEST(M2MReceiveBufferPool, limits)
+{
+    m2m_receive_buffer_pool->test_limits();
+}
+
+TEST(M2MReceiveBufferPool, concurrent_use)
+{
+    m2m_receive_buffer_pool->test_concurrent_use();
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2mreceivebufferpool.h"
+#include <pthread.h>
+
+#define WORKER_COUNT        4
+#define WORKER_ROUNDS       10000
+
+static void* worker(void *argument)
+{
+    M2MReceiveBufferPool *pool = (M2MReceiveBufferPool*)argument;
+    uint32_t failures = 0;
+    for(uint32_t i = 0; i < WORKER_ROUNDS; i++) {
+        uint8_t *buffer = pool->acquire();
+        if(buffer) {
+            // Buffer must not be handed to anyone else while held.
+            buffer[0] = (uint8_t)i;
+            buffer[1] = (uint8_t)i;
+            if(buffer[0] != buffer[1]) {
+                failures++;
+            }
+            pool->release(buffer);
+        }
+    }
+    return (void*)(uintptr_t)failures;
+}
+
+Test_M2MReceiveBufferPool::Test_M2MReceiveBufferPool()
+{
+    pool = new M2MReceiveBufferPool(4, 64);
+}
+
+Test_M2MReceiveBufferPool::~Test_M2MReceiveBufferPool()
+{
+    delete pool;
+}
+
+void Test_M2MReceiveBufferPool::test_acquire_release()
+{
+    CHECK(pool->buffer_size() == 64);
+    CHECK(pool->available() == 4);
+
+    uint8_t *buffers[4];
+    for(int i = 0; i < 4; i++) {
+        buffers[i] = pool->acquire();
+        CHECK(buffers[i] != NULL);
+        for(int j = 0; j < i; j++) {
+            CHECK(buffers[i] != buffers[j]);
+        }
+    }
+    CHECK(pool->available() == 0);
+    CHECK(pool->acquire() == NULL);
+
+    // Pointer into the middle of a buffer releases the whole buffer.
+    pool->release(buffers[2] + 10);
+    CHECK(pool->available() == 1);
+    CHECK(pool->acquire() == buffers[2]);
+
+    for(int i = 0; i < 4; i++) {
+        pool->release(buffers[i]);
+    }
+    CHECK(pool->available() == 4);
+}
+
+void Test_M2MReceiveBufferPool::test_owns()
+{
+    uint8_t *buffer = pool->acquire();
+    uint8_t other[8];
+
+    CHECK(pool->owns(buffer) == true);
+    CHECK(pool->owns(buffer + 63) == true);
+    CHECK(pool->owns(other) == false);
+    CHECK(pool->owns(NULL) == false);
+
+    // Foreign pointers are ignored.
+    pool->release(other);
+    pool->release(NULL);
+    CHECK(pool->available() == 3);
+
+    pool->release(buffer);
+    CHECK(pool->memory() == sizeof(M2MReceiveBufferPool) + 4 * 64);
+}
+
+void Test_M2MReceiveBufferPool::test_limits()
+{
+    M2MReceiveBufferPool *large = new M2MReceiveBufferPool(40, 16);
+    CHECK(large->available() == M2MReceiveBufferPool::MAX_BUFFERS);
+    delete large;
+
+    M2MReceiveBufferPool *empty = new M2MReceiveBufferPool(0, 16);
+    CHECK(empty->available() == 0);
+    CHECK(empty->acquire() == NULL);
+    CHECK(empty->owns(NULL) == false);
+    delete empty;
+}
+
+void Test_M2MReceiveBufferPool::test_concurrent_use()
+{
+    pthread_t threads[WORKER_COUNT];
+    for(int i = 0; i < WORKER_COUNT; i++) {
+        pthread_create(&threads[i], NULL, worker, pool);
+    }
+    uint32_t failures = 0;
+    for(int i = 0; i < WORKER_COUNT; i++) {
+        void *result = NULL;
+        pthread_join(threads[i], &result);
+        failures += (uint32_t)(uintptr_t)result;
+    }
+    CHECK(failures == 0);
+    CHECK(pool->available() == 4);
+}
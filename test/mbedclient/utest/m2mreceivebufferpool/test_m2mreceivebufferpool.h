@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TEST_M2M_RECEIVE_BUFFER_POOL_H
+#define TEST_M2M_RECEIVE_BUFFER_POOL_H
+
+#include "m2mreceivebufferpool.h"
+
+class Test_M2MReceiveBufferPool
+{
+public:
+    Test_M2MReceiveBufferPool();
+    virtual ~Test_M2MReceiveBufferPool();
+
+    void test_acquire_release();
+
+    void test_owns();
+
+    void test_limits();
+
+    void test_concurrent_use();
+
+    M2MReceiveBufferPool* pool;
+};
+
+#endif // TEST_M2M_RECEIVE_BUFFER_POOL_H
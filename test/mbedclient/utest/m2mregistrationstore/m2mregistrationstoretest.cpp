@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2mregistrationstore.h"
+
+TEST_GROUP(M2MRegistrationStore)
+{
+  Test_M2MRegistrationStore* m2m_registration_store;
+
+  void setup()
+  {
+    m2m_registration_store = new Test_M2MRegistrationStore();
+  }
+  void teardown()
+  {
+    delete m2m_registration_store;
+  }
+};
+
+TEST(M2MRegistrationStore, create)
+{
+    CHECK(m2m_registration_store->store != NULL);
+    CHECK(m2m_registration_store->store->is_registered() == false);
+    CHECK(m2m_registration_store->store->load() == false);
+}
+
+TEST(M2MRegistrationStore, save_and_load)
+{
+    m2m_registration_store->test_save_and_load();
+}
+
+TEST(M2MRegistrationStore, damaged_file)
+{
+    m2m_registration_store->test_damaged_file();
+}
+
+TEST(M2MRegistrationStore, can_resume)
+{
+    m2m_registration_store->test_can_resume();
+}
+
+TEST(M2MRegistrationStore, clear)
+{
+    m2m_registration_store->test_clear();
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2mregistrationstore.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#define STORE_PATH  "test_registration.dat"
+
+static const uint8_t LOCATION[] = { 'r', 'd', '/', '4', 'b', '2', 'c' };
+static const uint8_t ADDRESS[] = { 10, 45, 3, 83 };
+static const uint8_t SESSION[] = { 0x16, 0xfe, 0xfd, 0x01, 0x02, 0x03 };
+
+Test_M2MRegistrationStore::Test_M2MRegistrationStore()
+{
+    remove(STORE_PATH);
+    store = new M2MRegistrationStore(STORE_PATH);
+}
+
+Test_M2MRegistrationStore::~Test_M2MRegistrationStore()
+{
+    delete store;
+    remove(STORE_PATH);
+}
+
+void Test_M2MRegistrationStore::test_save_and_load()
+{
+    // Nothing to save before the first registration.
+    CHECK(store->save() == false);
+
+    CHECK(store->set_registration("endpoint", "coap://10.45.3.83:5683",
+                                  LOCATION, sizeof(LOCATION), 3600, 1000) == true);
+    store->set_server_address(ADDRESS, sizeof(ADDRESS), 5683);
+    CHECK(store->set_dtls_session(SESSION, sizeof(SESSION)) == true);
+    CHECK(store->save() == true);
+
+    // The record holds the session, only the owner may read it.
+    struct stat info;
+    CHECK(stat(STORE_PATH, &info) == 0);
+    CHECK((info.st_mode & 0777) == 0600);
+
+    M2MRegistrationStore restored(STORE_PATH);
+    CHECK(restored.load() == true);
+    CHECK(restored.is_registered() == true);
+    CHECK(restored.lifetime() == 3600);
+    CHECK(restored.registered_at() == 1000);
+
+    uint8_t length = 0;
+    const uint8_t *location = restored.location(length);
+    CHECK(length == sizeof(LOCATION));
+    CHECK(memcmp(location, LOCATION, length) == 0);
+
+    uint16_t port = 0;
+    const uint8_t *address = restored.server_address(length, port);
+    CHECK(length == sizeof(ADDRESS));
+    CHECK(port == 5683);
+    CHECK(memcmp(address, ADDRESS, length) == 0);
+
+    uint16_t session_length = 0;
+    const uint8_t *session = restored.dtls_session(session_length);
+    CHECK(session_length == sizeof(SESSION));
+    CHECK(memcmp(session, SESSION, session_length) == 0);
+
+    // An update moves the registration time and keeps the lifetime.
+    restored.registration_updated(0, 2000);
+    CHECK(restored.lifetime() == 3600);
+    CHECK(restored.registered_at() == 2000);
+    restored.registration_updated(600, 2100);
+    CHECK(restored.lifetime() == 600);
+}
+
+void Test_M2MRegistrationStore::test_damaged_file()
+{
+    CHECK(store->set_registration("endpoint", "coap://10.45.3.83:5683",
+                                  LOCATION, sizeof(LOCATION), 3600, 1000) == true);
+    CHECK(store->save() == true);
+
+    // Flip one byte of the location.
+    FILE *file = fopen(STORE_PATH, "r+b");
+    CHECK(file != NULL);
+    fseek(file, 5 + 1 + 8 + 1 + 22 + 1, SEEK_SET);
+    fputc('x', file);
+    fclose(file);
+
+    M2MRegistrationStore damaged(STORE_PATH);
+    CHECK(damaged.load() == false);
+    CHECK(damaged.is_registered() == false);
+
+    // Truncated file.
+    CHECK(store->save() == true);
+    file = fopen(STORE_PATH, "wb");
+    fputs("M2MR", file);
+    fclose(file);
+    CHECK(damaged.load() == false);
+
+    // Oversized values are refused.
+    char name[M2MRegistrationStore::MAX_NAME_LENGTH + 2];
+    memset(name, 'a', sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+    CHECK(store->set_registration(name, "coap://10.45.3.83:5683",
+                                  LOCATION, sizeof(LOCATION), 3600, 1000) == false);
+    CHECK(store->set_dtls_session(SESSION, M2MRegistrationStore::MAX_SESSION_LENGTH + 1) == false);
+}
+
+void Test_M2MRegistrationStore::test_can_resume()
+{
+    CHECK(store->can_resume("endpoint", "coap://10.45.3.83:5683", 1000) == false);
+
+    CHECK(store->set_registration("endpoint", "coap://10.45.3.83:5683",
+                                  LOCATION, sizeof(LOCATION), 3600, 1000) == true);
+    CHECK(store->can_resume("endpoint", "coap://10.45.3.83:5683", 1000) == true);
+    CHECK(store->can_resume("endpoint", "coap://10.45.3.83:5683", 4599) == true);
+
+    // Lifetime ran out.
+    CHECK(store->can_resume("endpoint", "coap://10.45.3.83:5683", 4600) == false);
+    // Clock went backwards.
+    CHECK(store->can_resume("endpoint", "coap://10.45.3.83:5683", 999) == false);
+    // Another endpoint or server.
+    CHECK(store->can_resume("other", "coap://10.45.3.83:5683", 1000) == false);
+    CHECK(store->can_resume("endpoint", "coap://10.45.3.84:5683", 1000) == false);
+    CHECK(store->can_resume(NULL, NULL, 1000) == false);
+}
+
+void Test_M2MRegistrationStore::test_clear()
+{
+    CHECK(store->set_registration("endpoint", "coap://10.45.3.83:5683",
+                                  LOCATION, sizeof(LOCATION), 3600, 1000) == true);
+    CHECK(store->set_dtls_session(SESSION, sizeof(SESSION)) == true);
+    CHECK(store->save() == true);
+
+    store->clear();
+    CHECK(store->is_registered() == false);
+    uint16_t session_length = 0;
+    CHECK(store->dtls_session(session_length) == NULL);
+    CHECK(session_length == 0);
+
+    FILE *file = fopen(STORE_PATH, "rb");
+    CHECK(file == NULL);
+
+    M2MRegistrationStore restored(STORE_PATH);
+    CHECK(restored.load() == false);
+}
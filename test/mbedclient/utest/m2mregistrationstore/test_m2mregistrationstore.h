@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TEST_M2M_REGISTRATION_STORE_H
+#define TEST_M2M_REGISTRATION_STORE_H
+
+#include "mbed-client/m2mregistrationstore.h"
+
+class Test_M2MRegistrationStore
+{
+public:
+    Test_M2MRegistrationStore();
+    virtual ~Test_M2MRegistrationStore();
+
+    void test_save_and_load();
+
+    void test_damaged_file();
+
+    void test_can_resume();
+
+    void test_clear();
+
+    M2MRegistrationStore* store;
+};
+
+#endif // TEST_M2M_REGISTRATION_STORE_H
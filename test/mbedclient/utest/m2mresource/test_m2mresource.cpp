@@ -39,8 +39,13 @@ public:
         visited = true;
     }
 
+    void memory_updated(M2MMemoryStats::Category category, int32_t delta) {
+        memory.update(category, delta);
+    }
+
     void clear() {visited = false;}
     bool visited;
+    M2MMemoryStats memory;
 };
 
 Test_M2MResource::Test_M2MResource()
@@ -81,6 +81,11 @@ TEST(M2MResourceInstance, test_set_value)
     m2m_resourceinstance->test_set_value();
 }
 
+TEST(M2MResourceInstance, test_set_value_reuses_buffer)
+{
+    m2m_resourceinstance->test_set_value_reuses_buffer();
+}
+
 TEST(M2MResourceInstance, test_get_value)
 {
     m2m_resourceinstance->test_get_value();
@@ -110,3 +115,8 @@ TEST(M2MResourceInstance, test_handle_post_request)
 {
     m2m_resourceinstance->test_handle_post_request();
 }
+
+TEST(M2MResourceInstance, test_memory_stats)
+{
+    m2m_resourceinstance->test_memory_stats();
+}
@@ -65,8 +65,13 @@ public:
         visited = true;
     }
 
+    void memory_updated(M2MMemoryStats::Category category, int32_t delta) {
+        memory.update(category, delta);
+    }
+
     void clear() {visited = false;}
     bool visited;
+    M2MMemoryStats memory;
 };
 
 
@@ -227,6 +232,28 @@ void Test_M2MResourceInstance::test_set_value()
     m2mbase_stub::report = NULL;
 }
 
+void Test_M2MResourceInstance::test_set_value_reuses_buffer()
+{
+    u_int8_t small[] = {"21"};
+    CHECK(resource_instance->set_value(small,(u_int32_t)sizeof(small)) == true);
+    CHECK(resource_instance->_value == resource_instance->_inline_value);
+    CHECK(resource_instance->_value_length == sizeof(small));
+    CHECK(memcmp(resource_instance->value(), small, sizeof(small)) == 0);
+
+    u_int8_t large[] = {"a value longer than inline storage"};
+    CHECK(resource_instance->set_value(large,(u_int32_t)sizeof(large)) == true);
+    CHECK(resource_instance->_value != resource_instance->_inline_value);
+    CHECK(resource_instance->_value_capacity == sizeof(large));
+
+    uint8_t *buffer = resource_instance->_value;
+    u_int8_t medium[] = {"shorter value, still on heap"};
+    CHECK(resource_instance->set_value(medium,(u_int32_t)sizeof(medium)) == true);
+    CHECK(resource_instance->_value == buffer);
+    CHECK(resource_instance->_value_length == sizeof(medium));
+    CHECK(resource_instance->_value[sizeof(medium)] == 0);
+    CHECK(memcmp(resource_instance->value(), medium, sizeof(medium)) == 0);
+}
+
 void Test_M2MResourceInstance::test_get_value()
 {
     u_int8_t test_value[] = {"value3"};
@@ -591,3 +618,27 @@ void Test_M2MResourceInstance::test_handle_post_request()
     m2mbase_stub::clear();
     common_stub::clear();
 }
+
+void Test_M2MResourceInstance::test_memory_stats()
+{
+    callback->memory = M2MMemoryStats();
+    CHECK(resource_instance->memory_stats().value_bytes == 0);
+
+    // Short values live inside the node.
+    u_int8_t value[32];
+    memset(value, 'a', sizeof(value));
+    resource_instance->set_value(value, 8);
+    CHECK(resource_instance->memory_stats().value_bytes == 0);
+
+    resource_instance->set_value(value, 20);
+    CHECK(resource_instance->memory_stats().value_bytes == 21);
+
+    resource_instance->set_value(value, 32);
+    CHECK(resource_instance->memory_stats().value_bytes == 33);
+
+    // Changes are passed on to the owning object instance.
+    resource_instance->update_owner_memory_stats(M2MMemoryStats::Values, 33);
+    CHECK(callback->memory.value_bytes == 33);
+    resource_instance->update_owner_memory_stats(M2MMemoryStats::Values, -33);
+    CHECK(callback->memory.total() == 0);
+}
@@ -46,6 +46,8 @@ public:
 
     void test_set_value();
 
+    void test_set_value_reuses_buffer();
+
     void test_get_value();
 
     void test_value();
@@ -58,6 +60,8 @@ public:
 
     void test_handle_post_request();
 
+    void test_memory_stats();
+
     M2MResourceInstance* resource_instance;
 
     Callback *callback;
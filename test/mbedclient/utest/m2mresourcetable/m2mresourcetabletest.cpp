@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2mresourcetable.h"
+
+TEST_GROUP(M2MResourceTable)
+{
+  Test_M2MResourceTable* m2m_table;
+
+  void setup()
+  {
+    m2m_table = new Test_M2MResourceTable();
+  }
+  void teardown()
+  {
+    delete m2m_table;
+  }
+};
+
+TEST(M2MResourceTable, Create)
+{
+    CHECK(m2m_table != NULL);
+}
+
+TEST(M2MResourceTable, add_resource)
+{
+    m2m_table->test_add_resource();
+}
+
+TEST(M2MResourceTable, set_resource_value)
+{
+    m2m_table->test_set_resource_value();
+}
+
+TEST(M2MResourceTable, instance_rows)
+{
+    m2m_table->test_instance_rows();
+}
+
+TEST(M2MResourceTable, memory_stats)
+{
+    m2m_table->test_memory_stats();
+}
+
+TEST(M2MResourceTable, const_resources)
+{
+    m2m_table->test_const_resources();
+}
+
+TEST(M2MResourceTable, handle_get_request)
+{
+    m2m_table->test_handle_get_request();
+}
+
+TEST(M2MResourceTable, handle_put_request)
+{
+    m2m_table->test_handle_put_request();
+}
+
+TEST(M2MResourceTable, handle_post_request)
+{
+    m2m_table->test_handle_post_request();
+}
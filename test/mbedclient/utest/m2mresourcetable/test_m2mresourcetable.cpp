@@ -0,0 +1,384 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2mresourcetable.h"
+#include "m2mconstants.h"
+#include "m2mtlvserializer_stub.h"
+#include "m2mbase_stub.h"
+#include "common_stub.h"
+
+class Handler : public M2MObservationHandler {
+
+public:
+
+    Handler(){}
+    ~Handler(){}
+    void observation_to_be_sent(M2MBase *){
+        visited = true;
+    }
+    void resource_to_be_deleted(const String &){visited=true;}
+    void remove_object(M2MBase *){visited = true;}
+    void value_updated(M2MBase *){visited = true;}
+
+    void clear() {visited = false;}
+    bool visited;
+};
+
+Test_M2MResourceTable::Test_M2MResourceTable()
+{
+    handler = new Handler();
+    handler->clear();
+    m2mbase_stub::clear();
+    m2mbase_stub::string_value = new String("name");
+    table = new M2MResourceTable("name");
+}
+
+Test_M2MResourceTable::~Test_M2MResourceTable()
+{
+    delete table;
+    delete m2mbase_stub::string_value;
+    m2mbase_stub::clear();
+    m2mtlvserializer_stub::clear();
+    common_stub::clear();
+    delete handler;
+}
+
+void Test_M2MResourceTable::test_add_resource()
+{
+    uint8_t value[] = {"value"};
+    uint32_t length = 0;
+
+    CHECK(table->add_resource(1, 5, M2MResourceInstance::STRING,
+                              M2MBase::GET_ALLOWED, value, 5) == true);
+    CHECK(table->add_resource(0, 7, M2MResourceInstance::INTEGER,
+                              M2MBase::GET_PUT_ALLOWED) == true);
+    CHECK(table->add_resource(0, 300, M2MResourceInstance::STRING,
+                              M2MBase::GET_ALLOWED, value, 3) == true);
+    // Duplicate row is rejected.
+    CHECK(table->add_resource(1, 5, M2MResourceInstance::STRING,
+                              M2MBase::GET_ALLOWED, value, 5) == false);
+
+    // Rows are kept sorted by instance and resource id.
+    CHECK(table->row_count() == 3);
+    CHECK(table->row_instance_id(0) == 0);
+    CHECK(table->row_resource_id(0) == 7);
+    CHECK(table->row_resource_id(1) == 300);
+    CHECK(table->row_instance_id(2) == 1);
+    CHECK(table->row_type(0) == M2MResourceInstance::INTEGER);
+    CHECK(table->row_operation(0) == M2MBase::GET_PUT_ALLOWED);
+
+    CHECK(table->find_row(1, 5) == 2);
+    CHECK(table->find_row(1, 6) == -1);
+
+    const uint8_t *ret = table->resource_value(1, 5, length);
+    CHECK(length == 5);
+    CHECK(memcmp(ret, value, 5) == 0);
+    table->resource_value(0, 7, length);
+    CHECK(length == 0);
+    CHECK(table->resource_value(2, 0, length) == NULL);
+
+    // Grows past the initial row capacity.
+    for(uint16_t i = 0; i < 40; i++) {
+        CHECK(table->add_resource(2, i, M2MResourceInstance::STRING,
+                                  M2MBase::GET_ALLOWED, value, 5) == true);
+    }
+    CHECK(table->row_count() == 43);
+    ret = table->resource_value(1, 5, length);
+    CHECK(memcmp(ret, value, 5) == 0);
+}
+
+void Test_M2MResourceTable::test_set_resource_value()
+{
+    uint8_t value[] = {"value"};
+    uint8_t longer[] = {"a considerably longer value"};
+    uint32_t length = 0;
+
+    CHECK(table->set_resource_value(0, 0, value, 5) == false);
+
+    table->add_resource(0, 0, M2MResourceInstance::STRING, M2MBase::GET_ALLOWED, value, 5);
+    table->add_resource(0, 1, M2MResourceInstance::STRING, M2MBase::GET_ALLOWED, value, 5);
+
+    // Shorter value is updated in place.
+    uint32_t offset = table->_value_offsets[0];
+    CHECK(table->set_resource_value(0, 0, value, 2) == true);
+    CHECK(table->_value_offsets[0] == offset);
+    table->resource_value(0, 0, length);
+    CHECK(length == 2);
+
+    // Longer value moves to the end of the heap.
+    CHECK(table->set_resource_value(0, 0, longer, sizeof(longer)) == true);
+    CHECK(table->_value_offsets[0] != offset);
+    CHECK(table->_heap_garbage == 5);
+    const uint8_t *ret = table->resource_value(0, 0, length);
+    CHECK(length == sizeof(longer));
+    CHECK(memcmp(ret, longer, sizeof(longer)) == 0);
+
+    // Running out of heap compacts the values in row order.
+    for(int i = 0; i < 10; i++) {
+        CHECK(table->set_resource_value(0, 1, longer, sizeof(longer) - 9 + i) == true);
+    }
+    ret = table->resource_value(0, 0, length);
+    CHECK(memcmp(ret, longer, sizeof(longer)) == 0);
+    ret = table->resource_value(0, 1, length);
+    CHECK(length == sizeof(longer));
+    CHECK(memcmp(ret, longer, sizeof(longer)) == 0);
+    CHECK(table->_heap_size - table->_heap_garbage == 2 * sizeof(longer));
+
+    CHECK(table->set_resource_value(0, 1, NULL, 0) == true);
+    table->resource_value(0, 1, length);
+    CHECK(length == 0);
+}
+
+void Test_M2MResourceTable::test_instance_rows()
+{
+    uint32_t first_row = 0;
+    CHECK(table->instance_rows(0, first_row) == 0);
+
+    table->add_resource(3, 0, M2MResourceInstance::STRING, M2MBase::GET_ALLOWED);
+    table->add_resource(1, 1, M2MResourceInstance::STRING, M2MBase::GET_ALLOWED);
+    table->add_resource(1, 0, M2MResourceInstance::STRING, M2MBase::GET_ALLOWED);
+    table->add_resource(3, 2, M2MResourceInstance::STRING, M2MBase::GET_ALLOWED);
+
+    CHECK(table->instance_rows(1, first_row) == 2);
+    CHECK(first_row == 0);
+    CHECK(table->instance_rows(3, first_row) == 2);
+    CHECK(first_row == 2);
+    CHECK(table->instance_rows(2, first_row) == 0);
+}
+
+void Test_M2MResourceTable::test_memory_stats()
+{
+    uint8_t value[] = {"value"};
+    table->add_resource(0, 0, M2MResourceInstance::STRING, M2MBase::GET_ALLOWED, value, 5);
+
+    const M2MMemoryStats &stats = table->_table_memory;
+    CHECK(stats.node_bytes == table->_row_count * 14);
+    CHECK(stats.value_bytes == 5);
+    CHECK(stats.node_bytes + stats.container_slack_bytes ==
+          table->_row_capacity * 14 + table->_heap_capacity - 5);
+
+    table->set_resource_value(0, 0, value, 6);
+    CHECK(stats.value_bytes == 6);
+    CHECK(stats.node_bytes + stats.value_bytes + stats.container_slack_bytes ==
+          table->_row_capacity * 14 + table->_heap_capacity);
+}
+
+static const uint8_t manufacturer[] = {"ARM"};
+static const uint8_t model[] = {"Model 1"};
+
+static const M2MResourceTable::ConstResource const_resources[] = {
+    { 0, 0, M2MResourceInstance::STRING, manufacturer, sizeof(manufacturer) - 1 },
+    { 0, 1, M2MResourceInstance::STRING, model, sizeof(model) - 1 },
+    { 1, 0, M2MResourceInstance::STRING, manufacturer, sizeof(manufacturer) - 1 }
+};
+
+void Test_M2MResourceTable::test_const_resources()
+{
+    uint32_t length = 0;
+    uint32_t first_row = 0;
+    M2MResourceTable *const_table = new M2MResourceTable("name", const_resources, 3);
+
+    CHECK(const_table->row_count() == 3);
+    CHECK(const_table->find_row(0, 1) == 1);
+    CHECK(const_table->find_row(1, 1) == -1);
+    CHECK(const_table->instance_rows(1, first_row) == 1);
+    CHECK(first_row == 2);
+    CHECK(const_table->row_type(1) == M2MResourceInstance::STRING);
+    CHECK(const_table->row_operation(1) == M2MBase::GET_ALLOWED);
+
+    // Values are read straight from the definitions.
+    CHECK(const_table->resource_value(0, 1, length) == model);
+    CHECK(length == sizeof(model) - 1);
+    CHECK(const_table->_value_heap == NULL);
+    CHECK(const_table->_keys == NULL);
+
+    // Read-only table can't be modified.
+    CHECK(const_table->add_resource(2, 0, M2MResourceInstance::STRING,
+                                    M2MBase::GET_ALLOWED) == false);
+    CHECK(const_table->set_resource_value(0, 0, model, 3) == false);
+    CHECK(const_table->resource_value(0, 0, length) == manufacturer);
+
+    sn_coap_hdr_s *coap_header = (sn_coap_hdr_s *)malloc(sizeof(sn_coap_hdr_s));
+    memset(coap_header, 0, sizeof(sn_coap_hdr_s));
+    coap_header->msg_code = COAP_MSG_CODE_REQUEST_GET;
+    common_stub::coap_header = (sn_coap_hdr_ *)malloc(sizeof(sn_coap_hdr_));
+    memset(common_stub::coap_header,0,sizeof(sn_coap_hdr_));
+
+    uint8_t path[] = {"name/0/1"};
+    coap_header->uri_path_ptr = path;
+    coap_header->uri_path_len = sizeof(path) - 1;
+    CHECK(const_table->handle_get_request(NULL,coap_header,handler) != NULL);
+    CHECK(common_stub::coap_header->payload_ptr == model);
+    free(common_stub::coap_header->options_list_ptr->max_age_ptr);
+    free(common_stub::coap_header->options_list_ptr);
+    free(common_stub::coap_header);
+    common_stub::coap_header = NULL;
+    free(coap_header);
+
+    delete const_table;
+}
+
+void Test_M2MResourceTable::test_handle_get_request()
+{
+    uint8_t value[] = {"value"};
+    table->add_resource(0, 1, M2MResourceInstance::STRING, M2MBase::GET_ALLOWED, value, 5);
+    table->add_resource(0, 2, M2MResourceInstance::STRING, M2MBase::PUT_ALLOWED, value, 5);
+
+    sn_coap_hdr_s *coap_header = (sn_coap_hdr_s *)malloc(sizeof(sn_coap_hdr_s));
+    memset(coap_header, 0, sizeof(sn_coap_hdr_s));
+    coap_header->msg_code = COAP_MSG_CODE_REQUEST_GET;
+
+    common_stub::coap_header = (sn_coap_hdr_ *)malloc(sizeof(sn_coap_hdr_));
+    memset(common_stub::coap_header,0,sizeof(sn_coap_hdr_));
+
+    CHECK(table->handle_get_request(NULL,NULL,handler) == NULL);
+
+    // Single resource is returned straight from the value heap.
+    uint8_t resource_path[] = {"name/0/1"};
+    coap_header->uri_path_ptr = resource_path;
+    coap_header->uri_path_len = sizeof(resource_path) - 1;
+    CHECK(table->handle_get_request(NULL,coap_header,handler) != NULL);
+    CHECK(common_stub::coap_header->payload_len == 5);
+    CHECK(memcmp(common_stub::coap_header->payload_ptr, value, 5) == 0);
+    CHECK(common_stub::coap_header->content_type_ptr == NULL);
+    free(common_stub::coap_header->options_list_ptr->max_age_ptr);
+    free(common_stub::coap_header->options_list_ptr);
+    memset(common_stub::coap_header,0,sizeof(sn_coap_hdr_));
+
+    // Resource without GET access.
+    uint8_t put_path[] = {"name/0/2"};
+    coap_header->uri_path_ptr = put_path;
+    coap_header->uri_path_len = sizeof(put_path) - 1;
+    CHECK(table->handle_get_request(NULL,coap_header,handler) != NULL);
+    CHECK(common_stub::coap_header->payload_ptr == NULL);
+
+    // Instance is encoded as TLV.
+    m2mbase_stub::operation = M2MBase::GET_ALLOWED;
+    m2mtlvserializer_stub::uint8_value = (uint8_t*)malloc(1);
+    uint8_t instance_path[] = {"name/0"};
+    coap_header->uri_path_ptr = instance_path;
+    coap_header->uri_path_len = sizeof(instance_path) - 1;
+    CHECK(table->handle_get_request(NULL,coap_header,handler) != NULL);
+    CHECK(common_stub::coap_header->payload_ptr == m2mtlvserializer_stub::uint8_value);
+    CHECK(*common_stub::coap_header->content_type_ptr == COAP_CONTENT_OMA_TLV_TYPE);
+    free(common_stub::coap_header->content_type_ptr);
+    free(common_stub::coap_header->options_list_ptr->max_age_ptr);
+    free(common_stub::coap_header->options_list_ptr);
+    memset(common_stub::coap_header,0,sizeof(sn_coap_hdr_));
+
+    // Whole table.
+    uint8_t object_path[] = {"name"};
+    coap_header->uri_path_ptr = object_path;
+    coap_header->uri_path_len = sizeof(object_path) - 1;
+    CHECK(table->handle_get_request(NULL,coap_header,handler) != NULL);
+    CHECK(common_stub::coap_header->payload_ptr == m2mtlvserializer_stub::uint8_value);
+    free(common_stub::coap_header->content_type_ptr);
+    free(common_stub::coap_header->options_list_ptr->max_age_ptr);
+    free(common_stub::coap_header->options_list_ptr);
+    memset(common_stub::coap_header,0,sizeof(sn_coap_hdr_));
+    free(m2mtlvserializer_stub::uint8_value);
+    m2mtlvserializer_stub::uint8_value = NULL;
+
+    // Unknown instance and malformed paths are rejected without payload.
+    uint8_t missing_path[] = {"name/4"};
+    coap_header->uri_path_ptr = missing_path;
+    coap_header->uri_path_len = sizeof(missing_path) - 1;
+    CHECK(table->handle_get_request(NULL,coap_header,handler) != NULL);
+    CHECK(common_stub::coap_header->payload_ptr == NULL);
+
+    uint8_t invalid_path[] = {"name/a/1"};
+    coap_header->uri_path_ptr = invalid_path;
+    coap_header->uri_path_len = sizeof(invalid_path) - 1;
+    CHECK(table->handle_get_request(NULL,coap_header,handler) != NULL);
+    CHECK(common_stub::coap_header->payload_ptr == NULL);
+
+    uint8_t other_path[] = {"other/0/1"};
+    coap_header->uri_path_ptr = other_path;
+    coap_header->uri_path_len = sizeof(other_path) - 1;
+    CHECK(table->handle_get_request(NULL,coap_header,handler) != NULL);
+    CHECK(common_stub::coap_header->payload_ptr == NULL);
+
+    free(common_stub::coap_header);
+    common_stub::coap_header = NULL;
+    free(coap_header);
+}
+
+void Test_M2MResourceTable::test_handle_put_request()
+{
+    uint8_t value[] = {"value"};
+    uint8_t payload[] = {"updated"};
+    uint32_t length = 0;
+    table->add_resource(0, 1, M2MResourceInstance::STRING, M2MBase::GET_PUT_ALLOWED, value, 5);
+    table->add_resource(0, 2, M2MResourceInstance::STRING, M2MBase::GET_ALLOWED, value, 5);
+
+    sn_coap_hdr_s *coap_header = (sn_coap_hdr_s *)malloc(sizeof(sn_coap_hdr_s));
+    memset(coap_header, 0, sizeof(sn_coap_hdr_s));
+    coap_header->msg_code = COAP_MSG_CODE_REQUEST_PUT;
+    coap_header->payload_ptr = payload;
+    coap_header->payload_len = sizeof(payload) - 1;
+
+    common_stub::coap_header = (sn_coap_hdr_ *)malloc(sizeof(sn_coap_hdr_));
+    memset(common_stub::coap_header,0,sizeof(sn_coap_hdr_));
+
+    CHECK(table->handle_put_request(NULL,NULL,handler) == NULL);
+
+    uint8_t path[] = {"name/0/1"};
+    coap_header->uri_path_ptr = path;
+    coap_header->uri_path_len = sizeof(path) - 1;
+    CHECK(table->handle_put_request(NULL,coap_header,handler) != NULL);
+    CHECK(handler->visited == true);
+    const uint8_t *ret = table->resource_value(0, 1, length);
+    CHECK(length == sizeof(payload) - 1);
+    CHECK(memcmp(ret, payload, length) == 0);
+
+    // Resource without PUT access keeps its value.
+    handler->clear();
+    uint8_t read_only_path[] = {"name/0/2"};
+    coap_header->uri_path_ptr = read_only_path;
+    coap_header->uri_path_len = sizeof(read_only_path) - 1;
+    CHECK(table->handle_put_request(NULL,coap_header,handler) != NULL);
+    CHECK(handler->visited == false);
+    ret = table->resource_value(0, 2, length);
+    CHECK(memcmp(ret, value, length) == 0);
+
+    // Instances can't be written.
+    uint8_t instance_path[] = {"name/0"};
+    coap_header->uri_path_ptr = instance_path;
+    coap_header->uri_path_len = sizeof(instance_path) - 1;
+    CHECK(table->handle_put_request(NULL,coap_header,handler) != NULL);
+    CHECK(handler->visited == false);
+
+    free(common_stub::coap_header);
+    common_stub::coap_header = NULL;
+    free(coap_header);
+}
+
+void Test_M2MResourceTable::test_handle_post_request()
+{
+    sn_coap_hdr_s *coap_header = (sn_coap_hdr_s *)malloc(sizeof(sn_coap_hdr_s));
+    memset(coap_header, 0, sizeof(sn_coap_hdr_s));
+    coap_header->msg_code = COAP_MSG_CODE_REQUEST_POST;
+
+    common_stub::coap_header = (sn_coap_hdr_ *)malloc(sizeof(sn_coap_hdr_));
+    memset(common_stub::coap_header,0,sizeof(sn_coap_hdr_));
+
+    CHECK(table->handle_post_request(NULL,NULL,handler) == NULL);
+    CHECK(table->handle_post_request(NULL,coap_header,handler) != NULL);
+
+    free(common_stub::coap_header);
+    common_stub::coap_header = NULL;
+    free(coap_header);
+}
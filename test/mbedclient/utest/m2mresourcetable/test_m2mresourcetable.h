@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TEST_M2M_RESOURCE_TABLE_H
+#define TEST_M2M_RESOURCE_TABLE_H
+
+#include "m2mresourcetable.h"
+
+class Handler;
+
+class Test_M2MResourceTable
+{
+public:
+    Test_M2MResourceTable();
+    virtual ~Test_M2MResourceTable();
+
+    void test_add_resource();
+
+    void test_set_resource_value();
+
+    void test_instance_rows();
+
+    void test_memory_stats();
+
+    void test_const_resources();
+
+    void test_handle_get_request();
+
+    void test_handle_put_request();
+
+    void test_handle_post_request();
+
+    M2MResourceTable* table;
+
+    Handler*    handler;
+};
+
+#endif // TEST_M2M_RESOURCE_TABLE_H
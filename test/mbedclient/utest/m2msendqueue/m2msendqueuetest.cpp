@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2msendqueue.h"
+
+TEST_GROUP(M2MSendQueue)
+{
+  Test_M2MSendQueue* m2m_send_queue;
+
+  void setup()
+  {
+    m2m_send_queue = new Test_M2MSendQueue();
+  }
+  void teardown()
+  {
+    delete m2m_send_queue;
+  }
+};
+
+TEST(M2MSendQueue, create)
+{
+    CHECK(m2m_send_queue->queue != NULL);
+    CHECK(m2m_send_queue->queue->count() == 0);
+}
+
+TEST(M2MSendQueue, classify)
+{
+    m2m_send_queue->test_classify();
+}
+
+TEST(M2MSendQueue, priorities)
+{
+    m2m_send_queue->test_priorities();
+}
+
+TEST(M2MSendQueue, in_flight_limit)
+{
+    m2m_send_queue->test_in_flight_limit();
+}
+
+TEST(M2MSendQueue, retransmission)
+{
+    m2m_send_queue->test_retransmission();
+}
+
+TEST(M2MSendQueue, superseded_notification)
+{
+    m2m_send_queue->test_superseded_notification();
+}
+
+TEST(M2MSendQueue, full_queue)
+{
+    m2m_send_queue->test_full_queue();
+}
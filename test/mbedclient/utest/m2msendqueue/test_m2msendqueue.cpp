@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2msendqueue.h"
+#include <string.h>
+
+#define QUEUE_SIZE      4
+#define NSTART          1
+#define TIMEOUT         10
+
+// Confirmable POST, as sent for a registration.
+static const uint8_t con_request[] = { 0x41, 0x02, 0x00, 0x01, 0xA1 };
+// Confirmable 2.05 notification with an Observe option.
+static const uint8_t con_notification[] = { 0x41, 0x45, 0x00, 0x02, 0xB1, 0x61, 0x01 };
+static const uint8_t non_notification[] = { 0x51, 0x45, 0x00, 0x03, 0xB1, 0x61, 0x02 };
+// Non-confirmable 2.05 with a Content-Format option only.
+static const uint8_t non_response[] = { 0x51, 0x45, 0x00, 0x04, 0xC1, 0xC0 };
+// Piggybacked response.
+static const uint8_t ack[] = { 0x61, 0x45, 0x12, 0x34, 0xD1 };
+static const uint8_t ack_for_request[] = { 0x60, 0x44, 0x00, 0x01 };
+
+static uint16_t message_id(const uint8_t *data)
+{
+    return (data[2] << 8) | data[3];
+}
+
+Test_M2MSendQueue::Test_M2MSendQueue()
+{
+    queue = new M2MSendQueue(QUEUE_SIZE, NSTART, TIMEOUT);
+    address_data[0] = 127;
+    address_data[1] = 0;
+    address_data[2] = 0;
+    address_data[3] = 1;
+    memset(&address, 0, sizeof(address));
+    address.type = SN_NSDL_ADDRESS_TYPE_IPV4;
+    address.addr_len = 4;
+    address.addr_ptr = address_data;
+    address.port = 5683;
+}
+
+Test_M2MSendQueue::~Test_M2MSendQueue()
+{
+    delete queue;
+}
+
+void Test_M2MSendQueue::test_classify()
+{
+    CHECK(M2MSendQueue::classify(ack, sizeof(ack)) == M2MSendQueue::Control);
+    CHECK(M2MSendQueue::classify(con_request, sizeof(con_request)) == M2MSendQueue::Registration);
+    CHECK(M2MSendQueue::classify(non_response, sizeof(non_response)) == M2MSendQueue::Response);
+    CHECK(M2MSendQueue::classify(con_notification, sizeof(con_notification)) == M2MSendQueue::Notification);
+
+    // Observe behind an extended option delta isn't mistaken for one.
+    const uint8_t extended[] = { 0x50, 0x45, 0x00, 0x05, 0xD0, 0x00 };
+    CHECK(M2MSendQueue::classify(extended, sizeof(extended)) == M2MSendQueue::Response);
+    const uint8_t truncated[] = { 0x50, 0x45, 0x00, 0x05, 0xE0, 0x00 };
+    CHECK(M2MSendQueue::classify(truncated, sizeof(truncated)) == M2MSendQueue::Response);
+
+    const uint8_t wrong_version[] = { 0x81, 0x45, 0x00, 0x05, 0x01 };
+    CHECK(M2MSendQueue::classify(wrong_version, sizeof(wrong_version)) == M2MSendQueue::PRIORITY_COUNT);
+    CHECK(M2MSendQueue::classify(con_request, 3) == M2MSendQueue::PRIORITY_COUNT);
+    CHECK(M2MSendQueue::classify(con_request, 4) == M2MSendQueue::PRIORITY_COUNT);
+    CHECK(M2MSendQueue::classify(NULL, 0) == M2MSendQueue::PRIORITY_COUNT);
+    CHECK(!queue->enqueue(con_request, 3, &address));
+    CHECK(!queue->enqueue(con_request, sizeof(con_request), NULL));
+}
+
+void Test_M2MSendQueue::test_priorities()
+{
+    uint16_t length = 0;
+    sn_nsdl_addr_s *to = NULL;
+    CHECK(queue->enqueue(non_notification, sizeof(non_notification), &address));
+    CHECK(queue->enqueue(non_response, sizeof(non_response), &address));
+    CHECK(queue->enqueue(con_request, sizeof(con_request), &address));
+    CHECK(queue->enqueue(ack, sizeof(ack), &address));
+    CHECK(queue->count() == 4);
+
+    const uint8_t *message = queue->front(length, to);
+    CHECK(message != NULL);
+    CHECK(length == sizeof(ack));
+    CHECK(memcmp(message, ack, length) == 0);
+    CHECK(to != NULL);
+    CHECK(to->port == 5683);
+    CHECK(to->addr_len == 4);
+    CHECK(memcmp(to->addr_ptr, address_data, 4) == 0);
+    queue->sent();
+    CHECK(message_id(queue->front(length, to)) == message_id(con_request));
+    queue->sent();
+    CHECK(message_id(queue->front(length, to)) == message_id(non_response));
+    queue->sent();
+    CHECK(message_id(queue->front(length, to)) == message_id(non_notification));
+    queue->sent();
+    CHECK(queue->front(length, to) == NULL);
+    CHECK(length == 0);
+    CHECK(to == NULL);
+    CHECK(queue->stats().sent == 4);
+    CHECK(queue->stats().largest_depth == 4);
+
+    // Calling sent() without a front message is harmless.
+    queue->sent();
+    CHECK(queue->stats().sent == 4);
+}
+
+void Test_M2MSendQueue::test_in_flight_limit()
+{
+    uint16_t length = 0;
+    sn_nsdl_addr_s *to = NULL;
+    CHECK(queue->enqueue(con_request, sizeof(con_request), &address));
+    CHECK(queue->enqueue(con_notification, sizeof(con_notification), &address));
+    CHECK(queue->enqueue(non_response, sizeof(non_response), &address));
+
+    queue->tick(100);
+    CHECK(message_id(queue->front(length, to)) == message_id(con_request));
+    queue->sent();
+    CHECK(queue->in_flight() == 1);
+
+    // The confirmable notification waits, the non-confirmable goes.
+    CHECK(message_id(queue->front(length, to)) == message_id(non_response));
+    queue->sent();
+    CHECK(queue->front(length, to) == NULL);
+    CHECK(queue->count() == 1);
+
+    // Acknowledgement releases the next one.
+    queue->message_received(ack, sizeof(ack));
+    CHECK(queue->in_flight() == 1);
+    queue->message_received(ack_for_request, sizeof(ack_for_request));
+    CHECK(queue->in_flight() == 0);
+    CHECK(message_id(queue->front(length, to)) == message_id(con_notification));
+    queue->sent();
+    CHECK(queue->in_flight() == 1);
+
+    // Unacknowledged exchange times out.
+    CHECK(queue->enqueue(con_request, sizeof(con_request), &address));
+    queue->tick(100 + TIMEOUT - 1);
+    CHECK(queue->front(length, to) == NULL);
+    queue->tick(100 + TIMEOUT);
+    CHECK(queue->in_flight() == 0);
+    CHECK(queue->stats().in_flight_timeouts == 1);
+    CHECK(queue->front(length, to) != NULL);
+
+    queue->clear();
+    CHECK(queue->count() == 0);
+    CHECK(queue->in_flight() == 0);
+}
+
+void Test_M2MSendQueue::test_retransmission()
+{
+    uint16_t length = 0;
+    sn_nsdl_addr_s *to = NULL;
+    CHECK(queue->enqueue(con_request, sizeof(con_request), &address));
+    // A copy of a message still queued is dropped.
+    CHECK(!queue->enqueue(con_request, sizeof(con_request), &address));
+    CHECK(queue->count() == 1);
+    queue->front(length, to);
+    queue->sent();
+
+    // The retransmission of the message in flight isn't held back and
+    // goes before the notification.
+    CHECK(queue->enqueue(non_notification, sizeof(non_notification), &address));
+    CHECK(queue->enqueue(con_request, sizeof(con_request), &address));
+    CHECK(message_id(queue->front(length, to)) == message_id(con_request));
+    queue->sent();
+    CHECK(queue->in_flight() == 1);
+    CHECK(message_id(queue->front(length, to)) == message_id(non_notification));
+}
+
+void Test_M2MSendQueue::test_superseded_notification()
+{
+    uint16_t length = 0;
+    sn_nsdl_addr_s *to = NULL;
+    const uint8_t newer[] = { 0x51, 0x45, 0x00, 0x06, 0xB1, 0x61, 0x03 };
+    const uint8_t other_observation[] = { 0x51, 0x45, 0x00, 0x07, 0xB2, 0x61, 0x03 };
+    CHECK(queue->enqueue(non_notification, sizeof(non_notification), &address));
+    CHECK(queue->enqueue(other_observation, sizeof(other_observation), &address));
+    CHECK(queue->enqueue(newer, sizeof(newer), &address));
+    CHECK(queue->count() == 2);
+    CHECK(queue->stats().superseded == 1);
+    CHECK(message_id(queue->front(length, to)) == message_id(other_observation));
+    queue->sent();
+    CHECK(message_id(queue->front(length, to)) == message_id(newer));
+
+    // The one being sent isn't replaced under the caller.
+    const uint8_t newest[] = { 0x51, 0x45, 0x00, 0x08, 0xB1, 0x61, 0x04 };
+    CHECK(queue->enqueue(newest, sizeof(newest), &address));
+    CHECK(queue->count() == 2);
+    queue->sent();
+    CHECK(message_id(queue->front(length, to)) == message_id(newest));
+}
+
+void Test_M2MSendQueue::test_full_queue()
+{
+    uint16_t length = 0;
+    sn_nsdl_addr_s *to = NULL;
+    uint8_t notification[] = { 0x51, 0x45, 0x00, 0x10, 0x00, 0x61, 0x01 };
+    for(uint8_t i = 0; i < QUEUE_SIZE; i++) {
+        notification[3] = 0x10 + i;
+        notification[4] = i;
+        CHECK(queue->enqueue(notification, sizeof(notification), &address));
+    }
+    // Registration request pushes out the oldest notification.
+    CHECK(queue->enqueue(con_request, sizeof(con_request), &address));
+    CHECK(queue->count() == QUEUE_SIZE);
+    CHECK(queue->stats().dropped == 1);
+    CHECK(message_id(queue->front(length, to)) == message_id(con_request));
+    queue->sent();
+    CHECK(message_id(queue->front(length, to)) == 0x11);
+
+    // Nothing less important left to drop.
+    CHECK(queue->enqueue(ack, sizeof(ack), &address));
+    CHECK(queue->enqueue(ack, sizeof(ack), &address));
+    CHECK(queue->enqueue(ack, sizeof(ack), &address));
+    CHECK(queue->count() == QUEUE_SIZE);
+    const uint8_t next_request[] = { 0x41, 0x02, 0x00, 0x09, 0xA2 };
+    CHECK(!queue->enqueue(next_request, sizeof(next_request), &address));
+    CHECK(queue->stats().dropped == 4);
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TEST_M2M_SEND_QUEUE_H
+#define TEST_M2M_SEND_QUEUE_H
+
+#include "include/m2msendqueue.h"
+
+class Test_M2MSendQueue
+{
+public:
+    Test_M2MSendQueue();
+    virtual ~Test_M2MSendQueue();
+
+    void test_classify();
+
+    void test_priorities();
+
+    void test_in_flight_limit();
+
+    void test_retransmission();
+
+    void test_superseded_notification();
+
+    void test_full_queue();
+
+    M2MSendQueue* queue;
+    sn_nsdl_addr_s address;
+    uint8_t address_data[4];
+};
+
+#endif // TEST_M2M_SEND_QUEUE_H
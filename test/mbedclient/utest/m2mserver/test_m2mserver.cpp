@@ -31,6 +31,9 @@ public:
         visited = true;
     }
 
+    void memory_updated(M2MMemoryStats::Category, int32_t) {
+    }
+
     void clear() {visited = false;}
     bool visited;
 };
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2mstringpool.h"
+
+TEST_GROUP(M2MStringPool)
+{
+  Test_M2MStringPool* m2m_string_pool;
+
+  void setup()
+  {
+    m2m_string_pool = new Test_M2MStringPool();
+  }
+  void teardown()
+  {
+    delete m2m_string_pool;
+  }
+};
+
+TEST(M2MStringPool, acquire)
+{
+    m2m_string_pool->test_acquire();
+}
+
+TEST(M2MStringPool, release)
+{
+    m2m_string_pool->test_release();
+}
+
+TEST(M2MStringPool, grow)
+{
+    m2m_string_pool->test_grow();
+}
+
+TEST(M2MStringPool, memory)
+{
+    m2m_string_pool->test_memory();
+}
+
+TEST(M2MStringPool, bytes)
+{
+    m2m_string_pool->test_bytes();
+}
+
+TEST(M2MStringPool, threads)
+{
+    m2m_string_pool->test_threads();
+}
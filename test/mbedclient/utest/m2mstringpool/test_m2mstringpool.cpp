@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2mstringpool.h"
+#include <stdio.h>
+#include <pthread.h>
+
+static void* acquire_and_release(void *)
+{
+    char buffer[10];
+    for(int i = 0; i < 2000; i++) {
+        snprintf(buffer, sizeof(buffer), "value%d", i % 40);
+        M2MStringPool::Handle handle = M2MStringPool::acquire(String(buffer));
+        const char *bytes = M2MStringPool::acquire_bytes(String(buffer));
+        M2MStringPool::release(handle);
+        M2MStringPool::release_bytes(bytes);
+    }
+    return NULL;
+}
+
+Test_M2MStringPool::Test_M2MStringPool()
+{
+}
+
+Test_M2MStringPool::~Test_M2MStringPool()
+{
+}
+
+void Test_M2MStringPool::test_acquire()
+{
+    CHECK(M2MStringPool::acquire("") == M2MStringPool::EMPTY);
+    CHECK(M2MStringPool::string(M2MStringPool::EMPTY).empty() == true);
+
+    M2MStringPool::Handle first = M2MStringPool::acquire("Temperature");
+    M2MStringPool::Handle second = M2MStringPool::acquire(String("Temperature"));
+    M2MStringPool::Handle other = M2MStringPool::acquire("oma.lwm2m");
+
+    CHECK(first != M2MStringPool::EMPTY);
+    CHECK(first == second);
+    CHECK(first != other);
+    CHECK(M2MStringPool::size() == 2);
+    CHECK(M2MStringPool::string(first) == "Temperature");
+    CHECK(M2MStringPool::string(other) == "oma.lwm2m");
+
+    CHECK(M2MStringPool::acquire(first) == first);
+    CHECK(M2MStringPool::_entries[first - 1]->references == 3);
+
+    M2MStringPool::release(first);
+    M2MStringPool::release(first);
+    M2MStringPool::release(first);
+    M2MStringPool::release(other);
+    CHECK(M2MStringPool::size() == 0);
+}
+
+void Test_M2MStringPool::test_release()
+{
+    M2MStringPool::Handle first = M2MStringPool::acquire("first");
+    M2MStringPool::Handle second = M2MStringPool::acquire("second");
+
+    M2MStringPool::release(first);
+    CHECK(M2MStringPool::size() == 1);
+    CHECK(M2MStringPool::string(first).empty() == true);
+    CHECK(M2MStringPool::string(second) == "second");
+
+    // Freed slot is reused.
+    CHECK(M2MStringPool::acquire("third") == first);
+
+    // Releasing the empty or an unknown handle does nothing.
+    M2MStringPool::release(M2MStringPool::EMPTY);
+    M2MStringPool::release(1000);
+    CHECK(M2MStringPool::size() == 2);
+
+    M2MStringPool::release(first);
+    M2MStringPool::release(second);
+    CHECK(M2MStringPool::size() == 0);
+    CHECK(M2MStringPool::_entries == NULL);
+}
+
+void Test_M2MStringPool::test_grow()
+{
+    M2MStringPool::Handle handles[20];
+    char buffer[10];
+    for(int i = 0; i < 20; i++) {
+        snprintf(buffer, sizeof(buffer), "value%d", i);
+        handles[i] = M2MStringPool::acquire(String(buffer));
+    }
+    CHECK(M2MStringPool::size() == 20);
+    CHECK(M2MStringPool::_capacity >= 20);
+    CHECK(M2MStringPool::string(handles[0]) == "value0");
+    CHECK(M2MStringPool::string(handles[19]) == "value19");
+    for(int i = 0; i < 20; i++) {
+        M2MStringPool::release(handles[i]);
+    }
+    CHECK(M2MStringPool::size() == 0);
+}
+
+void Test_M2MStringPool::test_memory()
+{
+    CHECK(M2MStringPool::memory() == 0);
+    M2MStringPool::Handle handle = M2MStringPool::acquire("type");
+    M2MStringPool::acquire("type");
+    uint32_t memory = M2MStringPool::memory();
+    CHECK(memory >= M2MStringPool::_capacity * sizeof(void*) + 5);
+    M2MStringPool::Handle other = M2MStringPool::acquire("other");
+    CHECK(M2MStringPool::memory() > memory);
+    M2MStringPool::release(other);
+    CHECK(M2MStringPool::memory() == memory);
+    M2MStringPool::release(handle);
+    M2MStringPool::release(handle);
+    CHECK(M2MStringPool::memory() == 0);
+}
+
+void Test_M2MStringPool::test_bytes()
+{
+    CHECK(M2MStringPool::acquire_bytes("") == NULL);
+    CHECK(M2MStringPool::release_bytes(NULL) == false);
+
+    M2MStringPool::Handle handle = M2MStringPool::acquire("oma.lwm2m");
+    const char *bytes = M2MStringPool::acquire_bytes("oma.lwm2m");
+    CHECK(bytes == M2MStringPool::string(handle).c_str());
+    CHECK(M2MStringPool::_entries[handle - 1]->references == 2);
+
+    // Bytes not interned are left to the caller.
+    char other[] = "oma.lwm2m";
+    CHECK(M2MStringPool::release_bytes(other) == false);
+    CHECK(M2MStringPool::_entries[handle - 1]->references == 2);
+
+    CHECK(M2MStringPool::release_bytes(bytes) == true);
+    CHECK(M2MStringPool::_entries[handle - 1]->references == 1);
+    M2MStringPool::release(handle);
+    CHECK(M2MStringPool::size() == 0);
+
+    // The holder of the bytes can outlive the other references.
+    bytes = M2MStringPool::acquire_bytes("oma.lwm2m");
+    CHECK(M2MStringPool::size() == 1);
+    CHECK(M2MStringPool::release_bytes(bytes) == true);
+    CHECK(M2MStringPool::size() == 0);
+}
+
+void Test_M2MStringPool::test_threads()
+{
+    pthread_t threads[4];
+    for(int i = 0; i < 4; i++) {
+        pthread_create(&threads[i], NULL, &acquire_and_release, NULL);
+    }
+    for(int i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    CHECK(M2MStringPool::size() == 0);
+    CHECK(M2MStringPool::_entries == NULL);
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2mtimingwheel.h"
+
+TEST_GROUP(M2MTimingWheel)
+{
+  Test_M2MTimingWheel* m2m_timing_wheel;
+
+  void setup()
+  {
+    m2m_timing_wheel = new Test_M2MTimingWheel();
+  }
+  void teardown()
+  {
+    delete m2m_timing_wheel;
+  }
+};
+
+TEST(M2MTimingWheel, create)
+{
+    CHECK(m2m_timing_wheel->wheel != NULL);
+    CHECK(m2m_timing_wheel->wheel->pending() == 0);
+}
+
+TEST(M2MTimingWheel, single_shot)
+{
+    m2m_timing_wheel->test_single_shot();
+}
+
+TEST(M2MTimingWheel, periodic)
+{
+    m2m_timing_wheel->test_periodic();
+}
+
+TEST(M2MTimingWheel, levels)
+{
+    m2m_timing_wheel->test_levels();
+}
+
+TEST(M2MTimingWheel, batch)
+{
+    m2m_timing_wheel->test_batch();
+}
+
+TEST(M2MTimingWheel, next_expiry)
+{
+    m2m_timing_wheel->test_next_expiry();
+}
+
+TEST(M2MTimingWheel, thread)
+{
+    m2m_timing_wheel->test_thread();
+}
+
+TEST(M2MTimingWheel, shared_polled)
+{
+    m2m_timing_wheel->test_shared_polled();
+}
+
+TEST(M2MTimingWheel, timer_poll)
+{
+    m2m_timing_wheel->test_timer_poll();
+}
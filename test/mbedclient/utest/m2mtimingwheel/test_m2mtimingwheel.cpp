@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2mtimingwheel.h"
+#include "mbed-client/m2mtimer.h"
+#include <unistd.h>
+
+#define MAX_EXPIRED 16
+
+class TestObserver : public M2MTimerObserver {
+public:
+    TestObserver()
+    : wheel(NULL), stop_timer(NULL), restart_timer(NULL), count(0) {}
+    virtual ~TestObserver() {}
+
+    void timer_expired(M2MTimerObserver::Type type)
+    {
+        if(count < MAX_EXPIRED) {
+            expired[count] = type;
+        }
+        if(stop_timer) {
+            wheel->stop_timer(stop_timer);
+        }
+        if(restart_timer) {
+            wheel->start_timer(restart_timer, 100, true, 0);
+            restart_timer = NULL;
+        }
+        __atomic_fetch_add(&count, 1, __ATOMIC_SEQ_CST);
+    }
+
+    M2MTimingWheel                  *wheel;
+    M2MTimingWheel::Timer           *stop_timer;
+    M2MTimingWheel::Timer           *restart_timer;
+    volatile uint32_t               count;
+    M2MTimerObserver::Type          expired[MAX_EXPIRED];
+};
+
+Test_M2MTimingWheel::Test_M2MTimingWheel()
+{
+    wheel = new M2MTimingWheel(10);
+}
+
+Test_M2MTimingWheel::~Test_M2MTimingWheel()
+{
+    delete wheel;
+}
+
+void Test_M2MTimingWheel::test_single_shot()
+{
+    TestObserver observer;
+    M2MTimingWheel::Timer timer;
+    M2MTimingWheel::init_timer(&timer, observer, M2MTimerObserver::Registration);
+    CHECK(wheel->is_pending(&timer) == false);
+
+    wheel->start_timer(&timer, 100, true, 1000);
+    CHECK(wheel->is_pending(&timer) == true);
+    CHECK(wheel->pending() == 1);
+
+    // Never early, also when the interval is not a multiple of the tick.
+    CHECK(wheel->poll(1099) == 0);
+    CHECK(wheel->poll(1100) == 1);
+    CHECK(observer.count == 1);
+    CHECK(observer.expired[0] == M2MTimerObserver::Registration);
+    CHECK(wheel->is_pending(&timer) == false);
+    CHECK(wheel->poll(5000) == 0);
+
+    wheel->start_timer(&timer, 95, true, 5000);
+    CHECK(wheel->poll(5099) == 0);
+    CHECK(wheel->poll(5100) == 1);
+
+    // Restarting moves the timer, stopping removes it.
+    wheel->start_timer(&timer, 100, true, 6000);
+    wheel->start_timer(&timer, 300, true, 6000);
+    CHECK(wheel->pending() == 1);
+    CHECK(wheel->poll(6200) == 0);
+    wheel->stop_timer(&timer);
+    wheel->stop_timer(&timer);
+    CHECK(wheel->pending() == 0);
+    CHECK(wheel->poll(7000) == 0);
+    CHECK(observer.count == 2);
+}
+
+void Test_M2MTimingWheel::test_periodic()
+{
+    TestObserver observer;
+    M2MTimingWheel::Timer timer;
+    M2MTimingWheel::init_timer(&timer, observer, M2MTimerObserver::NsdlExecution);
+
+    wheel->start_timer(&timer, 50, false, 0);
+    CHECK(wheel->poll(49) == 0);
+    CHECK(wheel->poll(50) == 1);
+    CHECK(wheel->poll(99) == 0);
+    CHECK(wheel->poll(100) == 1);
+    CHECK(wheel->is_pending(&timer) == true);
+
+    // Missed periods are not replayed.
+    CHECK(wheel->poll(1000) == 1);
+    CHECK(wheel->poll(1049) == 0);
+    CHECK(wheel->poll(1050) == 1);
+
+    wheel->stop_timer(&timer);
+    CHECK(wheel->poll(2000) == 0);
+    CHECK(observer.count == 4);
+}
+
+void Test_M2MTimingWheel::test_levels()
+{
+    TestObserver observer;
+    M2MTimingWheel::Timer timers[5];
+    // One timer on each level and one beyond the wheel.
+    const uint64_t intervals[5] = { 500, 30000, 600000, 3600000, 180000000 };
+    const M2MTimerObserver::Type types[5] = {
+        M2MTimerObserver::Notdefined,
+        M2MTimerObserver::Registration,
+        M2MTimerObserver::NsdlExecution,
+        M2MTimerObserver::PMinTimer,
+        M2MTimerObserver::PMaxTimer
+    };
+    const uint64_t start = 123450;
+    for(uint8_t i = 0; i < 5; i++) {
+        M2MTimingWheel::init_timer(&timers[i], observer, types[i]);
+        wheel->start_timer(&timers[i], intervals[i], true, start);
+    }
+    CHECK(wheel->_slots[0][((start + 500) / 10) & (M2MTimingWheel::SLOTS - 1)] == &timers[0]);
+    CHECK(wheel->pending() == 5);
+
+    for(uint8_t i = 0; i < 5; i++) {
+        CHECK(wheel->poll(start + intervals[i] - 1) == 0);
+        CHECK(wheel->poll(start + intervals[i]) == 1);
+        CHECK(observer.expired[i] == types[i]);
+        CHECK(wheel->pending() == (uint32_t)(4 - i));
+    }
+}
+
+void Test_M2MTimingWheel::test_batch()
+{
+    TestObserver observer;
+    observer.wheel = wheel;
+    M2MTimingWheel::Timer first;
+    M2MTimingWheel::Timer second;
+    M2MTimingWheel::Timer third;
+    M2MTimingWheel::init_timer(&first, observer, M2MTimerObserver::Registration);
+    M2MTimingWheel::init_timer(&second, observer, M2MTimerObserver::NsdlExecution);
+    M2MTimingWheel::init_timer(&third, observer, M2MTimerObserver::Dtls);
+
+    // Dispatched in one batch, in expiry order.
+    wheel->start_timer(&third, 30, true, 0);
+    wheel->start_timer(&first, 10, true, 0);
+    wheel->start_timer(&second, 20, true, 0);
+    CHECK(wheel->poll(100) == 3);
+    CHECK(observer.expired[0] == M2MTimerObserver::Registration);
+    CHECK(observer.expired[1] == M2MTimerObserver::NsdlExecution);
+    CHECK(observer.expired[2] == M2MTimerObserver::Dtls);
+
+    // A callback can stop a timer of the same batch and restart itself.
+    observer.count = 0;
+    observer.stop_timer = &third;
+    observer.restart_timer = &first;
+    wheel->start_timer(&first, 10, true, 100);
+    wheel->start_timer(&third, 20, true, 100);
+    CHECK(wheel->poll(200) == 1);
+    CHECK(wheel->is_pending(&third) == false);
+    CHECK(wheel->is_pending(&first) == true);
+    observer.stop_timer = NULL;
+    CHECK(wheel->poll(300) == 1);
+    CHECK(wheel->pending() == 0);
+}
+
+void Test_M2MTimingWheel::test_next_expiry()
+{
+    TestObserver observer;
+    M2MTimingWheel::Timer timer;
+    M2MTimingWheel::init_timer(&timer, observer);
+    uint64_t time = 0;
+    CHECK(wheel->next_expiry(time) == false);
+
+    wheel->start_timer(&timer, 100, true, 10000);
+    CHECK(wheel->next_expiry(time) == true);
+    CHECK(time == 10100);
+
+    // Far timers are only looked at when level 0 wraps.
+    wheel->start_timer(&timer, 60000, true, 10000);
+    CHECK(wheel->next_expiry(time) == true);
+    CHECK(time == 10240);
+    CHECK(wheel->poll(time) == 0);
+    CHECK(wheel->next_expiry(time) == true);
+    CHECK(time == 10880);
+
+    wheel->stop_timer(&timer);
+    CHECK(wheel->next_expiry(time) == false);
+}
+
+void Test_M2MTimingWheel::test_thread()
+{
+    TestObserver observer;
+    M2MTimingWheel::Timer timer;
+    M2MTimingWheel::init_timer(&timer, observer);
+
+    CHECK(wheel->start() == true);
+    CHECK(wheel->start() == true);
+    // The sleeping thread is woken for the new timer.
+    wheel->start_timer(&timer, 20, true, M2MTimingWheel::now());
+    for(int i = 0; i < 1000 && !__atomic_load_n(&observer.count, __ATOMIC_SEQ_CST); i++) {
+        usleep(1000);
+    }
+    CHECK(observer.count == 1);
+
+    wheel->start_timer(&timer, 10, false, M2MTimingWheel::now());
+    for(int i = 0; i < 1000 && __atomic_load_n(&observer.count, __ATOMIC_SEQ_CST) < 4; i++) {
+        usleep(1000);
+    }
+    wheel->stop_timer(&timer);
+    uint32_t count = observer.count;
+    CHECK(count >= 4);
+    usleep(50000);
+    CHECK(observer.count == count);
+    wheel->stop();
+}
+
+void Test_M2MTimingWheel::test_shared_polled()
+{
+    M2MTimingWheel::set_shared_polled(true);
+    CHECK(M2MTimingWheel::shared_polled() == true);
+    M2MTimingWheel *shared = M2MTimingWheel::shared();
+    CHECK(shared != NULL);
+    CHECK(shared == M2MTimingWheel::shared());
+    CHECK(shared->_thread_running == false);
+
+    TestObserver observer;
+    M2MTimingWheel::Timer timer;
+    M2MTimingWheel::init_timer(&timer, observer);
+    uint64_t now = M2MTimingWheel::now();
+    shared->start_timer(&timer, 10, true, now);
+    CHECK(shared->poll(now + 20) == 1);
+    CHECK(observer.count == 1);
+
+    M2MTimingWheel::set_shared_polled(false);
+    CHECK(M2MTimingWheel::shared_polled() == false);
+    CHECK(shared->_thread_running == true);
+    M2MTimingWheel::set_shared_polled(true);
+    CHECK(shared->_thread_running == false);
+}
+
+void Test_M2MTimingWheel::test_timer_poll()
+{
+    M2MTimer::set_polled(true);
+    M2MTimingWheel *shared = M2MTimingWheel::shared();
+    CHECK(shared->_thread_running == false);
+
+    uint64_t time = 0;
+    CHECK(M2MTimer::next_expiry(time) == false);
+
+    TestObserver observer;
+    M2MTimingWheel::Timer timer;
+    M2MTimingWheel::init_timer(&timer, observer);
+    uint64_t now = M2MTimingWheel::now();
+    shared->start_timer(&timer, 10, true, now);
+    CHECK(M2MTimer::next_expiry(time) == true);
+    CHECK(time > now);
+
+    // The shared wheel keeps its time, don't poll ahead of the clock.
+    usleep(30000);
+    M2MTimer::poll(M2MTimingWheel::now());
+    CHECK(observer.count == 1);
+    CHECK(M2MTimer::next_expiry(time) == false);
+
+    // The thread drives the wheel, there is nothing to poll.
+    shared->start_timer(&timer, 10000, true, now);
+    M2MTimer::set_polled(false);
+    CHECK(shared->_thread_running == true);
+    CHECK(M2MTimer::next_expiry(time) == false);
+    M2MTimer::poll(now + 20000);
+    CHECK(observer.count == 1);
+    shared->stop_timer(&timer);
+
+    M2MTimer::set_polled(true);
+    CHECK(shared->_thread_running == false);
+}
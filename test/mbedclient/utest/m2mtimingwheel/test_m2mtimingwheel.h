@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TEST_M2M_TIMING_WHEEL_H
+#define TEST_M2M_TIMING_WHEEL_H
+
+#include "mbed-client/m2mtimingwheel.h"
+
+class Test_M2MTimingWheel
+{
+public:
+    Test_M2MTimingWheel();
+    virtual ~Test_M2MTimingWheel();
+
+    void test_single_shot();
+
+    void test_periodic();
+
+    void test_levels();
+
+    void test_batch();
+
+    void test_next_expiry();
+
+    void test_thread();
+
+    void test_shared_polled();
+
+    void test_timer_poll();
+
+    M2MTimingWheel* wheel;
+};
+
+#endif // TEST_M2M_TIMING_WHEEL_H
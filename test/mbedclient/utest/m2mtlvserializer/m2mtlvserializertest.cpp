@@ -47,3 +47,7 @@ TEST(M2MTLVSerializer, serialize_object_instance)
     m2m_serializer->test_serialize_object_instance();
 }
 
+TEST(M2MTLVSerializer, serialize_resource_table)
+{
+    m2m_serializer->test_serialize_resource_table();
+}
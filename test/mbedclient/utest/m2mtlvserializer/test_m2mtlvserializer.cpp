@@ -20,6 +20,7 @@
 #include "m2mresource_stub.h"
 #include "m2mresourceinstance_stub.h"
 #include "m2mbase_stub.h"
+#include "m2mresourcetable.h"
 
 
 Test_M2MTLVSerializer::Test_M2MTLVSerializer()
@@ -193,3 +194,52 @@ void Test_M2MTLVSerializer::test_serialize_object_instance()
     m2mobjectinstance_stub::clear();
     m2mobject_stub::clear();
 }
+
+void Test_M2MTLVSerializer::test_serialize_resource_table()
+{
+    uint32_t size = 0;
+    uint8_t *data = 0;
+
+    String *name = new String("1");
+    m2mbase_stub::string_value = name;
+    M2MResourceTable *table = new M2MResourceTable(*name);
+
+    data = serializer->serialize(table, size);
+    CHECK(data == NULL);
+
+    uint8_t short_value[] = {"ab"};
+    uint8_t long_value[] = {"0123456789"};
+    table->add_resource(1, 1, M2MResourceInstance::STRING, M2MBase::GET_ALLOWED);
+    table->add_resource(0, 300, M2MResourceInstance::STRING, M2MBase::GET_ALLOWED, long_value, 10);
+    table->add_resource(0, 0, M2MResourceInstance::STRING, M2MBase::GET_ALLOWED, short_value, 2);
+
+    uint8_t instance_tlv[] = { 0xC2, 0x00, 'a', 'b',
+                               0xE8, 0x01, 0x2C, 0x0A,
+                               '0', '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    uint8_t table_tlv[] = { 0x08, 0x00, 0x12 };
+
+    data = serializer->serialize(table, 0, size);
+    CHECK(data != NULL);
+    CHECK(size == sizeof(instance_tlv));
+    CHECK(memcmp(data, instance_tlv, sizeof(instance_tlv)) == 0);
+    free(data);
+
+    size = 0;
+    data = serializer->serialize(table, 2, size);
+    CHECK(data == NULL);
+
+    data = serializer->serialize(table, size);
+    CHECK(data != NULL);
+    CHECK(size == sizeof(table_tlv) + sizeof(instance_tlv) + 4);
+    CHECK(memcmp(data, table_tlv, sizeof(table_tlv)) == 0);
+    CHECK(memcmp(data + sizeof(table_tlv), instance_tlv, sizeof(instance_tlv)) == 0);
+    CHECK(data[21] == 0x02);
+    CHECK(data[22] == 0x01);
+    CHECK(data[23] == 0xC0);
+    CHECK(data[24] == 0x01);
+    free(data);
+
+    delete table;
+    delete name;
+    m2mbase_stub::string_value = NULL;
+}
@@ -29,6 +29,8 @@ public:
 
     void test_serialize_object_instance();
 
+    void test_serialize_resource_table();
+
     M2MTLVSerializer *serializer;
 };
 
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2mudpbatch.h"
+
+TEST_GROUP(M2MUdpBatch)
+{
+  Test_M2MUdpBatch* m2m_udp_batch;
+
+  void setup()
+  {
+    m2m_udp_batch = new Test_M2MUdpBatch();
+  }
+  void teardown()
+  {
+    delete m2m_udp_batch;
+  }
+};
+
+TEST(M2MUdpBatch, create)
+{
+    CHECK(m2m_udp_batch->batch != NULL);
+}
+
+TEST(M2MUdpBatch, send_receive)
+{
+    m2m_udp_batch->test_send_receive();
+}
+
+TEST(M2MUdpBatch, full_batch)
+{
+    m2m_udp_batch->test_full_batch();
+}
+
+TEST(M2MUdpBatch, invalid_datagram)
+{
+    m2m_udp_batch->test_invalid_datagram();
+}
+
+TEST(M2MUdpBatch, socket_error)
+{
+    m2m_udp_batch->test_socket_error();
+}
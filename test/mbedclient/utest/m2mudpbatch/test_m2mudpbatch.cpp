@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2mudpbatch.h"
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <arpa/inet.h>
+
+#define DATAGRAM_SIZE   64
+
+static int open_socket(struct sockaddr_in &address)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, (struct sockaddr*)&address, sizeof(address));
+    socklen_t length = sizeof(address);
+    getsockname(fd, (struct sockaddr*)&address, &length);
+    return fd;
+}
+
+static void wait_readable(int fd)
+{
+    struct pollfd poll_fd;
+    poll_fd.fd = fd;
+    poll_fd.events = POLLIN;
+    poll(&poll_fd, 1, 1000);
+}
+
+Test_M2MUdpBatch::Test_M2MUdpBatch()
+{
+    socket_fd = open_socket(address);
+    peer_fd = open_socket(peer_address);
+    batch = new M2MUdpBatch(socket_fd, DATAGRAM_SIZE);
+    peer = new M2MUdpBatch(peer_fd, DATAGRAM_SIZE);
+}
+
+Test_M2MUdpBatch::~Test_M2MUdpBatch()
+{
+    delete batch;
+    delete peer;
+    close(socket_fd);
+    close(peer_fd);
+}
+
+void Test_M2MUdpBatch::test_send_receive()
+{
+    uint8_t data[DATAGRAM_SIZE];
+    for(uint8_t i = 0; i < 5; i++) {
+        memset(data, i, sizeof(data));
+        CHECK(batch->queue(data, i + 1, (struct sockaddr*)&peer_address,
+                           sizeof(peer_address)) == true);
+    }
+    CHECK(batch->pending() == 5);
+    CHECK(batch->flush() == 5);
+    CHECK(batch->pending() == 0);
+    CHECK(batch->stats().send_calls == 1);
+    CHECK(batch->stats().datagrams_sent == 5);
+    CHECK(batch->stats().largest_send_batch == 5);
+
+    // Nothing queued, nothing sent.
+    CHECK(batch->flush() == 0);
+    CHECK(batch->stats().send_calls == 1);
+
+    uint8_t buffer[M2MUdpBatch::MAX_BATCH][DATAGRAM_SIZE];
+    uint8_t *buffers[M2MUdpBatch::MAX_BATCH];
+    for(uint8_t i = 0; i < M2MUdpBatch::MAX_BATCH; i++) {
+        buffers[i] = buffer[i];
+    }
+    wait_readable(peer_fd);
+    int received = 0;
+    while(received < 5) {
+        int count = peer->receive(buffers + received, M2MUdpBatch::MAX_BATCH - received,
+                                  DATAGRAM_SIZE);
+        CHECK(count >= 0);
+        for(int i = 0; i < count; i++) {
+            CHECK(peer->received_length(i) == received + i + 1);
+            CHECK(buffers[received + i][0] == received + i);
+            socklen_t length = 0;
+            const struct sockaddr_in *from =
+                (const struct sockaddr_in*)peer->received_address(i, length);
+            CHECK(length == sizeof(struct sockaddr_in));
+            CHECK(from->sin_port == address.sin_port);
+        }
+        received += count;
+    }
+    CHECK(peer->stats().datagrams_received == 5);
+    CHECK(peer->stats().largest_receive_batch >= 1);
+
+    // Nothing waiting.
+    CHECK(peer->receive(buffers, M2MUdpBatch::MAX_BATCH, DATAGRAM_SIZE) == 0);
+
+    socklen_t length = 0;
+    CHECK(peer->received_address(M2MUdpBatch::MAX_BATCH, length) == NULL);
+    CHECK(length == 0);
+    CHECK(peer->received_length(M2MUdpBatch::MAX_BATCH) == 0);
+}
+
+void Test_M2MUdpBatch::test_full_batch()
+{
+    uint8_t data[4] = { 1, 2, 3, 4 };
+    for(uint8_t i = 0; i < M2MUdpBatch::MAX_BATCH; i++) {
+        CHECK(batch->queue(data, sizeof(data), (struct sockaddr*)&peer_address,
+                           sizeof(peer_address)) == true);
+    }
+    CHECK(batch->pending() == M2MUdpBatch::MAX_BATCH);
+
+    // Full batch is flushed to make room.
+    CHECK(batch->queue(data, sizeof(data), (struct sockaddr*)&peer_address,
+                       sizeof(peer_address)) == true);
+    CHECK(batch->pending() == 1);
+    CHECK(batch->stats().largest_send_batch == M2MUdpBatch::MAX_BATCH);
+    CHECK(batch->flush() == 1);
+    CHECK(batch->stats().datagrams_sent == M2MUdpBatch::MAX_BATCH + 1);
+}
+
+void Test_M2MUdpBatch::test_invalid_datagram()
+{
+    uint8_t data[DATAGRAM_SIZE + 1];
+    memset(data, 0, sizeof(data));
+    CHECK(batch->queue(data, sizeof(data), (struct sockaddr*)&peer_address,
+                       sizeof(peer_address)) == false);
+    CHECK(batch->queue(data, 1, (struct sockaddr*)&peer_address,
+                       sizeof(struct sockaddr_storage) + 1) == false);
+    CHECK(batch->pending() == 0);
+
+    M2MUdpBatch *empty = new M2MUdpBatch(socket_fd, 0);
+    CHECK(empty->queue(data, 0, (struct sockaddr*)&peer_address,
+                       sizeof(peer_address)) == false);
+    uint8_t *buffers[1] = { data };
+    CHECK(empty->receive(buffers, 1, sizeof(data)) == -1);
+    delete empty;
+}
+
+void Test_M2MUdpBatch::test_socket_error()
+{
+    uint8_t data[4] = { 1, 2, 3, 4 };
+    M2MUdpBatch *closed = new M2MUdpBatch(-1, DATAGRAM_SIZE);
+    CHECK(closed->queue(data, sizeof(data), (struct sockaddr*)&peer_address,
+                        sizeof(peer_address)) == true);
+    CHECK(closed->queue(data, sizeof(data), (struct sockaddr*)&peer_address,
+                        sizeof(peer_address)) == true);
+
+    // Failing datagrams are dropped instead of blocking the queue.
+    CHECK(closed->flush() == -1);
+    CHECK(closed->pending() == 0);
+    CHECK(closed->stats().send_errors == 2);
+
+    uint8_t *buffers[1] = { data };
+    CHECK(closed->receive(buffers, 1, sizeof(data)) == -1);
+    delete closed;
+}
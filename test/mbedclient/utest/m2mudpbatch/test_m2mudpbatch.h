@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TEST_M2M_UDP_BATCH_H
+#define TEST_M2M_UDP_BATCH_H
+
+#include <netinet/in.h>
+#include "m2mudpbatch.h"
+
+class Test_M2MUdpBatch
+{
+public:
+    Test_M2MUdpBatch();
+    virtual ~Test_M2MUdpBatch();
+
+    void test_send_receive();
+
+    void test_full_batch();
+
+    void test_invalid_datagram();
+
+    void test_socket_error();
+
+    M2MUdpBatch* batch;
+    M2MUdpBatch* peer;
+    int socket_fd;
+    int peer_fd;
+    struct sockaddr_in address;
+    struct sockaddr_in peer_address;
+};
+
+#endif // TEST_M2M_UDP_BATCH_H
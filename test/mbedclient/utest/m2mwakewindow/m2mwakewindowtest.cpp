@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2mwakewindow.h"
+
+TEST_GROUP(M2MWakeWindow)
+{
+  Test_M2MWakeWindow* m2m_wake_window;
+
+  void setup()
+  {
+    m2m_wake_window = new Test_M2MWakeWindow();
+  }
+  void teardown()
+  {
+    delete m2m_wake_window;
+  }
+};
+
+TEST(M2MWakeWindow, create)
+{
+    CHECK(m2m_wake_window->window != NULL);
+    CHECK(m2m_wake_window->window->is_open() == false);
+}
+
+TEST(M2MWakeWindow, open)
+{
+    m2m_wake_window->test_open();
+}
+
+TEST(M2MWakeWindow, listen_time)
+{
+    m2m_wake_window->test_listen_time();
+}
+
+TEST(M2MWakeWindow, wake_interval)
+{
+    m2m_wake_window->test_wake_interval();
+}
+
+TEST(M2MWakeWindow, stats)
+{
+    m2m_wake_window->test_stats();
+}
+
+TEST(M2MWakeWindow, next_change)
+{
+    m2m_wake_window->test_next_change();
+}
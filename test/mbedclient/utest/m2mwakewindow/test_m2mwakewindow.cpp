@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2mwakewindow.h"
+
+#define LISTEN_TIME     10
+#define WAKE_INTERVAL   60
+
+Test_M2MWakeWindow::Test_M2MWakeWindow()
+{
+    window = new M2MWakeWindow(LISTEN_TIME, WAKE_INTERVAL);
+}
+
+Test_M2MWakeWindow::~Test_M2MWakeWindow()
+{
+    delete window;
+}
+
+void Test_M2MWakeWindow::test_open()
+{
+    // Nothing happens before the client starts.
+    CHECK(window->tick(100, true) == M2MWakeWindow::None);
+    CHECK(window->is_open() == false);
+
+    CHECK(window->open(100) == true);
+    CHECK(window->is_open() == true);
+    CHECK(window->open(101) == false);
+    CHECK(window->stats(101).windows == 1);
+
+    window->stop(102);
+    CHECK(window->is_open() == false);
+    CHECK(window->tick(500, true) == M2MWakeWindow::None);
+    CHECK(window->open(500) == true);
+    CHECK(window->stats(500).windows == 2);
+}
+
+void Test_M2MWakeWindow::test_listen_time()
+{
+    window->open(0);
+    CHECK(window->tick(LISTEN_TIME - 1, false) == M2MWakeWindow::None);
+
+    // Activity restarts the listen time.
+    window->message_received(5);
+    CHECK(window->tick(LISTEN_TIME, false) == M2MWakeWindow::None);
+    window->message_sent(8, 20);
+    CHECK(window->tick(8 + LISTEN_TIME - 1, false) == M2MWakeWindow::None);
+
+    // Pending exchanges keep the window open.
+    CHECK(window->tick(100, true) == M2MWakeWindow::None);
+    CHECK(window->is_open() == true);
+
+    CHECK(window->tick(101, false) == M2MWakeWindow::Closed);
+    CHECK(window->is_open() == false);
+    CHECK(window->tick(102, false) == M2MWakeWindow::None);
+
+    // Shorter listen time applies from the next tick.
+    window->open(200);
+    window->set_timing(2, WAKE_INTERVAL);
+    CHECK(window->tick(202, false) == M2MWakeWindow::Closed);
+}
+
+void Test_M2MWakeWindow::test_wake_interval()
+{
+    window->open(0);
+    CHECK(window->tick(LISTEN_TIME, false) == M2MWakeWindow::Closed);
+
+    // Stays closed with nothing to send.
+    CHECK(window->tick(LISTEN_TIME + WAKE_INTERVAL, false) == M2MWakeWindow::None);
+    CHECK(window->is_open() == false);
+
+    // Deferred messages wait for the wake interval.
+    window->message_deferred();
+    CHECK(window->tick(LISTEN_TIME + WAKE_INTERVAL - 1, true) == M2MWakeWindow::None);
+    CHECK(window->tick(LISTEN_TIME + WAKE_INTERVAL, true) == M2MWakeWindow::Opened);
+    CHECK(window->is_open() == true);
+    CHECK(window->stats(LISTEN_TIME + WAKE_INTERVAL).windows == 2);
+    CHECK(window->stats(LISTEN_TIME + WAKE_INTERVAL).messages_deferred == 1);
+}
+
+void Test_M2MWakeWindow::test_stats()
+{
+    window->open(0);
+    window->message_sent(1, 100);
+    window->message_sent(2, 50);
+    CHECK(window->tick(2 + LISTEN_TIME, false) == M2MWakeWindow::Closed);
+
+    M2MInterface::QueueModeStats stats = window->stats(20);
+    CHECK(stats.bytes_sent == 150);
+    CHECK(stats.window_bytes == 150);
+    CHECK(stats.largest_window_bytes == 150);
+    // Ongoing idle period is included.
+    CHECK(stats.idle_time == 20 - (2 + LISTEN_TIME));
+
+    window->open(100);
+    CHECK(window->stats(100).idle_time == 100 - (2 + LISTEN_TIME));
+    CHECK(window->stats(100).window_bytes == 0);
+    window->message_sent(101, 30);
+    stats = window->stats(101);
+    CHECK(stats.bytes_sent == 180);
+    CHECK(stats.window_bytes == 30);
+    CHECK(stats.largest_window_bytes == 150);
+
+    // Idle time stops counting once the client stops.
+    CHECK(window->tick(101 + LISTEN_TIME, false) == M2MWakeWindow::Closed);
+    window->stop(121);
+    CHECK(window->stats(500).idle_time == 100 - (2 + LISTEN_TIME) + 121 - (101 + LISTEN_TIME));
+}
+
+void Test_M2MWakeWindow::test_next_change()
+{
+    // Nothing changes before the client starts.
+    CHECK(window->next_change(0, true) == 0);
+
+    // An open window closes after the listen time unless exchanges are pending.
+    window->open(0);
+    CHECK(window->next_change(4, false) == LISTEN_TIME - 4);
+    CHECK(window->next_change(4, true) == 0);
+    CHECK(window->next_change(LISTEN_TIME + 5, false) == 1);
+
+    // A closed window opens after the wake interval only for pending messages.
+    CHECK(window->tick(LISTEN_TIME, false) == M2MWakeWindow::Closed);
+    CHECK(window->next_change(LISTEN_TIME, false) == 0);
+    CHECK(window->next_change(LISTEN_TIME + 10, true) == WAKE_INTERVAL - 10);
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TEST_M2M_WAKE_WINDOW_H
+#define TEST_M2M_WAKE_WINDOW_H
+
+#include "include/m2mwakewindow.h"
+
+class Test_M2MWakeWindow
+{
+public:
+    Test_M2MWakeWindow();
+    virtual ~Test_M2MWakeWindow();
+
+    void test_open();
+
+    void test_listen_time();
+
+    void test_wake_interval();
+
+    void test_stats();
+
+    void test_next_change();
+
+    M2MWakeWindow* window;
+};
+
+#endif // TEST_M2M_WAKE_WINDOW_H
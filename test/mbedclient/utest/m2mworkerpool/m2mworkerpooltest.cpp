@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+//CppUTest includes should be after your and system includes
+#include "CppUTest/TestHarness.h"
+#include "test_m2mworkerpool.h"
+
+TEST_GROUP(M2MWorkerPool)
+{
+  Test_M2MWorkerPool* m2m_worker_pool;
+
+  void setup()
+  {
+    m2m_worker_pool = new Test_M2MWorkerPool();
+  }
+  void teardown()
+  {
+    delete m2m_worker_pool;
+  }
+};
+
+TEST(M2MWorkerPool, create)
+{
+    CHECK(m2m_worker_pool->pool != NULL);
+    CHECK(m2m_worker_pool->pool->pending() == 0);
+}
+
+TEST(M2MWorkerPool, submit)
+{
+    m2m_worker_pool->test_submit();
+}
+
+TEST(M2MWorkerPool, parallel_jobs)
+{
+    m2m_worker_pool->test_parallel_jobs();
+}
+
+TEST(M2MWorkerPool, cancel)
+{
+    m2m_worker_pool->test_cancel();
+}
+
+TEST(M2MWorkerPool, full_pool)
+{
+    m2m_worker_pool->test_full_pool();
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CppUTest/TestHarness.h"
+#include "test_m2mworkerpool.h"
+#include <unistd.h>
+
+#define WORKERS     2
+
+class Job : public M2MWorkerJob {
+public:
+    Job(useconds_t run_time = 0)
+    : duration(run_time), ran(0), completions(0), completed_on(0) {}
+    ~Job() {}
+
+    void run()
+    {
+        usleep(duration);
+        __atomic_store_n(&ran, 1, __ATOMIC_SEQ_CST);
+    }
+
+    void completed()
+    {
+        // Completion is reported on the reactor thread, not on the worker.
+        __atomic_store_n(&completed_on, pthread_self(), __ATOMIC_SEQ_CST);
+        __atomic_fetch_add(&completions, 1, __ATOMIC_SEQ_CST);
+    }
+
+    uint32_t value(volatile uint32_t *counter)
+    {
+        return __atomic_load_n(counter, __ATOMIC_SEQ_CST);
+    }
+
+    bool wait_completed()
+    {
+        for(int i = 0; i < 1000; i++) {
+            if(value(&completions)) {
+                return true;
+            }
+            usleep(1000);
+        }
+        return false;
+    }
+
+    useconds_t          duration;
+    volatile uint32_t   ran;
+    volatile uint32_t   completions;
+    pthread_t           completed_on;
+};
+
+Test_M2MWorkerPool::Test_M2MWorkerPool()
+{
+    reactor = new M2MReactor(1);
+    reactor->start();
+    pool = new M2MWorkerPool(*reactor, WORKERS);
+    pool->start();
+}
+
+Test_M2MWorkerPool::~Test_M2MWorkerPool()
+{
+    delete pool;
+    delete reactor;
+}
+
+void Test_M2MWorkerPool::test_submit()
+{
+    Job job;
+    CHECK(!pool->submit(NULL));
+    CHECK(pool->submit(&job));
+    CHECK(job.wait_completed());
+    CHECK(job.value(&job.ran) == 1);
+    CHECK(job.value(&job.completions) == 1);
+    CHECK(!pthread_equal(__atomic_load_n(&job.completed_on, __ATOMIC_SEQ_CST), pthread_self()));
+    CHECK(pool->pending() == 0);
+
+    pool->stop();
+    CHECK(!pool->submit(&job));
+    CHECK(pool->start());
+    Job restarted;
+    CHECK(pool->submit(&restarted));
+    CHECK(restarted.wait_completed());
+}
+
+void Test_M2MWorkerPool::test_parallel_jobs()
+{
+    // A slow job doesn't hold back the others.
+    Job slow(200000);
+    Job fast;
+    CHECK(pool->submit(&slow));
+    CHECK(pool->submit(&fast));
+    CHECK(fast.wait_completed());
+    CHECK(slow.value(&slow.completions) == 0);
+    CHECK(slow.wait_completed());
+}
+
+void Test_M2MWorkerPool::test_cancel()
+{
+    Job first(100000);
+    Job second(100000);
+    Job queued;
+    Job unknown;
+    CHECK(pool->submit(&first));
+    CHECK(pool->submit(&second));
+    CHECK(pool->submit(&queued));
+    usleep(20000);
+    // Both workers are busy, so the third job is still queued.
+    CHECK(pool->cancel(&queued));
+    // A running job is waited for.
+    CHECK(pool->cancel(&first));
+    CHECK(first.value(&first.ran) == 1);
+    CHECK(!pool->cancel(&unknown));
+    CHECK(second.wait_completed());
+    usleep(20000);
+    CHECK(queued.value(&queued.ran) == 0);
+    CHECK(queued.value(&queued.completions) == 0);
+    CHECK(first.value(&first.completions) == 0);
+    CHECK(pool->pending() == 0);
+}
+
+void Test_M2MWorkerPool::test_full_pool()
+{
+    Job blockers[WORKERS];
+    Job jobs[M2MWorkerPool::MAX_JOBS];
+    for(uint8_t i = 0; i < WORKERS; i++) {
+        blockers[i].duration = 100000;
+        CHECK(pool->submit(&blockers[i]));
+    }
+    // Running jobs hold their slots too.
+    uint8_t accepted = 0;
+    while(accepted < M2MWorkerPool::MAX_JOBS && pool->submit(&jobs[accepted])) {
+        accepted++;
+    }
+    CHECK(accepted == M2MWorkerPool::MAX_JOBS - WORKERS);
+    CHECK(pool->pending() == M2MWorkerPool::MAX_JOBS);
+    for(uint8_t i = 0; i < accepted; i++) {
+        CHECK(jobs[i].wait_completed());
+    }
+    CHECK(pool->submit(&jobs[accepted]));
+    CHECK(jobs[accepted].wait_completed());
+}
@@ -67,6 +67,11 @@ TEST(NsdlAccessHelper, test_nsdl_c_bootstrap_done)
     nsdl->test_nsdl_c_bootstrap_done();
 }
 
+TEST(NsdlAccessHelper, test_nsdl_interface_registry)
+{
+    nsdl->test_nsdl_interface_registry();
+}
+
 TEST(NsdlAccessHelper, test_socket_malloc)
 {
     nsdl->test_socket_malloc();
@@ -15,6 +15,7 @@
  */
 #include "CppUTest/TestHarness.h"
 #include "test_nsdlaccesshelper.h"
+#include "mbed-client/m2mstringpool.h"
 #include "common_stub.h"
 #include "m2mnsdlinterface_stub.h"
 #include "m2mnsdlobserver.h"
@@ -86,70 +87,73 @@ Test_NsdlAccessHelper::~Test_NsdlAccessHelper()
 
 void Test_NsdlAccessHelper::test_nsdl_c_callback()
 {
-
-    CHECK(__nsdl_c_callback(NULL,NULL,NULL,SN_NSDL_PROTOCOL_HTTP) == 0 );
+    struct nsdl_s *handle = (struct nsdl_s*)0x10;
+    CHECK(__nsdl_c_callback(handle,NULL,NULL,SN_NSDL_PROTOCOL_HTTP) == 0 );
 
     m2mnsdlinterface_stub::int_value = 1;
-    __nsdl_interface = new M2MNsdlInterface(*observer);
+    M2MNsdlInterface *nsdl_interface = new M2MNsdlInterface(*observer);
+    CHECK(__nsdl_interface_register(handle, nsdl_interface));
 
-    CHECK(__nsdl_c_callback(NULL,NULL,NULL,SN_NSDL_PROTOCOL_HTTP) == 1 );
+    CHECK(__nsdl_c_callback(handle,NULL,NULL,SN_NSDL_PROTOCOL_HTTP) == 1 );
+    CHECK(__nsdl_c_callback((struct nsdl_s*)0x20,NULL,NULL,SN_NSDL_PROTOCOL_HTTP) == 0 );
 
-    delete __nsdl_interface;
-    __nsdl_interface = NULL;
+    __nsdl_interface_unregister(handle);
+    CHECK(__nsdl_c_callback(handle,NULL,NULL,SN_NSDL_PROTOCOL_HTTP) == 0 );
+    delete nsdl_interface;
 }
 
 void Test_NsdlAccessHelper::test_nsdl_c_memory_alloc()
 {
-    void *ptr = __nsdl_c_memory_alloc(6);
+    void *ptr = __nsdl_c_memory_alloc(0);
     CHECK(ptr == NULL);
 
-    __nsdl_interface = new M2MNsdlInterface(*observer);
     ptr = __nsdl_c_memory_alloc(6);
     CHECK(ptr != NULL);
-
-    delete __nsdl_interface;
-    __nsdl_interface = NULL;
     free(ptr);
 }
 
 void Test_NsdlAccessHelper::test_nsdl_c_memory_free()
 {
     void* ptr = malloc(7);
-    __nsdl_c_memory_free(ptr);
-
     CHECK(ptr != NULL);
-
-    __nsdl_interface = new M2MNsdlInterface(*observer);
     __nsdl_c_memory_free(ptr);
-
-    delete __nsdl_interface;
-    __nsdl_interface = NULL;
+    __nsdl_c_memory_free(NULL);
     ptr = NULL;
-    //No need to check anything, since memory leak is the test
+
+    // Interned bytes handed to the library are released, not freed.
+    const char *bytes = M2MStringPool::acquire_bytes("oma.lwm2m");
+    CHECK(M2MStringPool::size() == 1);
+    __nsdl_c_memory_free((void*)bytes);
+    CHECK(M2MStringPool::size() == 0);
+    //No need to check anything else, since memory leak is the test
 }
 
 void Test_NsdlAccessHelper::test_nsdl_c_send_to_server()
 {
-    CHECK(__nsdl_c_send_to_server(NULL, SN_NSDL_PROTOCOL_HTTP, NULL, 0, NULL) == 0);
+    struct nsdl_s *handle = (struct nsdl_s*)0x10;
+    CHECK(__nsdl_c_send_to_server(handle, SN_NSDL_PROTOCOL_HTTP, NULL, 0, NULL) == 0);
 
     m2mnsdlinterface_stub::int_value = 1;
-    __nsdl_interface = new M2MNsdlInterface(*observer);
-    CHECK(__nsdl_c_send_to_server(NULL, SN_NSDL_PROTOCOL_HTTP, NULL, 0, NULL) == 1);
+    M2MNsdlInterface *nsdl_interface = new M2MNsdlInterface(*observer);
+    CHECK(__nsdl_interface_register(handle, nsdl_interface));
+    CHECK(__nsdl_c_send_to_server(handle, SN_NSDL_PROTOCOL_HTTP, NULL, 0, NULL) == 1);
 
-    delete __nsdl_interface;
-    __nsdl_interface = NULL;
+    __nsdl_interface_unregister(handle);
+    delete nsdl_interface;
 }
 
 void Test_NsdlAccessHelper::test_nsdl_c_received_from_server()
 {
-    CHECK( 0 == __nsdl_c_received_from_server(NULL, NULL, NULL));
+    struct nsdl_s *handle = (struct nsdl_s*)0x10;
+    CHECK( 0 == __nsdl_c_received_from_server(handle, NULL, NULL));
 
     m2mnsdlinterface_stub::int_value = 1;
-    __nsdl_interface = new M2MNsdlInterface(*observer);
-    CHECK( 1 == __nsdl_c_received_from_server(NULL, NULL, NULL));
+    M2MNsdlInterface *nsdl_interface = new M2MNsdlInterface(*observer);
+    CHECK(__nsdl_interface_register(handle, nsdl_interface));
+    CHECK( 1 == __nsdl_c_received_from_server(handle, NULL, NULL));
 
-    delete __nsdl_interface;
-    __nsdl_interface = NULL;
+    __nsdl_interface_unregister(handle);
+    delete nsdl_interface;
 }
 
 void Test_NsdlAccessHelper::test_nsdl_c_bootstrap_done()
@@ -157,11 +161,50 @@ void Test_NsdlAccessHelper::test_nsdl_c_bootstrap_done()
     __nsdl_c_bootstrap_done(NULL);
 
     m2mnsdlinterface_stub::int_value = 1;
-    __nsdl_interface = new M2MNsdlInterface(*observer);
+    M2MNsdlInterface *nsdl_interface = new M2MNsdlInterface(*observer);
+    __nsdl_processing_interface = nsdl_interface;
     __nsdl_c_bootstrap_done(NULL);
 
-    delete __nsdl_interface;
-    __nsdl_interface = NULL;
+    // Unregistering the interface being processed clears the routing.
+    CHECK(__nsdl_interface_register((struct nsdl_s*)0x10, nsdl_interface));
+    __nsdl_interface_unregister((struct nsdl_s*)0x10);
+    CHECK(__nsdl_processing_interface == NULL);
+    delete nsdl_interface;
+}
+
+void Test_NsdlAccessHelper::test_nsdl_interface_registry()
+{
+    M2MNsdlInterface *first = new M2MNsdlInterface(*observer);
+    M2MNsdlInterface *second = new M2MNsdlInterface(*observer);
+    M2MNsdlInterface *third = new M2MNsdlInterface(*observer);
+
+    CHECK(__nsdl_interface_find((struct nsdl_s*)0x30) == NULL);
+    CHECK(__nsdl_interface_register((struct nsdl_s*)0x30, third));
+    CHECK(__nsdl_interface_register((struct nsdl_s*)0x10, first));
+    CHECK(__nsdl_interface_register((struct nsdl_s*)0x20, second));
+
+    CHECK(__nsdl_interface_find((struct nsdl_s*)0x10) == first);
+    CHECK(__nsdl_interface_find((struct nsdl_s*)0x20) == second);
+    CHECK(__nsdl_interface_find((struct nsdl_s*)0x30) == third);
+    CHECK(__nsdl_interface_find((struct nsdl_s*)0x40) == NULL);
+
+    // Registering the same handle again replaces the interface.
+    CHECK(__nsdl_interface_register((struct nsdl_s*)0x20, third));
+    CHECK(__nsdl_interface_find((struct nsdl_s*)0x20) == third);
+
+    __nsdl_interface_unregister((struct nsdl_s*)0x20);
+    CHECK(__nsdl_interface_find((struct nsdl_s*)0x20) == NULL);
+    CHECK(__nsdl_interface_find((struct nsdl_s*)0x10) == first);
+    CHECK(__nsdl_interface_find((struct nsdl_s*)0x30) == third);
+
+    __nsdl_interface_unregister((struct nsdl_s*)0x40);
+    __nsdl_interface_unregister((struct nsdl_s*)0x10);
+    __nsdl_interface_unregister((struct nsdl_s*)0x30);
+    CHECK(__nsdl_interface_find((struct nsdl_s*)0x10) == NULL);
+
+    delete first;
+    delete second;
+    delete third;
 }
 
 void Test_NsdlAccessHelper::test_socket_malloc()
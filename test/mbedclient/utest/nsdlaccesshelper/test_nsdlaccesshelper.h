@@ -40,6 +40,8 @@ public:
 
     void test_nsdl_c_bootstrap_done();
 
+    void test_nsdl_interface_registry();
+
     void test_socket_malloc();
 
     void test_socket_free();
@@ -32,6 +32,8 @@ sn_coap_hdr_s *common_stub::coap_header;
 sn_nsdl_resource_info_s *common_stub::resource;
 pthread_t common_stub::thread;
 const char* common_stub::char_value;
+uint32_t common_stub::exec_time;
+uint8_t common_stub::exec_count;
 
 using namespace mbed;
 using namespace mbed::Sockets::v0;
@@ -52,6 +54,8 @@ void common_stub::clear()
     resource = NULL;
     addrinfo = NULL;
     char_value = NULL;
+    exec_time = 0;
+    exec_count = 0;
 }
 
 UDPSocket::UDPSocket(socket_stack_t stack) :Socket(stack)
@@ -140,8 +144,10 @@ int8_t sn_nsdl_process_coap(struct nsdl_s *, uint8_t *, uint16_t , sn_nsdl_addr_
     return common_stub::int_value;
 }
 
-int8_t sn_nsdl_exec(uint32_t)
+int8_t sn_nsdl_exec(uint32_t time)
 {
+    common_stub::exec_time = time;
+    common_stub::exec_count++;
     return common_stub::int_value;
 }
 
@@ -171,8 +177,12 @@ int8_t sn_nsdl_delete_resource(struct nsdl_s *, uint16_t , uint8_t *)
     return common_stub::int_value;
 }
 
-int8_t sn_nsdl_send_coap_message(struct nsdl_s *, sn_nsdl_addr_s *, sn_coap_hdr_s *)
+int8_t sn_nsdl_send_coap_message(struct nsdl_s *, sn_nsdl_addr_s *, sn_coap_hdr_s *coap_hdr_ptr)
 {
+    // The library numbers messages built without an ID.
+    if(0 == common_stub::int_value && coap_hdr_ptr && 0 == coap_hdr_ptr->msg_id) {
+        coap_hdr_ptr->msg_id = common_stub::uint_value;
+    }
     return common_stub::int_value;
 }
 
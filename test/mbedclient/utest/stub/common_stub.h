@@ -42,6 +42,8 @@ namespace common_stub
     extern sn_nsdl_resource_info_s *resource;
     extern pthread_t thread;
     extern const char *char_value;
+    extern uint32_t exec_time;
+    extern uint8_t exec_count;
     void clear();
 }
 
@@ -188,6 +188,11 @@ uint16_t M2MBase::observation_number() const
     return m2mbase_stub::uint16_value;
 }
 
+M2MMemoryStats M2MBase::memory_stats() const
+{
+    return M2MMemoryStats();
+}
+
 void M2MBase::remove_resource_from_coap(const String &)
 {
 }
@@ -224,6 +229,34 @@ M2MObservationHandler* M2MBase::observation_handler()
     return m2mbase_stub::observe;
 }
 
+void M2MBase::set_memory_attached(bool)
+{
+}
+
+void M2MBase::mark_memory_attached(bool)
+{
+}
+
+bool M2MBase::memory_attached() const
+{
+    return m2mbase_stub::bool_value;
+}
+
+void M2MBase::update_memory_stats(M2MMemoryStats::Category,
+                                  int32_t)
+{
+}
+
+void M2MBase::update_owner_memory_stats(M2MMemoryStats::Category,
+                                        int32_t)
+{
+}
+
+void M2MBase::update_list_memory_stats(int /*old_size*/, int /*old_capacity*/,
+                                       int /*new_size*/, int /*new_capacity*/)
+{
+}
+
 sn_coap_hdr_s* M2MBase::handle_get_request(nsdl_s */*nsdl*/,
                                            sn_coap_hdr_s */*received_coap_header*/,
                                            M2MObservationHandler */*observation_handler*/)
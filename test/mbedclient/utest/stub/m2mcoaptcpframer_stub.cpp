@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "m2mcoaptcpframer_stub.h"
+
+uint8_t m2mcoaptcpframer_stub::buffer[16];
+const uint8_t *m2mcoaptcpframer_stub::frame_value = NULL;
+uint8_t m2mcoaptcpframer_stub::message_count = 0;
+const uint8_t *m2mcoaptcpframer_stub::signal_value = NULL;
+bool m2mcoaptcpframer_stub::failed_value = false;
+uint16_t m2mcoaptcpframer_stub::fed = 0;
+bool m2mcoaptcpframer_stub::reset_called = false;
+
+void m2mcoaptcpframer_stub::clear()
+{
+    frame_value = NULL;
+    message_count = 0;
+    signal_value = NULL;
+    failed_value = false;
+    fed = 0;
+    reset_called = false;
+}
+
+M2MCoapTcpFramer::M2MCoapTcpFramer(uint16_t)
+{
+}
+
+M2MCoapTcpFramer::~M2MCoapTcpFramer()
+{
+}
+
+void M2MCoapTcpFramer::reset()
+{
+    m2mcoaptcpframer_stub::reset_called = true;
+    m2mcoaptcpframer_stub::failed_value = false;
+}
+
+const uint8_t* M2MCoapTcpFramer::encode(const uint8_t *,
+                                        uint16_t,
+                                        uint16_t &frame_length)
+{
+    frame_length = m2mcoaptcpframer_stub::frame_value ? sizeof(m2mcoaptcpframer_stub::buffer) : 0;
+    return m2mcoaptcpframer_stub::frame_value;
+}
+
+uint16_t M2MCoapTcpFramer::feed(const uint8_t *, uint16_t length)
+{
+    m2mcoaptcpframer_stub::fed += length;
+    return length;
+}
+
+const uint8_t* M2MCoapTcpFramer::next_message(uint16_t &length)
+{
+    if(!m2mcoaptcpframer_stub::message_count) {
+        length = 0;
+        return NULL;
+    }
+    m2mcoaptcpframer_stub::message_count--;
+    length = sizeof(m2mcoaptcpframer_stub::buffer);
+    return m2mcoaptcpframer_stub::buffer;
+}
+
+const uint8_t* M2MCoapTcpFramer::next_signal(uint16_t &frame_length)
+{
+    const uint8_t *signal = m2mcoaptcpframer_stub::signal_value;
+    m2mcoaptcpframer_stub::signal_value = NULL;
+    frame_length = signal ? sizeof(m2mcoaptcpframer_stub::buffer) : 0;
+    return signal;
+}
+
+bool M2MCoapTcpFramer::failed() const
+{
+    return m2mcoaptcpframer_stub::failed_value;
+}
+
+uint32_t M2MCoapTcpFramer::peer_max_message_size() const
+{
+    return 0;
+}
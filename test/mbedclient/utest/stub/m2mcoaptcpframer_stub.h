@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_COAP_TCP_FRAMER_STUB_H
+#define M2M_COAP_TCP_FRAMER_STUB_H
+
+#include <stddef.h>
+#include "m2mcoaptcpframer.h"
+
+//some internal test related stuff
+namespace m2mcoaptcpframer_stub
+{
+    extern uint8_t buffer[16];
+    extern const uint8_t *frame_value;
+    extern uint8_t message_count;
+    extern const uint8_t *signal_value;
+    extern bool failed_value;
+    extern uint16_t fed;
+    extern bool reset_called;
+    void clear();
+}
+
+#endif // M2M_COAP_TCP_FRAMER_STUB_H
@@ -20,12 +20,16 @@
 int m2mconnectionhandler_stub::int_value;
 uint16_t m2mconnectionhandler_stub::uint_value;
 bool m2mconnectionhandler_stub::bool_value;
+int m2mconnectionhandler_stub::fd_value;
+uint8_t m2mconnectionhandler_stub::process_io_count;
 
 void m2mconnectionhandler_stub::clear()
 {
     int_value = -1;
     uint_value = 0;
     bool_value = false;
+    fd_value = -1;
+    process_io_count = 0;
 }
 
 M2MConnectionHandler::M2MConnectionHandler(M2MConnectionObserver &observer,
@@ -72,6 +76,16 @@ void M2MConnectionHandler::stop_listening()
 {
 }
 
+int M2MConnectionHandler::socket_fd() const
+{
+    return m2mconnectionhandler_stub::fd_value;
+}
+
+void M2MConnectionHandler::process_io()
+{
+    m2mconnectionhandler_stub::process_io_count++;
+}
+
 int M2MConnectionHandler::sendToSocket(const unsigned char *, size_t ){
     return m2mconnectionhandler_stub::int_value;
 }
@@ -24,6 +24,8 @@ namespace m2mconnectionhandler_stub
     extern int int_value;
     extern uint16_t uint_value;
     extern bool bool_value;
+    extern int fd_value;
+    extern uint8_t process_io_count;
     void clear();
 }
 
@@ -43,6 +43,9 @@ M2MConnectionSecurity::~M2MConnectionSecurity(){
 void M2MConnectionSecurity::reset(){
 }
 
+void M2MConnectionSecurity::set_session_cache(M2MDtlsSessionCache *){
+}
+
 int M2MConnectionSecurity::init(const M2MSecurity *security){
     if(m2mconnectionsecurityimpl_stub::use_inc_int){
         return m2mconnectionsecurityimpl_stub::inc_int_value++;
@@ -13,8 +13,10 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <string.h>
 #include "m2minterfaceimpl_stub.h"
 #include "common_stub.h"
+#include "m2mconstants.h"
 
 u_int8_t m2minterfaceimpl_stub::int_value;
 String m2minterfaceimpl_stub::string_value;
@@ -37,10 +39,25 @@ M2MInterfaceImpl::M2MInterfaceImpl(M2MInterfaceObserver& observer,
                                    M2MInterface::NetworkStack,
                                    const String &)
 : _observer(observer),
+  _device(NULL),
   _current_state(0),
   _max_states( STATE_MAX_STATES ),
-  _event_generated(false),
-  _event_data(NULL)
+  _event_head(0),
+  _event_count(0),
+  _event_insert(0),
+  _event_dispatching(false),
+  _receive_pool(0, 0),
+  _tcp_framer(NULL),
+  _tcp_processing(false),
+  _send_queue(SEND_QUEUE_SIZE, COAP_NSTART, COAP_EXCHANGE_TIMEOUT),
+  _send_failures(0),
+  _sending(false),
+  _queue_mode(false),
+  _wake_window(QUEUE_MODE_LISTEN_TIME, QUEUE_MODE_WAKE_INTERVAL),
+  _coap_time(0),
+  _registration_store(NULL),
+  _resume_registration(false),
+  _keepalive(KEEPALIVE_TIMEOUT, KEEPALIVE_ATTEMPTS)
 {
 }
 
@@ -67,6 +84,64 @@ void M2MInterfaceImpl::unregister_object(M2MSecurity*)
 {
 }
 
+M2MMemoryStats M2MInterfaceImpl::memory_stats() const
+{
+    return M2MMemoryStats();
+}
+
+void M2MInterfaceImpl::set_queue_mode_timing(uint32_t, uint32_t)
+{
+}
+
+M2MInterface::QueueModeStats M2MInterfaceImpl::queue_mode_stats() const
+{
+    M2MInterface::QueueModeStats stats;
+    memset(&stats, 0, sizeof(stats));
+    return stats;
+}
+
+void M2MInterfaceImpl::set_registration_store(M2MRegistrationStore *)
+{
+}
+
+void M2MInterfaceImpl::set_keepalive_interval(uint32_t, uint32_t)
+{
+}
+
+M2MInterface::KeepaliveStats M2MInterfaceImpl::keepalive_stats() const
+{
+    M2MInterface::KeepaliveStats stats;
+    memset(&stats, 0, sizeof(stats));
+    return stats;
+}
+
+void M2MInterfaceImpl::set_poll_mode(bool)
+{
+}
+
+int M2MInterfaceImpl::socket_fd() const
+{
+    return -1;
+}
+
+bool M2MInterfaceImpl::next_deadline(uint64_t &) const
+{
+    return false;
+}
+
+void M2MInterfaceImpl::process_io()
+{
+}
+
+void M2MInterfaceImpl::process_timers(uint64_t)
+{
+}
+
+M2MDevice* M2MInterfaceImpl::device()
+{
+    return NULL;
+}
+
 void M2MInterfaceImpl::coap_message_ready(uint8_t *,
                                 uint16_t ,
                                 sn_nsdl_addr_s *)
@@ -104,6 +179,31 @@ void M2MInterfaceImpl::coap_data_processed()
 
 }
 
+M2MConnectionObserver::TransportType M2MInterfaceImpl::transport_type() const
+{
+    return M2MConnectionObserver::Datagram;
+}
+
+uint8_t* M2MInterfaceImpl::receive_buffer(uint16_t &size)
+{
+    size = 0;
+    return NULL;
+}
+
+void M2MInterfaceImpl::release_receive_buffer(uint8_t*)
+{
+}
+
+M2MRegistrationStore* M2MInterfaceImpl::registration_store()
+{
+    return NULL;
+}
+
+bool M2MInterfaceImpl::poll_mode() const
+{
+    return false;
+}
+
 void M2MInterfaceImpl::data_available(uint8_t*,
                             uint16_t,
                             const M2MConnectionObserver::SocketAddress &)
@@ -137,3 +237,12 @@ void M2MInterfaceImpl::value_updated(M2MBase *)
 
 }
 
+void M2MInterfaceImpl::coap_timer_tick(uint32_t)
+{
+}
+
+uint32_t M2MInterfaceImpl::coap_timer_delay(uint32_t)
+{
+    return 0;
+}
+
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include "m2mkeepalive_stub.h"
+
+M2MKeepalive::Action m2mkeepalive_stub::tick_value = M2MKeepalive::None;
+uint32_t m2mkeepalive_stub::next_action_value = 0;
+bool m2mkeepalive_stub::pong_value = false;
+bool m2mkeepalive_stub::running = false;
+uint8_t m2mkeepalive_stub::activity_count = 0;
+uint32_t m2mkeepalive_stub::interval = 0;
+uint32_t m2mkeepalive_stub::max_interval = 0;
+
+void m2mkeepalive_stub::clear()
+{
+    tick_value = M2MKeepalive::None;
+    next_action_value = 0;
+    pong_value = false;
+    running = false;
+    activity_count = 0;
+    interval = 0;
+    max_interval = 0;
+}
+
+M2MKeepalive::M2MKeepalive(uint32_t, uint8_t)
+{
+}
+
+M2MKeepalive::~M2MKeepalive()
+{
+}
+
+void M2MKeepalive::set_interval(uint32_t interval, uint32_t max_interval)
+{
+    m2mkeepalive_stub::interval = interval;
+    m2mkeepalive_stub::max_interval = max_interval;
+}
+
+void M2MKeepalive::start(uint32_t)
+{
+    m2mkeepalive_stub::running = true;
+}
+
+void M2MKeepalive::stop()
+{
+    m2mkeepalive_stub::running = false;
+}
+
+void M2MKeepalive::activity(uint32_t)
+{
+    m2mkeepalive_stub::activity_count++;
+}
+
+M2MKeepalive::Action M2MKeepalive::tick(uint32_t)
+{
+    return m2mkeepalive_stub::tick_value;
+}
+
+uint32_t M2MKeepalive::next_action(uint32_t) const
+{
+    return m2mkeepalive_stub::next_action_value;
+}
+
+uint16_t M2MKeepalive::ping_message(uint8_t *buffer) const
+{
+    memset(buffer, 0, PING_LENGTH);
+    buffer[0] = 0x40;
+    return PING_LENGTH;
+}
+
+bool M2MKeepalive::pong_received(const uint8_t *, uint16_t, uint32_t)
+{
+    return m2mkeepalive_stub::pong_value;
+}
+
+M2MInterface::KeepaliveStats M2MKeepalive::stats() const
+{
+    M2MInterface::KeepaliveStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.interval = m2mkeepalive_stub::interval;
+    return stats;
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_KEEPALIVE_STUB_H
+#define M2M_KEEPALIVE_STUB_H
+
+#include "include/m2mkeepalive.h"
+
+//some internal test related stuff
+namespace m2mkeepalive_stub
+{
+    extern M2MKeepalive::Action tick_value;
+    extern uint32_t next_action_value;
+    extern bool pong_value;
+    extern bool running;
+    extern uint8_t activity_count;
+    extern uint32_t interval;
+    extern uint32_t max_interval;
+    void clear();
+}
+
+#endif // M2M_KEEPALIVE_STUB_H
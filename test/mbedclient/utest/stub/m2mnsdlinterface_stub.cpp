@@ -17,11 +17,21 @@
 
 bool m2mnsdlinterface_stub::bool_value;
 uint32_t m2mnsdlinterface_stub::int_value;
+sn_nsdl_addr_type_e m2mnsdlinterface_stub::address_type;
+bool m2mnsdlinterface_stub::resumed;
+uint8_t m2mnsdlinterface_stub::update_count;
+uint32_t m2mnsdlinterface_stub::coap_time;
+uint8_t m2mnsdlinterface_stub::schedule_count;
 
 void m2mnsdlinterface_stub::clear()
 {
     bool_value = false;
     int_value = 0;
+    address_type = SN_NSDL_ADDRESS_TYPE_NONE;
+    resumed = false;
+    update_count = 0;
+    coap_time = 0;
+    schedule_count = 0;
 }
 
 M2MNsdlInterface::M2MNsdlInterface(M2MNsdlObserver &observer)
@@ -68,13 +78,37 @@ bool M2MNsdlInterface::create_bootstrap_resource(sn_nsdl_addr_s *)
 
 bool M2MNsdlInterface::send_register_message(uint8_t*,
                                              const uint16_t,
-                                             sn_nsdl_addr_type_e)
+                                             sn_nsdl_addr_type_e address_type)
 {
+    m2mnsdlinterface_stub::address_type = address_type;
     return m2mnsdlinterface_stub::bool_value;
 }
 
+bool M2MNsdlInterface::send_resume_registration(uint8_t*,
+                                                const uint16_t,
+                                                sn_nsdl_addr_type_e address_type,
+                                                const uint8_t *,
+                                                uint8_t)
+{
+    m2mnsdlinterface_stub::address_type = address_type;
+    m2mnsdlinterface_stub::resumed = true;
+    return m2mnsdlinterface_stub::bool_value;
+}
+
+const uint8_t* M2MNsdlInterface::registration_location(uint8_t &length) const
+{
+    length = 0;
+    return NULL;
+}
+
+uint32_t M2MNsdlInterface::registration_lifetime() const
+{
+    return m2mnsdlinterface_stub::int_value;
+}
+
 bool M2MNsdlInterface::send_update_registration(const uint32_t)
 {
+    m2mnsdlinterface_stub::update_count++;
     return m2mnsdlinterface_stub::bool_value;
 }
 
@@ -129,11 +163,26 @@ bool M2MNsdlInterface::process_received_data(uint8_t *,
     return m2mnsdlinterface_stub::bool_value;
 }
 
+M2MMemoryStats M2MNsdlInterface::memory_stats() const
+{
+    return M2MMemoryStats();
+}
+
 void M2MNsdlInterface::stop_timers()
 {
 
 }
 
+uint32_t M2MNsdlInterface::coap_time() const
+{
+    return m2mnsdlinterface_stub::coap_time;
+}
+
+void M2MNsdlInterface::schedule_execution()
+{
+    m2mnsdlinterface_stub::schedule_count++;
+}
+
 void M2MNsdlInterface::timer_expired(M2MTimerObserver::Type)
 {
 }
@@ -23,6 +23,11 @@ namespace m2mnsdlinterface_stub
 {
     extern bool bool_value;
     extern uint32_t int_value;
+    extern sn_nsdl_addr_type_e address_type;
+    extern bool resumed;
+    extern uint8_t update_count;
+    extern uint32_t coap_time;
+    extern uint8_t schedule_count;
     void clear();
 }
 
@@ -115,3 +115,18 @@ sn_coap_hdr_s* M2MObject::handle_post_request(nsdl_s *,
 void M2MObject::notification_update()
 {
 }
+
+M2MMemoryStats M2MObject::memory_stats() const
+{
+    return _memory_stats;
+}
+
+void M2MObject::memory_updated(M2MMemoryStats::Category category, int32_t delta)
+{
+    _memory_stats.update(category, delta);
+}
+
+void M2MObject::update_memory_stats(M2MMemoryStats::Category category, int32_t delta)
+{
+    _memory_stats.update(category, delta);
+}
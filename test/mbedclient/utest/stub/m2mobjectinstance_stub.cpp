@@ -49,6 +49,14 @@ M2MObjectInstance::M2MObjectInstance(const M2MObjectInstance& other)
     *this = other;
 }
 
+M2MObjectInstance::M2MObjectInstance(const M2MObjectInstance& other,
+                                     M2MObjectCallback &object_callback)
+: M2MBase(other),
+  _object_callback(object_callback)
+{
+    *this = other;
+}
+
 M2MObjectInstance::M2MObjectInstance(const String &object_name, M2MObjectCallback &object_callback)
 : M2MBase(object_name,M2MBase::Dynamic),
   _object_callback(object_callback)
@@ -164,3 +172,23 @@ sn_coap_hdr_s* M2MObjectInstance::handle_post_request(nsdl_s *,
 void M2MObjectInstance::notification_update(M2MBase::Observation)
 {
 }
+
+M2MMemoryStats M2MObjectInstance::memory_stats() const
+{
+    return _memory_stats;
+}
+
+void M2MObjectInstance::memory_updated(M2MMemoryStats::Category category, int32_t delta)
+{
+    _memory_stats.update(category, delta);
+}
+
+void M2MObjectInstance::update_memory_stats(M2MMemoryStats::Category category, int32_t delta)
+{
+    _memory_stats.update(category, delta);
+}
+
+void M2MObjectInstance::update_owner_memory_stats(M2MMemoryStats::Category,
+                                                  int32_t)
+{
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "m2mreceivebufferpool_stub.h"
+
+uint8_t m2mreceivebufferpool_stub::buffer[1024];
+uint8_t *m2mreceivebufferpool_stub::acquire_value = m2mreceivebufferpool_stub::buffer;
+bool m2mreceivebufferpool_stub::owns_value = false;
+uint16_t m2mreceivebufferpool_stub::size_value = sizeof(m2mreceivebufferpool_stub::buffer);
+uint8_t *m2mreceivebufferpool_stub::released = NULL;
+
+void m2mreceivebufferpool_stub::clear()
+{
+    acquire_value = buffer;
+    owns_value = false;
+    size_value = sizeof(buffer);
+    released = NULL;
+}
+
+M2MReceiveBufferPool::M2MReceiveBufferPool(uint8_t, uint16_t)
+{
+}
+
+M2MReceiveBufferPool::~M2MReceiveBufferPool()
+{
+}
+
+uint8_t* M2MReceiveBufferPool::acquire()
+{
+    return m2mreceivebufferpool_stub::acquire_value;
+}
+
+void M2MReceiveBufferPool::release(uint8_t *buffer)
+{
+    m2mreceivebufferpool_stub::released = buffer;
+}
+
+bool M2MReceiveBufferPool::owns(const uint8_t *) const
+{
+    return m2mreceivebufferpool_stub::owns_value;
+}
+
+uint16_t M2MReceiveBufferPool::buffer_size() const
+{
+    return m2mreceivebufferpool_stub::size_value;
+}
+
+uint8_t M2MReceiveBufferPool::available() const
+{
+    return 0;
+}
+
+uint32_t M2MReceiveBufferPool::memory() const
+{
+    return sizeof(M2MReceiveBufferPool);
+}
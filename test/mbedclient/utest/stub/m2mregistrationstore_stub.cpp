@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stddef.h>
+#include "m2mregistrationstore_stub.h"
+
+bool m2mregistrationstore_stub::bool_value = false;
+bool m2mregistrationstore_stub::registered = false;
+uint8_t m2mregistrationstore_stub::load_count = 0;
+uint8_t m2mregistrationstore_stub::save_count = 0;
+uint8_t m2mregistrationstore_stub::clear_count = 0;
+uint8_t m2mregistrationstore_stub::address_length = 0;
+
+void m2mregistrationstore_stub::clear()
+{
+    bool_value = false;
+    registered = false;
+    load_count = 0;
+    save_count = 0;
+    clear_count = 0;
+    address_length = 0;
+}
+
+M2MRegistrationStore::M2MRegistrationStore(const char *)
+: _path(NULL),
+  _location_length(0),
+  _lifetime(0),
+  _registered_at(0),
+  _address_length(0),
+  _port(0),
+  _session(NULL),
+  _session_length(0)
+{
+}
+
+M2MRegistrationStore::~M2MRegistrationStore()
+{
+}
+
+bool M2MRegistrationStore::load()
+{
+    m2mregistrationstore_stub::load_count++;
+    return m2mregistrationstore_stub::bool_value;
+}
+
+bool M2MRegistrationStore::save()
+{
+    m2mregistrationstore_stub::save_count++;
+    return m2mregistrationstore_stub::bool_value;
+}
+
+void M2MRegistrationStore::clear()
+{
+    m2mregistrationstore_stub::clear_count++;
+    m2mregistrationstore_stub::registered = false;
+}
+
+bool M2MRegistrationStore::is_registered() const
+{
+    return m2mregistrationstore_stub::registered;
+}
+
+bool M2MRegistrationStore::can_resume(const char *, const char *, uint32_t) const
+{
+    return m2mregistrationstore_stub::bool_value;
+}
+
+bool M2MRegistrationStore::set_registration(const char *,
+                                            const char *,
+                                            const uint8_t *,
+                                            uint8_t,
+                                            uint32_t,
+                                            uint32_t)
+{
+    m2mregistrationstore_stub::registered = m2mregistrationstore_stub::bool_value;
+    return m2mregistrationstore_stub::bool_value;
+}
+
+void M2MRegistrationStore::registration_updated(uint32_t, uint32_t)
+{
+}
+
+const uint8_t* M2MRegistrationStore::location(uint8_t &length) const
+{
+    length = 0;
+    return NULL;
+}
+
+uint32_t M2MRegistrationStore::lifetime() const
+{
+    return 0;
+}
+
+uint32_t M2MRegistrationStore::registered_at() const
+{
+    return 0;
+}
+
+void M2MRegistrationStore::set_server_address(const uint8_t *, uint8_t length, uint16_t)
+{
+    m2mregistrationstore_stub::address_length = length;
+}
+
+const uint8_t* M2MRegistrationStore::server_address(uint8_t &length, uint16_t &port) const
+{
+    length = 0;
+    port = 0;
+    return NULL;
+}
+
+bool M2MRegistrationStore::set_dtls_session(const uint8_t *, uint16_t)
+{
+    return m2mregistrationstore_stub::bool_value;
+}
+
+const uint8_t* M2MRegistrationStore::dtls_session(uint16_t &length) const
+{
+    length = 0;
+    return NULL;
+}
@@ -39,6 +39,13 @@ M2MResource::M2MResource(const M2MResource& other)
     *this = other;
 }
 
+M2MResource::M2MResource(const M2MResource& other,
+                         M2MObjectInstanceCallback &object_instance_callback)
+: M2MResourceInstance(other, object_instance_callback)
+{
+    *this = other;
+}
+
 M2MResource::M2MResource(M2MObjectInstanceCallback & object_instance_callback,
                          const String &resource_name,
                          const String &resource_type,
@@ -107,3 +114,12 @@ void M2MResource::add_observation_level(M2MBase::Observation)
 void M2MResource::remove_observation_level(M2MBase::Observation)
 {
 }
+
+M2MMemoryStats M2MResource::memory_stats() const
+{
+    return M2MMemoryStats();
+}
+
+void M2MResource::set_memory_attached(bool)
+{
+}
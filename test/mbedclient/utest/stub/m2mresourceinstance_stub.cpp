@@ -20,6 +20,8 @@ bool m2mresourceinstance_stub::bool_value;
 M2MResourceInstance::ResourceType m2mresourceinstance_stub::resource_type;
 sn_coap_hdr_s *m2mresourceinstance_stub::header;
 uint8_t* m2mresourceinstance_stub::value;
+uint32_t m2mresourceinstance_stub::set_value_count;
+uint32_t m2mresourceinstance_stub::set_value_length;
 
 
 void m2mresourceinstance_stub::clear()
@@ -29,6 +31,8 @@ void m2mresourceinstance_stub::clear()
     resource_type = M2MResourceInstance::STRING;
     header = NULL;
     value = NULL;
+    set_value_count = 0;
+    set_value_length = 0;
 }
 
 M2MResourceInstance& M2MResourceInstance::operator=(const M2MResourceInstance&)
@@ -43,6 +47,14 @@ M2MResourceInstance::M2MResourceInstance(const M2MResourceInstance& other)
     this->operator=(other);
 }
 
+M2MResourceInstance::M2MResourceInstance(const M2MResourceInstance& other,
+                                         M2MObjectInstanceCallback &object_instance_callback)
+: M2MBase(other),
+  _object_instance_callback(object_instance_callback)
+{
+    this->operator=(other);
+}
+
 M2MResourceInstance::M2MResourceInstance(const String &res_name,
                                          const String &,
                                          M2MResourceInstance::ResourceType,
@@ -89,8 +101,10 @@ void M2MResourceInstance::set_execute_function(execute_callback)
 }
 
 bool M2MResourceInstance::set_value(const uint8_t *,
-                                    const uint32_t )
+                                    const uint32_t value_length)
 {
+    m2mresourceinstance_stub::set_value_count++;
+    m2mresourceinstance_stub::set_value_length = value_length;
     return m2mresourceinstance_stub::bool_value;
 }
 
@@ -142,3 +156,13 @@ sn_coap_hdr_s* M2MResourceInstance::handle_post_request(nsdl_s *,
 {
     return m2mresourceinstance_stub::header;
 }
+
+M2MMemoryStats M2MResourceInstance::memory_stats() const
+{
+    return M2MMemoryStats();
+}
+
+void M2MResourceInstance::update_owner_memory_stats(M2MMemoryStats::Category,
+                                                    int32_t)
+{
+}
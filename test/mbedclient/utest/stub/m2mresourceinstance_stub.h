@@ -26,6 +26,8 @@ namespace m2mresourceinstance_stub
     extern bool bool_value;
     extern M2MResourceInstance::ResourceType resource_type;
     extern sn_coap_hdr_s *header;
+    extern uint32_t set_value_count;
+    extern uint32_t set_value_length;
     void clear();
 }
 
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "m2mresourcetable_stub.h"
+
+uint32_t m2mresourcetable_stub::row_count;
+uint16_t m2mresourcetable_stub::instance_id;
+uint16_t m2mresourcetable_stub::resource_id;
+int32_t m2mresourcetable_stub::int_value;
+bool m2mresourcetable_stub::bool_value;
+uint8_t *m2mresourcetable_stub::value;
+uint32_t m2mresourcetable_stub::value_length;
+M2MBase::Operation m2mresourcetable_stub::operation;
+
+void m2mresourcetable_stub::clear()
+{
+    row_count = 0;
+    instance_id = 0;
+    resource_id = 0;
+    int_value = -1;
+    bool_value = false;
+    value = NULL;
+    value_length = 0;
+    operation = M2MBase::NOT_ALLOWED;
+}
+
+M2MResourceTable::M2MResourceTable(const String &object_name)
+: M2MObject(object_name)
+{
+}
+
+M2MResourceTable::M2MResourceTable(const String &object_name,
+                                   const M2MResourceTable::ConstResource *,
+                                   uint16_t)
+: M2MObject(object_name)
+{
+}
+
+M2MResourceTable::~M2MResourceTable()
+{
+}
+
+bool M2MResourceTable::add_resource(uint16_t,
+                                    uint16_t,
+                                    M2MResourceInstance::ResourceType,
+                                    M2MBase::Operation,
+                                    const uint8_t *,
+                                    const uint32_t)
+{
+    return m2mresourcetable_stub::bool_value;
+}
+
+bool M2MResourceTable::set_resource_value(uint16_t,
+                                          uint16_t,
+                                          const uint8_t *,
+                                          const uint32_t)
+{
+    return m2mresourcetable_stub::bool_value;
+}
+
+const uint8_t* M2MResourceTable::resource_value(uint16_t,
+                                                uint16_t,
+                                                uint32_t &value_length) const
+{
+    value_length = m2mresourcetable_stub::value_length;
+    return m2mresourcetable_stub::value;
+}
+
+int32_t M2MResourceTable::find_row(uint16_t, uint16_t) const
+{
+    return m2mresourcetable_stub::int_value;
+}
+
+uint32_t M2MResourceTable::instance_rows(uint16_t, uint32_t &first_row) const
+{
+    first_row = 0;
+    return m2mresourcetable_stub::row_count;
+}
+
+uint32_t M2MResourceTable::row_count() const
+{
+    return m2mresourcetable_stub::row_count;
+}
+
+uint16_t M2MResourceTable::row_instance_id(uint32_t) const
+{
+    return m2mresourcetable_stub::instance_id;
+}
+
+uint16_t M2MResourceTable::row_resource_id(uint32_t) const
+{
+    return m2mresourcetable_stub::resource_id;
+}
+
+M2MResourceInstance::ResourceType M2MResourceTable::row_type(uint32_t) const
+{
+    return M2MResourceInstance::STRING;
+}
+
+M2MBase::Operation M2MResourceTable::row_operation(uint32_t) const
+{
+    return m2mresourcetable_stub::operation;
+}
+
+const uint8_t* M2MResourceTable::row_value(uint32_t, uint32_t &value_length) const
+{
+    value_length = m2mresourcetable_stub::value_length;
+    return m2mresourcetable_stub::value;
+}
+
+sn_coap_hdr_s* M2MResourceTable::handle_get_request(nsdl_s *,
+                                                    sn_coap_hdr_s *,
+                                                    M2MObservationHandler *)
+{
+    return NULL;
+}
+
+sn_coap_hdr_s* M2MResourceTable::handle_put_request(nsdl_s *,
+                                                    sn_coap_hdr_s *,
+                                                    M2MObservationHandler *)
+{
+    return NULL;
+}
+
+sn_coap_hdr_s* M2MResourceTable::handle_post_request(nsdl_s *,
+                                                     sn_coap_hdr_s *,
+                                                     M2MObservationHandler *)
+{
+    return NULL;
+}
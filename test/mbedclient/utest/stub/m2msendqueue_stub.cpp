@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include "m2msendqueue_stub.h"
+
+bool m2msendqueue_stub::enqueue_value = true;
+const uint8_t *m2msendqueue_stub::front_value = NULL;
+uint16_t m2msendqueue_stub::front_length = 0;
+sn_nsdl_addr_s m2msendqueue_stub::address;
+uint8_t m2msendqueue_stub::address_data[16];
+uint8_t m2msendqueue_stub::count_value = 0;
+uint8_t m2msendqueue_stub::sent_count = 0;
+uint8_t m2msendqueue_stub::received_count = 0;
+uint32_t m2msendqueue_stub::tick_value = 0;
+bool m2msendqueue_stub::cleared = false;
+uint8_t m2msendqueue_stub::in_flight_value = 0;
+M2MSendQueue::Priority m2msendqueue_stub::classify_value = M2MSendQueue::Response;
+
+void m2msendqueue_stub::clear()
+{
+    enqueue_value = true;
+    front_value = NULL;
+    front_length = 0;
+    memset(&address, 0, sizeof(address));
+    memset(address_data, 0, sizeof(address_data));
+    count_value = 0;
+    sent_count = 0;
+    received_count = 0;
+    tick_value = 0;
+    cleared = false;
+    in_flight_value = 0;
+    classify_value = M2MSendQueue::Response;
+}
+
+M2MSendQueue::M2MSendQueue(uint8_t, uint8_t, uint32_t)
+{
+}
+
+M2MSendQueue::~M2MSendQueue()
+{
+}
+
+bool M2MSendQueue::enqueue(const uint8_t *data, uint16_t length, const sn_nsdl_addr_s *address)
+{
+    if(m2msendqueue_stub::enqueue_value) {
+        m2msendqueue_stub::front_value = data;
+        m2msendqueue_stub::front_length = length;
+        if(address) {
+            m2msendqueue_stub::address = *address;
+        }
+        m2msendqueue_stub::address.addr_ptr = m2msendqueue_stub::address_data;
+        m2msendqueue_stub::count_value = 1;
+    }
+    return m2msendqueue_stub::enqueue_value;
+}
+
+const uint8_t* M2MSendQueue::front(uint16_t &length, sn_nsdl_addr_s *&address)
+{
+    if(!m2msendqueue_stub::count_value) {
+        length = 0;
+        address = NULL;
+        return NULL;
+    }
+    length = m2msendqueue_stub::front_length;
+    address = &m2msendqueue_stub::address;
+    return m2msendqueue_stub::front_value;
+}
+
+void M2MSendQueue::sent()
+{
+    m2msendqueue_stub::sent_count++;
+    m2msendqueue_stub::count_value = 0;
+}
+
+void M2MSendQueue::message_received(const uint8_t *, uint16_t)
+{
+    m2msendqueue_stub::received_count++;
+}
+
+void M2MSendQueue::tick(uint32_t now)
+{
+    m2msendqueue_stub::tick_value = now;
+}
+
+void M2MSendQueue::clear()
+{
+    m2msendqueue_stub::cleared = true;
+    m2msendqueue_stub::count_value = 0;
+}
+
+uint8_t M2MSendQueue::count() const
+{
+    return m2msendqueue_stub::count_value;
+}
+
+uint8_t M2MSendQueue::in_flight() const
+{
+    return m2msendqueue_stub::in_flight_value;
+}
+
+const M2MSendQueue::Stats& M2MSendQueue::stats() const
+{
+    return _stats;
+}
+
+M2MSendQueue::Priority M2MSendQueue::classify(const uint8_t *, uint16_t)
+{
+    return m2msendqueue_stub::classify_value;
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_SEND_QUEUE_STUB_H
+#define M2M_SEND_QUEUE_STUB_H
+
+#include <stddef.h>
+#include "include/m2msendqueue.h"
+
+//some internal test related stuff
+namespace m2msendqueue_stub
+{
+    extern bool enqueue_value;
+    extern const uint8_t *front_value;      // Last queued message, held until sent().
+    extern uint16_t front_length;
+    extern sn_nsdl_addr_s address;
+    extern uint8_t address_data[16];
+    extern uint8_t count_value;
+    extern uint8_t sent_count;
+    extern uint8_t received_count;
+    extern uint32_t tick_value;
+    extern bool cleared;
+    extern uint8_t in_flight_value;
+    extern M2MSendQueue::Priority classify_value;
+    void clear();
+}
+
+#endif // M2M_SEND_QUEUE_STUB_H
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "m2mstringpool.h"
+
+static const String empty_string;
+
+M2MStringPool::Entry **M2MStringPool::_entries = NULL;
+uint16_t M2MStringPool::_size = 0;
+uint16_t M2MStringPool::_capacity = 0;
+
+M2MStringPool::Handle M2MStringPool::acquire(const String &)
+{
+    return EMPTY;
+}
+
+M2MStringPool::Handle M2MStringPool::acquire(M2MStringPool::Handle handle)
+{
+    return handle;
+}
+
+void M2MStringPool::release(M2MStringPool::Handle)
+{
+}
+
+const String& M2MStringPool::string(M2MStringPool::Handle)
+{
+    return empty_string;
+}
+
+uint16_t M2MStringPool::size()
+{
+    return 0;
+}
+
+uint32_t M2MStringPool::memory()
+{
+    return 0;
+}
+
+const char* M2MStringPool::acquire_bytes(const String &)
+{
+    return NULL;
+}
+
+bool M2MStringPool::release_bytes(const void *)
+{
+    return false;
+}
@@ -17,11 +17,27 @@
 
 bool m2mtimer_stub::bool_value;
 bool m2mtimer_stub::total_bool_value;
+uint64_t m2mtimer_stub::interval;
+bool m2mtimer_stub::single_shot;
+uint8_t m2mtimer_stub::start_count;
+bool m2mtimer_stub::polled;
+bool m2mtimer_stub::expiry_value;
+uint64_t m2mtimer_stub::expiry;
+uint64_t m2mtimer_stub::poll_time;
+uint8_t m2mtimer_stub::poll_count;
 
 void m2mtimer_stub::clear()
 {
     bool_value = false;
     total_bool_value = false;
+    interval = 0;
+    single_shot = false;
+    start_count = 0;
+    polled = false;
+    expiry_value = false;
+    expiry = 0;
+    poll_time = 0;
+    poll_count = 0;
 }
 
 // Prevents the use of assignment operator
@@ -46,10 +62,13 @@ M2MTimer::~M2MTimer()
 {
 }
 
-void M2MTimer::start_timer(uint64_t /*interval*/,
+void M2MTimer::start_timer(uint64_t interval,
                            M2MTimerObserver::Type /*type*/,
-                           bool /*single_shot*/)
+                           bool single_shot)
 {
+    m2mtimer_stub::interval = interval;
+    m2mtimer_stub::single_shot = single_shot;
+    m2mtimer_stub::start_count++;
 }
 
 void M2MTimer::start_dtls_timer(uint64_t , uint64_t , M2MTimerObserver::Type )
@@ -68,3 +87,20 @@ bool M2MTimer::is_intermediate_interval_passed(){
 bool M2MTimer::is_total_interval_passed(){
     return m2mtimer_stub::total_bool_value;
 }
+
+void M2MTimer::set_polled(bool polled)
+{
+    m2mtimer_stub::polled = polled;
+}
+
+bool M2MTimer::next_expiry(uint64_t &time)
+{
+    time = m2mtimer_stub::expiry;
+    return m2mtimer_stub::expiry_value;
+}
+
+void M2MTimer::poll(uint64_t time)
+{
+    m2mtimer_stub::poll_time = time;
+    m2mtimer_stub::poll_count++;
+}
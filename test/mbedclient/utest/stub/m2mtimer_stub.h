@@ -23,6 +23,14 @@ namespace m2mtimer_stub
 {
     extern bool bool_value;
     extern bool total_bool_value;
+    extern uint64_t interval;
+    extern bool single_shot;
+    extern uint8_t start_count;
+    extern bool polled;
+    extern bool expiry_value;
+    extern uint64_t expiry;
+    extern uint64_t poll_time;
+    extern uint8_t poll_count;
     void clear();
 }
 
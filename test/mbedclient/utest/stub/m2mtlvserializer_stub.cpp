@@ -39,3 +39,13 @@ uint8_t* M2MTLVSerializer::serialize(M2MResourceList resource_list, uint32_t &si
 {
     return m2mtlvserializer_stub::uint8_value;
 }
+
+uint8_t* M2MTLVSerializer::serialize(const M2MResourceTable *, uint32_t &)
+{
+    return m2mtlvserializer_stub::uint8_value;
+}
+
+uint8_t* M2MTLVSerializer::serialize(const M2MResourceTable *, uint16_t, uint32_t &)
+{
+    return m2mtlvserializer_stub::uint8_value;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include "m2mwakewindow_stub.h"
+
+bool m2mwakewindow_stub::is_open_value = false;
+M2MWakeWindow::Change m2mwakewindow_stub::tick_value = M2MWakeWindow::None;
+bool m2mwakewindow_stub::tick_pending = false;
+uint32_t m2mwakewindow_stub::next_change_value = 0;
+uint8_t m2mwakewindow_stub::open_count = 0;
+uint8_t m2mwakewindow_stub::stop_count = 0;
+uint8_t m2mwakewindow_stub::sent_count = 0;
+uint32_t m2mwakewindow_stub::sent_bytes = 0;
+uint8_t m2mwakewindow_stub::received_count = 0;
+uint8_t m2mwakewindow_stub::deferred_count = 0;
+uint32_t m2mwakewindow_stub::listen_time = 0;
+uint32_t m2mwakewindow_stub::wake_interval = 0;
+M2MInterface::QueueModeStats m2mwakewindow_stub::stats;
+
+void m2mwakewindow_stub::clear()
+{
+    is_open_value = false;
+    tick_value = M2MWakeWindow::None;
+    tick_pending = false;
+    next_change_value = 0;
+    open_count = 0;
+    stop_count = 0;
+    sent_count = 0;
+    sent_bytes = 0;
+    received_count = 0;
+    deferred_count = 0;
+    listen_time = 0;
+    wake_interval = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+M2MWakeWindow::M2MWakeWindow(uint32_t, uint32_t)
+{
+}
+
+M2MWakeWindow::~M2MWakeWindow()
+{
+}
+
+void M2MWakeWindow::set_timing(uint32_t listen_time, uint32_t wake_interval)
+{
+    m2mwakewindow_stub::listen_time = listen_time;
+    m2mwakewindow_stub::wake_interval = wake_interval;
+}
+
+bool M2MWakeWindow::open(uint32_t)
+{
+    if(m2mwakewindow_stub::is_open_value) {
+        return false;
+    }
+    m2mwakewindow_stub::is_open_value = true;
+    m2mwakewindow_stub::open_count++;
+    return true;
+}
+
+void M2MWakeWindow::stop(uint32_t)
+{
+    m2mwakewindow_stub::is_open_value = false;
+    m2mwakewindow_stub::stop_count++;
+}
+
+bool M2MWakeWindow::is_open() const
+{
+    return m2mwakewindow_stub::is_open_value;
+}
+
+void M2MWakeWindow::message_received(uint32_t)
+{
+    m2mwakewindow_stub::received_count++;
+}
+
+void M2MWakeWindow::message_sent(uint32_t, uint16_t bytes)
+{
+    m2mwakewindow_stub::sent_count++;
+    m2mwakewindow_stub::sent_bytes += bytes;
+}
+
+void M2MWakeWindow::message_deferred()
+{
+    m2mwakewindow_stub::deferred_count++;
+}
+
+M2MWakeWindow::Change M2MWakeWindow::tick(uint32_t, bool pending)
+{
+    m2mwakewindow_stub::tick_pending = pending;
+    if(M2MWakeWindow::Opened == m2mwakewindow_stub::tick_value) {
+        m2mwakewindow_stub::is_open_value = true;
+    } else if(M2MWakeWindow::Closed == m2mwakewindow_stub::tick_value) {
+        m2mwakewindow_stub::is_open_value = false;
+    }
+    return m2mwakewindow_stub::tick_value;
+}
+
+uint32_t M2MWakeWindow::next_change(uint32_t, bool) const
+{
+    return m2mwakewindow_stub::next_change_value;
+}
+
+M2MInterface::QueueModeStats M2MWakeWindow::stats(uint32_t) const
+{
+    return m2mwakewindow_stub::stats;
+}
+
+void M2MWakeWindow::close(uint32_t)
+{
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_WAKE_WINDOW_STUB_H
+#define M2M_WAKE_WINDOW_STUB_H
+
+#include "include/m2mwakewindow.h"
+
+//some internal test related stuff
+namespace m2mwakewindow_stub
+{
+    extern bool is_open_value;
+    extern M2MWakeWindow::Change tick_value;
+    extern bool tick_pending;
+    extern uint32_t next_change_value;
+    extern uint8_t open_count;
+    extern uint8_t stop_count;
+    extern uint8_t sent_count;
+    extern uint32_t sent_bytes;
+    extern uint8_t received_count;
+    extern uint8_t deferred_count;
+    extern uint32_t listen_time;
+    extern uint32_t wake_interval;
+    extern M2MInterface::QueueModeStats stats;
+    void clear();
+}
+
+#endif // M2M_WAKE_WINDOW_STUB_H
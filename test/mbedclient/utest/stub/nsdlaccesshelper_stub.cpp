@@ -19,7 +19,7 @@ bool nsdlaccesshelper_stub::bool_value;
 void* nsdlaccesshelper_stub::void_value;
 uint8_t nsdlaccesshelper_stub::int_value;
 
-M2MNsdlInterface  *__nsdl_interface= NULL;
+M2M_THREAD_LOCAL M2MNsdlInterface  *__nsdl_processing_interface= NULL;
 #ifdef USE_LINUX
 M2MTimerImpl  *__timer_impl = NULL;
 M2MConnectionHandler *__connection_impl = NULL;
@@ -31,6 +31,20 @@ void nsdlaccesshelper_stub::clear()
     int_value = 0;
 }
 
+bool __nsdl_interface_register(struct nsdl_s *, M2MNsdlInterface *)
+{
+    return nsdlaccesshelper_stub::bool_value;
+}
+
+void __nsdl_interface_unregister(struct nsdl_s *)
+{
+}
+
+M2MNsdlInterface* __nsdl_interface_find(struct nsdl_s *)
+{
+    return NULL;
+}
+
 uint8_t __nsdl_c_callback(struct nsdl_s * ,
                           sn_coap_hdr_s *,
                           sn_nsdl_addr_s *,
@@ -0,0 +1,784 @@
+/*
+ * Copyright (c) 2015 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * Load generator emulating a large number of mbed Client devices in one
+ * process. Every virtual device runs its own M2MInterface with a generated
+ * object model, the devices are driven by a shared pool of worker threads
+ * which register them at a configurable rate and update their observable
+ * resources periodically. Registration latency, notification throughput
+ * and memory are reported per device and as an aggregate.
+ *
+ * The devices run in poll mode on a single network thread, which is the
+ * only thread touching the interfaces and the object models. The workers
+ * only decide what is due and post the work to that thread through an
+ * M2MCommandQueue.
+ */
+#include <unistd.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <poll.h>
+#include <signal.h> /* For SIGIGN and SIGINT */
+#include "mbed-client/m2minterfacefactory.h"
+#include "mbed-client/m2mdevice.h"
+#include "mbed-client/m2minterfaceobserver.h"
+#include "mbed-client/m2minterface.h"
+#include "mbed-client/m2mobject.h"
+#include "mbed-client/m2mobjectinstance.h"
+#include "mbed-client/m2mresource.h"
+#include "mbed-client/m2msecurity.h"
+#include "mbed-client/m2mcommandqueue.h"
+#include "mbed-client/m2mtimer.h"
+
+#include "ns_trace.h"
+
+typedef void (*signalhandler_t)(int); /* Function pointer type for ctrl-c */
+
+// Generated objects get IDs from the private range.
+const uint16_t OBJECT_ID_BASE = 26241;
+const uint32_t UNREGISTER_TIMEOUT = 5000000;
+// Longest the network thread waits, in milliseconds, before applying posted commands.
+const int NETWORK_POLL_TIMEOUT = 1;
+
+typedef struct {
+    uint32_t    clients;
+    uint32_t    workers;
+    const char  *server_address;
+    uint16_t    base_port;
+    int32_t     life_time;
+    uint32_t    objects;
+    uint32_t    instances;
+    uint32_t    resources;
+    uint32_t    observable_percent;
+    uint32_t    update_interval;    // Milliseconds between updates of one device, 0 disables.
+    uint32_t    updates_per_tick;
+    uint32_t    ramp_rate;          // Registrations started per second, 0 starts all at once.
+    uint32_t    duration;           // Seconds, 0 runs until interrupted.
+    bool        verbose;
+} Options;
+
+static volatile bool running = true;
+
+static uint64_t now_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static uint32_t heap_in_use()
+{
+    struct mallinfo mi = mallinfo();
+    return (uint32_t)mi.uordblks + (uint32_t)mi.hblkhd;
+}
+
+/**
+ * One emulated device. Library callbacks and the posted commands run on
+ * the network thread, tick() is called by the workers, never by two of
+ * them at the same time.
+ */
+class LoadClient: public M2MInterfaceObserver {
+public:
+
+    typedef enum {
+        Idle,
+        Registering,
+        Registered,
+        Unregistering,
+        Unregistered,
+        Failed
+    } State;
+
+    LoadClient(uint32_t index, const Options &options, M2MCommandQueue &commands)
+    : _index(index),
+      _options(options),
+      _commands(commands),
+      _interface(NULL),
+      _security(NULL),
+      _resources(NULL),
+      _resource_count(0),
+      _next_resource(0),
+      _state(Idle),
+      _busy(false),
+      _register_at(0),
+      _register_start(0),
+      _register_latency(0),
+      _next_update(0),
+      _value(0),
+      _updates(0),
+      _notifications(0),
+      _errors(0)
+    {
+    }
+
+    virtual ~LoadClient() {
+        // The interface owns the device object and only refers to the
+        // other objects, so it goes first.
+        delete _interface;
+        M2MObjectList::const_iterator it = _objects.begin();
+        for ( ; it != _objects.end(); it++) {
+            delete *it;
+        }
+        delete _security;
+        free(_resources);
+    }
+
+    bool create(uint64_t start) {
+        char name[32];
+        snprintf(name, sizeof(name), "loadgen-%06u", _index);
+        uint16_t port = _options.base_port ? _options.base_port + _index : 0;
+        _interface = M2MInterfaceFactory::create_interface(*this,
+                                                           name,
+                                                           "loadgen",
+                                                           _options.life_time,
+                                                           port,
+                                                           "",
+                                                           M2MInterface::UDP,
+                                                           M2MInterface::LwIP_IPv4,
+                                                           "");
+        if(!_interface || !create_security() || !create_object_model()) {
+            return false;
+        }
+        _interface->set_poll_mode(true);
+        _register_at = start;
+        if(_options.ramp_rate) {
+            _register_at += (uint64_t)_index * 1000000ULL / _options.ramp_rate;
+        }
+        return true;
+    }
+
+    /**
+     * Runs the work that is due, returns true if something was done.
+     */
+    bool tick(uint64_t now) {
+        if(__atomic_exchange_n(&_busy, true, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        bool worked = false;
+        uint8_t state = __atomic_load_n(&_state, __ATOMIC_ACQUIRE);
+        if(Idle == state && now >= _register_at) {
+            _register_start = now;
+            __atomic_store_n(&_state, (uint8_t)Registering, __ATOMIC_RELEASE);
+            if(!_commands.post_call(&LoadClient::register_device, this)) {
+                fail();
+            }
+            worked = true;
+        } else if(Registered == state && _options.update_interval &&
+                  _resource_count && now >= __atomic_load_n(&_next_update, __ATOMIC_RELAXED)) {
+            if(!_commands.post_call(&LoadClient::update_resources, this)) {
+                __atomic_add_fetch(&_errors, 1, __ATOMIC_RELAXED);
+            }
+            __atomic_store_n(&_next_update, now + (uint64_t)_options.update_interval * 1000,
+                             __ATOMIC_RELAXED);
+            worked = true;
+        }
+        __atomic_store_n(&_busy, false, __ATOMIC_RELEASE);
+        return worked;
+    }
+
+    void unregister() {
+        uint8_t expected = Registered;
+        if(__atomic_compare_exchange_n(&_state, &expected, (uint8_t)Unregistering,
+                                       false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) &&
+           !_commands.post_call(&LoadClient::unregister_device, this)) {
+            fail();
+        }
+    }
+
+    /**
+     * Appends the socket of the device to the set to poll, on the network thread.
+     */
+    bool add_socket(struct pollfd *fds, nfds_t &count) const {
+        int fd = _interface->socket_fd();
+        if(fd < 0) {
+            return false;
+        }
+        fds[count].fd = fd;
+        fds[count].events = POLLIN;
+        fds[count].revents = 0;
+        count++;
+        return true;
+    }
+
+    M2MInterface* interface() const { return _interface; }
+
+    State state() const { return (State)__atomic_load_n(&_state, __ATOMIC_ACQUIRE); }
+    uint32_t index() const { return _index; }
+    uint64_t register_latency() const { return _register_latency; }
+    uint32_t updates() const { return __atomic_load_n(&_updates, __ATOMIC_RELAXED); }
+    uint32_t notifications() const { return __atomic_load_n(&_notifications, __ATOMIC_RELAXED); }
+    uint32_t errors() const { return __atomic_load_n(&_errors, __ATOMIC_RELAXED); }
+    uint32_t memory() const { return _interface ? _interface->memory_stats().total() : 0; }
+
+    // From M2MInterfaceObserver
+    void bootstrap_done(M2MSecurity */*server_object*/) {
+    }
+
+    void object_registered(M2MSecurity */*security_object*/, const M2MServer &/*server_object*/) {
+        uint64_t now = now_us();
+        _register_latency = now - _register_start;
+        __atomic_store_n(&_next_update, now + (uint64_t)_options.update_interval * 1000,
+                         __ATOMIC_RELAXED);
+        __atomic_store_n(&_state, (uint8_t)Registered, __ATOMIC_RELEASE);
+    }
+
+    void object_unregistered(M2MSecurity */*server_object*/) {
+        __atomic_store_n(&_state, (uint8_t)Unregistered, __ATOMIC_RELEASE);
+    }
+
+    void registration_updated(M2MSecurity */*security_object*/, const M2MServer &/*server_object*/) {
+    }
+
+    void error(M2MInterface::Error /*error*/) {
+        fail();
+    }
+
+    void value_updated(M2MBase */*base*/, M2MBase::BaseType /*type*/) {
+    }
+
+private:
+
+    void fail() {
+        __atomic_add_fetch(&_errors, 1, __ATOMIC_RELAXED);
+        uint8_t state = __atomic_load_n(&_state, __ATOMIC_ACQUIRE);
+        if(Registering == state || Unregistering == state) {
+            __atomic_store_n(&_state, (uint8_t)Failed, __ATOMIC_RELEASE);
+        }
+    }
+
+    // Commands run on the network thread.
+    static void register_device(void *argument) {
+        LoadClient *client = (LoadClient*)argument;
+        M2MObjectList object_list;
+        M2MObjectList::const_iterator it = client->_objects.begin();
+        object_list.push_back(client->_interface->device());
+        for ( ; it != client->_objects.end(); it++) {
+            object_list.push_back(*it);
+        }
+        client->_interface->register_object(client->_security, object_list);
+    }
+
+    static void unregister_device(void *argument) {
+        ((LoadClient*)argument)->_interface->unregister_object(NULL);
+    }
+
+    static void update_resources(void *argument) {
+        LoadClient *client = (LoadClient*)argument;
+        for(uint32_t i = 0; i < client->_options.updates_per_tick; i++) {
+            client->update_resource();
+        }
+    }
+
+    bool create_security() {
+        _security = M2MInterfaceFactory::create_security(M2MSecurity::M2MServer);
+        return _security &&
+               _security->set_resource_value(M2MSecurity::M2MServerUri, _options.server_address) &&
+               _security->set_resource_value(M2MSecurity::SecurityMode, M2MSecurity::NoSecurity);
+    }
+
+    bool create_object_model() {
+        M2MDevice *device = _interface->device();
+        if(!device ||
+           !device->create_resource(M2MDevice::Manufacturer, "loadgen") ||
+           !device->create_resource(M2MDevice::ModelNumber, "virtual")) {
+            return false;
+        }
+        uint32_t total = _options.objects * _options.instances * _options.resources;
+        if(total) {
+            _resources = (M2MResource**)malloc(total * sizeof(M2MResource*));
+            if(!_resources) {
+                return false;
+            }
+        }
+        char name[8];
+        uint32_t counter = 0;
+        for(uint32_t o = 0; o < _options.objects; o++) {
+            snprintf(name, sizeof(name), "%u", OBJECT_ID_BASE + o);
+            M2MObject *object = M2MInterfaceFactory::create_object(name);
+            if(!object) {
+                return false;
+            }
+            _objects.push_back(object);
+            for(uint32_t i = 0; i < _options.instances; i++) {
+                M2MObjectInstance *inst = object->create_object_instance(i);
+                if(!inst) {
+                    return false;
+                }
+                for(uint32_t r = 0; r < _options.resources; r++, counter++) {
+                    // Spread the observable resources evenly over the model.
+                    bool observable = ((counter + 1) * _options.observable_percent / 100) !=
+                                      (counter * _options.observable_percent / 100);
+                    snprintf(name, sizeof(name), "%u", r);
+                    M2MResource *res = inst->create_dynamic_resource(name,
+                                                                     "LoadTest",
+                                                                     M2MResourceInstance::INTEGER,
+                                                                     observable);
+                    if(!res) {
+                        return false;
+                    }
+                    res->set_operation(M2MBase::GET_PUT_ALLOWED);
+                    res->set_value((const uint8_t*)"0", 1);
+                    if(observable) {
+                        _resources[_resource_count++] = res;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    void update_resource() {
+        M2MResource *res = _resources[_next_resource];
+        _next_resource = (_next_resource + 1) % _resource_count;
+        char buffer[12];
+        int size = snprintf(buffer, sizeof(buffer), "%u", ++_value);
+        res->set_value((const uint8_t*)buffer, (uint32_t)size);
+        __atomic_add_fetch(&_updates, 1, __ATOMIC_RELAXED);
+        // A notification is sent for every update of an observed resource.
+        if(M2MBase::None != res->observation_level()) {
+            __atomic_add_fetch(&_notifications, 1, __ATOMIC_RELAXED);
+        }
+    }
+
+private:
+
+    uint32_t            _index;
+    const Options       &_options;
+    M2MCommandQueue     &_commands;         // Runs the work on the network thread.
+    M2MInterface        *_interface;
+    M2MSecurity         *_security;
+    M2MObjectList       _objects;
+    M2MResource         **_resources;       // Observable resources, updated in turn.
+    uint32_t            _resource_count;
+    uint32_t            _next_resource;     // Network thread only, as is _value.
+    uint8_t             _state;
+    bool                _busy;
+    uint64_t            _register_at;
+    uint64_t            _register_start;
+    uint64_t            _register_latency;
+    uint64_t            _next_update;
+    uint32_t            _value;
+    uint32_t            _updates;
+    uint32_t            _notifications;
+    uint32_t            _errors;
+};
+
+/**
+ * Worker threads sharing one cursor over all the devices, a worker takes
+ * the next device that isn't being run by another worker.
+ */
+class WorkerPool {
+public:
+
+    WorkerPool(LoadClient **clients, uint32_t client_count, uint32_t worker_count)
+    : _clients(clients),
+      _client_count(client_count),
+      _worker_count(worker_count),
+      _threads(NULL),
+      _cursor(0),
+      _running(false)
+    {
+    }
+
+    ~WorkerPool() {
+        stop();
+    }
+
+    bool start() {
+        _threads = (pthread_t*)malloc(_worker_count * sizeof(pthread_t));
+        if(!_threads) {
+            return false;
+        }
+        __atomic_store_n(&_running, true, __ATOMIC_RELEASE);
+        for(uint32_t i = 0; i < _worker_count; i++) {
+            if(pthread_create(&_threads[i], NULL, &WorkerPool::run, this) != 0) {
+                _worker_count = i;
+                stop();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void stop() {
+        if(_threads) {
+            __atomic_store_n(&_running, false, __ATOMIC_RELEASE);
+            for(uint32_t i = 0; i < _worker_count; i++) {
+                pthread_join(_threads[i], NULL);
+            }
+            free(_threads);
+            _threads = NULL;
+        }
+    }
+
+private:
+
+    static void* run(void *arg) {
+        WorkerPool *pool = (WorkerPool*)arg;
+        uint32_t share = pool->_client_count / pool->_worker_count + 1;
+        while(__atomic_load_n(&pool->_running, __ATOMIC_ACQUIRE)) {
+            bool worked = false;
+            uint64_t now = now_us();
+            for(uint32_t i = 0; i < share; i++) {
+                uint32_t index = __atomic_fetch_add(&pool->_cursor, 1, __ATOMIC_RELAXED) %
+                                 pool->_client_count;
+                worked |= pool->_clients[index]->tick(now);
+            }
+            if(!worked) {
+                usleep(1000);
+            }
+        }
+        return NULL;
+    }
+
+private:
+
+    LoadClient          **_clients;
+    uint32_t            _client_count;
+    uint32_t            _worker_count;
+    pthread_t           *_threads;
+    uint32_t            _cursor;
+    bool                _running;
+};
+
+/**
+ * The network thread, runs all the devices in poll mode and applies the
+ * commands posted by the other threads.
+ */
+class NetworkLoop {
+public:
+
+    NetworkLoop(LoadClient **clients, uint32_t client_count, M2MCommandQueue &commands)
+    : _clients(clients),
+      _client_count(client_count),
+      _commands(commands),
+      _fds(NULL),
+      _owners(NULL),
+      _started(false),
+      _running(false)
+    {
+    }
+
+    ~NetworkLoop() {
+        stop();
+        free(_fds);
+        free(_owners);
+    }
+
+    bool start() {
+        _fds = (struct pollfd*)malloc(_client_count * sizeof(struct pollfd));
+        _owners = (LoadClient**)malloc(_client_count * sizeof(LoadClient*));
+        if(!_fds || !_owners) {
+            return false;
+        }
+        __atomic_store_n(&_running, true, __ATOMIC_RELEASE);
+        _started = (pthread_create(&_thread, NULL, &NetworkLoop::run, this) == 0);
+        return _started;
+    }
+
+    void stop() {
+        if(_started) {
+            __atomic_store_n(&_running, false, __ATOMIC_RELEASE);
+            pthread_join(_thread, NULL);
+            _started = false;
+        }
+    }
+
+private:
+
+    static void* run(void *arg) {
+        NetworkLoop *loop = (NetworkLoop*)arg;
+        while(__atomic_load_n(&loop->_running, __ATOMIC_ACQUIRE)) {
+            loop->_commands.process();
+            // Sockets change when a device connects again, so the set is
+            // collected on every round.
+            nfds_t count = 0;
+            for(uint32_t i = 0; i < loop->_client_count; i++) {
+                if(loop->_clients[i]->add_socket(loop->_fds, count)) {
+                    loop->_owners[count - 1] = loop->_clients[i];
+                }
+            }
+            int timeout = NETWORK_POLL_TIMEOUT;
+            uint64_t deadline;
+            if(M2MTimer::next_expiry(deadline) && deadline <= now_us() / 1000) {
+                timeout = 0;
+            }
+            int ready = poll(loop->_fds, count, timeout);
+            for(nfds_t i = 0; ready > 0 && i < count; i++) {
+                if(loop->_fds[i].revents) {
+                    loop->_owners[i]->interface()->process_io();
+                    ready--;
+                }
+            }
+            // The timers are shared by all the devices of the process.
+            M2MTimer::poll(now_us() / 1000);
+        }
+        return NULL;
+    }
+
+private:
+
+    LoadClient          **_clients;
+    uint32_t            _client_count;
+    M2MCommandQueue     &_commands;
+    struct pollfd       *_fds;
+    LoadClient          **_owners;          // Device of each entry in _fds.
+    pthread_t           _thread;
+    bool                _started;
+    bool                _running;
+};
+
+static void ctrl_c_handle_function(void)
+{
+    running = false;
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  -n <count>     Number of virtual devices (default 100)\n");
+    printf("  -w <count>     Number of worker threads (default 4)\n");
+    printf("  -s <uri>       LWM2M server URI (default coap://127.0.0.1:5683)\n");
+    printf("  -p <port>      First local port, 0 lets the system choose (default 0)\n");
+    printf("  -l <seconds>   Registration lifetime (default 3600)\n");
+    printf("  -o <count>     Objects per device (default 1)\n");
+    printf("  -i <count>     Instances per object (default 1)\n");
+    printf("  -r <count>     Resources per instance (default 4)\n");
+    printf("  -O <percent>   Share of observable resources (default 50)\n");
+    printf("  -u <ms>        Update interval of a device, 0 disables (default 5000)\n");
+    printf("  -U <count>     Resources updated per interval (default 1)\n");
+    printf("  -R <rate>      Registrations started per second, 0 for all at once (default 0)\n");
+    printf("  -d <seconds>   Test duration, 0 runs until ctrl-c (default 60)\n");
+    printf("  -v             Print statistics of every device\n");
+}
+
+static bool parse_options(int argc, char **argv, Options &options)
+{
+    options.clients = 100;
+    options.workers = 4;
+    options.server_address = "coap://127.0.0.1:5683";
+    options.base_port = 0;
+    options.life_time = 3600;
+    options.objects = 1;
+    options.instances = 1;
+    options.resources = 4;
+    options.observable_percent = 50;
+    options.update_interval = 5000;
+    options.updates_per_tick = 1;
+    options.ramp_rate = 0;
+    options.duration = 60;
+    options.verbose = false;
+
+    int opt;
+    while((opt = getopt(argc, argv, "n:w:s:p:l:o:i:r:O:u:U:R:d:vh")) != -1) {
+        switch(opt) {
+            case 'n': options.clients = strtoul(optarg, NULL, 10); break;
+            case 'w': options.workers = strtoul(optarg, NULL, 10); break;
+            case 's': options.server_address = optarg; break;
+            case 'p': options.base_port = (uint16_t)strtoul(optarg, NULL, 10); break;
+            case 'l': options.life_time = strtol(optarg, NULL, 10); break;
+            case 'o': options.objects = strtoul(optarg, NULL, 10); break;
+            case 'i': options.instances = strtoul(optarg, NULL, 10); break;
+            case 'r': options.resources = strtoul(optarg, NULL, 10); break;
+            case 'O': options.observable_percent = strtoul(optarg, NULL, 10); break;
+            case 'u': options.update_interval = strtoul(optarg, NULL, 10); break;
+            case 'U': options.updates_per_tick = strtoul(optarg, NULL, 10); break;
+            case 'R': options.ramp_rate = strtoul(optarg, NULL, 10); break;
+            case 'd': options.duration = strtoul(optarg, NULL, 10); break;
+            case 'v': options.verbose = true; break;
+            default:
+                return false;
+        }
+    }
+    return options.clients > 0 && options.workers > 0 &&
+           options.observable_percent <= 100;
+}
+
+static int compare_latency(const void *a, const void *b)
+{
+    uint64_t first = *(const uint64_t*)a;
+    uint64_t second = *(const uint64_t*)b;
+    return (first > second) - (first < second);
+}
+
+static void report(LoadClient **clients, const Options &options,
+                   uint64_t elapsed, uint32_t heap_per_client)
+{
+    uint64_t *latencies = (uint64_t*)malloc(options.clients * sizeof(uint64_t));
+    uint32_t registered = 0;
+    uint32_t failed = 0;
+    uint64_t updates = 0;
+    uint64_t notifications = 0;
+    uint64_t errors = 0;
+    uint64_t memory = 0;
+    uint64_t latency_sum = 0;
+
+    if(options.verbose) {
+        printf("\n%8s %12s %10s %14s %8s %10s\n", "device", "reg latency", "updates",
+               "notifications", "errors", "memory");
+    }
+    for(uint32_t i = 0; i < options.clients; i++) {
+        LoadClient *client = clients[i];
+        bool done = client->register_latency() > 0;
+        if(done && latencies) {
+            latencies[registered] = client->register_latency();
+            latency_sum += client->register_latency();
+        }
+        registered += done ? 1 : 0;
+        failed += (LoadClient::Failed == client->state()) ? 1 : 0;
+        updates += client->updates();
+        notifications += client->notifications();
+        errors += client->errors();
+        memory += client->memory();
+        if(options.verbose) {
+            printf("%8u %10.1fms %10u %14u %8u %10u\n", client->index(),
+                   client->register_latency() / 1000.0, client->updates(),
+                   client->notifications(), client->errors(), client->memory());
+        }
+    }
+
+    double seconds = elapsed / 1000000.0;
+    printf("\n============== Load generator results ==============\n");
+    printf("Devices:                        %u\n", options.clients);
+    printf("Registered:                     %u\n", registered);
+    printf("Failed:                         %u\n", failed);
+    printf("Errors:                         %llu\n", (unsigned long long)errors);
+    if(registered && latencies) {
+        qsort(latencies, registered, sizeof(uint64_t), compare_latency);
+        printf("Registration latency min:       %.1f ms\n", latencies[0] / 1000.0);
+        printf("Registration latency avg:       %.1f ms\n", latency_sum / registered / 1000.0);
+        printf("Registration latency p50:       %.1f ms\n", latencies[registered / 2] / 1000.0);
+        printf("Registration latency p95:       %.1f ms\n", latencies[registered * 95 / 100] / 1000.0);
+        printf("Registration latency max:       %.1f ms\n", latencies[registered - 1] / 1000.0);
+    }
+    printf("Resource updates:               %llu (%.1f/s)\n", (unsigned long long)updates,
+           seconds > 0 ? updates / seconds : 0.0);
+    printf("Notifications:                  %llu (%.1f/s)\n", (unsigned long long)notifications,
+           seconds > 0 ? notifications / seconds : 0.0);
+    printf("Object model memory per device: %llu bytes\n",
+           (unsigned long long)(memory / options.clients));
+    printf("Heap per device:                %u bytes\n", heap_per_client);
+    free(latencies);
+}
+
+void trace_printer(const char* str)
+{
+  printf("%s\r\n", str);
+}
+
+int main(int argc, char **argv) {
+
+    Options options;
+    if(!parse_options(argc, argv, options)) {
+        usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    trace_init();
+    set_trace_print_function( trace_printer );
+    set_trace_config(TRACE_MODE_COLOR|TRACE_ACTIVE_LEVEL_ERROR|TRACE_CARRIAGE_RETURN);
+
+    signal(SIGINT, (signalhandler_t)ctrl_c_handle_function);
+
+    LoadClient **clients = (LoadClient**)calloc(options.clients, sizeof(LoadClient*));
+    if(!clients) {
+        exit(EXIT_FAILURE);
+    }
+    M2MCommandQueue commands;
+
+    // All the timers of the process run on the network thread.
+    M2MTimer::set_polled(true);
+
+    // Devices are created up front from this thread, the object model
+    // isn't meant to be built from several threads at once.
+    printf("Creating %u devices\n", options.clients);
+    uint32_t heap_before = heap_in_use();
+    uint64_t start = now_us();
+    for(uint32_t i = 0; i < options.clients; i++) {
+        clients[i] = new LoadClient(i, options, commands);
+        if(!clients[i]->create(start)) {
+            printf("Failed to create device %u\n", i);
+            options.clients = i + 1;
+            running = false;
+            break;
+        }
+    }
+    uint32_t heap_per_client = (heap_in_use() - heap_before) / options.clients;
+
+    NetworkLoop network(clients, options.clients, commands);
+    if(running && !network.start()) {
+        printf("Failed to start the network thread\n");
+        running = false;
+    }
+
+    WorkerPool pool(clients, options.clients, options.workers);
+    if(running && !pool.start()) {
+        printf("Failed to start the workers\n");
+        running = false;
+    }
+
+    start = now_us();
+    uint64_t last_notifications = 0;
+    while(running) {
+        sleep(1);
+        uint64_t elapsed = now_us() - start;
+        uint32_t registered = 0;
+        uint64_t notifications = 0;
+        for(uint32_t i = 0; i < options.clients; i++) {
+            registered += (LoadClient::Registered == clients[i]->state()) ? 1 : 0;
+            notifications += clients[i]->notifications();
+        }
+        printf("[%5llus] registered %u/%u, notifications %llu/s\n",
+               (unsigned long long)(elapsed / 1000000), registered, options.clients,
+               (unsigned long long)(notifications - last_notifications));
+        last_notifications = notifications;
+        if(options.duration && elapsed >= (uint64_t)options.duration * 1000000ULL) {
+            running = false;
+        }
+    }
+    pool.stop();
+    uint64_t elapsed = now_us() - start;
+
+    report(clients, options, elapsed, heap_per_client);
+
+    printf("\nUnregistering devices\n");
+    for(uint32_t i = 0; i < options.clients; i++) {
+        clients[i]->unregister();
+    }
+    uint64_t deadline = now_us() + UNREGISTER_TIMEOUT;
+    bool pending = true;
+    while(pending && now_us() < deadline) {
+        pending = false;
+        for(uint32_t i = 0; i < options.clients && !pending; i++) {
+            pending = (LoadClient::Unregistering == clients[i]->state());
+        }
+        if(pending) {
+            usleep(10000);
+        }
+    }
+    network.stop();
+
+    for(uint32_t i = 0; i < options.clients; i++) {
+        delete clients[i];
+    }
+    free(clients);
+
+    exit(EXIT_SUCCESS);
+}